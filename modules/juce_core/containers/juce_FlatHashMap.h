@@ -0,0 +1,556 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Generates the hash values used by FlatHashMap and FlatHashSet.
+
+    Unlike DefaultHashFunctions, these return a full 32-bit hash, which the containers
+    scramble and reduce to a slot index themselves. Strings are hashed from their UTF-8
+    bytes (or from their characters, if JUCE_STRING_UTF_TYPE isn't 8), so that a String,
+    a StringRef, a string literal and an Identifier with the same text all produce the
+    same hash, and can be used to look up each other.
+
+    To use your own key types, write a class with a generateHash() method for each type
+    of key that you'd like to look things up by:
+
+    @code
+    struct MyHashGenerator
+    {
+        uint32 generateHash (const MyKeyType& key) const noexcept
+        {
+            return someFunctionOfMyKeyType (key);
+        }
+    };
+    @endcode
+
+    @see FlatHashMap, FlatHashSet
+*/
+struct FlatHashFunctions
+{
+    /** Generates a hash from an unsigned int. */
+    static uint32 generateHash (uint32 key) noexcept                { return key; }
+    /** Generates a hash from an int. */
+    static uint32 generateHash (int32 key) noexcept                 { return (uint32) key; }
+    /** Generates a hash from a uint64. */
+    static uint32 generateHash (uint64 key) noexcept                { return (uint32) (key ^ (key >> 32)); }
+    /** Generates a hash from an int64. */
+    static uint32 generateHash (int64 key) noexcept                 { return generateHash ((uint64) key); }
+    /** Generates a hash from an unsigned long (e.g. a size_t), which is a different type to uint32 and uint64. */
+    static uint32 generateHash (unsigned long key) noexcept         { return generateHash ((uint64) key); }
+    /** Generates a hash from a long, which is a different type to int32 and int64. */
+    static uint32 generateHash (long key) noexcept                  { return generateHash ((uint64) key); }
+    /** Generates a hash from a pointer. */
+    static uint32 generateHash (const void* key) noexcept           { return generateHash ((uint64) (pointer_sized_uint) key); }
+    /** Generates a hash from a string. */
+    static uint32 generateHash (const String& key) noexcept         { return hashText (key.getCharPointer()); }
+    /** Generates a hash from a string. */
+    static uint32 generateHash (StringRef key) noexcept             { return hashText (key.text); }
+    /** Generates a hash from an Identifier. */
+    static uint32 generateHash (const Identifier& key) noexcept     { return hashText (key.getCharPointer()); }
+    /** Generates a hash from a null-terminated UTF-8 string. */
+    static uint32 generateHash (const char* key) noexcept           { return hashText (CharPointer_UTF8 (key)); }
+
+private:
+    static uint32 hashText (CharPointer_UTF8 text) noexcept
+    {
+        uint32 hash = 2166136261u;
+
+       #if JUCE_STRING_UTF_TYPE == 8
+        for (auto* p = text.getAddress(); auto c = (uint8) *p; ++p)
+            hash = (hash ^ c) * 16777619u;
+       #else
+        while (auto c = text.getAndAdvance())
+            hash = (hash ^ (uint32) c) * 16777619u;
+       #endif
+
+        return hash;
+    }
+
+   #if JUCE_STRING_UTF_TYPE != 8
+    static uint32 hashText (String::CharPointerType text) noexcept
+    {
+        uint32 hash = 2166136261u;
+
+        while (auto c = text.getAndAdvance())
+            hash = (hash ^ (uint32) c) * 16777619u;
+
+        return hash;
+    }
+   #endif
+};
+
+//==============================================================================
+/**
+    A hash map which keeps all its items in a single flat array.
+
+    HashMap allocates an entry for each item and chains them together from its slots,
+    so a lookup usually involves a few cache misses. This class stores the items in the
+    slot array itself, using open addressing with Robin Hood hashing: when an item is
+    inserted, it displaces any item which is closer to its ideal slot than the new one,
+    which keeps the probe sequences short even when the table is quite full. Alongside
+    each slot, it stores the key's hash and its distance from its ideal slot, so most
+    probes don't have to look at the keys at all.
+
+    The lookup methods are templates, so you can find an item using any type that the
+    hash function can hash and which can be compared with the key type. With the
+    default FlatHashFunctions, this means that a map with String keys can be searched
+    using a StringRef or a string literal without creating a temporary String:
+
+    @code
+    FlatHashMap<String, int> map;
+    map.set ("one", 1);
+
+    if (auto* value = map.find (StringRef ("one")))
+        DBG (*value);
+
+    for (auto& item : map)
+        DBG (item.key << " -> " << item.value);
+    @endcode
+
+    Because the items live in the table, adding or removing an item may move the others,
+    so unlike HashMap, a pointer or reference to a value is only valid until the map is
+    next modified. The map isn't thread-safe.
+
+    @see HashMap, FlatHashSet, FlatHashFunctions
+*/
+template <typename KeyType,
+          typename ValueType,
+          class HashFunctionType = FlatHashFunctions>
+class FlatHashMap
+{
+private:
+    typedef typename TypeHelpers::ParameterType<KeyType>::type   KeyTypeParameter;
+    typedef typename TypeHelpers::ParameterType<ValueType>::type ValueTypeParameter;
+
+public:
+    //==============================================================================
+    /** Creates an empty map.
+
+        @param numItemsToReserve    if this is greater than zero, the map allocates enough
+                                    space to hold this many items without growing
+        @param hashFunction         an instance of HashFunctionType, which will be copied
+                                    and stored to use with the map
+    */
+    explicit FlatHashMap (int numItemsToReserve = 0,
+                          HashFunctionType hashFunction = HashFunctionType())
+        : hashFunctionToUse (hashFunction)
+    {
+        reserve (numItemsToReserve);
+    }
+
+    /** Destructor. */
+    ~FlatHashMap()
+    {
+        clear();
+    }
+
+    //==============================================================================
+    /** The key and value which are stored in each occupied slot. */
+    struct Item
+    {
+        KeyType key;
+        ValueType value;
+    };
+
+    //==============================================================================
+    /** Returns the number of items in the map. */
+    int size() const noexcept                   { return numItems; }
+
+    /** Returns true if the map is empty. */
+    bool isEmpty() const noexcept               { return numItems == 0; }
+
+    /** Returns the number of slots in the table. */
+    int getCapacity() const noexcept            { return capacity; }
+
+    /** Removes all the items, but keeps the table allocated. */
+    void clear()
+    {
+        for (int i = 0; i < capacity; ++i)
+        {
+            if (distances[i] != 0)
+            {
+                items[i].~Item();
+                distances[i] = 0;
+            }
+        }
+
+        numItems = 0;
+    }
+
+    /** Makes sure that the table has space for at least the given number of items. */
+    void reserve (int numItemsNeeded)
+    {
+        auto newCapacity = jmax (capacity, minimumCapacity);
+
+        while (numItemsNeeded > getMaxNumItems (newCapacity))
+            newCapacity *= 2;
+
+        if (newCapacity != capacity && numItemsNeeded > 0)
+            rehash (newCapacity);
+    }
+
+    //==============================================================================
+    /** Returns a pointer to the value stored for a key, or nullptr if there isn't one.
+        The pointer is only valid until the map is next modified.
+    */
+    template <typename KeyToFind>
+    ValueType* find (const KeyToFind& keyToFind) noexcept
+    {
+        auto index = findIndex (keyToFind);
+        return index >= 0 ? &(items[index].value) : nullptr;
+    }
+
+    /** Returns a pointer to the value stored for a key, or nullptr if there isn't one.
+        The pointer is only valid until the map is next modified.
+    */
+    template <typename KeyToFind>
+    const ValueType* find (const KeyToFind& keyToFind) const noexcept
+    {
+        auto index = findIndex (keyToFind);
+        return index >= 0 ? &(items[index].value) : nullptr;
+    }
+
+    /** Returns true if the map contains an item with the given key. */
+    template <typename KeyToFind>
+    bool contains (const KeyToFind& keyToFind) const noexcept
+    {
+        return findIndex (keyToFind) >= 0;
+    }
+
+    /** Returns the value stored for a key, or a default-constructed value if there isn't one. */
+    template <typename KeyToFind>
+    ValueType operator[] (const KeyToFind& keyToFind) const
+    {
+        if (auto* value = find (keyToFind))
+            return *value;
+
+        return ValueType();
+    }
+
+    /** Returns a reference to the value stored for a key, adding a default-constructed
+        value if there isn't one. The reference is only valid until the map is next modified.
+    */
+    ValueType& getReference (KeyTypeParameter key)
+    {
+        auto index = findIndex (key);
+
+        if (index < 0)
+        {
+            insert (key, ValueType());
+            index = findIndex (key);
+        }
+
+        return items[index].value;
+    }
+
+    /** Adds or replaces the value stored for a key. */
+    void set (KeyTypeParameter key, ValueTypeParameter value)
+    {
+        auto index = findIndex (key);
+
+        if (index >= 0)
+            items[index].value = value;
+        else
+            insert (key, value);
+    }
+
+    /** Removes the item with the given key, returning false if there wasn't one. */
+    template <typename KeyToFind>
+    bool remove (const KeyToFind& keyToFind)
+    {
+        auto index = findIndex (keyToFind);
+
+        if (index < 0)
+            return false;
+
+        // shift the following items back, until one of them is in its ideal slot
+        for (;;)
+        {
+            auto next = (index + 1) & mask;
+
+            if (distances[next] <= 1)
+                break;
+
+            items[index] = static_cast<Item&&> (items[next]);
+            hashes[index] = hashes[next];
+            distances[index] = (uint8) (distances[next] - 1);
+            index = next;
+        }
+
+        items[index].~Item();
+        distances[index] = 0;
+        --numItems;
+        return true;
+    }
+
+    /** Efficiently swaps the contents of two maps. */
+    void swapWith (FlatHashMap& other) noexcept
+    {
+        items.swapWith (other.items);
+        hashes.swapWith (other.hashes);
+        distances.swapWith (other.distances);
+        std::swap (capacity, other.capacity);
+        std::swap (mask, other.mask);
+        std::swap (shift, other.shift);
+        std::swap (numItems, other.numItems);
+        std::swap (hashFunctionToUse, other.hashFunctionToUse);
+    }
+
+    //==============================================================================
+    /** Iterates the items in the map, in no particular order.
+        The keys mustn't be modified through the iterator.
+    */
+    struct Iterator
+    {
+        Iterator (const FlatHashMap& m, int i) noexcept  : map (m), index (i)   { skipEmptySlots(); }
+
+        Item& operator*() const noexcept                { return map.items[index]; }
+        Item* operator->() const noexcept               { return map.items + index; }
+        Iterator& operator++() noexcept                 { ++index; skipEmptySlots(); return *this; }
+        bool operator!= (const Iterator& other) const noexcept   { return index != other.index; }
+
+    private:
+        const FlatHashMap& map;
+        int index;
+
+        void skipEmptySlots() noexcept
+        {
+            while (index < map.capacity && map.distances[index] == 0)
+                ++index;
+        }
+    };
+
+    /** Returns an iterator pointing to the first item. */
+    Iterator begin() const noexcept     { return Iterator (*this, 0); }
+
+    /** Returns an iterator pointing past the last item. */
+    Iterator end() const noexcept       { return Iterator (*this, capacity); }
+
+private:
+    //==============================================================================
+    static constexpr int minimumCapacity = 8, maxDistance = 255;
+
+    HashFunctionType hashFunctionToUse;
+    HeapBlock<Item> items;
+    HeapBlock<uint32> hashes;
+    HeapBlock<uint8> distances;   // 0 for an empty slot, otherwise the distance from the ideal slot + 1
+    int capacity = 0, mask = 0, shift = 32, numItems = 0;
+
+    static int getMaxNumItems (int numSlots) noexcept     { return numSlots - numSlots / 8; }
+
+    int getIdealSlot (uint32 hash) const noexcept
+    {
+        // multiplying by the golden ratio spreads poorly distributed hashes, like a run of
+        // consecutive ints, across the table
+        return (int) ((hash * 2654435769u) >> shift);
+    }
+
+    template <typename KeyToFind>
+    int findIndex (const KeyToFind& keyToFind) const noexcept
+    {
+        if (numItems == 0)
+            return -1;
+
+        auto hash = hashFunctionToUse.generateHash (keyToFind);
+        auto index = getIdealSlot (hash);
+
+        for (int distance = 1;; ++distance)
+        {
+            // an item further along would have displaced one that's closer to its ideal slot
+            if (distances[index] < distance)
+                return -1;
+
+            if (hashes[index] == hash && items[index].key == keyToFind)
+                return index;
+
+            index = (index + 1) & mask;
+        }
+    }
+
+    void insert (KeyTypeParameter key, ValueTypeParameter value)
+    {
+        if (numItems >= getMaxNumItems (capacity))
+            rehash (jmax (minimumCapacity, capacity * 2));
+
+        Item item = { key, value };
+        insertItem (item, hashFunctionToUse.generateHash (key));
+        ++numItems;
+    }
+
+    void insertItem (Item& item, uint32 hash)
+    {
+        auto index = getIdealSlot (hash);
+
+        for (int distance = 1;; ++distance)
+        {
+            if (distances[index] == 0)
+            {
+                new (items + index) Item (static_cast<Item&&> (item));
+                hashes[index] = hash;
+                distances[index] = (uint8) distance;
+                return;
+            }
+
+            if (distances[index] < distance)
+            {
+                // take the slot from the richer item, and carry on inserting that one instead
+                std::swap (item, items[index]);
+                std::swap (hash, hashes[index]);
+
+                auto displacedDistance = (int) distances[index];
+                distances[index] = (uint8) distance;
+                distance = displacedDistance;
+            }
+
+            if (distance >= maxDistance)
+            {
+                // this can only happen with a very poor hash function
+                jassertfalse;
+                rehash (capacity * 2);
+                insertItem (item, hash);
+                return;
+            }
+
+            index = (index + 1) & mask;
+        }
+    }
+
+    void rehash (int newCapacity)
+    {
+        jassert (isPowerOfTwo (newCapacity));
+
+        HeapBlock<Item> oldItems (static_cast<HeapBlock<Item>&&> (items));
+        HeapBlock<uint32> oldHashes (static_cast<HeapBlock<uint32>&&> (hashes));
+        HeapBlock<uint8> oldDistances (static_cast<HeapBlock<uint8>&&> (distances));
+        auto oldCapacity = capacity;
+
+        items.malloc ((size_t) newCapacity);
+        hashes.malloc ((size_t) newCapacity);
+        distances.calloc ((size_t) newCapacity);
+        capacity = newCapacity;
+        mask = newCapacity - 1;
+        shift = 32;
+
+        for (auto n = newCapacity; n > 1; n >>= 1)
+            --shift;
+
+        for (int i = 0; i < oldCapacity; ++i)
+        {
+            if (oldDistances[i] != 0)
+            {
+                insertItem (oldItems[i], oldHashes[i]);
+                oldItems[i].~Item();
+            }
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FlatHashMap)
+};
+
+//==============================================================================
+/**
+    A set of unique keys, stored in a flat open-addressed table.
+
+    This works in the same way as FlatHashMap, and can also be searched with any type
+    that the hash function accepts, e.g. a StringRef for a set of Strings.
+
+    @see FlatHashMap, SortedSet
+*/
+template <typename KeyType, class HashFunctionType = FlatHashFunctions>
+class FlatHashSet
+{
+private:
+    struct Empty {};
+    typedef FlatHashMap<KeyType, Empty, HashFunctionType> MapType;
+    typedef typename TypeHelpers::ParameterType<KeyType>::type KeyTypeParameter;
+
+public:
+    //==============================================================================
+    /** Creates an empty set. */
+    explicit FlatHashSet (int numItemsToReserve = 0,
+                          HashFunctionType hashFunction = HashFunctionType())
+        : map (numItemsToReserve, hashFunction)
+    {
+    }
+
+    /** Returns the number of keys in the set. */
+    int size() const noexcept                   { return map.size(); }
+
+    /** Returns true if the set is empty. */
+    bool isEmpty() const noexcept               { return map.isEmpty(); }
+
+    /** Removes all the keys, but keeps the table allocated. */
+    void clear()                                { map.clear(); }
+
+    /** Makes sure that the table has space for at least the given number of keys. */
+    void reserve (int numItemsNeeded)           { map.reserve (numItemsNeeded); }
+
+    /** Returns true if the set contains the given key. */
+    template <typename KeyToFind>
+    bool contains (const KeyToFind& keyToFind) const noexcept   { return map.contains (keyToFind); }
+
+    /** Adds a key to the set, returning false if it was already there. */
+    bool add (KeyTypeParameter key)
+    {
+        if (map.contains (key))
+            return false;
+
+        map.set (key, Empty());
+        return true;
+    }
+
+    /** Removes a key from the set, returning false if it wasn't there. */
+    template <typename KeyToFind>
+    bool remove (const KeyToFind& keyToFind)    { return map.remove (keyToFind); }
+
+    //==============================================================================
+    /** Iterates the keys in the set, in no particular order. */
+    struct Iterator
+    {
+        Iterator (typename MapType::Iterator i) noexcept  : iterator (i) {}
+
+        const KeyType& operator*() const noexcept           { return (*iterator).key; }
+        Iterator& operator++() noexcept                     { ++iterator; return *this; }
+        bool operator!= (const Iterator& other) const noexcept  { return iterator != other.iterator; }
+
+    private:
+        typename MapType::Iterator iterator;
+    };
+
+    /** Returns an iterator pointing to the first key. */
+    Iterator begin() const noexcept     { return Iterator (map.begin()); }
+
+    /** Returns an iterator pointing past the last key. */
+    Iterator end() const noexcept       { return Iterator (map.end()); }
+
+private:
+    MapType map;
+
+    JUCE_DECLARE_NON_COPYABLE (FlatHashSet)
+};
+
+} // namespace juce
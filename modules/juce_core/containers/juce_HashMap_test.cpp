@@ -29,20 +29,31 @@ struct HashMapTest : public UnitTest
 
     void runTest() override
     {
-        doTest<AddElementsTest> ("AddElementsTest");
-        doTest<AccessTest> ("AccessTest");
-        doTest<RemoveTest> ("RemoveTest");
-        doTest<PersistantMemoryLocationOfValues> ("PersistantMemoryLocationOfValues");
+        doTest<AddElementsTest, HashMap> ("AddElementsTest");
+        doTest<AccessTest, HashMap> ("AccessTest");
+        doTest<RemoveTest, HashMap> ("RemoveTest");
+        doTest<PersistantMemoryLocationOfValues, HashMap> ("PersistantMemoryLocationOfValues");
+
+        doTest<AddElementsTest, FlatHashMap> ("FlatHashMap AddElementsTest");
+        doTest<AccessTest, FlatHashMap> ("FlatHashMap AccessTest");
+        doTest<RemoveTest, FlatHashMap> ("FlatHashMap RemoveTest");
+
+        testFlatHashMapLookups();
+        testFlatHashSet();
+
+        beginTest ("Benchmark");
+        benchmark<int>();
+        benchmark<String>();
     }
 
     //==============================================================================
     struct AddElementsTest
     {
-        template <typename KeyType>
+        template <template <typename...> class MapType, typename KeyType>
         static void run (UnitTest& u)
         {
             AssociativeMap<KeyType, int> groundTruth;
-            HashMap<KeyType, int> hashMap;
+            MapType<KeyType, int> hashMap;
 
             RandomKeys<KeyType> keyOracle (300, 3827829);
             Random valueOracle (48735);
@@ -68,11 +79,11 @@ struct HashMapTest : public UnitTest
 
     struct AccessTest
     {
-        template <typename KeyType>
+        template <template <typename...> class MapType, typename KeyType>
         static void run (UnitTest& u)
         {
             AssociativeMap<KeyType, int> groundTruth;
-            HashMap<KeyType, int> hashMap;
+            MapType<KeyType, int> hashMap;
 
             fillWithRandomValues (hashMap, groundTruth);
 
@@ -83,11 +94,11 @@ struct HashMapTest : public UnitTest
 
     struct RemoveTest
     {
-        template <typename KeyType>
+        template <template <typename...> class MapType, typename KeyType>
         static void run (UnitTest& u)
         {
             AssociativeMap<KeyType, int> groundTruth;
-            HashMap<KeyType, int> hashMap;
+            MapType<KeyType, int> hashMap;
 
             fillWithRandomValues (hashMap, groundTruth);
             auto n = groundTruth.size();
@@ -115,11 +126,11 @@ struct HashMapTest : public UnitTest
     {
         struct AddressAndValue { int value; const int* valueAddress; };
 
-        template <typename KeyType>
+        template <template <typename...> class MapType, typename KeyType>
         static void run (UnitTest& u)
         {
             AssociativeMap<KeyType, AddressAndValue> groundTruth;
-            HashMap<KeyType, int> hashMap;
+            MapType<KeyType, int> hashMap;
 
             RandomKeys<KeyType> keyOracle (300, 3827829);
             Random valueOracle (48735);
@@ -173,14 +184,165 @@ struct HashMapTest : public UnitTest
     };
 
     //==============================================================================
-    template <class Test>
+    template <class Test, template <typename...> class MapType>
     void doTest (const String& testName)
     {
         beginTest (testName);
 
-        Test::template run<int> (*this);
-        Test::template run<void*> (*this);
-        Test::template run<String> (*this);
+        Test::template run<MapType, int> (*this);
+        Test::template run<MapType, void*> (*this);
+        Test::template run<MapType, String> (*this);
+    }
+
+    //==============================================================================
+    void testFlatHashMapLookups()
+    {
+        beginTest ("FlatHashMap heterogeneous lookups");
+
+        FlatHashMap<String, int> map;
+
+        for (int i = 0; i < 1000; ++i)
+            map.set ("item" + String (i), i);
+
+        expectEquals (map.size(), 1000);
+        expectEquals (map["item123"], 123);
+        expectEquals (map[StringRef ("item456")], 456);
+        expect (map.find (StringRef ("item1000")) == nullptr);
+        expect (! map.contains ("item"));
+
+        ++map.getReference ("item1");
+        map.getReference ("new") = -1;
+        expectEquals (map["item1"], 2);
+        expectEquals (map["new"], -1);
+        expectEquals (map.size(), 1001);
+
+        int total = 0, count = 0;
+
+        for (auto& item : map)
+        {
+            expect (item.key == "new" || item.key == "item" + String (item.value - (item.key == "item1" ? 1 : 0)));
+            total += item.value;
+            ++count;
+        }
+
+        expectEquals (count, 1001);
+        expectEquals (total, 999 * 1000 / 2 + 1 - 1);
+
+        for (int i = 0; i < 1000; i += 2)
+            expect (map.remove (StringRef ("item" + String (i))));
+
+        expect (! map.remove ("item0"));
+        expectEquals (map.size(), 501);
+
+        for (int i = 1; i < 1000; i += 2)
+            expect (map.contains ("item" + String (i)));
+
+        FlatHashMap<String, int> other;
+        other.swapWith (map);
+        expect (map.isEmpty());
+        expectEquals (other.size(), 501);
+
+        other.clear();
+        expect (other.isEmpty() && ! other.contains ("item1"));
+    }
+
+    void testFlatHashSet()
+    {
+        beginTest ("FlatHashSet");
+
+        FlatHashSet<String> set;
+        expect (set.add ("a"));
+        expect (set.add ("b"));
+        expect (! set.add ("a"));
+        expectEquals (set.size(), 2);
+        expect (set.contains (StringRef ("b")));
+        expect (set.remove ("a"));
+        expect (! set.contains ("a"));
+
+        StringArray keys;
+
+        for (auto& key : set)
+            keys.add (key);
+
+        expect (keys == StringArray ("b"));
+
+        // (size_t and long aren't the same types as uint64 and int64 on every platform)
+        FlatHashSet<size_t> sizes;
+        FlatHashSet<long> longs;
+
+        for (int i = 0; i < 100; ++i)
+        {
+            sizes.add ((size_t) i);
+            longs.add ((long) -i);
+        }
+
+        expect (sizes.size() == 100 && sizes.contains ((size_t) 99));
+        expect (longs.size() == 100 && longs.contains ((long) -99));
+    }
+
+    //==============================================================================
+    template <typename KeyType>
+    void benchmark()
+    {
+        const int numKeys = 100000, numLookups = 1000000;
+
+        Array<KeyType> keys, missingKeys;
+        FlatHashSet<KeyType> uniqueKeys;
+        Random r (12345);
+
+        while (uniqueKeys.size() < numKeys * 2)
+        {
+            auto key = RandomKeys<KeyType>::generateBenchmarkKey (r);
+
+            if (uniqueKeys.add (key))
+                (keys.size() < numKeys ? keys : missingKeys).add (key);
+        }
+
+        auto hashMapTimes = timeMap<HashMap<KeyType, int>> (keys, missingKeys, numLookups);
+        auto flatMapTimes = timeMap<FlatHashMap<KeyType, int>> (keys, missingKeys, numLookups);
+
+        auto describe = [] (const char* mapName, const Array<double>& times)
+        {
+            return String (mapName).paddedRight (' ', 12)
+                    + " insert " + String (times[0], 1) + " ms, hits " + String (times[1], 1)
+                    + " ms, misses " + String (times[2], 1) + " ms";
+        };
+
+        logMessage (String (std::is_same<KeyType, String>::value ? "String" : "int") + " keys, "
+                      + String (numKeys) + " items, " + String (numLookups) + " lookups:");
+        logMessage (describe ("HashMap", hashMapTimes));
+        logMessage (describe ("FlatHashMap", flatMapTimes));
+    }
+
+    template <typename MapType, typename KeyType>
+    Array<double> timeMap (const Array<KeyType>& keys, const Array<KeyType>& missingKeys, int numLookups)
+    {
+        Array<double> times;
+        MapType map (keys.size());   // HashMap doesn't grow its table, so size both maps up-front
+        int total = 0;
+
+        auto start = Time::getMillisecondCounterHiRes();
+
+        for (int i = 0; i < keys.size(); ++i)
+            map.set (keys.getReference (i), i);
+
+        times.add (Time::getMillisecondCounterHiRes() - start);
+        start = Time::getMillisecondCounterHiRes();
+
+        for (int i = 0, index = 0; i < numLookups; ++i, index = (index + 7919) % keys.size())
+            total += map[keys.getReference (index)];
+
+        times.add (Time::getMillisecondCounterHiRes() - start);
+        start = Time::getMillisecondCounterHiRes();
+
+        for (int i = 0, index = 0; i < numLookups; ++i, index = (index + 7919) % missingKeys.size())
+            total += map.contains (missingKeys.getReference (index)) ? 1 : 0;
+
+        times.add (Time::getMillisecondCounterHiRes() - start);
+
+        expectEquals (map.size(), keys.size());
+        expect (total != 12345); // stops the lookups being optimised away
+        return times;
     }
 
     //==============================================================================
@@ -217,8 +379,8 @@ struct HashMapTest : public UnitTest
         Array<KeyValuePair> pairs;
     };
 
-    template <typename KeyType, typename ValueType>
-    static void fillWithRandomValues (HashMap<KeyType, int>& hashMap, AssociativeMap<KeyType, ValueType>& groundTruth)
+    template <typename MapType, typename KeyType, typename ValueType>
+    static void fillWithRandomValues (MapType& hashMap, AssociativeMap<KeyType, ValueType>& groundTruth)
     {
         RandomKeys<KeyType> keyOracle (300, 3827829);
         Random valueOracle (48735);
@@ -249,6 +411,9 @@ struct HashMapTest : public UnitTest
             int i = r.nextInt (keys.size() - 1);
             return keys.getReference (i);
         }
+
+        static KeyType generateBenchmarkKey (Random&);
+
     private:
         static KeyType generateRandomKey (Random&);
 
@@ -271,6 +436,13 @@ template <> String HashMapTest::RandomKeys<String>::generateRandomKey (Random& r
     return str;
 }
 
+template <> int HashMapTest::RandomKeys<int>::generateBenchmarkKey (Random& rnd)  { return rnd.nextInt(); }
+
+template <> String HashMapTest::RandomKeys<String>::generateBenchmarkKey (Random& rnd)
+{
+    return "key_" + String::toHexString (rnd.nextInt64());
+}
+
 static HashMapTest hashMapTest;
 
 } // namespace juce
@@ -0,0 +1,268 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A lock-free, single-reader, single-writer FIFO which holds its own elements.
+
+    Unlike AbstractFifo, which only manages the read and write positions of a buffer
+    that you provide, this class owns its storage, and can hand out the free or ready
+    regions as spans, so that a block of data can be written or read in place without
+    an extra copy.
+
+    @code
+    LockFreeFifo<float> fifo (4096);
+
+    // writer thread:
+    auto span = fifo.prepareToWrite (numSamples);
+    FloatVectorOperations::copy (span.data1, source, span.size1);
+    FloatVectorOperations::copy (span.data2, source + span.size1, span.size2);
+    fifo.finishedWrite (span.getTotalSize());
+
+    // reader thread:
+    auto ready = fifo.prepareToRead (numSamples);
+    ...
+    fifo.finishedRead (ready.getTotalSize());
+    @endcode
+
+    Only one thread may write and only one thread may read at any time. The capacity is
+    rounded up to a power of two. All the elements are constructed when the FIFO is
+    created, and items are moved in and out of them by assignment.
+
+    @see AbstractFifo, LockFreeQueue, LockFreeMessageQueue
+*/
+template <typename ElementType>
+class LockFreeFifo
+{
+public:
+    //==============================================================================
+    /** Creates a FIFO which can hold at least the given number of items. */
+    explicit LockFreeFifo (int minimumCapacity)
+        : capacity (nextPowerOfTwo (jmax (2, minimumCapacity))),
+          mask ((uint32) capacity - 1)
+    {
+        elements.malloc ((size_t) capacity);
+
+        for (int i = 0; i < capacity; ++i)
+            new (elements + i) ElementType();
+    }
+
+    /** Destructor. */
+    ~LockFreeFifo()
+    {
+        for (int i = 0; i < capacity; ++i)
+            elements[i].~ElementType();
+    }
+
+    //==============================================================================
+    /** Returns the number of items that the FIFO can hold. */
+    int getCapacity() const noexcept            { return capacity; }
+
+    /** Returns the number of items that can currently be read. */
+    int getNumReady() const noexcept            { return (int) (writePosition.get() - readPosition.get()); }
+
+    /** Returns the number of items that can currently be written. */
+    int getFreeSpace() const noexcept           { return capacity - getNumReady(); }
+
+    /** Empties the FIFO. This isn't thread-safe, so neither end may be in use. */
+    void reset() noexcept
+    {
+        writePosition.set (0);
+        readPosition.set (0);
+        cachedReadPosition = cachedWritePosition = 0;
+    }
+
+    //==============================================================================
+    /** A region of the FIFO, which may wrap around the end of its storage. */
+    struct Span
+    {
+        ElementType* data1;
+        int size1;
+        ElementType* data2;
+        int size2;
+
+        /** Returns the total number of items in the two parts. */
+        int getTotalSize() const noexcept       { return size1 + size2; }
+
+        /** Returns one of the items, where 0 is the first item in data1. */
+        ElementType& operator[] (int index) const noexcept
+        {
+            jassert (isPositiveAndBelow (index, size1 + size2));
+            return index < size1 ? data1[index] : data2[index - size1];
+        }
+    };
+
+    /** Returns the free region into which up to numWanted items can be written.
+
+        The span may be smaller than numWanted if there isn't enough space. Once you've
+        filled it in, call finishedWrite() to make the new items visible to the reader.
+        This must only be called by the writer thread.
+    */
+    Span prepareToWrite (int numWanted) noexcept
+    {
+        auto start = writePosition.get();
+        auto freeSpace = capacity - (int) (start - cachedReadPosition);
+
+        if (numWanted > freeSpace)
+        {
+            cachedReadPosition = readPosition.get();
+            freeSpace = capacity - (int) (start - cachedReadPosition);
+        }
+
+        return getSpan (start, jmin (jmax (0, numWanted), freeSpace));
+    }
+
+    /** Publishes the given number of items from the start of the span returned by
+        prepareToWrite().
+    */
+    void finishedWrite (int numWritten) noexcept
+    {
+        jassert (numWritten >= 0 && numWritten <= capacity - (int) (writePosition.get() - cachedReadPosition));
+        writePosition.set (writePosition.get() + (uint32) numWritten);
+    }
+
+    /** Returns the region containing up to numWanted items which are ready to be read.
+
+        The span may be smaller than numWanted if fewer items are available. After
+        reading them, call finishedRead() to release the space to the writer.
+        This must only be called by the reader thread.
+    */
+    Span prepareToRead (int numWanted) noexcept
+    {
+        auto start = readPosition.get();
+        auto numReady = (int) (cachedWritePosition - start);
+
+        if (numWanted > numReady)
+        {
+            cachedWritePosition = writePosition.get();
+            numReady = (int) (cachedWritePosition - start);
+        }
+
+        return getSpan (start, jmin (jmax (0, numWanted), numReady));
+    }
+
+    /** Releases the given number of items from the start of the span returned by
+        prepareToRead().
+    */
+    void finishedRead (int numRead) noexcept
+    {
+        jassert (numRead >= 0 && numRead <= (int) (cachedWritePosition - readPosition.get()));
+        readPosition.set (readPosition.get() + (uint32) numRead);
+    }
+
+    //==============================================================================
+    /** Adds an item, returning false if the FIFO is full. */
+    bool push (const ElementType& newItem)
+    {
+        auto span = prepareToWrite (1);
+
+        if (span.size1 == 0)
+            return false;
+
+        *span.data1 = newItem;
+        finishedWrite (1);
+        return true;
+    }
+
+    /** Adds an item, returning false if the FIFO is full. */
+    bool push (ElementType&& newItem)
+    {
+        auto span = prepareToWrite (1);
+
+        if (span.size1 == 0)
+            return false;
+
+        *span.data1 = static_cast<ElementType&&> (newItem);
+        finishedWrite (1);
+        return true;
+    }
+
+    /** Removes the next item, returning false if the FIFO is empty. */
+    bool pop (ElementType& result)
+    {
+        auto span = prepareToRead (1);
+
+        if (span.size1 == 0)
+            return false;
+
+        result = static_cast<ElementType&&> (*span.data1);
+        finishedRead (1);
+        return true;
+    }
+
+    /** Copies as many of the given items into the FIFO as will fit, and returns the
+        number that were written.
+    */
+    int write (const ElementType* source, int numItems)
+    {
+        auto span = prepareToWrite (numItems);
+        std::copy (source, source + span.size1, span.data1);
+        std::copy (source + span.size1, source + span.size1 + span.size2, span.data2);
+        finishedWrite (span.getTotalSize());
+        return span.getTotalSize();
+    }
+
+    /** Moves up to numItems items out of the FIFO, and returns the number that were read. */
+    int read (ElementType* destination, int numItems)
+    {
+        auto span = prepareToRead (numItems);
+        std::move (span.data1, span.data1 + span.size1, destination);
+        std::move (span.data2, span.data2 + span.size2, destination + span.size1);
+        finishedRead (span.getTotalSize());
+        return span.getTotalSize();
+    }
+
+private:
+    //==============================================================================
+    enum { cacheLineSize = 64 };
+
+    const int capacity;
+    const uint32 mask;
+    HeapBlock<ElementType> elements;
+
+    // The positions are free-running counters, which are masked to find an index.
+    // Each end keeps a private copy of the other's position, so that it only needs to
+    // read the shared one when the copy suggests that it's run out of room.
+    char padding1[cacheLineSize];
+    Atomic<uint32> writePosition;
+    uint32 cachedReadPosition = 0;
+    char padding2[cacheLineSize];
+    Atomic<uint32> readPosition;
+    uint32 cachedWritePosition = 0;
+    char padding3[cacheLineSize];
+
+    Span getSpan (uint32 start, int num) const noexcept
+    {
+        auto index = (int) (start & mask);
+        auto size1 = jmin (num, capacity - index);
+
+        return { elements + index, size1, elements.get(), num - size1 };
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (LockFreeFifo)
+};
+
+} // namespace juce
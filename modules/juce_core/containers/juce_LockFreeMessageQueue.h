@@ -0,0 +1,167 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    The base class for objects which can be passed through a LockFreeMessageQueue.
+
+    @see LockFreeMessageQueue
+*/
+struct LockFreeMessageQueueNode
+{
+    LockFreeMessageQueueNode() noexcept {}
+
+    /** Used by the queue to link its nodes together. */
+    Atomic<LockFreeMessageQueueNode*> nextInQueue;
+
+    JUCE_DECLARE_NON_COPYABLE (LockFreeMessageQueueNode)
+};
+
+//==============================================================================
+/**
+    An unbounded, lock-free queue which any number of threads can push to, but only
+    one thread may pop from.
+
+    The queue is intrusive: the objects that it holds must inherit from
+    LockFreeMessageQueueNode, and are linked together through that base class, so
+    pushing and popping never allocate any memory. The queue doesn't own its objects,
+    so you need to make sure that each one stays alive until it's been popped.
+
+    @code
+    struct Message  : public LockFreeMessageQueueNode
+    {
+        int type;
+        float value;
+    };
+
+    LockFreeMessageQueue<Message> messages;
+
+    // any thread:
+    messages.push (message);
+
+    // the consumer thread:
+    while (auto* m = messages.pop())
+        handleMessage (*m);
+    @endcode
+
+    A push is a single atomic exchange, so the producers never wait for each other.
+    While a push is half-way through, the consumer may briefly be unable to see the
+    items that come after it, so pop() can return nullptr even though isEmpty() is
+    false; the item will become visible as soon as the push completes.
+
+    @see LockFreeQueue, LockFreeFifo
+*/
+template <typename NodeType>
+class LockFreeMessageQueue
+{
+public:
+    //==============================================================================
+    /** Creates an empty queue. */
+    LockFreeMessageQueue() noexcept
+        : head (&stub), tail (&stub)
+    {
+        static_assert (std::is_base_of<LockFreeMessageQueueNode, NodeType>::value,
+                       "The queue's objects must inherit from LockFreeMessageQueueNode");
+    }
+
+    /** Destructor. The queue should be empty when it's deleted. */
+    ~LockFreeMessageQueue()
+    {
+        jassert (isEmpty());
+    }
+
+    //==============================================================================
+    /** Adds an object to the end of the queue. This can be called from any thread. */
+    void push (NodeType* node) noexcept
+    {
+        jassert (node != nullptr);
+        pushNode (node);
+    }
+
+    /** Removes the object at the front of the queue, or returns nullptr if there isn't
+        one. This must only be called by the consumer thread.
+    */
+    NodeType* pop() noexcept
+    {
+        auto* first = tail;
+        auto* next = first->nextInQueue.get();
+
+        if (first == &stub)
+        {
+            if (next == nullptr)
+                return nullptr;
+
+            tail = first = next;
+            next = next->nextInQueue.get();
+        }
+
+        if (next != nullptr)
+        {
+            tail = next;
+            return static_cast<NodeType*> (first);
+        }
+
+        // a producer has swapped in a new head, but hasn't linked it in yet
+        if (first != head.get())
+            return nullptr;
+
+        // the last node can't be removed until something follows it, so push the stub
+        pushNode (&stub);
+        next = first->nextInQueue.get();
+
+        if (next != nullptr)
+        {
+            tail = next;
+            return static_cast<NodeType*> (first);
+        }
+
+        return nullptr;
+    }
+
+    /** Returns true if there's nothing in the queue.
+        If other threads are pushing, this is only a snapshot.
+    */
+    bool isEmpty() const noexcept
+    {
+        return tail == &stub && head.get() == &stub;
+    }
+
+private:
+    //==============================================================================
+    LockFreeMessageQueueNode stub;
+    Atomic<LockFreeMessageQueueNode*> head;
+    LockFreeMessageQueueNode* tail;
+
+    void pushNode (LockFreeMessageQueueNode* node) noexcept
+    {
+        node->nextInQueue.set (nullptr);
+        head.exchange (node)->nextInQueue.set (node);
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (LockFreeMessageQueue)
+};
+
+} // namespace juce
@@ -0,0 +1,191 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A bounded, lock-free queue which any number of threads can push to and pop from.
+
+    Each slot holds a sequence number alongside its item. A thread claims a slot by
+    advancing the shared enqueue or dequeue position with a compare-and-swap, and
+    then publishes it by updating the slot's sequence number, so the threads only
+    contend on the positions and never wait for one another while an item is being
+    copied.
+
+    @code
+    LockFreeQueue<Job> jobs (256);
+
+    // any producer:
+    if (! jobs.push (newJob))
+        handleOverflow();
+
+    // any consumer:
+    Job job;
+    while (jobs.pop (job))
+        job.run();
+    @endcode
+
+    The capacity is rounded up to a power of two. All the elements are constructed when
+    the queue is created, and items are moved in and out of them by assignment.
+
+    @see LockFreeFifo, LockFreeMessageQueue
+*/
+template <typename ElementType>
+class LockFreeQueue
+{
+public:
+    //==============================================================================
+    /** Creates a queue which can hold at least the given number of items. */
+    explicit LockFreeQueue (int minimumCapacity)
+        : capacity (nextPowerOfTwo (jmax (2, minimumCapacity))),
+          mask ((uint32) capacity - 1)
+    {
+        cells.malloc ((size_t) capacity);
+
+        for (int i = 0; i < capacity; ++i)
+            new (cells + i) Cell ((uint32) i);
+    }
+
+    /** Destructor. */
+    ~LockFreeQueue()
+    {
+        for (int i = 0; i < capacity; ++i)
+            cells[i].~Cell();
+    }
+
+    //==============================================================================
+    /** Returns the number of items that the queue can hold. */
+    int getCapacity() const noexcept        { return capacity; }
+
+    /** Returns the number of items in the queue.
+        If other threads are using the queue, this is only a snapshot.
+    */
+    int getNumReady() const noexcept
+    {
+        return jlimit (0, capacity, (int) (enqueuePosition.get() - dequeuePosition.get()));
+    }
+
+    //==============================================================================
+    /** Adds an item to the queue, returning false if it's full. */
+    bool push (const ElementType& newItem)
+    {
+        if (auto* cell = claimCellToWrite())
+        {
+            cell->item = newItem;
+            cell->sequence.set (cell->sequence.get() + 1);
+            return true;
+        }
+
+        return false;
+    }
+
+    /** Adds an item to the queue, returning false if it's full. */
+    bool push (ElementType&& newItem)
+    {
+        if (auto* cell = claimCellToWrite())
+        {
+            cell->item = static_cast<ElementType&&> (newItem);
+            cell->sequence.set (cell->sequence.get() + 1);
+            return true;
+        }
+
+        return false;
+    }
+
+    /** Removes the oldest item from the queue, returning false if it's empty. */
+    bool pop (ElementType& result)
+    {
+        for (auto position = dequeuePosition.get();;)
+        {
+            auto& cell = cells[position & mask];
+            auto difference = (int32) (cell.sequence.get() - (position + 1));
+
+            if (difference == 0)
+            {
+                if (dequeuePosition.compareAndSetBool (position + 1, position))
+                {
+                    result = static_cast<ElementType&&> (cell.item);
+                    cell.sequence.set (position + (uint32) capacity);
+                    return true;
+                }
+            }
+            else if (difference < 0)
+            {
+                return false;
+            }
+
+            position = dequeuePosition.get();
+        }
+    }
+
+private:
+    //==============================================================================
+    // A cell is free for the write at position p when its sequence is p, and holds
+    // the item for the read at position p when its sequence is p + 1.
+    struct Cell
+    {
+        Cell (uint32 initialSequence) noexcept  : sequence (initialSequence) {}
+
+        Atomic<uint32> sequence;
+        ElementType item;
+    };
+
+    enum { cacheLineSize = 64 };
+
+    const int capacity;
+    const uint32 mask;
+    HeapBlock<Cell> cells;
+
+    char padding1[cacheLineSize];
+    Atomic<uint32> enqueuePosition;
+    char padding2[cacheLineSize];
+    Atomic<uint32> dequeuePosition;
+    char padding3[cacheLineSize];
+
+    Cell* claimCellToWrite() noexcept
+    {
+        for (auto position = enqueuePosition.get();;)
+        {
+            auto& cell = cells[position & mask];
+            auto difference = (int32) (cell.sequence.get() - position);
+
+            if (difference == 0)
+            {
+                if (enqueuePosition.compareAndSetBool (position + 1, position))
+                    return &cell;
+            }
+            else if (difference < 0)
+            {
+                return nullptr;
+            }
+
+            position = enqueuePosition.get();
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (LockFreeQueue)
+};
+
+} // namespace juce
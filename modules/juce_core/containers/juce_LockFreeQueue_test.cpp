@@ -0,0 +1,429 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+struct LockFreeQueueTests  : public UnitTest
+{
+    LockFreeQueueTests() : UnitTest ("Lock-free queues", "Containers") {}
+
+    //==============================================================================
+    struct TestThread  : public Thread
+    {
+        TestThread (std::function<void()> f)  : Thread ("Queue test"), function (f) { startThread(); }
+        ~TestThread()  { stopThread (-1); }
+
+        void run() override   { function(); }
+
+        std::function<void()> function;
+    };
+
+    struct Message  : public LockFreeMessageQueueNode
+    {
+        int producer = 0, sequence = 0;
+    };
+
+    //==============================================================================
+    void runTest() override
+    {
+        testFifo();
+        testQueue();
+        testMessageQueue();
+        runBenchmarks();
+    }
+
+    void testFifo()
+    {
+        beginTest ("LockFreeFifo push, pop and spans");
+        {
+            LockFreeFifo<String> fifo (5);
+            expectEquals (fifo.getCapacity(), 8);
+
+            for (int i = 0; i < 8; ++i)
+                expect (fifo.push (String (i)));
+
+            expect (! fifo.push ("overflow"));
+            expectEquals (fifo.getNumReady(), 8);
+
+            String s;
+            for (int i = 0; i < 5; ++i)
+            {
+                expect (fifo.pop (s));
+                expectEquals (s, String (i));
+            }
+
+            auto span = fifo.prepareToWrite (10);
+            expectEquals (span.getTotalSize(), 5);
+
+            for (int i = 0; i < span.getTotalSize(); ++i)
+                span[i] = String (8 + i);
+
+            fifo.finishedWrite (span.getTotalSize());
+
+            // this read has to wrap around the end of the storage
+            auto ready = fifo.prepareToRead (100);
+            expectEquals (ready.getTotalSize(), 8);
+            expectEquals (ready.size1, 3);
+
+            for (int i = 0; i < ready.getTotalSize(); ++i)
+                expectEquals (ready[i], String (5 + i));
+
+            fifo.finishedRead (ready.getTotalSize());
+            expectEquals (fifo.getNumReady(), 0);
+            expect (! fifo.pop (s));
+        }
+
+        beginTest ("LockFreeFifo stress");
+        {
+            const int numItems = 2000000;
+            LockFreeFifo<int> fifo (1000);
+            bool inOrder = true;
+
+            {
+                TestThread writer ([&]
+                {
+                    Random r (1);
+                    int next = 0;
+
+                    while (next < numItems)
+                    {
+                        auto span = fifo.prepareToWrite (jmin (r.nextInt (300) + 1, numItems - next));
+
+                        for (int i = 0; i < span.getTotalSize(); ++i)
+                            span[i] = next++;
+
+                        fifo.finishedWrite (span.getTotalSize());
+
+                        if (span.getTotalSize() == 0)
+                            Thread::sleep (1);
+                    }
+                });
+
+                Random r (2);
+                HeapBlock<int> buffer (300);
+
+                for (int expected = 0; expected < numItems;)
+                {
+                    auto num = fifo.read (buffer, r.nextInt (300) + 1);
+
+                    for (int i = 0; i < num; ++i)
+                        inOrder = (buffer[i] == expected++) && inOrder;
+
+                    if (num == 0)
+                        Thread::sleep (1);
+                }
+            }
+
+            expect (inOrder);
+            expectEquals (fifo.getNumReady(), 0);
+        }
+    }
+
+    void testQueue()
+    {
+        beginTest ("LockFreeQueue push and pop");
+        {
+            LockFreeQueue<String> queue (4);
+
+            for (int i = 0; i < 4; ++i)
+                expect (queue.push (String (i)));
+
+            expect (! queue.push ("overflow"));
+
+            String s;
+            for (int i = 0; i < 4; ++i)
+            {
+                expect (queue.pop (s));
+                expectEquals (s, String (i));
+            }
+
+            expect (! queue.pop (s));
+        }
+
+        beginTest ("LockFreeQueue stress");
+        {
+            const int numProducers = 3, numConsumers = 3, itemsPerProducer = 200000;
+            const int numItems = numProducers * itemsPerProducer;
+
+            LockFreeQueue<int> queue (256);
+            HeapBlock<Atomic<int>> timesSeen ((size_t) numItems, true);
+            Atomic<int> numConsumed;
+
+            {
+                OwnedArray<TestThread> threads;
+
+                for (int p = 0; p < numProducers; ++p)
+                {
+                    threads.add (new TestThread ([&, p]
+                    {
+                        for (int i = 0; i < itemsPerProducer; ++i)
+                            while (! queue.push (p * itemsPerProducer + i))
+                                Thread::sleep (1);
+                    }));
+                }
+
+                for (int c = 0; c < numConsumers; ++c)
+                {
+                    threads.add (new TestThread ([&]
+                    {
+                        int item;
+
+                        while (numConsumed.get() < numItems)
+                        {
+                            if (queue.pop (item))
+                            {
+                                ++timesSeen[item];
+                                ++numConsumed;
+                            }
+                            else
+                            {
+                                Thread::sleep (1);
+                            }
+                        }
+                    }));
+                }
+            }
+
+            bool allSeenOnce = true;
+
+            for (int i = 0; i < numItems; ++i)
+                allSeenOnce = allSeenOnce && timesSeen[i].get() == 1;
+
+            expect (allSeenOnce);
+            expectEquals (queue.getNumReady(), 0);
+        }
+    }
+
+    void testMessageQueue()
+    {
+        beginTest ("LockFreeMessageQueue push and pop");
+        {
+            LockFreeMessageQueue<Message> queue;
+            Message messages[3];
+            expect (queue.isEmpty());
+            expect (queue.pop() == nullptr);
+
+            for (int round = 0; round < 2; ++round)
+            {
+                for (auto& m : messages)
+                    queue.push (&m);
+
+                expect (! queue.isEmpty());
+
+                for (auto& m : messages)
+                    expect (queue.pop() == &m);
+
+                expect (queue.pop() == nullptr);
+                expect (queue.isEmpty());
+            }
+        }
+
+        beginTest ("LockFreeMessageQueue stress");
+        {
+            const int numProducers = 3, messagesPerProducer = 200000;
+            HeapBlock<Message> messages ((size_t) (numProducers * messagesPerProducer));
+
+            for (int i = 0; i < numProducers * messagesPerProducer; ++i)
+                new (messages + i) Message();
+
+            LockFreeMessageQueue<Message> queue;
+            int lastSequence[numProducers] = { -1, -1, -1 };
+            bool inOrder = true;
+
+            {
+                OwnedArray<TestThread> producers;
+
+                for (int p = 0; p < numProducers; ++p)
+                {
+                    producers.add (new TestThread ([&, p]
+                    {
+                        for (int i = 0; i < messagesPerProducer; ++i)
+                        {
+                            auto& m = messages[p * messagesPerProducer + i];
+                            m.producer = p;
+                            m.sequence = i;
+                            queue.push (&m);
+                        }
+                    }));
+                }
+
+                for (int numReceived = 0; numReceived < numProducers * messagesPerProducer;)
+                {
+                    if (auto* m = queue.pop())
+                    {
+                        inOrder = inOrder && m->sequence == lastSequence[m->producer] + 1;
+                        lastSequence[m->producer] = m->sequence;
+                        ++numReceived;
+                    }
+                    else
+                    {
+                        Thread::sleep (1);
+                    }
+                }
+            }
+
+            expect (inOrder);
+            expect (queue.isEmpty());
+
+            for (int i = 0; i < numProducers * messagesPerProducer; ++i)
+                messages[i].~Message();
+        }
+    }
+
+    //==============================================================================
+    template <typename PushFunction, typename PopFunction>
+    double measureThroughput (int numProducers, int itemsPerProducer, PushFunction push, PopFunction pop)
+    {
+        const int numItems = numProducers * itemsPerProducer;
+        auto start = Time::getHighResolutionTicks();
+
+        {
+            OwnedArray<TestThread> producers;
+
+            for (int p = 0; p < numProducers; ++p)
+            {
+                producers.add (new TestThread ([&]
+                {
+                    for (int i = 0; i < itemsPerProducer; ++i)
+                        while (! push (i))
+                            Thread::sleep (1);
+                }));
+            }
+
+            for (int numReceived = 0; numReceived < numItems;)
+            {
+                auto num = pop();
+                numReceived += num;
+
+                if (num == 0)
+                    Thread::sleep (1);
+            }
+        }
+
+        return numItems / Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start);
+    }
+
+    void logThroughput (const String& label, double itemsPerSecond)
+    {
+        logMessage (label.paddedRight (' ', 40) + String (itemsPerSecond / 1.0e6, 2) + " M items/s");
+    }
+
+    void runBenchmarks()
+    {
+        beginTest ("Throughput");
+
+        // The containers are big enough to hold all the items, so this measures the cost
+        // of pushing and popping under contention rather than how often a full container
+        // makes the producers wait.
+        const int numItems = 1 << 21;
+
+        // a mutex-protected AbstractFifo is what these classes typically replace
+        {
+            AbstractFifo abstractFifo (numItems + 1);
+            HeapBlock<int> buffer ((size_t) numItems + 1);
+            CriticalSection lock;
+
+            logThroughput ("Locked AbstractFifo, 1 producer", measureThroughput (1, numItems,
+                [&] (int item)
+                {
+                    const ScopedLock sl (lock);
+                    int start1, size1, start2, size2;
+                    abstractFifo.prepareToWrite (1, start1, size1, start2, size2);
+
+                    if (size1 == 0)
+                        return false;
+
+                    buffer[start1] = item;
+                    abstractFifo.finishedWrite (1);
+                    return true;
+                },
+                [&]
+                {
+                    const ScopedLock sl (lock);
+                    int start1, size1, start2, size2;
+                    abstractFifo.prepareToRead (numItems, start1, size1, start2, size2);
+                    abstractFifo.finishedRead (size1 + size2);
+                    return size1 + size2;
+                }));
+        }
+
+        {
+            LockFreeFifo<int> fifo (numItems);
+
+            logThroughput ("LockFreeFifo, single items", measureThroughput (1, numItems,
+                [&] (int item) { return fifo.push (item); },
+                [&] { int item; return fifo.pop (item) ? 1 : 0; }));
+
+            logThroughput ("LockFreeFifo, spans", measureThroughput (1, numItems,
+                [&] (int item) { return fifo.push (item); },
+                [&]
+                {
+                    auto span = fifo.prepareToRead (numItems);
+                    fifo.finishedRead (span.getTotalSize());
+                    return span.getTotalSize();
+                }));
+        }
+
+        {
+            CriticalSection lock;
+            Array<int> lockedQueue;
+            LockFreeQueue<int> queue (numItems);
+
+            logThroughput ("Locked Array, 2 producers", measureThroughput (2, numItems / 2,
+                [&] (int item) { const ScopedLock sl (lock); lockedQueue.add (item); return true; },
+                [&]
+                {
+                    const ScopedLock sl (lock);
+                    auto num = lockedQueue.size();
+                    lockedQueue.clearQuick();
+                    return num;
+                }));
+
+            logThroughput ("LockFreeQueue, 2 producers", measureThroughput (2, numItems / 2,
+                [&] (int item) { return queue.push (item); },
+                [&] { int item; return queue.pop (item) ? 1 : 0; }));
+        }
+
+        {
+            HeapBlock<Message> messages ((size_t) numItems);
+
+            for (int i = 0; i < numItems; ++i)
+                new (messages + i) Message();
+
+            LockFreeMessageQueue<Message> queue;
+            Atomic<int> nextMessage;
+
+            logThroughput ("LockFreeMessageQueue, 2 producers", measureThroughput (2, numItems / 2,
+                [&] (int) { queue.push (messages + (++nextMessage - 1)); return true; },
+                [&] { return queue.pop() != nullptr ? 1 : 0; }));
+
+            for (int i = 0; i < numItems; ++i)
+                messages[i].~Message();
+        }
+    }
+};
+
+static LockFreeQueueTests lockFreeQueueTests;
+
+} // namespace juce
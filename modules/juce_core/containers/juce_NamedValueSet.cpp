@@ -23,6 +23,24 @@
 namespace juce
 {
 
+//==============================================================================
+/*  Maps the names of a large set onto their positions in the values array.
+    Identifiers are pooled, so the names can be hashed and compared by address.
+*/
+struct NamedValueSet::Index
+{
+    enum
+    {
+        minSizeToIndex = 32,        // below this, a linear search of the names is quicker
+        minSizeToKeepIndex = 16     // hysteresis, so that a set hovering around the limit isn't repeatedly re-indexed
+    };
+
+    static const void* getKey (const Identifier& name) noexcept     { return name.getCharPointer().getAddress(); }
+
+    FlatHashMap<const void*, int> positions;
+};
+
+//==============================================================================
 NamedValueSet::NamedValueSet() noexcept
 {
 }
@@ -30,23 +48,27 @@ NamedValueSet::NamedValueSet() noexcept
 NamedValueSet::NamedValueSet (const NamedValueSet& other)
    : values (other.values)
 {
+    updateIndex();
 }
 
 NamedValueSet& NamedValueSet::operator= (const NamedValueSet& other)
 {
     clear();
     values = other.values;
+    updateIndex();
     return *this;
 }
 
 NamedValueSet::NamedValueSet (NamedValueSet&& other) noexcept
-    : values (static_cast<Array<NamedValue>&&> (other.values))
+    : values (static_cast<Array<NamedValue>&&> (other.values)),
+      nameIndex (static_cast<ScopedPointer<Index>&&> (other.nameIndex))
 {
 }
 
 NamedValueSet& NamedValueSet::operator= (NamedValueSet&& other) noexcept
 {
     other.values.swapWith (values);
+    other.nameIndex.swapWith (nameIndex);
     return *this;
 }
 
@@ -57,6 +79,39 @@ NamedValueSet::~NamedValueSet() noexcept
 void NamedValueSet::clear()
 {
     values.clear();
+    nameIndex = nullptr;
+}
+
+void NamedValueSet::addValue (NamedValue&& newValue)
+{
+    auto key = Index::getKey (newValue.name);
+    values.add (static_cast<NamedValue&&> (newValue));
+
+    if (nameIndex != nullptr)
+        nameIndex->positions.set (key, values.size() - 1);
+    else if (values.size() >= Index::minSizeToIndex)
+        updateIndex();
+}
+
+void NamedValueSet::updateIndex()
+{
+    auto numValues = values.size();
+
+    if (numValues < Index::minSizeToKeepIndex
+         || (nameIndex == nullptr && numValues < Index::minSizeToIndex))
+    {
+        nameIndex = nullptr;
+        return;
+    }
+
+    if (nameIndex == nullptr)
+        nameIndex = new Index();
+
+    nameIndex->positions.clear();
+    nameIndex->positions.reserve (numValues);
+
+    for (int i = 0; i < numValues; ++i)
+        nameIndex->positions.set (Index::getKey (values.getReference (i).name), i);
 }
 
 bool NamedValueSet::operator== (const NamedValueSet& other) const
@@ -107,6 +162,14 @@ var NamedValueSet::getWithDefault (const Identifier& name, const var& defaultRet
 
 var* NamedValueSet::getVarPointer (const Identifier& name) const noexcept
 {
+    if (nameIndex != nullptr)
+    {
+        if (auto* position = nameIndex->positions.find (Index::getKey (name)))
+            return &(values.getReference (*position).value);
+
+        return nullptr;
+    }
+
     for (NamedValue* e = values.end(), *i = values.begin(); i != e; ++i)
         if (i->name == name)
             return &(i->value);
@@ -125,7 +188,7 @@ bool NamedValueSet::set (const Identifier& name, var&& newValue)
         return true;
     }
 
-    values.add (NamedValue (name, static_cast<var&&> (newValue)));
+    addValue (NamedValue (name, static_cast<var&&> (newValue)));
     return true;
 }
 
@@ -140,7 +203,7 @@ bool NamedValueSet::set (const Identifier& name, const var& newValue)
         return true;
     }
 
-    values.add (NamedValue (name, newValue));
+    addValue (NamedValue (name, newValue));
     return true;
 }
 
@@ -151,6 +214,12 @@ bool NamedValueSet::contains (const Identifier& name) const noexcept
 
 int NamedValueSet::indexOf (const Identifier& name) const noexcept
 {
+    if (nameIndex != nullptr)
+    {
+        auto* position = nameIndex->positions.find (Index::getKey (name));
+        return position != nullptr ? *position : -1;
+    }
+
     const int numValues = values.size();
 
     for (int i = 0; i < numValues; ++i)
@@ -162,18 +231,30 @@ int NamedValueSet::indexOf (const Identifier& name) const noexcept
 
 bool NamedValueSet::remove (const Identifier& name)
 {
-    const int numValues = values.size();
+    auto i = indexOf (name);
 
-    for (int i = 0; i < numValues; ++i)
+    if (i < 0)
+        return false;
+
+    values.remove (i);
+
+    if (nameIndex != nullptr)
     {
-        if (values.getReference(i).name == name)
+        if (values.size() < Index::minSizeToKeepIndex)
         {
-            values.remove (i);
-            return true;
+            nameIndex = nullptr;
+        }
+        else
+        {
+            nameIndex->positions.remove (Index::getKey (name));
+
+            for (auto& item : nameIndex->positions)
+                if (item.value > i)
+                    --item.value;
         }
     }
 
-    return false;
+    return true;
 }
 
 Identifier NamedValueSet::getName (const int index) const noexcept
@@ -205,6 +286,7 @@ var* NamedValueSet::getVarPointerAt (int index) const noexcept
 void NamedValueSet::setFromXmlAttributes (const XmlElement& xml)
 {
     values.clearQuick();
+    nameIndex = nullptr;
 
     for (const XmlElement::XmlAttributeNode* att = xml.attributes; att != nullptr; att = att->nextListItem)
     {
@@ -221,6 +303,8 @@ void NamedValueSet::setFromXmlAttributes (const XmlElement& xml)
 
         values.add (NamedValue (att->name, var (att->value)));
     }
+
+    updateIndex();
 }
 
 void NamedValueSet::copyToXmlAttributes (XmlElement& xml) const
@@ -244,4 +328,151 @@ void NamedValueSet::copyToXmlAttributes (XmlElement& xml) const
     }
 }
 
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class NamedValueSetTests  : public UnitTest
+{
+public:
+    NamedValueSetTests() : UnitTest ("NamedValueSet", "Containers") {}
+
+    static Identifier getName (int i)     { return "property" + String (i); }
+
+    void expectConsistent (const NamedValueSet& set, const Array<int>& expectedOrder)
+    {
+        expectEquals (set.size(), expectedOrder.size());
+
+        for (int i = 0; i < expectedOrder.size(); ++i)
+        {
+            auto itemName = getName (expectedOrder[i]);
+
+            expect (set.getName (i) == itemName);
+            expectEquals (set.indexOf (itemName), i);
+            expectEquals ((int) set[itemName], expectedOrder[i]);
+        }
+
+        expect (! set.contains ("missing"));
+        expectEquals (set.indexOf ("missing"), -1);
+    }
+
+    void runTest() override
+    {
+        beginTest ("Insertion order");
+        {
+            NamedValueSet set;
+            Array<int> order;
+
+            for (int i = 0; i < 200; ++i)
+            {
+                expect (set.set (getName (i), i));
+                order.add (i);
+
+                if (i % 10 == 0)
+                    expectConsistent (set, order);
+            }
+
+            expect (! set.set (getName (10), 10));
+            expect (set.set (getName (10), 10.0));
+            expect (set.set (getName (10), 10));
+            expectConsistent (set, order);
+
+            NamedValueSet copy (set);
+            expectConsistent (copy, order);
+            expect (copy == set);
+
+            NamedValueSet moved (static_cast<NamedValueSet&&> (copy));
+            expectConsistent (moved, order);
+
+            NamedValueSet assigned;
+            assigned.set ("missing", 1);
+            assigned = set;
+            expectConsistent (assigned, order);
+        }
+
+        beginTest ("Removal");
+        {
+            NamedValueSet set;
+            Array<int> order;
+
+            for (int i = 0; i < 100; ++i)
+            {
+                set.set (getName (i), i);
+                order.add (i);
+            }
+
+            Random r (1234);
+            bool hasAddedAgain = false;
+
+            while (order.size() > 0)
+            {
+                auto i = r.nextInt (order.size());
+                expect (set.remove (getName (order[i])));
+                expect (! set.remove (getName (order[i])));
+                order.remove (i);
+
+                expectConsistent (set, order);
+
+                if (order.size() == 20 && ! hasAddedAgain)
+                {
+                    hasAddedAgain = true;
+                    set.set (getName (1000), 1000);
+                    order.add (1000);
+                    expectConsistent (set, order);
+                }
+            }
+        }
+
+        beginTest ("JSON parse and lookup benchmark");
+        {
+            for (auto numProperties : { 8, 64, 512 })
+            {
+                Array<Identifier> names;
+                MemoryOutputStream json;
+                json << "[";
+
+                for (int i = 0; i < numProperties; ++i)
+                    names.add (getName (i));
+
+                const int numObjects = 8192 / numProperties;
+
+                for (int i = 0; i < numObjects; ++i)
+                {
+                    json << (i > 0 ? ", {" : "{");
+
+                    for (int j = 0; j < numProperties; ++j)
+                        json << (j > 0 ? ", \"" : "\"") << names.getReference (j).toString() << "\": " << j;
+
+                    json << "}";
+                }
+
+                json << "]";
+
+                auto start = Time::getMillisecondCounterHiRes();
+                auto parsed = JSON::parse (json.toString());
+                auto parseTime = Time::getMillisecondCounterHiRes() - start;
+
+                start = Time::getMillisecondCounterHiRes();
+                int64 total = 0;
+
+                for (int repeat = 0; repeat < 10; ++repeat)
+                    for (auto& object : *parsed.getArray())
+                        for (auto& propertyName : names)
+                            total += (int) object[propertyName];
+
+                auto lookupTime = Time::getMillisecondCounterHiRes() - start;
+
+                expectEquals (total, (int64) 10 * numObjects * (numProperties * (numProperties - 1) / 2));
+
+                logMessage (String (numObjects) + " objects with " + String (numProperties) + " properties: parse "
+                              + String (parseTime, 2) + " ms, " + String (10 * numObjects * numProperties)
+                              + " lookups " + String (lookupTime, 2) + " ms");
+            }
+        }
+    }
+};
+
+static NamedValueSetTests namedValueSetTests;
+
+#endif
+
 } // namespace juce
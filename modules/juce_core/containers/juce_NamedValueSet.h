@@ -28,6 +28,12 @@ namespace juce
 
     This can be used as a basic structure to hold a set of var object, which can
     be retrieved by using their identifier.
+
+    The values are kept in the order in which they were added. Small sets are searched
+    linearly, but once a set grows beyond a few dozen values, it also builds a hash
+    table of the names, so that looking up a property of a large object doesn't get
+    slower as it grows. (If you use begin() to iterate the values, don't change their
+    names, or the table will get out of step).
 */
 class JUCE_API  NamedValueSet
 {
@@ -169,7 +175,13 @@ public:
 
 private:
     //==============================================================================
+    struct Index;
+
     Array<NamedValue> values;
+    ScopedPointer<Index> nameIndex;
+
+    void addValue (NamedValue&&);
+    void updateIndex();
 };
 
 } // namespace juce
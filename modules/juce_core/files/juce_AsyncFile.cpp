@@ -0,0 +1,224 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+struct AsyncFile::Request::State  : public ReferenceCountedObject
+{
+    TaskScheduler::TaskHandle task;
+    Result result { Result::ok() };
+    size_t numBytesTransferred = 0;
+    Atomic<int> finished;
+};
+
+AsyncFile::Request::Request() noexcept {}
+AsyncFile::Request::Request (const Request& other) noexcept : state (other.state) {}
+AsyncFile::Request::~Request() {}
+
+AsyncFile::Request& AsyncFile::Request::operator= (const Request& other) noexcept
+{
+    state = other.state;
+    return *this;
+}
+
+bool AsyncFile::Request::isValid() const noexcept
+{
+    return state != nullptr;
+}
+
+bool AsyncFile::Request::isFinished() const noexcept
+{
+    return state != nullptr && state->finished.get() != 0;
+}
+
+bool AsyncFile::Request::wait (int timeOutMilliseconds) const
+{
+    jassert (isValid());
+
+    if (isFinished())
+        return true;
+
+    return state->task.wait (timeOutMilliseconds) || isFinished();
+}
+
+Result AsyncFile::Request::getResult() const
+{
+    jassert (isFinished());
+    return state != nullptr ? state->result : Result::fail ("Invalid request");
+}
+
+size_t AsyncFile::Request::getNumBytesTransferred() const noexcept
+{
+    jassert (isFinished());
+    return state != nullptr ? state->numBytesTransferred : 0;
+}
+
+//==============================================================================
+AsyncFile::AsyncFile (const File& f, AccessMode mode, TaskScheduler& s)
+    : file (f), scheduler (s), status (Result::ok())
+{
+    openHandle (mode);
+}
+
+AsyncFile::~AsyncFile()
+{
+    waitForAllRequests();
+    closeHandle();
+}
+
+AsyncFile::Request AsyncFile::read (int64 filePosition, void* destBuffer, size_t numBytes, Callback callback)
+{
+    return submit ({ { Operation::readOperation, filePosition, destBuffer, numBytes, callback } }).getFirst();
+}
+
+AsyncFile::Request AsyncFile::write (int64 filePosition, const void* sourceData, size_t numBytes, Callback callback)
+{
+    return submit ({ { Operation::writeOperation, filePosition, const_cast<void*> (sourceData), numBytes, callback } }).getFirst();
+}
+
+Array<AsyncFile::Request> AsyncFile::submit (const Array<Operation>& operations)
+{
+    // You should always check that a file opened successfully before using it!
+    jassert (openedOk());
+
+    Array<Request> requests;
+    Array<ReferenceCountedObjectPtr<Request::State>> states;
+
+    for (int i = 0; i < operations.size(); ++i)
+    {
+        Request r;
+        r.state = new Request::State();
+        requests.add (r);
+        states.add (r.state);
+    }
+
+    if (operations.isEmpty())
+        return requests;
+
+    numPendingRequests += operations.size();
+
+    auto task = scheduler.addTask ([this, operations, states]
+    {
+        for (int i = 0; i < operations.size(); ++i)
+            perform (operations.getReference (i), *states.getUnchecked (i));
+    });
+
+    for (auto& r : requests)
+        r.state->task = task;
+
+    addPendingTask (task);
+    return requests;
+}
+
+void AsyncFile::perform (const Operation& op, Request::State& state)
+{
+    jassert (op.buffer != nullptr || op.numBytes == 0);
+
+    if (fileHandle == nullptr)
+        state.result = status;
+    else if (op.type == Operation::readOperation)
+        state.result = readAt (op.filePosition, op.buffer, op.numBytes, state.numBytesTransferred);
+    else
+        state.result = writeAt (op.filePosition, op.buffer, op.numBytes, state.numBytesTransferred);
+
+    if (op.callback != nullptr)
+        op.callback (state.result, state.numBytesTransferred);
+
+    state.finished = 1;
+    --numPendingRequests;
+}
+
+AsyncFile::Request AsyncFile::flush (Callback callback)
+{
+    Request r;
+    r.state = new Request::State();
+    ReferenceCountedObjectPtr<Request::State> state (r.state);
+
+    ++numPendingRequests;
+
+    r.state->task = scheduler.addTask ([this, state, callback]
+    {
+        state->result = fileHandle != nullptr ? flushInternal() : status;
+
+        if (callback != nullptr)
+            callback (state->result, 0);
+
+        state->finished = 1;
+        --numPendingRequests;
+    }, getPendingTasks());
+
+    addPendingTask (r.state->task);
+    return r;
+}
+
+bool AsyncFile::waitForAllRequests (int timeOutMilliseconds)
+{
+    auto endTime = Time::getMillisecondCounter() + (uint32) timeOutMilliseconds;
+
+    for (auto& task : getPendingTasks())
+    {
+        auto timeLeft = -1;
+
+        if (timeOutMilliseconds >= 0)
+        {
+            timeLeft = (int) (endTime - Time::getMillisecondCounter());
+
+            if (timeLeft <= 0 && ! task.isFinished())
+                return false;
+        }
+
+        if (! task.wait (jmax (-1, timeLeft)))
+            return false;
+    }
+
+    return true;
+}
+
+int AsyncFile::getNumPendingRequests() const noexcept
+{
+    return numPendingRequests.get();
+}
+
+int64 AsyncFile::getSize() const
+{
+    return file.getSize();
+}
+
+void AsyncFile::addPendingTask (const TaskScheduler::TaskHandle& task)
+{
+    const ScopedLock sl (pendingLock);
+
+    for (int i = pendingTasks.size(); --i >= 0;)
+        if (pendingTasks.getReference (i).isFinished())
+            pendingTasks.remove (i);
+
+    pendingTasks.add (task);
+}
+
+Array<TaskScheduler::TaskHandle> AsyncFile::getPendingTasks()
+{
+    const ScopedLock sl (pendingLock);
+    return pendingTasks;
+}
+
+} // namespace juce
@@ -0,0 +1,221 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A file which can be read and written asynchronously.
+
+    Reads and writes are given an explicit position in the file, and are carried out
+    by the threads of a TaskScheduler, so the thread that submits them can carry on
+    with other work and check on them later, or be called back when they're done:
+    @code
+    TaskScheduler ioThreads (2);
+    AsyncFile file (someFile, AsyncFile::readOnly, ioThreads);
+
+    HeapBlock<char> buffer (65536);
+    auto request = file.read (0, buffer, 65536);
+
+    doSomethingElse();
+
+    if (request.wait() && request.getResult().wasOk())
+        useData (buffer, request.getNumBytesTransferred());
+    @endcode
+
+    A batch of operations can be submitted with a single call to submit(), which runs
+    them one after the other, in order, on one thread. That's cheaper than submitting
+    them separately, and means that writes within a batch happen in the order given.
+    Separately submitted requests may run in any order, or at the same time.
+
+    The threads spend most of their time blocked in the OS's read and write calls, so
+    it's best to give an AsyncFile a scheduler which is used for I/O, rather than one
+    that's busy with computational work.
+
+    @see ReadAheadFileInputStream, TaskScheduler
+*/
+class JUCE_API  AsyncFile
+{
+public:
+    //==============================================================================
+    /** The ways in which a file can be opened. */
+    enum AccessMode
+    {
+        readOnly,   /**< The file must exist, and can only be read. */
+        readWrite   /**< The file can be read and written, and will be created if it doesn't exist. */
+    };
+
+    /** Opens a file.
+
+        After creating an AsyncFile, you should use openedOk() to make sure that it's OK
+        before submitting any requests. The scheduler must not be deleted before this object.
+    */
+    AsyncFile (const File& file, AccessMode mode, TaskScheduler& scheduler);
+
+    /** Destructor.
+        This waits for any requests which are still pending to finish before closing the file.
+    */
+    ~AsyncFile();
+
+    //==============================================================================
+    /** Returns the file that was opened. */
+    const File& getFile() const noexcept                { return file; }
+
+    /** Returns the result of opening the file. */
+    const Result& getStatus() const noexcept            { return status; }
+
+    /** Returns true if the file was opened without problems. */
+    bool openedOk() const noexcept                      { return status.wasOk(); }
+
+    //==============================================================================
+    /** A handle to a read or write which has been submitted.
+        Copies of a Request refer to the same operation.
+    */
+    class JUCE_API  Request
+    {
+    public:
+        /** Creates an invalid request. */
+        Request() noexcept;
+        /** Creates a copy of another request, which refers to the same operation. */
+        Request (const Request&) noexcept;
+        /** Makes this refer to the same operation as another request. */
+        Request& operator= (const Request&) noexcept;
+        /** Destructor. */
+        ~Request();
+
+        /** Returns true if this refers to an operation. */
+        bool isValid() const noexcept;
+
+        /** Returns true if the operation has finished. */
+        bool isFinished() const noexcept;
+
+        /** Waits until the operation has finished.
+
+            For an operation that was submitted as part of a batch, this may wait until the
+            whole batch has finished.
+
+            @param timeOutMilliseconds  the maximum time to wait, or -1 to wait forever
+            @returns true if the operation has finished, false if the timeout expired
+        */
+        bool wait (int timeOutMilliseconds = -1) const;
+
+        /** Returns the result of the operation.
+            This is only meaningful once the operation has finished.
+        */
+        Result getResult() const;
+
+        /** Returns the number of bytes that were read or written.
+            For a read, this may be less than the number requested if the end of the file
+            was reached. This is only meaningful once the operation has finished.
+        */
+        size_t getNumBytesTransferred() const noexcept;
+
+    private:
+        friend class AsyncFile;
+        struct State;
+        ReferenceCountedObjectPtr<State> state;
+    };
+
+    /** A function which is called on one of the scheduler's threads when an operation has
+        finished, with its result and the number of bytes that were read or written.
+    */
+    using Callback = std::function<void (const Result& result, size_t numBytesTransferred)>;
+
+    //==============================================================================
+    /** Starts reading a block of data from the file.
+
+        The buffer must stay valid until the request has finished. If a callback is given,
+        it'll be called when the read has finished.
+    */
+    Request read (int64 filePosition, void* destBuffer, size_t numBytes, Callback callback = nullptr);
+
+    /** Starts writing a block of data to the file.
+
+        The data must stay valid until the request has finished. If a callback is given,
+        it'll be called when the write has finished.
+    */
+    Request write (int64 filePosition, const void* sourceData, size_t numBytes, Callback callback = nullptr);
+
+    /** Describes one of the operations in a batch.
+        @see submit
+    */
+    struct Operation
+    {
+        enum Type { readOperation, writeOperation };
+
+        Type type;
+        int64 filePosition;
+        void* buffer;
+        size_t numBytes;
+        Callback callback;
+    };
+
+    /** Submits a batch of operations, which will be carried out one after the other.
+
+        If an operation fails, the rest of the batch still runs. The returned array contains
+        a Request for each operation, in the same order.
+    */
+    Array<Request> submit (const Array<Operation>& operations);
+
+    //==============================================================================
+    /** Starts flushing any data that has been written to the disk.
+        This will only run once all the requests submitted before it have finished.
+    */
+    Request flush (Callback callback = nullptr);
+
+    /** Waits until all the requests that have been submitted have finished.
+        @returns true if they've finished, false if the timeout expired
+    */
+    bool waitForAllRequests (int timeOutMilliseconds = -1);
+
+    /** Returns the number of requests which haven't finished yet. */
+    int getNumPendingRequests() const noexcept;
+
+    /** Returns the current size of the file. */
+    int64 getSize() const;
+
+private:
+    //==============================================================================
+    const File file;
+    TaskScheduler& scheduler;
+    void* fileHandle = nullptr;
+    Result status;
+
+    CriticalSection pendingLock;
+    Array<TaskScheduler::TaskHandle> pendingTasks;
+    Atomic<int> numPendingRequests;
+
+    void addPendingTask (const TaskScheduler::TaskHandle&);
+    Array<TaskScheduler::TaskHandle> getPendingTasks();
+    void perform (const Operation&, Request::State&);
+
+    void openHandle (AccessMode);
+    void closeHandle();
+    Result readAt (int64 position, void* buffer, size_t numBytes, size_t& numRead);
+    Result writeAt (int64 position, const void* data, size_t numBytes, size_t& numWritten);
+    Result flushInternal();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AsyncFile)
+};
+
+} // namespace juce
@@ -0,0 +1,315 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+struct DirectoryScanner::ScanState
+{
+    ScanState (TaskScheduler& s, const Callback& c) : scheduler (s), callback (c) {}
+
+    TaskScheduler& scheduler;
+    const Callback& callback;
+    Atomic<int> numPendingDirectories, shouldStop;
+    WaitableEvent finished;
+};
+
+//==============================================================================
+DirectoryScanner::DirectoryScanner (const File& dir, bool recursive, const String& pattern, int type)
+    : directory (dir), whatToLookFor (type), isRecursive (recursive)
+{
+    // you have to specify the type of files you're looking for!
+    jassert ((type & (File::findFiles | File::findDirectories)) != 0);
+    jassert (type > 0 && type <= 7);
+
+    wildCards.addTokens (pattern, ";,", "\"'");
+    wildCards.trim();
+    wildCards.removeEmptyStrings();
+}
+
+DirectoryScanner::~DirectoryScanner()
+{
+}
+
+bool DirectoryScanner::scan (TaskScheduler& scheduler, const Callback& callback)
+{
+    // The calling thread just blocks until the scan has finished, so this shouldn't be
+    // called from one of the scheduler's own threads.
+    jassert (callback != nullptr);
+
+    ScanState state (scheduler, callback);
+    state.numPendingDirectories = 1;
+    scheduler.addTask ([this, &state] { scanDirectory (state, directory); });
+    state.finished.wait();
+
+    return state.shouldStop.get() == 0;
+}
+
+Array<DirectoryScanner::Entry> DirectoryScanner::findAll (TaskScheduler& scheduler)
+{
+    Array<Entry> results;
+    CriticalSection lock;
+
+    scan (scheduler, [&] (const Array<Entry>& entries)
+    {
+        const ScopedLock sl (lock);
+        results.addArray (entries);
+        return true;
+    });
+
+    return results;
+}
+
+void DirectoryScanner::scanDirectory (ScanState& state, const File& dir)
+{
+    Array<Entry> entries;
+
+    if (state.shouldStop.get() == 0 && readDirectory (dir, fetchSizesAndTimes, entries))
+    {
+        const bool ignoreHidden = (whatToLookFor & File::ignoreHiddenFiles) != 0;
+
+        // start on the subdirectories before handing over the results, so that the other
+        // threads can get going on them while the callback runs
+        if (isRecursive)
+        {
+            for (auto& e : entries)
+            {
+                if (e.isDirectory && ! (ignoreHidden && e.isHidden) && (followSymbolicLinks || ! e.isSymbolicLink))
+                {
+                    ++state.numPendingDirectories;
+                    auto subDirectory = e.file;
+                    state.scheduler.addTask ([this, &state, subDirectory] { scanDirectory (state, subDirectory); });
+                }
+            }
+        }
+
+        for (int i = entries.size(); --i >= 0;)
+            if (! matches (entries.getReference (i)))
+                entries.remove (i);
+
+        if (entries.size() > 0 && state.shouldStop.get() == 0 && ! state.callback (entries))
+            state.shouldStop = 1;
+    }
+
+    if (--state.numPendingDirectories == 0)
+        state.finished.signal();
+}
+
+bool DirectoryScanner::matches (const Entry& e) const
+{
+    if ((whatToLookFor & (e.isDirectory ? File::findDirectories : File::findFiles)) == 0)
+        return false;
+
+    if (e.isHidden && (whatToLookFor & File::ignoreHiddenFiles) != 0)
+        return false;
+
+    auto filename = e.file.getFileName();
+
+    for (auto& w : wildCards)
+        if (filename.matchesWildcard (w, ! File::areFileNamesCaseSensitive()))
+            return true;
+
+    return false;
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct DirectoryScannerTests  : public UnitTest
+{
+    DirectoryScannerTests()  : UnitTest ("DirectoryScanner", "Files") {}
+
+    static StringArray getSortedPaths (const Array<DirectoryScanner::Entry>& entries, const File& root)
+    {
+        StringArray paths;
+
+        for (auto& e : entries)
+            paths.add (e.file.getRelativePathFrom (root));
+
+        paths.sort (false);
+        return paths;
+    }
+
+    static StringArray getSortedPaths (DirectoryIterator& iter, const File& root)
+    {
+        StringArray paths;
+
+        while (iter.next())
+            paths.add (iter.getFile().getRelativePathFrom (root));
+
+        paths.sort (false);
+        return paths;
+    }
+
+    // Creates a tree of folders containing files of a few different types
+    static void createTree (const File& folder, Random& r, int depth, int& numFiles)
+    {
+        folder.createDirectory();
+
+        for (int i = r.nextInt (6) + 1; --i >= 0;)
+        {
+            static const char* const extensions[] = { ".wav", ".aif", ".txt" };
+            auto name = (r.nextInt (5) == 0 ? "." : "") + String (i) + extensions[r.nextInt (3)];
+            folder.getChildFile (name).replaceWithText (String::repeatedString ("x", r.nextInt (100)));
+            ++numFiles;
+        }
+
+        if (depth > 0)
+            for (int i = r.nextInt (4) + 1; --i >= 0;)
+                createTree (folder.getChildFile ((r.nextInt (5) == 0 ? ".dir" : "dir") + String (i)), r, depth - 1, numFiles);
+    }
+
+    void runTest() override
+    {
+        auto r = getRandom();
+        auto root = File::getSpecialLocation (File::tempDirectory).getNonexistentChildFile ("juce_DirectoryScannerTests", {}, false);
+        int numFiles = 0;
+        createTree (root, r, 4, numFiles);
+
+        TaskScheduler scheduler (3);
+
+        beginTest ("Matches DirectoryIterator");
+        {
+            for (auto type : { (int) File::findFiles, (int) File::findDirectories, (int) File::findFilesAndDirectories,
+                               File::findFiles | File::ignoreHiddenFiles, File::findFilesAndDirectories | File::ignoreHiddenFiles })
+            {
+                for (auto* pattern : { "*", "*.wav", "*.WAV;*.aif", "1*" })
+                {
+                    for (auto recursive : { false, true })
+                    {
+                        DirectoryIterator iter (root, recursive, pattern, type);
+                        DirectoryScanner scanner (root, recursive, pattern, type);
+
+                        // (DirectoryIterator follows links into directories)
+                        scanner.setFollowSymbolicLinks (true);
+
+                        expect (getSortedPaths (scanner.findAll (scheduler), root) == getSortedPaths (iter, root));
+                    }
+                }
+            }
+        }
+
+        beginTest ("File details");
+        {
+            DirectoryScanner scanner (root, true, "*", File::findFilesAndDirectories);
+            auto entries = scanner.findAll (scheduler);
+            int numFound = 0;
+
+            for (auto& e : entries)
+            {
+                expect (e.isDirectory == e.file.isDirectory());
+                expect (e.isHidden == e.file.isHidden());
+
+                if (! e.isDirectory)
+                {
+                    expectEquals (e.size, e.file.getSize());
+                    expect (e.modificationTime == e.file.getLastModificationTime());
+                    ++numFound;
+                }
+            }
+
+            expectEquals (numFound, numFiles);
+
+            DirectoryScanner fastScanner (root, true, "*", File::findFilesAndDirectories);
+            fastScanner.setFetchSizesAndTimes (false);
+            expectEquals (fastScanner.findAll (scheduler).size(), entries.size());
+        }
+
+        beginTest ("Stopping a scan");
+        {
+            DirectoryScanner scanner (root, true, "*", File::findFilesAndDirectories);
+            Atomic<int> numCalls;
+
+            expect (! scanner.scan (scheduler, [&] (const Array<DirectoryScanner::Entry>&) { ++numCalls; return false; }));
+            expect (numCalls.get() >= 1);
+
+            DirectoryScanner missing (root.getChildFile ("nonexistent"), true);
+            expect (missing.findAll (scheduler).isEmpty());
+        }
+
+       #if JUCE_LINUX || JUCE_MAC
+        beginTest ("Symbolic links");
+        {
+            auto linkedFolder = root.getChildFile ("dir0");
+            auto link = root.getChildFile ("link");
+
+            if (linkedFolder.isDirectory() && linkedFolder.createSymbolicLink (link, true))
+            {
+                DirectoryScanner scanner (root, true, "*", File::findFilesAndDirectories);
+                auto withoutLinks = scanner.findAll (scheduler);
+
+                scanner.setFollowSymbolicLinks (true);
+                auto withLinks = scanner.findAll (scheduler);
+
+                auto numInLinkedFolder = DirectoryScanner (linkedFolder, true, "*", File::findFilesAndDirectories)
+                                            .findAll (scheduler).size();
+
+                expectEquals (withLinks.size(), withoutLinks.size() + numInLinkedFolder);
+
+                for (auto& e : withoutLinks)
+                    if (e.file == link)
+                        expect (e.isSymbolicLink && e.isDirectory);
+            }
+        }
+       #endif
+
+        beginTest ("Benchmark");
+        {
+            auto bigTree = root.getChildFile ("big");
+            int numBigFiles = 0;
+
+            for (int i = 0; i < 40; ++i)
+                createTree (bigTree.getChildFile (String (i)), r, 2, numBigFiles);
+
+            auto start = Time::getMillisecondCounterHiRes();
+            int numIterated = 0;
+
+            for (DirectoryIterator iter (bigTree, true, "*"); iter.next (nullptr, nullptr, nullptr, nullptr, nullptr, nullptr);)
+            {
+                iter.getFile().getSize();
+                iter.getFile().getLastModificationTime();
+                ++numIterated;
+            }
+
+            auto iteratorTime = Time::getMillisecondCounterHiRes() - start;
+
+            start = Time::getMillisecondCounterHiRes();
+            auto numScanned = DirectoryScanner (bigTree, true, "*").findAll (scheduler).size();
+            auto scannerTime = Time::getMillisecondCounterHiRes() - start;
+
+            expectEquals (numScanned, numIterated);
+
+            logMessage (String (numIterated) + " files: DirectoryIterator + File queries " + String (iteratorTime, 1)
+                          + " ms, DirectoryScanner on " + String (scheduler.getNumThreads()) + " threads "
+                          + String (scannerTime, 1) + " ms");
+        }
+
+        root.deleteRecursively();
+    }
+};
+
+static DirectoryScannerTests directoryScannerTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,147 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Searches a directory tree using several threads at once.
+
+    Each directory is read by a task on a TaskScheduler, and the subdirectories that it
+    finds are added as new tasks, so a large tree is searched by all the scheduler's
+    threads in parallel. This makes a big difference when each directory read has to
+    wait for a slow disk or a network drive.
+
+    The results come with each file's type, size and modification time, so there's no
+    need to query the File objects afterwards, which would mean another round-trip to
+    the filesystem per file. Where the OS can supply these while listing the directory
+    (e.g. the file type on Linux and macOS, or all of them on Windows), no extra calls
+    are needed, and otherwise they're fetched relative to the open directory rather than
+    by looking up each file's full path.
+
+    The results are delivered in batches, one per directory, as soon as it has been read:
+    @code
+    TaskScheduler scheduler;
+    DirectoryScanner scanner (File ("/samples"), true, "*.wav");
+
+    scanner.scan (scheduler, [&] (const Array<DirectoryScanner::Entry>& entries)
+    {
+        const ScopedLock sl (lock);   // (this is called by several threads at once)
+
+        for (auto& e : entries)
+            addSampleToLibrary (e.file, e.size);
+
+        return true;
+    });
+    @endcode
+
+    As with DirectoryIterator, the order in which the files are found is undefined.
+
+    @see DirectoryIterator, File::findChildFiles
+*/
+class JUCE_API  DirectoryScanner
+{
+public:
+    //==============================================================================
+    /** Creates a DirectoryScanner for a given directory.
+
+        @param directory        the directory to search in
+        @param isRecursive      whether all the subdirectories should also be searched
+        @param wildCard         the file pattern to match. This may contain multiple patterns
+                                separated by a semi-colon or comma, e.g. "*.jpg;*.png"
+        @param whatToLookFor    a value from the File::TypesOfFileToFind enum, specifying
+                                whether to look for files, directories, or both.
+    */
+    DirectoryScanner (const File& directory,
+                      bool isRecursive,
+                      const String& wildCard = "*",
+                      int whatToLookFor = File::findFiles);
+
+    /** Destructor. */
+    ~DirectoryScanner();
+
+    //==============================================================================
+    /** Describes a file that has been found. */
+    struct Entry
+    {
+        File file;
+        int64 size = 0;
+        Time modificationTime;
+        bool isDirectory = false;
+        bool isHidden = false;
+        bool isSymbolicLink = false;
+    };
+
+    /** Called with a batch of entries that have been found.
+
+        This will be called on the scheduler's threads, possibly by several of them at the
+        same time, so it must be thread-safe. Return false to stop the scan.
+    */
+    using Callback = std::function<bool (const Array<Entry>& entries)>;
+
+    //==============================================================================
+    /** Sets whether symbolic links to directories are searched when scanning recursively.
+        This is off by default, because a link to one of its own parents would make a
+        tree infinitely deep.
+    */
+    void setFollowSymbolicLinks (bool shouldFollow) noexcept        { followSymbolicLinks = shouldFollow; }
+
+    /** Sets whether the sizes and modification times of the files are needed.
+        If not, the scan can avoid querying each file on systems where listing a directory
+        only returns the names and types of its files. This is on by default.
+    */
+    void setFetchSizesAndTimes (bool shouldFetch) noexcept          { fetchSizesAndTimes = shouldFetch; }
+
+    //==============================================================================
+    /** Searches the directory, passing the results to a callback, and returns when
+        the search has finished.
+
+        The calling thread waits while the scheduler's threads do the work, so this
+        mustn't be called from one of the scheduler's own threads.
+
+        @returns false if the callback stopped the search, true otherwise
+    */
+    bool scan (TaskScheduler& scheduler, const Callback& callback);
+
+    /** Searches the directory and returns all the results. */
+    Array<Entry> findAll (TaskScheduler& scheduler);
+
+private:
+    //==============================================================================
+    struct ScanState;
+
+    const File directory;
+    StringArray wildCards;
+    const int whatToLookFor;
+    const bool isRecursive;
+    bool followSymbolicLinks = false, fetchSizesAndTimes = true;
+
+    void scanDirectory (ScanState&, const File&);
+    bool matches (const Entry&) const;
+
+    static bool readDirectory (const File&, bool fetchSizesAndTimes, Array<Entry>&);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DirectoryScanner)
+};
+
+} // namespace juce
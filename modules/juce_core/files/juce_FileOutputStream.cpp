@@ -115,6 +115,39 @@ bool FileOutputStream::write (const void* const src, const size_t numBytes)
     return true;
 }
 
+bool FileOutputStream::writeGathered (const Array<DataToWrite>& blocks)
+{
+    size_t totalBytes = 0;
+
+    for (auto& b : blocks)
+        totalBytes += b.numBytes;
+
+    // small amounts of data are just copied into the buffer as usual..
+    if (bytesInBuffer + totalBytes < bufferSize)
+        return OutputStream::writeGathered (blocks);
+
+    // ..otherwise, whatever's in the buffer gets written out along with the new blocks
+    Array<DataToWrite> allBlocks;
+    allBlocks.ensureStorageAllocated (blocks.size() + 1);
+
+    if (bytesInBuffer > 0)
+        allBlocks.add ({ buffer.get(), bytesInBuffer });
+
+    allBlocks.addArray (blocks);
+
+    auto numBytesExpected = (ssize_t) (bytesInBuffer + totalBytes);
+    currentPosition -= (int64) bytesInBuffer;
+    bytesInBuffer = 0;
+
+    auto bytesWritten = writeGatheredInternal (allBlocks);
+
+    if (bytesWritten < 0)
+        return false;
+
+    currentPosition += (int64) bytesWritten;
+    return bytesWritten == numBytesExpected;
+}
+
 bool FileOutputStream::writeRepeatedByte (uint8 byte, size_t numBytes)
 {
     jassert (((ssize_t) numBytes) >= 0);
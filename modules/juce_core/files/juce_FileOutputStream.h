@@ -88,6 +88,7 @@ public:
     int64 getPosition() override;
     bool setPosition (int64) override;
     bool write (const void*, size_t) override;
+    bool writeGathered (const Array<DataToWrite>&) override;
     bool writeRepeatedByte (uint8 byte, size_t numTimesToRepeat) override;
 
 
@@ -106,6 +107,7 @@ private:
     bool flushBuffer();
     int64 setPositionInternal (int64);
     ssize_t writeInternal (const void*, size_t);
+    ssize_t writeGatheredInternal (const Array<DataToWrite>&);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FileOutputStream)
 };
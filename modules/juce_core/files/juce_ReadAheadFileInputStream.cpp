@@ -0,0 +1,317 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+ReadAheadFileInputStream::ReadAheadFileInputStream (const File& f, TaskScheduler& scheduler,
+                                                    int size, int numBlocksToReadAhead)
+    : file (f, AsyncFile::readOnly, scheduler),
+      blockSize (jmax (16, size)),
+      status (file.getStatus())
+{
+    jassert (size > 0 && numBlocksToReadAhead > 0);
+
+    if (openedOk())
+    {
+        totalLength = file.getSize();
+
+        for (int i = jmax (2, numBlocksToReadAhead); --i >= 0;)
+            blocks.add (new Block())->data.malloc ((size_t) blockSize);
+    }
+}
+
+ReadAheadFileInputStream::~ReadAheadFileInputStream()
+{
+    // (the blocks' buffers can't be freed while they're being read into)
+    file.waitForAllRequests();
+}
+
+int64 ReadAheadFileInputStream::getTotalLength()
+{
+    // You should always check that a stream opened successfully before using it!
+    jassert (openedOk());
+
+    return totalLength;
+}
+
+bool ReadAheadFileInputStream::isExhausted()
+{
+    return position >= totalLength;
+}
+
+int64 ReadAheadFileInputStream::getPosition()
+{
+    return position;
+}
+
+bool ReadAheadFileInputStream::setPosition (int64 newPosition)
+{
+    // You should always check that a stream opened successfully before using it!
+    jassert (openedOk());
+
+    position = jlimit ((int64) 0, totalLength, newPosition);
+    return position == newPosition;
+}
+
+ReadAheadFileInputStream::Block& ReadAheadFileInputStream::getSlotFor (int64 blockIndex) const noexcept
+{
+    return *blocks.getUnchecked ((int) (blockIndex % blocks.size()));
+}
+
+// Makes sure that the given block and the ones after it have been requested, re-using the
+// slots of any blocks that came before them.
+void ReadAheadFileInputStream::readAheadFrom (int64 blockIndex)
+{
+    Array<AsyncFile::Operation> operations;
+    Array<Block*> requestedBlocks;
+
+    for (int i = 0; i < blocks.size(); ++i)
+    {
+        auto index = blockIndex + i;
+        auto blockStart = index * blockSize;
+
+        if (blockStart >= totalLength)
+            break;
+
+        auto& block = getSlotFor (index);
+
+        if (block.index != index)
+        {
+            // a slot that's being re-used after a seek may still have a read in progress
+            if (block.request.isValid())
+                block.request.wait();
+
+            block.index = index;
+            operations.add ({ AsyncFile::Operation::readOperation, blockStart, block.data.get(),
+                              (size_t) jmin ((int64) blockSize, totalLength - blockStart), nullptr });
+            requestedBlocks.add (&block);
+        }
+    }
+
+    auto requests = file.submit (operations);
+
+    for (int i = 0; i < requests.size(); ++i)
+        requestedBlocks.getUnchecked (i)->request = requests.getReference (i);
+}
+
+int ReadAheadFileInputStream::read (void* destBuffer, int maxBytesToRead)
+{
+    // You should always check that a stream opened successfully before using it!
+    jassert (openedOk());
+
+    // The buffer should never be null, and a negative size is probably a
+    // sign that something is broken!
+    jassert (destBuffer != nullptr && maxBytesToRead >= 0);
+
+    auto* dest = static_cast<char*> (destBuffer);
+    int numRead = 0;
+
+    while (numRead < maxBytesToRead && position < totalLength && status.wasOk())
+    {
+        auto blockIndex = position / blockSize;
+        readAheadFrom (blockIndex);
+
+        auto& block = getSlotFor (blockIndex);
+        block.request.wait();
+
+        auto result = block.request.getResult();
+
+        if (result.failed())
+        {
+            status = result;
+            block.index = -1;
+            break;
+        }
+
+        auto offset = (int) (position - blockIndex * blockSize);
+        auto numAvailable = (int) block.request.getNumBytesTransferred() - offset;
+
+        if (numAvailable <= 0)
+        {
+            // the file must have been truncated while it was being read
+            totalLength = position;
+            break;
+        }
+
+        auto numToCopy = jmin (numAvailable, maxBytesToRead - numRead);
+        memcpy (dest + numRead, block.data + offset, (size_t) numToCopy);
+        numRead += numToCopy;
+        position += numToCopy;
+    }
+
+    return numRead;
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct AsyncFileTests  : public UnitTest
+{
+    AsyncFileTests()  : UnitTest ("AsyncFile", "Files") {}
+
+    void runTest() override
+    {
+        auto r = getRandom();
+        auto tempFile = File::createTempFile (".bin");
+        TaskScheduler scheduler (3);
+
+        MemoryBlock data ((size_t) 300000 + (size_t) r.nextInt (100000));
+        r.fillBitsRandomly (data.getData(), data.getSize());
+
+        beginTest ("Writing and reading");
+        {
+            {
+                AsyncFile asyncFile (tempFile, AsyncFile::readWrite, scheduler);
+                expect (asyncFile.openedOk());
+
+                // write the second half first, so that the file has to grow past a gap
+                auto half = data.getSize() / 2;
+                Atomic<int> numCallbacks;
+
+                auto second = asyncFile.write ((int64) half, static_cast<const char*> (data.getData()) + half, data.getSize() - half,
+                                               [&] (const Result& result, size_t num) { if (result.wasOk() && num == data.getSize() - half) ++numCallbacks; });
+                auto first = asyncFile.write (0, data.getData(), half);
+
+                expect (second.wait() && first.wait());
+                expect (first.getResult().wasOk() && first.getNumBytesTransferred() == half);
+                expectEquals (numCallbacks.get(), 1);
+
+                auto flushed = asyncFile.flush();
+                expect (flushed.wait() && flushed.getResult().wasOk());
+                expectEquals (asyncFile.getSize(), (int64) data.getSize());
+            }
+
+            MemoryBlock fileData;
+            expect (tempFile.loadFileAsData (fileData) && fileData == data);
+
+            AsyncFile asyncFile (tempFile, AsyncFile::readOnly, scheduler);
+            HeapBlock<char> buffer (data.getSize() + 100);
+
+            // a read past the end of the file only returns what's there
+            auto request = asyncFile.read (100, buffer, data.getSize());
+            expect (request.wait() && request.getResult().wasOk());
+            expectEquals ((int) request.getNumBytesTransferred(), (int) data.getSize() - 100);
+            expect (memcmp (buffer, static_cast<const char*> (data.getData()) + 100, data.getSize() - 100) == 0);
+        }
+
+        beginTest ("Batches");
+        {
+            AsyncFile asyncFile (tempFile, AsyncFile::readOnly, scheduler);
+            HeapBlock<char> buffer (data.getSize());
+            Array<AsyncFile::Operation> operations;
+            const size_t chunkSize = 10000;
+
+            // read the file in chunks, submitted in reverse order
+            for (size_t pos = 0; pos < data.getSize(); pos += chunkSize)
+                operations.insert (0, { AsyncFile::Operation::readOperation, (int64) pos, buffer + pos,
+                                        jmin (chunkSize, data.getSize() - pos), nullptr });
+
+            auto requests = asyncFile.submit (operations);
+            expectEquals (requests.size(), operations.size());
+            expect (asyncFile.waitForAllRequests());
+            expectEquals (asyncFile.getNumPendingRequests(), 0);
+
+            for (auto& request : requests)
+                expect (request.isFinished() && request.getResult().wasOk());
+
+            expect (memcmp (buffer, data.getData(), data.getSize()) == 0);
+
+            AsyncFile missingFile (tempFile.getSiblingFile ("nonexistent"), AsyncFile::readOnly, scheduler);
+            expect (missingFile.getStatus().failed());
+        }
+
+        beginTest ("Read-ahead stream");
+        {
+            for (auto blockSize : { 100, 4096, 65536 })
+            {
+                ReadAheadFileInputStream in (tempFile, scheduler, blockSize, 3);
+                expect (in.openedOk());
+                expectEquals (in.getTotalLength(), (int64) data.getSize());
+
+                MemoryOutputStream out;
+                HeapBlock<char> buffer (10000);
+
+                while (! in.isExhausted())
+                {
+                    auto num = in.read (buffer, r.nextInt (10000) + 1);
+                    expect (num > 0);
+                    out.write (buffer, (size_t) num);
+                }
+
+                expect (out.getMemoryBlock() == data);
+
+                for (int i = 0; i < 50; ++i)
+                {
+                    auto pos = (int64) r.nextInt ((int) data.getSize());
+                    auto num = r.nextInt (5000);
+
+                    expect (in.setPosition (pos));
+                    auto numRead = in.read (buffer, num);
+                    expectEquals (numRead, (int) jmin ((int64) num, (int64) data.getSize() - pos));
+                    expect (memcmp (buffer, static_cast<const char*> (data.getData()) + pos, (size_t) numRead) == 0);
+                    expectEquals (in.getPosition(), pos + numRead);
+                }
+            }
+        }
+
+        beginTest ("Benchmark");
+        {
+            // Simulates a streaming reader which processes each block it reads.
+            auto timeStreaming = [&] (InputStream& in)
+            {
+                HeapBlock<char> buffer (8192);
+                auto start = Time::getMillisecondCounterHiRes();
+                uint32 checksum = 0;
+
+                in.setPosition (0);
+
+                while (! in.isExhausted())
+                {
+                    auto num = in.read (buffer, 8192);
+
+                    for (int i = 0; i < num; ++i)
+                        checksum = checksum * 31 + (uint8) buffer[i];
+                }
+
+                expect (checksum != 1);
+                return Time::getMillisecondCounterHiRes() - start;
+            };
+
+            FileInputStream fileStream (tempFile);
+            ReadAheadFileInputStream readAheadStream (tempFile, scheduler);
+
+            logMessage ("Streaming " + String (data.getSize() / 1024) + " KB: FileInputStream "
+                          + String (timeStreaming (fileStream), 2) + " ms, ReadAheadFileInputStream "
+                          + String (timeStreaming (readAheadStream), 2) + " ms");
+        }
+
+        tempFile.deleteFile();
+    }
+};
+
+static AsyncFileTests asyncFileTests;
+
+#endif
+
+} // namespace juce
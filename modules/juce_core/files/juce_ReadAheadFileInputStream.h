@@ -0,0 +1,107 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    An input stream that reads from a local file, and keeps a number of blocks ahead of
+    the current position being read in the background.
+
+    This is intended for streaming, e.g. audio files that are played from disk: when the
+    data is read sequentially, each read will usually find its data has already arrived,
+    so the thread reading the stream rarely has to wait for the disk. It can be used
+    anywhere that a FileInputStream could, e.g. it can be given to an AudioFormat to
+    create a reader.
+
+    Seeking to a position outside the blocks that have been read ahead discards them, and
+    starts reading ahead from the new position.
+
+    @see AsyncFile, FileInputStream, BufferedInputStream
+*/
+class JUCE_API  ReadAheadFileInputStream  : public InputStream
+{
+public:
+    //==============================================================================
+    /** Creates a stream to read from the given file.
+
+        @param fileToRead           the file to read
+        @param scheduler            the scheduler whose threads will do the reading. This must
+                                    not be deleted before the stream
+        @param blockSize            the number of bytes in each block that is read ahead
+        @param numBlocksToReadAhead the number of blocks to keep in memory. Together with the
+                                    block size, this sets how much data can be buffered
+    */
+    ReadAheadFileInputStream (const File& fileToRead,
+                              TaskScheduler& scheduler,
+                              int blockSize = 65536,
+                              int numBlocksToReadAhead = 4);
+
+    /** Destructor. */
+    ~ReadAheadFileInputStream();
+
+    //==============================================================================
+    /** Returns the file that this stream is reading from. */
+    const File& getFile() const noexcept                { return file.getFile(); }
+
+    /** Returns the status of the stream.
+        The result will be ok if the file opened successfully. If an error occurs while
+        opening or reading from the file, this will contain an error message.
+    */
+    const Result& getStatus() const noexcept            { return status; }
+
+    /** Returns true if the stream couldn't be opened for some reason. */
+    bool failedToOpen() const noexcept                  { return status.failed(); }
+
+    /** Returns true if the stream opened without problems. */
+    bool openedOk() const noexcept                      { return status.wasOk(); }
+
+    //==============================================================================
+    int64 getTotalLength() override;
+    int read (void*, int) override;
+    bool isExhausted() override;
+    int64 getPosition() override;
+    bool setPosition (int64) override;
+
+private:
+    //==============================================================================
+    struct Block
+    {
+        int64 index = -1;
+        HeapBlock<char> data;
+        AsyncFile::Request request;
+    };
+
+    AsyncFile file;
+    const int blockSize;
+    OwnedArray<Block> blocks;
+    int64 position = 0, totalLength = 0;
+    Result status;
+
+    Block& getSlotFor (int64 blockIndex) const noexcept;
+    void readAheadFrom (int64 blockIndex);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ReadAheadFileInputStream)
+};
+
+} // namespace juce
@@ -41,8 +41,20 @@ struct JSONParser
 
     static Result parseString (const juce_wchar quoteChar, String::CharPointerType& t, var& result)
     {
-        MemoryOutputStream buffer (256);
+        char buffer[256];
+        StringArena text (buffer, sizeof (buffer));
+        auto r = readString (quoteChar, t, text);
 
+        if (r.wasOk())
+            result = String (text.finishString().text);
+
+        return r;
+    }
+
+    // Reads the contents of a string constant into the arena's current string,
+    // which is usually short enough to stay in the caller's stack buffer.
+    static Result readString (const juce_wchar quoteChar, String::CharPointerType& t, StringArena& buffer)
+    {
         for (;;)
         {
             auto c = t.getAndAdvance();
@@ -90,10 +102,9 @@ struct JSONParser
             if (c == 0)
                 return createFail ("Unexpected end-of-input in string constant");
 
-            buffer.appendUTF8Char (c);
+            buffer.appendChar (c);
         }
 
-        result = buffer.toUTF8();
         return Result::ok();
     }
 
@@ -234,13 +245,16 @@ private:
 
             if (c == '"')
             {
-                var propertyNameVar;
-                auto r = parseString ('"', t, propertyNameVar);
+                // the name only needs a String if it's not already in the StringPool
+                char nameBuffer[128];
+                StringArena nameText (nameBuffer, sizeof (nameBuffer));
+                auto r = readString ('"', t, nameText);
 
                 if (r.failed())
                     return r;
 
-                const Identifier propertyName (propertyNameVar.toString());
+                auto name = nameText.finishString();
+                const Identifier propertyName (name.text, name.text.findTerminatingNull());
 
                 if (propertyName.isValid())
                 {
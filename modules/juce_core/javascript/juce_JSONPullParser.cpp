@@ -0,0 +1,808 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+JSONPullParser::JSONPullParser (InputStream& sourceStream)  : source (sourceStream)
+{
+}
+
+JSONPullParser::~JSONPullParser()
+{
+}
+
+//==============================================================================
+JSONPullParser::EventType JSONPullParser::next()
+{
+    if (savedCharIndex >= 0)
+    {
+        buffer[savedCharIndex] = savedChar;
+        savedCharIndex = -1;
+    }
+
+   #if JUCE_STRING_UTF_TYPE != 8
+    convertedString.clear();
+   #endif
+
+    if (currentEvent == endOfDocument || currentEvent == parseError)
+        return currentEvent;
+
+    eventStart += position;
+    position = 0;
+    stringStart = -1;
+    skipWhitespace();
+    return next (state);
+}
+
+JSONPullParser::EventType JSONPullParser::next (State currentState)
+{
+    switch (currentState)
+    {
+        case expectCommaOrEnd:
+        {
+            auto isObject = containers.getLast();
+            auto c = peek (0);
+
+            if (c == (isObject ? '}' : ']'))
+            {
+                ++position;
+                return endContainer (isObject);
+            }
+
+            if (c != ',')
+                return setError (isObject ? "Expected ',' or '}' after object member"
+                                          : "Expected ',' or ']' after array item");
+
+            // (like JSON::parse(), this allows a trailing comma before the closing bracket)
+            ++position;
+            skipWhitespace();
+            state = isObject ? expectNameOrEndOfObject : expectValueOrEndOfArray;
+            return next (state);
+        }
+
+        case expectNameOrEndOfObject:
+            if (peek (0) == '}')
+            {
+                ++position;
+                return endContainer (true);
+            }
+
+            return readString (propertyName);
+
+        case expectValueOrEndOfArray:
+            if (peek (0) == ']')
+            {
+                ++position;
+                return endContainer (false);
+            }
+
+            return readValueToken();
+
+        case finished:
+            return setEvent (endOfDocument);
+
+        case expectValue:
+        default:
+            if (containers.isEmpty() && peek (0) == 0)
+                return setEvent (endOfDocument);
+
+            return readValueToken();
+    }
+}
+
+//==============================================================================
+StringRef JSONPullParser::getString() const noexcept
+{
+    if (stringStart >= 0 && (currentEvent == propertyName || currentEvent == stringValue))
+    {
+       #if JUCE_STRING_UTF_TYPE == 8
+        return String::CharPointerType (buffer + eventStart + stringStart);
+       #else
+        if (convertedString.isEmpty())
+            convertedString = CharPointer_UTF8 (buffer + eventStart + stringStart);
+
+        return convertedString;
+       #endif
+    }
+
+    return {};
+}
+
+var JSONPullParser::getValue() const
+{
+    switch (currentEvent)
+    {
+        case stringValue:
+            return String (getString().text);
+
+        case numberValue:
+        {
+            if (! numberIsInteger)
+                return doubleValue;
+
+            auto magnitude = intValue < 0 ? -intValue : intValue;
+
+            if ((magnitude >> 31) != 0)
+                return intValue;
+
+            return (int) intValue;
+        }
+
+        case boolValue:
+            return boolean;
+
+        default:
+            return {};
+    }
+}
+
+var JSONPullParser::readValue()
+{
+    switch (currentEvent)
+    {
+        case startObject:
+        {
+            DynamicObject::Ptr object (new DynamicObject());
+            auto& properties = object->getProperties();
+
+            while (next() == propertyName)
+            {
+                auto name = getString();
+                const Identifier id (name.text, name.text.findTerminatingNull());
+
+                if (! id.isValid())
+                {
+                    setError ("Expected object member declaration");
+                    return {};
+                }
+
+                next();
+                auto value = readValue();
+
+                if (currentEvent == parseError)
+                    return {};
+
+                properties.set (id, static_cast<var&&> (value));
+            }
+
+            if (currentEvent == endObject)
+                return object.get();
+
+            return {};
+        }
+
+        case startArray:
+        {
+            var result (Array<var>{});
+            auto* array = result.getArray();
+
+            for (;;)
+            {
+                auto event = next();
+
+                if (event == endArray)
+                    return result;
+
+                if (event == parseError || event == endOfDocument)
+                    return {};
+
+                array->add (readValue());
+
+                if (currentEvent == parseError)
+                    return {};
+            }
+        }
+
+        case stringValue:
+        case numberValue:
+        case boolValue:
+        case nullValue:
+            return getValue();
+
+        default:
+            return {};
+    }
+}
+
+bool JSONPullParser::skipValue()
+{
+    if (currentEvent == startObject || currentEvent == startArray)
+    {
+        for (auto targetDepth = getDepth() - 1; getDepth() > targetDepth;)
+        {
+            auto event = next();
+
+            if (event == endOfDocument || event == parseError)
+                return false;
+        }
+    }
+
+    return currentEvent != endOfDocument && currentEvent != parseError;
+}
+
+//==============================================================================
+char JSONPullParser::peekAfterReading (int offset)
+{
+    while (eventStart + position + offset >= dataEnd)
+        if (! readMoreData())
+            return 0;
+
+    return buffer[eventStart + position + offset];
+}
+
+bool JSONPullParser::readMoreData()
+{
+    if (sourceExhausted)
+        return false;
+
+    // positions are relative to eventStart, so the current event can be moved to the start of the buffer
+    if (eventStart > 0)
+    {
+        dataEnd -= eventStart;
+        memmove (buffer, buffer + eventStart, (size_t) dataEnd);
+        eventStart = 0;
+    }
+
+    const int minBytesToRead = 32768;
+
+    if (dataEnd + minBytesToRead > bufferSize)
+    {
+        bufferSize = jmax (bufferSize * 2, dataEnd + minBytesToRead);
+        buffer.realloc ((size_t) bufferSize + 1);
+    }
+
+    auto numRead = source.read (buffer + dataEnd, bufferSize - dataEnd);
+
+    if (numRead <= 0)
+    {
+        sourceExhausted = true;
+        return false;
+    }
+
+    dataEnd += numRead;
+    return true;
+}
+
+void JSONPullParser::terminate (int end) noexcept
+{
+    // if the terminator overwrites a character that hasn't been parsed yet, it'll be put back by next()
+    auto index = eventStart + end;
+
+    if (end >= position)
+    {
+        savedCharIndex = index;
+        savedChar = buffer[index];
+    }
+
+    buffer[index] = 0;
+}
+
+void JSONPullParser::skipWhitespace()
+{
+    while (CharacterFunctions::isWhitespace (peek (0)))
+        ++position;
+}
+
+bool JSONPullParser::matches (const char* text)
+{
+    for (int i = 0; text[i] != 0; ++i)
+        if (peek (i) != text[i])
+            return false;
+
+    return true;
+}
+
+//==============================================================================
+JSONPullParser::EventType JSONPullParser::readValueToken()
+{
+    switch (peek (0))
+    {
+        case '{':
+            ++position;
+            containers.add (true);
+            state = expectNameOrEndOfObject;
+            return setEvent (startObject);
+
+        case '[':
+            ++position;
+            containers.add (false);
+            state = expectValueOrEndOfArray;
+            return setEvent (startArray);
+
+        case '"':
+        case '\'':
+            return readString (stringValue);
+
+        case '-':
+        case '0': case '1': case '2': case '3': case '4':
+        case '5': case '6': case '7': case '8': case '9':
+            return readNumber();
+
+        case 't':   boolean = true;  return readLiteral ("true", boolValue);
+        case 'f':   boolean = false; return readLiteral ("false", boolValue);
+        case 'n':   return readLiteral ("null", nullValue);
+
+        case 0:     return setError ("Unexpected end-of-input");
+        default:    return setError ("Syntax error");
+    }
+}
+
+// The unescaped string is never longer than the original, so it's written over it.
+JSONPullParser::EventType JSONPullParser::readString (EventType type)
+{
+    auto quote = peek (0);
+
+    if (quote != '"' && (quote != '\'' || type == propertyName))
+        return setError ("Expected object member declaration");
+
+    ++position;
+    stringStart = position;
+    auto output = position;
+
+    for (;;)
+    {
+        auto c = peek (0);
+
+        if (c == 0)
+            return setError ("Unexpected end-of-input in string constant");
+
+        ++position;
+
+        if (c == quote)
+            break;
+
+        if (c != '\\')
+        {
+            buffer[eventStart + output++] = c;
+            continue;
+        }
+
+        juce_wchar decoded = (juce_wchar) (uint8) peek (0);
+        ++position;
+
+        switch (decoded)
+        {
+            case 'a':  decoded = '\a'; break;
+            case 'b':  decoded = '\b'; break;
+            case 'f':  decoded = '\f'; break;
+            case 'n':  decoded = '\n'; break;
+            case 'r':  decoded = '\r'; break;
+            case 't':  decoded = '\t'; break;
+
+            case 'u':
+            {
+                auto readHexDigits = [this] (int offset) -> int
+                {
+                    int value = 0;
+
+                    for (int i = 0; i < 4; ++i)
+                    {
+                        auto digit = CharacterFunctions::getHexDigitValue ((juce_wchar) (uint8) peek (offset + i));
+
+                        if (digit < 0)
+                            return -1;
+
+                        value = (value << 4) + digit;
+                    }
+
+                    return value;
+                };
+
+                auto value = readHexDigits (0);
+
+                if (value < 0)
+                    return setError ("Syntax error in unicode escape sequence");
+
+                position += 4;
+
+                // combine surrogate pairs, which is how the formatter writes characters outside the BMP
+                if (value >= 0xd800 && value < 0xdc00 && peek (0) == '\\' && peek (1) == 'u')
+                {
+                    auto lowSurrogate = readHexDigits (2);
+
+                    if (lowSurrogate >= 0xdc00 && lowSurrogate < 0xe000)
+                    {
+                        value = 0x10000 + ((value - 0xd800) << 10) + (lowSurrogate - 0xdc00);
+                        position += 6;
+                    }
+                }
+
+                decoded = (juce_wchar) value;
+                break;
+            }
+
+            default:
+                break;
+        }
+
+        if (decoded == 0)
+            return setError ("Unexpected end-of-input in string constant");
+
+        CharPointer_UTF8 dest (buffer + eventStart + output);
+        dest.write (decoded);
+        output = (int) (dest.getAddress() - (buffer + eventStart));
+    }
+
+    if (type == propertyName)
+    {
+        skipWhitespace();
+
+        if (peek (0) != ':')
+            return setError ("Expected ':'");
+
+        ++position;
+        state = expectValue;
+        terminate (output);
+        return setEvent (propertyName);
+    }
+
+    terminate (output);
+    return finishedValue (stringValue);
+}
+
+JSONPullParser::EventType JSONPullParser::readNumber()
+{
+    stringStart = position;
+    const bool isNegative = (peek (0) == '-');
+
+    if (isNegative)
+        ++position;
+
+    if (! CharacterFunctions::isDigit (peek (0)))
+        return setError ("Syntax error in number");
+
+    uint64 magnitude = 0;
+    numberIsInteger = true;
+
+    for (;;)
+    {
+        auto c = peek (0);
+
+        if (CharacterFunctions::isDigit (c))
+        {
+            magnitude = magnitude * 10 + (uint64) (c - '0');
+            ++position;
+        }
+        else if (c == '.' || c == 'e' || c == 'E' || (! numberIsInteger && (c == '+' || c == '-')))
+        {
+            numberIsInteger = false;
+            ++position;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    auto c = peek (0);
+
+    if (! (c == 0 || c == ',' || c == '}' || c == ']' || CharacterFunctions::isWhitespace (c)))
+        return setError ("Syntax error in number");
+
+    terminate (position);
+
+    if (numberIsInteger)
+    {
+        intValue = isNegative ? -(int64) magnitude : (int64) magnitude;
+    }
+    else
+    {
+        CharPointer_UTF8 text (buffer + eventStart + stringStart);
+        doubleValue = CharacterFunctions::readDoubleValue (text);
+    }
+
+    return finishedValue (numberValue);
+}
+
+JSONPullParser::EventType JSONPullParser::readLiteral (const char* text, EventType type)
+{
+    if (! matches (text))
+        return setError ("Syntax error");
+
+    position += (int) strlen (text);
+    return finishedValue (type);
+}
+
+JSONPullParser::EventType JSONPullParser::endContainer (bool isObject)
+{
+    containers.removeLast();
+    return finishedValue (isObject ? endObject : endArray);
+}
+
+JSONPullParser::EventType JSONPullParser::finishedValue (EventType type)
+{
+    state = containers.isEmpty() ? finished : expectCommaOrEnd;
+    return setEvent (type);
+}
+
+JSONPullParser::EventType JSONPullParser::setEvent (EventType type)
+{
+    currentEvent = type;
+    return type;
+}
+
+JSONPullParser::EventType JSONPullParser::setError (const String& message)
+{
+    String context;
+
+    for (int i = 0; i < 20; ++i)
+        if (auto c = peek (i))
+            context << c;
+        else
+            break;
+
+    lastError = message + (context.isNotEmpty() ? ": \"" + context + "\"" : String());
+    stringStart = -1;
+    return setEvent (parseError);
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class JSONStreamingTests  : public UnitTest
+{
+public:
+    JSONStreamingTests() : UnitTest ("JSON streaming", "JSON") {}
+
+    static void writeWithEvents (JSONWriter& writer, const var& v)
+    {
+        if (auto* array = v.getArray())
+        {
+            writer.startArray();
+
+            for (auto& item : *array)
+                writeWithEvents (writer, item);
+
+            writer.endArray();
+        }
+        else if (auto* object = v.getDynamicObject())
+        {
+            writer.startObject();
+
+            for (auto& property : object->getProperties())
+            {
+                writer.writeName (property.name.toString());
+                writeWithEvents (writer, property.value);
+            }
+
+            writer.endObject();
+        }
+        else if (v.isString())  writer.writeString (v.toString());
+        else if (v.isDouble())  writer.writeDouble (v);
+        else if (v.isBool())    writer.writeBool (v);
+        else if (v.isVoid())    writer.writeNull();
+        else                    writer.writeInt (v);
+    }
+
+    static String getEvents (const String& text)
+    {
+        ChunkedTestInputStream in (text, 2);
+        JSONPullParser parser (in);
+        StringArray events;
+
+        for (;;)
+        {
+            switch (parser.next())
+            {
+                case JSONPullParser::startObject:   events.add ("{"); break;
+                case JSONPullParser::endObject:     events.add ("}"); break;
+                case JSONPullParser::startArray:    events.add ("["); break;
+                case JSONPullParser::endArray:      events.add ("]"); break;
+                case JSONPullParser::propertyName:  events.add ("name:" + String (parser.getString())); break;
+                case JSONPullParser::stringValue:   events.add ("string:" + String (parser.getString())); break;
+                case JSONPullParser::numberValue:   events.add ((parser.isInteger() ? "int:" : "double:") + parser.getValue().toString()); break;
+                case JSONPullParser::boolValue:     events.add (parser.getBool() ? "true" : "false"); break;
+                case JSONPullParser::nullValue:     events.add ("null"); break;
+                case JSONPullParser::endOfDocument: return events.joinIntoString (" ");
+                case JSONPullParser::parseError:    return "error";
+                default:                            jassertfalse; return {};
+            }
+        }
+    }
+
+    void runTest() override
+    {
+        beginTest ("Events");
+        {
+            expectEquals (getEvents (""), String());
+            expectEquals (getEvents ("  123 "), String ("int:123"));
+            expectEquals (getEvents ("{}"), String ("{ }"));
+            expectEquals (getEvents ("[ ]"), String ("[ ]"));
+            expectEquals (getEvents ("{ \"a\" : [1, -2.5e1, 'x', \"\\u00e9\\n\\uD83D\\uDE00\", true, false, null, {}], \"b\": 12345678901234 }"),
+                          String (CharPointer_UTF8 ("{ name:a [ int:1 double:-25 string:x string:\xc3\xa9\n\xf0\x9f\x98\x80 true false null { } ] name:b int:12345678901234 }")));
+            expectEquals (getEvents ("[1] trailing"), String ("[ int:1 ]"));
+            expectEquals (getEvents ("[1, {\"a\": 2,},]"), String ("[ int:1 { name:a int:2 } ]"));
+        }
+
+        beginTest ("Errors");
+        {
+            for (auto text : { "[", "{", "[1 2]", "{\"a\" 1}", "{\"a\":}", "{a:1}", "{'a':1}", "[\"abc]", "[tru]",
+                               "[1.2.3x]", "[-]", "[1-2]", "[,]", "[}", "{]", "[\"\\uZZZZ\"]", "@" })
+            {
+                MemoryInputStream in (text, strlen (text), false);
+                JSONPullParser parser (in);
+                auto event = parser.next();
+
+                while (event != JSONPullParser::endOfDocument && event != JSONPullParser::parseError)
+                    event = parser.next();
+
+                expect (event == JSONPullParser::parseError, text);
+                expect (parser.getLastParseError().isNotEmpty());
+                expect (parser.next() == JSONPullParser::parseError);
+
+                var result;
+                expect (JSON::parse (text, result).failed(), text);
+            }
+        }
+
+        beginTest ("Round trips");
+        {
+            auto r = getRandom();
+
+            for (int i = 0; i < 50; ++i)
+            {
+                auto v = JSONTests::createRandomVar (r, 0);
+                auto oneLine = r.nextBool();
+                auto text = JSON::toString (v, oneLine);
+
+                for (auto chunkSize : { 1, 3, 64, 100000 })
+                {
+                    ChunkedTestInputStream in (text, chunkSize);
+                    JSONPullParser parser (in);
+                    parser.next();
+                    auto parsed = parser.readValue();
+
+                    expect (parser.next() == JSONPullParser::endOfDocument);
+                    expectEquals (JSON::toString (parsed, oneLine), text);
+                }
+
+                MemoryOutputStream written;
+
+                {
+                    JSONWriter writer (written, oneLine);
+                    writeWithEvents (writer, v);
+                }
+
+                expectEquals (written.toString(), text);
+            }
+        }
+
+        beginTest ("Records");
+        {
+            ChunkedTestInputStream in ("[{\"id\": 1, \"skip\": [[{}], {\"x\": []}]}, {\"id\": 2}, 3]", 4);
+            JSONPullParser parser (in);
+            expect (parser.next() == JSONPullParser::startArray);
+
+            expect (parser.next() == JSONPullParser::startObject);
+            expect (parser.next() == JSONPullParser::propertyName && parser.getString() == StringRef ("id"));
+            expect (parser.next() == JSONPullParser::numberValue && parser.getInt64() == 1);
+            expect (parser.next() == JSONPullParser::propertyName && parser.getString() == StringRef ("skip"));
+            expect (parser.next() == JSONPullParser::startArray && parser.skipValue());
+            expectEquals (parser.getDepth(), 2);
+            expect (parser.next() == JSONPullParser::endObject);
+
+            expect (parser.next() == JSONPullParser::startObject);
+            expect ((int) parser.readValue()["id"] == 2);
+            expect (parser.next() == JSONPullParser::numberValue && (int) parser.readValue() == 3);
+            expect (parser.next() == JSONPullParser::endArray);
+            expect (parser.next() == JSONPullParser::endOfDocument);
+        }
+
+        beginTest ("Benchmark");
+        {
+            MemoryOutputStream data;
+
+            {
+                JSONWriter writer (data, true);
+                Random r (1234);
+                writer.startArray();
+
+                for (int i = 0; i < 50000; ++i)
+                {
+                    writer.startObject();
+                    writer.writeProperty ("id", i);
+                    writer.writeProperty ("name", "record \"" + String (r.nextInt()) + "\"");
+                    writer.writeProperty ("value", r.nextDouble());
+                    writer.writeName ("tags");
+                    writer.startArray();
+                    writer.writeString ("a");
+                    writer.writeBool (r.nextBool());
+                    writer.writeNull();
+                    writer.endArray();
+                    writer.endObject();
+                }
+
+                writer.endArray();
+            }
+
+            auto text = data.toString();
+
+            auto start = Time::getMillisecondCounterHiRes();
+            auto parsed = JSON::parse (text);
+            auto parseTime = Time::getMillisecondCounterHiRes() - start;
+
+            start = Time::getMillisecondCounterHiRes();
+            int numEvents = 0;
+
+            {
+                MemoryInputStream in (data.getData(), data.getDataSize(), false);
+                JSONPullParser parser (in);
+
+                while (parser.next() < JSONPullParser::endOfDocument)
+                    ++numEvents;
+            }
+
+            auto eventTime = Time::getMillisecondCounterHiRes() - start;
+
+            start = Time::getMillisecondCounterHiRes();
+            int64 total = 0;
+
+            {
+                MemoryInputStream in (data.getData(), data.getDataSize(), false);
+                JSONPullParser parser (in);
+                parser.next();
+
+                while (parser.next() == JSONPullParser::startObject)
+                    total += (int) parser.readValue()["id"];
+            }
+
+            auto recordTime = Time::getMillisecondCounterHiRes() - start;
+
+            expectEquals (total, (int64) 49999 * 50000 / 2);
+
+            start = Time::getMillisecondCounterHiRes();
+            auto formatted = JSON::toString (parsed, true);
+            auto toStringTime = Time::getMillisecondCounterHiRes() - start;
+
+            start = Time::getMillisecondCounterHiRes();
+            MemoryOutputStream written (data.getDataSize() + 16);
+
+            {
+                JSONWriter writer (written, true);
+                writer.startArray();
+
+                for (auto& record : *parsed.getArray())
+                    writer.writeValue (record);
+
+                writer.endArray();
+            }
+
+            auto writerTime = Time::getMillisecondCounterHiRes() - start;
+
+            expect (formatted == written.toString());
+
+            logMessage (String (data.getDataSize() / 1024) + " KB: JSON::parse " + String (parseTime, 1)
+                          + " ms, pull events " + String (eventTime, 1) + " ms (" + String (numEvents)
+                          + "), pull records " + String (recordTime, 1) + " ms");
+
+            logMessage ("JSON::toString " + String (toStringTime, 1) + " ms, JSONWriter " + String (writerTime, 1) + " ms");
+        }
+    }
+};
+
+static JSONStreamingTests jsonStreamingTests;
+
+#endif
+
+} // namespace juce
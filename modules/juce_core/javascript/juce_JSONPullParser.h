@@ -0,0 +1,186 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Reads JSON from a stream as a sequence of events, without building a var tree.
+
+    JSON::parse() needs the whole document in a String, and creates a var for every
+    value in it. This parser reads the stream in blocks, and each call to next() moves
+    on to the next token. Strings are unescaped in-place and returned as StringRefs
+    pointing into the parser's buffer, so the memory used depends only on the length of
+    the longest string, not on the size of the document. (The buffer holds UTF-8, so if
+    JUCE_STRING_UTF_TYPE isn't 8, the StringRefs instead refer to a converted copy that
+    the parser keeps until the next event).
+
+    You can also mix the two approaches, e.g. to process an array of records one at a
+    time, call readValue() when you get to the start of each one:
+
+    @code
+    FileInputStream in (file);
+    JSONPullParser parser (in);
+
+    if (parser.next() == JSONPullParser::startArray)
+    {
+        while (parser.next() == JSONPullParser::startObject)
+            processRecord (parser.readValue());
+    }
+
+    if (parser.getCurrentEvent() == JSONPullParser::parseError)
+        DBG (parser.getLastParseError());
+    @endcode
+
+    Any kind of value is accepted at the top level, as with JSON::fromString(), and
+    anything following it in the stream is ignored.
+
+    @see JSON, JSONWriter
+*/
+class JUCE_API  JSONPullParser
+{
+public:
+    //==============================================================================
+    /** Creates a parser to read from the given stream.
+        The stream must stay valid for as long as the parser is being used.
+    */
+    explicit JSONPullParser (InputStream& sourceStream);
+
+    /** Destructor. */
+    ~JSONPullParser();
+
+    //==============================================================================
+    /** The types of event that next() can return. */
+    enum EventType
+    {
+        startObject,    /**< A '{'. It'll be followed by pairs of propertyName and value events, then endObject. */
+        endObject,      /**< A '}'. */
+        startArray,     /**< A '['. It'll be followed by any number of values, then endArray. */
+        endArray,       /**< A ']'. */
+        propertyName,   /**< The name of an object member, which you can get with getString(). */
+        stringValue,    /**< A string, which you can get with getString(). */
+        numberValue,    /**< A number - see isInteger(), getInt64() and getDouble(). */
+        boolValue,      /**< true or false - see getBool(). */
+        nullValue,      /**< null. */
+        endOfDocument,  /**< The top-level value has been read. */
+        parseError      /**< The JSON is malformed, see getLastParseError(). */
+    };
+
+    /** Reads the next event from the stream.
+
+        Any StringRefs that were obtained for the previous event become invalid when
+        this is called. Once endOfDocument or parseError has been returned, all
+        subsequent calls return the same thing.
+    */
+    EventType next();
+
+    /** Returns the type of the event that was last returned by next(). */
+    EventType getCurrentEvent() const noexcept      { return currentEvent; }
+
+    /** For a propertyName or stringValue event, returns the unescaped string. */
+    StringRef getString() const noexcept;
+
+    /** For a numberValue event, returns true if the number has no fractional part or exponent. */
+    bool isInteger() const noexcept                 { return numberIsInteger; }
+
+    /** For a numberValue event, returns the number as an integer. */
+    int64 getInt64() const noexcept                 { return numberIsInteger ? intValue : (int64) doubleValue; }
+
+    /** For a numberValue event, returns the number as a double. */
+    double getDouble() const noexcept               { return numberIsInteger ? (double) intValue : doubleValue; }
+
+    /** For a boolValue event, returns the value. */
+    bool getBool() const noexcept                   { return boolean; }
+
+    /** For a value event, returns the value as a var, using the same types that
+        JSON::parse() would have used.
+    */
+    var getValue() const;
+
+    /** Reads the value that starts with the current event into a var.
+
+        If the current event is a startObject or startArray, this reads everything up to
+        the matching end event, and returns the whole structure. For the other types of
+        value it just returns getValue().
+    */
+    var readValue();
+
+    /** If the current event is a startObject or startArray, this skips everything up to
+        and including the matching end event.
+        Returns false if an error or the end of the document was reached first.
+    */
+    bool skipValue();
+
+    /** Returns the number of objects and arrays that are currently open. */
+    int getDepth() const noexcept                   { return containers.size(); }
+
+    /** Returns a description of the error if next() has returned parseError. */
+    const String& getLastParseError() const noexcept    { return lastError; }
+
+private:
+    //==============================================================================
+    enum State { expectValue, expectValueOrEndOfArray, expectNameOrEndOfObject, expectCommaOrEnd, finished };
+
+    InputStream& source;
+    HeapBlock<char> buffer;
+    int bufferSize = 0, dataEnd = 0, eventStart = 0, position = 0;
+    int stringStart = -1, savedCharIndex = -1;
+    char savedChar = 0;
+    Array<bool> containers;  // true for an object, false for an array
+    State state = expectValue;
+    EventType currentEvent = nullValue;
+    bool sourceExhausted = false, numberIsInteger = false, boolean = false;
+    int64 intValue = 0;
+    double doubleValue = 0;
+    String lastError;
+
+   #if JUCE_STRING_UTF_TYPE != 8
+    mutable String convertedString;
+   #endif
+
+    char peek (int offset)
+    {
+        auto index = eventStart + position + offset;
+        return index < dataEnd ? buffer[index] : peekAfterReading (offset);
+    }
+
+    char peekAfterReading (int offset);
+    bool readMoreData();
+    void terminate (int end) noexcept;
+    void skipWhitespace();
+    bool matches (const char*);
+    EventType next (State);
+    EventType readValueToken();
+    EventType readString (EventType);
+    EventType readNumber();
+    EventType readLiteral (const char*, EventType);
+    EventType endContainer (bool isObject);
+    EventType finishedValue (EventType);
+    EventType setError (const String&);
+    EventType setEvent (EventType);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (JSONPullParser)
+};
+
+} // namespace juce
@@ -0,0 +1,177 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+JSONWriter::JSONWriter (OutputStream& destination, bool shouldBeOnOneLine, int numDecimalPlaces)
+    : out (destination), allOnOneLine (shouldBeOnOneLine), maximumDecimalPlaces (numDecimalPlaces)
+{
+}
+
+JSONWriter::~JSONWriter()
+{
+    // You need to close all the objects and arrays that you start!
+    jassert (containers.isEmpty());
+}
+
+//==============================================================================
+void JSONWriter::startObject()      { startContainer (true); }
+void JSONWriter::endObject()        { endContainer (true); }
+void JSONWriter::startArray()       { startContainer (false); }
+void JSONWriter::endArray()         { endContainer (false); }
+
+void JSONWriter::writeName (StringRef name)
+{
+    // Names can only be written inside an object, and each one must be followed by a value
+    jassert (! containers.isEmpty() && containers.getLast().isObject && ! containers.getLast().hasName);
+
+    startItem();
+    out << '"';
+    JSONFormatter::writeString (out, name.text);
+    out << "\": ";
+    containers.getReference (containers.size() - 1).hasName = true;
+}
+
+void JSONWriter::writeString (StringRef text)
+{
+    startValue();
+    out << '"';
+    JSONFormatter::writeString (out, text.text);
+    out << '"';
+}
+
+void JSONWriter::writeInt (int64 value)
+{
+    startValue();
+    out << value;
+}
+
+void JSONWriter::writeDouble (double value)
+{
+    startValue();
+    out << String (value, maximumDecimalPlaces);
+}
+
+void JSONWriter::writeBool (bool value)
+{
+    startValue();
+    out << (value ? "true" : "false");
+}
+
+void JSONWriter::writeNull()
+{
+    startValue();
+    out << "null";
+}
+
+void JSONWriter::writeValue (const var& value)
+{
+    startValue();
+    JSONFormatter::write (out, value, containers.size() * JSONFormatter::indentSize, allOnOneLine, maximumDecimalPlaces);
+}
+
+void JSONWriter::writeProperty (StringRef name, const var& value)
+{
+    writeName (name);
+    writeValue (value);
+}
+
+//==============================================================================
+// This produces the same layout as JSONFormatter and DynamicObject::writeAsJSON()
+void JSONWriter::startItem()
+{
+    if (containers.isEmpty())
+        return;
+
+    auto& container = containers.getReference (containers.size() - 1);
+
+    if (container.isEmpty)
+    {
+        container.isEmpty = false;
+
+        if (! (allOnOneLine || container.isObject))
+            out << newLine;
+    }
+    else
+    {
+        if (allOnOneLine)
+            out << ", ";
+        else
+            out << ',' << newLine;
+    }
+
+    if (! allOnOneLine)
+        JSONFormatter::writeSpaces (out, containers.size() * JSONFormatter::indentSize);
+}
+
+void JSONWriter::startValue()
+{
+    if (containers.isEmpty())
+        return;
+
+    auto& container = containers.getReference (containers.size() - 1);
+
+    if (container.isObject)
+    {
+        // Inside an object, you need to call writeName() before each value!
+        jassert (container.hasName);
+        container.hasName = false;
+    }
+    else
+    {
+        startItem();
+    }
+}
+
+void JSONWriter::startContainer (bool isObject)
+{
+    startValue();
+    out << (isObject ? '{' : '[');
+
+    if (isObject && ! allOnOneLine)
+        out << newLine;
+
+    containers.add ({ isObject, true, false });
+}
+
+void JSONWriter::endContainer (bool isObject)
+{
+    // The end call doesn't match the innermost object or array that's open!
+    jassert (! containers.isEmpty() && containers.getLast().isObject == isObject && ! containers.getLast().hasName);
+
+    auto wasEmpty = containers.getLast().isEmpty;
+    containers.removeLast();
+
+    if (! allOnOneLine && (isObject || ! wasEmpty))
+    {
+        if (! wasEmpty)
+            out << newLine;
+
+        JSONFormatter::writeSpaces (out, containers.size() * JSONFormatter::indentSize);
+    }
+
+    out << (isObject ? '}' : ']');
+}
+
+} // namespace juce
@@ -0,0 +1,134 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Writes JSON directly to a stream, one value at a time.
+
+    JSON::toString() and JSON::writeToStream() need the whole structure to be built as
+    a var first. This class lets you write the objects, arrays and values as you generate
+    them, so large documents can be written without holding them in memory. The output
+    is laid out in exactly the same way as JSON::writeToStream() would format it.
+
+    @code
+    FileOutputStream out (file);
+    JSONWriter json (out);
+
+    json.startObject();
+    json.writeProperty ("name", "My Preset Bank");
+    json.writeName ("presets");
+    json.startArray();
+
+    for (auto& preset : presets)
+        json.writeValue (preset.toVar());
+
+    json.endArray();
+    json.endObject();
+    @endcode
+
+    Inside an object, each value must be preceded by a call to writeName() (or you can use
+    writeProperty() to write both at once).
+
+    @see JSON, JSONPullParser
+*/
+class JUCE_API  JSONWriter
+{
+public:
+    //==============================================================================
+    /** Creates a writer that will write to the given stream.
+        The allOnOneLine and maximumDecimalPlaces parameters have the same meaning as in
+        JSON::writeToStream().
+    */
+    JSONWriter (OutputStream& destination,
+                bool allOnOneLine = false,
+                int maximumDecimalPlaces = 20);
+
+    /** Destructor. All the objects and arrays must have been closed by the time this is called. */
+    ~JSONWriter();
+
+    //==============================================================================
+    /** Writes a '{' to begin an object. */
+    void startObject();
+
+    /** Writes the '}' that ends the innermost object. */
+    void endObject();
+
+    /** Writes a '[' to begin an array. */
+    void startArray();
+
+    /** Writes the ']' that ends the innermost array. */
+    void endArray();
+
+    /** Writes the name of an object member. The next value to be written will be its value. */
+    void writeName (StringRef name);
+
+    //==============================================================================
+    /** Writes a string value. */
+    void writeString (StringRef text);
+
+    /** Writes an integer value. */
+    void writeInt (int64 value);
+
+    /** Writes a floating point value. */
+    void writeDouble (double value);
+
+    /** Writes a boolean value. */
+    void writeBool (bool value);
+
+    /** Writes a null value. */
+    void writeNull();
+
+    /** Writes a var, which may be a whole tree of objects and arrays. */
+    void writeValue (const var& value);
+
+    /** Writes an object member's name followed by its value. */
+    void writeProperty (StringRef name, const var& value);
+
+    //==============================================================================
+    /** Returns the number of objects and arrays that are currently open. */
+    int getDepth() const noexcept       { return containers.size(); }
+
+private:
+    //==============================================================================
+    struct Container
+    {
+        bool isObject, isEmpty, hasName;
+    };
+
+    OutputStream& out;
+    Array<Container> containers;
+    const bool allOnOneLine;
+    const int maximumDecimalPlaces;
+
+    void startItem();
+    void startValue();
+    void startContainer (bool isObject);
+    void endContainer (bool isObject);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (JSONWriter)
+};
+
+} // namespace juce
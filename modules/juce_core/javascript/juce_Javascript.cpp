@@ -74,6 +74,7 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     }
 
     Time timeout;
+    int timeoutCheckCountdown = 0;
 
     typedef const var::NativeFunctionArgs& Args;
     typedef const char* TokenType;
@@ -102,9 +103,48 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     static bool isNumeric (const var& v) noexcept             { return v.isInt() || v.isDouble() || v.isInt64() || v.isBool(); }
     static bool isNumericOrUndefined (const var& v) noexcept  { return isNumeric (v) || v.isUndefined(); }
     static int64 getOctalValue (const String& s)              { BigInteger b; b.parseString (s.initialSectionContainingOnly ("01234567"), 8); return b.toInt64(); }
-    static Identifier getPrototypeIdentifier()                { static const Identifier i ("prototype"); return i; }
+    static const Identifier& getPrototypeIdentifier()         { static const Identifier i ("prototype"); return i; }
     static var* getPropertyPointer (DynamicObject* o, const Identifier& i) noexcept   { return o->getProperties().getVarPointer (i); }
 
+    //==============================================================================
+    /** Remembers the index at which a node last found a name in an object's properties.
+        Objects that get built by the same code keep their properties in the same order,
+        so when the node runs again it can usually go straight to the right slot rather
+        than searching for it. The index is only a hint, and is checked against the name
+        before being used, so it doesn't matter if objects change in between.
+    */
+    struct PropertyCache
+    {
+        PropertyCache() noexcept {}
+
+        var* find (DynamicObject& o, const Identifier& name) const noexcept
+        {
+            auto& props = o.getProperties();
+            auto i = lastIndex.load (std::memory_order_relaxed);
+
+            if (isPositiveAndBelow (i, props.size()))
+            {
+                auto& item = props.begin()[i];
+
+                if (item.name == name)
+                    return &item.value;
+            }
+
+            i = props.indexOf (name);
+
+            if (i < 0)
+                return nullptr;
+
+            lastIndex.store (i, std::memory_order_relaxed);
+            return props.getVarPointerAt (i);
+        }
+
+    private:
+        mutable std::atomic<int> lastIndex { 0 };
+
+        JUCE_DECLARE_NON_COPYABLE (PropertyCache)
+    };
+
     //==============================================================================
     struct CodeLocation
     {
@@ -137,11 +177,12 @@ struct JavascriptEngine::RootObject   : public DynamicObject
         ReferenceCountedObjectPtr<RootObject> root;
         DynamicObject::Ptr scope;
 
-        var findFunctionCall (const CodeLocation& location, const var& targetObject, const Identifier& functionName) const
+        var findFunctionCall (const CodeLocation& location, const var& targetObject, const Identifier& functionName,
+                              const PropertyCache& methodCache, const PropertyCache& classCache) const
         {
             if (auto* o = targetObject.getDynamicObject())
             {
-                if (auto* prop = getPropertyPointer (o, functionName))
+                if (auto* prop = methodCache.find (*o, functionName))
                     return *prop;
 
                 for (auto* p = o->getProperty (getPrototypeIdentifier()).getDynamicObject(); p != nullptr;
@@ -157,35 +198,37 @@ struct JavascriptEngine::RootObject   : public DynamicObject
             }
 
             if (targetObject.isString())
-                if (auto* m = findRootClassProperty (StringClass::getClassName(), functionName))
+                if (auto* m = findRootClassProperty (StringClass::getClassName(), functionName, methodCache, classCache))
                     return *m;
 
             if (targetObject.isArray())
-                if (auto* m = findRootClassProperty (ArrayClass::getClassName(), functionName))
+                if (auto* m = findRootClassProperty (ArrayClass::getClassName(), functionName, methodCache, classCache))
                     return *m;
 
-            if (auto* m = findRootClassProperty (ObjectClass::getClassName(), functionName))
+            if (auto* m = findRootClassProperty (ObjectClass::getClassName(), functionName, methodCache, classCache))
                 return *m;
 
             location.throwError ("Unknown function '" + functionName.toString() + "'");
             return {};
         }
 
-        var* findRootClassProperty (const Identifier& className, const Identifier& propName) const
+        var* findRootClassProperty (const Identifier& className, const Identifier& propName,
+                                    const PropertyCache& methodCache, const PropertyCache& classCache) const
         {
-            if (auto* cls = root->getProperty (className).getDynamicObject())
-                return getPropertyPointer (cls, propName);
+            if (auto* cls = classCache.find (*root, className))
+                if (auto* o = cls->getDynamicObject())
+                    return methodCache.find (*o, propName);
 
             return nullptr;
         }
 
-        var findSymbolInParentScopes (const Identifier& name) const
+        var findSymbolInParentScopes (const Identifier& name, const PropertyCache& cache) const
         {
-            if (auto* v = getPropertyPointer (scope, name))
-                return *v;
+            for (auto* s = this; s != nullptr; s = s->parent)
+                if (auto* v = cache.find (*s->scope, name))
+                    return *v;
 
-            return parent != nullptr ? parent->findSymbolInParentScopes (name)
-                                     : var::undefined();
+            return var::undefined();
         }
 
         bool findAndInvokeMethod (const Identifier& function, const var::NativeFunctionArgs& args, var& result) const
@@ -235,6 +278,13 @@ struct JavascriptEngine::RootObject   : public DynamicObject
 
         void checkTimeOut (const CodeLocation& location) const
         {
+            // Reading the clock takes longer than running a simple loop iteration, so
+            // this only looks at it every few calls.
+            if (--(root->timeoutCheckCountdown) > 0)
+                return;
+
+            root->timeoutCheckCountdown = 16;
+
             if (Time::getCurrentTime() > root->timeout)
                 location.throwError (root->timeout == Time() ? "Interrupted" : "Execution timed-out");
         }
@@ -374,17 +424,18 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     {
         UnqualifiedName (const CodeLocation& l, const Identifier& n) noexcept : Expression (l), name (n) {}
 
-        var getResult (const Scope& s) const override  { return s.findSymbolInParentScopes (name); }
+        var getResult (const Scope& s) const override  { return s.findSymbolInParentScopes (name, cache); }
 
         void assign (const Scope& s, const var& newValue) const override
         {
-            if (auto* v = getPropertyPointer (s.scope, name))
+            if (auto* v = cache.find (*s.scope, name))
                 *v = newValue;
             else
                 s.root->setProperty (name, newValue);
         }
 
         Identifier name;
+        PropertyCache cache;
     };
 
     struct DotOperator  : public Expression
@@ -403,7 +454,7 @@ struct JavascriptEngine::RootObject   : public DynamicObject
             }
 
             if (auto* o = p.getDynamicObject())
-                if (auto* v = getPropertyPointer (o, child))
+                if (auto* v = cache.find (*o, child))
                     return *v;
 
             return var::undefined();
@@ -419,6 +470,7 @@ struct JavascriptEngine::RootObject   : public DynamicObject
 
         ExpPtr parent;
         Identifier child;
+        PropertyCache cache;
     };
 
     struct ArraySubscript  : public Expression
@@ -499,6 +551,10 @@ struct JavascriptEngine::RootObject   : public DynamicObject
         {
             var a (lhs->getResult (s)), b (rhs->getResult (s));
 
+            // (quick checks for the most common cases before working through all the type rules)
+            if ((a.isInt() || a.isInt64()) && (b.isInt() || b.isInt64()))  return getWithInts (a, b);
+            if (a.isDouble() && b.isDouble())                              return getWithDoubles (a, b);
+
             if ((a.isUndefined() || a.isVoid()) && (b.isUndefined() || b.isVoid()))
                 return getWithUndefinedArg();
 
@@ -724,7 +780,7 @@ struct JavascriptEngine::RootObject   : public DynamicObject
             if (auto* dot = dynamic_cast<DotOperator*> (object.get()))
             {
                 auto thisObject = dot->parent->getResult (s);
-                return invokeFunction (s, s.findFunctionCall (location, thisObject, dot->child), thisObject);
+                return invokeFunction (s, s.findFunctionCall (location, thisObject, dot->child, methodCache, classCache), thisObject);
             }
 
             auto function = object->getResult (s);
@@ -757,6 +813,7 @@ struct JavascriptEngine::RootObject   : public DynamicObject
 
         ExpPtr object;
         OwnedArray<Expression> arguments;
+        PropertyCache methodCache, classCache;
     };
 
     struct NewOperator  : public FunctionCall
@@ -1899,4 +1956,129 @@ const NamedValueSet& JavascriptEngine::getRootObjectProperties() const noexcept
  #pragma warning (pop)
 #endif
 
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class JavascriptEngineTests  : public UnitTest
+{
+public:
+    JavascriptEngineTests() : UnitTest ("JavascriptEngine", "Javascript") {}
+
+    void runTest() override
+    {
+        beginTest ("Name lookups");
+        {
+            expectResult ("var a = 1; function f() { var a = 2; return a; } var result = a * 10 + f();", "12");
+
+            // (functions can see their callers' variables, so the same name can come from a different scope each time)
+            expectResult ("var x = 1; function g() { return x; } function h() { var x = 5; return g(); }"
+                          "var result = g() + h() * 10 + g() * 100;", "151");
+
+            expectResult ("function f() { z = 3; } f(); var result = z;", "3");
+        }
+
+        beginTest ("Property lookups");
+        {
+            expectResult ("function getY (o) { return o.y; } var a = { x: 1, y: 2 }; var b = { y: 3 }; var c = { z: 0, w: 0, y: 4 };"
+                          "var result = \"\" + getY (a) + getY (b) + getY (c) + getY (a) + typeof (getY ({ x: 0 }));", "2342undefined");
+
+            expectResult ("var o = { a: 1, b: 2 }; function setB (p, v) { p.b = v; } setB (o, 5);"
+                          "var p = { b: 1 }; setB (p, 7); var result = o.b * 10 + p.b;", "57");
+
+            expectResult ("var result = 0; for (var i = 0; i < 10; ++i) { var o = (i % 2 == 0) ? { a: i } : { b: 0, a: -i }; result += o.a; }", "-5");
+        }
+
+        beginTest ("Method lookups");
+        {
+            expectResult ("function idx (x, y) { return x.indexOf (y); }"
+                          "var result = idx (\"abc\", \"c\") * 10 + idx ([1, 2, 3], 2) + \"abc\".length * 100 + [1, 2].length * 1000;", "2321");
+
+            expectResult ("var base = { f: function() { return 7; } }; var o = new base(); var p = { f: function() { return 2; } };"
+                          "function call (x) { return x.f(); } var result = call (o) * 10 + call (p) + call (o) * 100;", "772");
+        }
+
+        beginTest ("Arithmetic");
+        {
+            expectResult ("var i = 3000000000; var result = (i + 1) + \", \" + (2.5 * 2) + \", \" + (7 / 2) + \", \" + (1 + 0.5) + \", \" + (i * 2 > i);",
+                          "3000000001, 5, 3.5, 1.5, 1");
+        }
+
+        beginTest ("Timeouts");
+        {
+            JavascriptEngine engine;
+            engine.maximumExecutionTime = RelativeTime::milliseconds (20);
+            auto r = engine.execute ("var i = 0; while (true) ++i;");
+            expect (r.getErrorMessage().contains ("timed-out"));
+        }
+
+        beginTest ("Benchmark");
+        {
+            static const char* const scripts[][2] =
+            {
+                { "Numeric loop",       "var sum = 0; for (var i = 0; i < 300000; ++i) { sum += i * 2 - (i % 7); }" },
+
+                { "Function calls",     "function fib (n) { return n < 2 ? n : fib (n - 1) + fib (n - 2); } var r = fib (20);" },
+
+                { "Local variables",    "function f (n) { var a = 0, b = 1; for (var i = 0; i < n; ++i) { var t = a + b; a = b; b = t % 1000; } return b; }"
+                                        "var r = f (200000);" },
+
+                { "Object properties",  "var o = { x: 1, y: 2, z: 3, w: 4 }; for (var i = 0; i < 100000; ++i) { o.x = o.y + o.z; o.w = o.x * 2; o.y = i; }" },
+
+                { "Method calls",       "var s = 0; for (var i = 0; i < 100000; ++i) { s += Math.abs (Math.sin (i)) + Math.min (i, 5); }" },
+
+                { "Arrays",             "var a = []; for (var i = 0; i < 50000; ++i) a.push (i); var t = 0; for (var i = 0; i < a.length; ++i) t += a[i];" },
+
+                { "Preset macro",       "var preset = { gain: 0.5, cutoff: 1000, res: 0.2, params: [] };"
+                                        "function setParam (p, name, value) { p.params.push ({ name: name, value: value }); return value; }"
+                                        "function scale (v, lo, hi) { return lo + (hi - lo) * v; }"
+                                        "for (var i = 0; i < 20000; ++i) { preset.gain = scale (i / 20000, 0, 2); preset.cutoff = scale (preset.gain, 20, 20000);"
+                                        "  if (i % 100 == 0) setParam (preset, \"p\" + i, preset.cutoff); }" },
+
+                { "UI logic",           "var width = 400, height = 300, margin = 4, rows = 8, cols = 4, selected = 3, hover = -1, scale = 1.5;"
+                                        "var colours = { background: 0xff202020, text: 0xffe0e0e0, highlight: 0xff3060c0, outline: 0xff808080 };"
+                                        "function cellX (c) { return margin + c * ((width - margin * 2) / cols); }"
+                                        "function cellY (r) { return margin + r * ((height - margin * 2) / rows); }"
+                                        "function colourFor (index) { return index == selected ? colours.highlight : (index == hover ? colours.outline : colours.background); }"
+                                        "var total = 0;"
+                                        "for (var frame = 0; frame < 400; ++frame) { hover = frame % (rows * cols);"
+                                        "  for (var r = 0; r < rows; ++r) for (var c = 0; c < cols; ++c) total += cellX (c) * scale + cellY (r) + (colourFor (r * cols + c) & 0xff); }" }
+            };
+
+            for (auto& script : scripts)
+            {
+                double bestTime = 0;
+
+                for (int i = 0; i < 5; ++i)
+                {
+                    JavascriptEngine engine;
+                    engine.maximumExecutionTime = RelativeTime::seconds (100);
+
+                    auto start = Time::getMillisecondCounterHiRes();
+                    auto r = engine.execute (script[1]);
+                    auto elapsed = Time::getMillisecondCounterHiRes() - start;
+
+                    expect (r.wasOk(), r.getErrorMessage());
+                    bestTime = (i == 0 ? elapsed : jmin (bestTime, elapsed));
+                }
+
+                logMessage (String (script[0]) + ": " + String (bestTime, 1) + " ms");
+            }
+        }
+    }
+
+    void expectResult (const String& code, const String& expectedResult)
+    {
+        JavascriptEngine engine;
+        auto r = engine.execute (code);
+
+        expect (r.wasOk(), r.getErrorMessage());
+        expectEquals (engine.evaluate ("result").toString(), expectedResult);
+    }
+};
+
+static JavascriptEngineTests javascriptEngineTests;
+
+#endif
+
 } // namespace juce
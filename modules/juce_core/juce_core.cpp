@@ -40,6 +40,10 @@
 #include <cctype>
 #include <cstdarg>
 
+#if JUCE_INTEL
+ #include <immintrin.h>
+#endif
+
 #if ! JUCE_ANDROID
  #include <sys/timeb.h>
  #include <cwctype>
@@ -117,6 +121,10 @@
 #endif
 
 //==============================================================================
+#if JUCE_UNIT_TESTS
+ #include "unit_tests/juce_ChunkedTestInputStream.h"
+#endif
+
 #include "containers/juce_AbstractFifo.cpp"
 #include "containers/juce_NamedValueSet.cpp"
 #include "containers/juce_ListenerList.cpp"
@@ -129,10 +137,13 @@
 #include "files/juce_FileSearchPath.cpp"
 #include "files/juce_TemporaryFile.cpp"
 #include "javascript/juce_JSON.cpp"
+#include "javascript/juce_JSONPullParser.cpp"
+#include "javascript/juce_JSONWriter.cpp"
 #include "javascript/juce_Javascript.cpp"
 #include "containers/juce_DynamicObject.cpp"
 #include "logging/juce_FileLogger.cpp"
 #include "logging/juce_Logger.cpp"
+#include "logging/juce_AsyncFileLogger.cpp"
 #include "maths/juce_BigInteger.cpp"
 #include "maths/juce_Expression.cpp"
 #include "maths/juce_Random.cpp"
@@ -146,6 +157,7 @@
 #include "network/juce_Socket.cpp"
 #include "network/juce_IPAddress.cpp"
 #include "streams/juce_BufferedInputStream.cpp"
+#include "streams/juce_ChunkedMemoryOutputStream.cpp"
 #include "streams/juce_FileInputSource.cpp"
 #include "streams/juce_InputStream.cpp"
 #include "streams/juce_MemoryInputStream.cpp"
@@ -160,11 +172,14 @@
 #include "text/juce_StringArray.cpp"
 #include "text/juce_StringPairArray.cpp"
 #include "text/juce_StringPool.cpp"
+#include "text/juce_StringArena.cpp"
 #include "text/juce_TextDiff.cpp"
 #include "text/juce_Base64.cpp"
 #include "threads/juce_ReadWriteLock.cpp"
 #include "threads/juce_Thread.cpp"
 #include "threads/juce_ThreadPool.cpp"
+#include "threads/juce_TaskScheduler.cpp"
+#include "threads/juce_RealtimeThreadPool.cpp"
 #include "threads/juce_TimeSliceThread.cpp"
 #include "time/juce_PerformanceCounter.cpp"
 #include "time/juce_RelativeTime.cpp"
@@ -172,11 +187,15 @@
 #include "unit_tests/juce_UnitTest.cpp"
 #include "xml/juce_XmlDocument.cpp"
 #include "xml/juce_XmlElement.cpp"
+#include "xml/juce_XmlPullParser.cpp"
 #include "zip/juce_GZIPDecompressorInputStream.cpp"
 #include "zip/juce_GZIPCompressorOutputStream.cpp"
 #include "zip/juce_ZipFile.cpp"
 #include "files/juce_FileFilter.cpp"
 #include "files/juce_WildcardFileFilter.cpp"
+#include "files/juce_AsyncFile.cpp"
+#include "files/juce_DirectoryScanner.cpp"
+#include "files/juce_ReadAheadFileInputStream.cpp"
 
 //==============================================================================
 #if ! JUCE_WINDOWS
@@ -231,6 +250,7 @@
 //==============================================================================
 #if JUCE_UNIT_TESTS
 #include "containers/juce_HashMap_test.cpp"
+#include "containers/juce_LockFreeQueue_test.cpp"
 #endif
 
 //==============================================================================
@@ -241,8 +241,12 @@ namespace juce
 #include "containers/juce_SortedSet.h"
 #include "containers/juce_SparseSet.h"
 #include "containers/juce_AbstractFifo.h"
+#include "containers/juce_LockFreeFifo.h"
+#include "containers/juce_LockFreeQueue.h"
+#include "containers/juce_LockFreeMessageQueue.h"
 #include "text/juce_NewLine.h"
 #include "text/juce_StringPool.h"
+#include "text/juce_StringArena.h"
 #include "text/juce_Identifier.h"
 #include "text/juce_StringArray.h"
 #include "text/juce_StringPairArray.h"
@@ -254,6 +258,7 @@ namespace juce
 #include "containers/juce_NamedValueSet.h"
 #include "containers/juce_DynamicObject.h"
 #include "containers/juce_HashMap.h"
+#include "containers/juce_FlatHashMap.h"
 #include "time/juce_RelativeTime.h"
 #include "time/juce_Time.h"
 #include "streams/juce_InputStream.h"
@@ -261,6 +266,7 @@ namespace juce
 #include "streams/juce_BufferedInputStream.h"
 #include "streams/juce_MemoryInputStream.h"
 #include "streams/juce_MemoryOutputStream.h"
+#include "streams/juce_ChunkedMemoryOutputStream.h"
 #include "streams/juce_SubregionStream.h"
 #include "streams/juce_InputSource.h"
 #include "files/juce_File.h"
@@ -275,6 +281,8 @@ namespace juce
 #include "streams/juce_FileInputSource.h"
 #include "logging/juce_FileLogger.h"
 #include "javascript/juce_JSON.h"
+#include "javascript/juce_JSONPullParser.h"
+#include "javascript/juce_JSONWriter.h"
 #include "javascript/juce_Javascript.h"
 #include "maths/juce_BigInteger.h"
 #include "maths/juce_Expression.h"
@@ -292,6 +300,8 @@ namespace juce
 #include "threads/juce_Thread.h"
 #include "threads/juce_ThreadLocalValue.h"
 #include "threads/juce_ThreadPool.h"
+#include "threads/juce_TaskScheduler.h"
+#include "threads/juce_RealtimeThreadPool.h"
 #include "threads/juce_TimeSliceThread.h"
 #include "threads/juce_ReadWriteLock.h"
 #include "threads/juce_ScopedReadLock.h"
@@ -307,9 +317,14 @@ namespace juce
 #include "unit_tests/juce_UnitTest.h"
 #include "xml/juce_XmlDocument.h"
 #include "xml/juce_XmlElement.h"
+#include "xml/juce_XmlPullParser.h"
 #include "zip/juce_GZIPCompressorOutputStream.h"
 #include "zip/juce_GZIPDecompressorInputStream.h"
 #include "zip/juce_ZipFile.h"
+#include "files/juce_AsyncFile.h"
+#include "files/juce_DirectoryScanner.h"
+#include "files/juce_ReadAheadFileInputStream.h"
+#include "logging/juce_AsyncFileLogger.h"
 #include "containers/juce_PropertySet.h"
 #include "memory/juce_SharedResourcePointer.h"
 
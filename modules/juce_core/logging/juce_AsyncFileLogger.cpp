@@ -0,0 +1,493 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+// Each thread that logs gets one of these. Its messages are stored in the FIFO as plain
+// UTF-8 text, each with its newline already added, so the writer thread can copy
+// whatever is there straight into the file. A message is only made visible to the
+// writer once all of it has been copied in, so the writer never sees half a message.
+// When its thread releases it, a buffer is marked as free and can be claimed by another
+// thread, which simply carries on appending after any messages that are still waiting.
+struct AsyncFileLogger::ThreadBuffer
+{
+    ThreadBuffer (int size) : fifo (size) {}
+
+    LockFreeFifo<char> fifo;
+    ThreadBuffer* next = nullptr;
+    Atomic<int> isFree;
+
+    JUCE_DECLARE_NON_COPYABLE (ThreadBuffer)
+};
+
+//==============================================================================
+AsyncFileLogger::AsyncFileLogger (const File& file, const String& welcomeMessage,
+                                  int64 maxFileSizeBytes, int numOldFiles,
+                                  int bufferSizePerThread, int writeIntervalMs)
+    : Thread ("AsyncFileLogger"),
+      logFile (file),
+      maxFileSize (maxFileSizeBytes),
+      maxNumOldFiles (jmax (0, numOldFiles)),
+      bufferSize (jmax (256, bufferSizePerThread)),
+      writeInterval (jmax (1, writeIntervalMs))
+{
+    if (! file.exists())
+        file.create();  // (to create the parent directories)
+
+    stream = new FileOutputStream (logFile, 16384);
+
+    String welcome;
+    welcome << newLine
+            << "**********************************************************" << newLine
+            << welcomeMessage << newLine
+            << "Log started: " << Time::getCurrentTime().toString (true, true) << newLine;
+
+    batch << welcome;
+    writeWaitingMessages();
+
+    startThread (3);
+}
+
+AsyncFileLogger::~AsyncFileLogger()
+{
+    signalThreadShouldExit();
+    notify();
+    stopThread (-1);
+    writeWaitingMessages();
+
+    for (auto* b = firstBuffer.get(); b != nullptr;)
+    {
+        auto* next = b->next;
+        delete b;
+        b = next;
+    }
+}
+
+File AsyncFileLogger::getOldLogFile (int index) const
+{
+    return logFile.getSiblingFile (logFile.getFileNameWithoutExtension() + "_" + String (index)
+                                     + logFile.getFileExtension());
+}
+
+//==============================================================================
+AsyncFileLogger::ThreadBuffer* AsyncFileLogger::getBufferForCurrentThread()
+{
+    auto& b = currentThreadBuffer.get();
+
+    if (b != nullptr)
+        return b;
+
+    for (auto* candidate = firstBuffer.get(); candidate != nullptr; candidate = candidate->next)
+    {
+        if (candidate->isFree.compareAndSetBool (0, 1))
+        {
+            b = candidate;
+            return b;
+        }
+    }
+
+    if (++numBuffers > maxNumThreadBuffers)
+    {
+        --numBuffers;
+        return nullptr;
+    }
+
+    b = new ThreadBuffer (bufferSize);
+
+    do { b->next = firstBuffer.get(); }
+    while (! firstBuffer.compareAndSetBool (b, b->next));
+
+    return b;
+}
+
+void AsyncFileLogger::releaseBufferForCurrentThread()
+{
+    auto& b = currentThreadBuffer.get();
+
+    if (b != nullptr)
+    {
+        b->isFree = 1;
+        b = nullptr;
+    }
+
+    currentThreadBuffer.releaseCurrentThreadStorage();
+}
+
+void AsyncFileLogger::logMessage (const String& message)
+{
+    auto* buffer = getBufferForCurrentThread();
+
+    if (buffer == nullptr)
+    {
+        ++numDropped;
+        ++totalNumDropped;
+        return;
+    }
+
+    auto& fifo = buffer->fifo;
+
+    auto text = message.toUTF8();
+    auto textSize = (int) text.sizeInBytes() - 1;
+    auto lineEnd = newLine.getDefault();
+    auto lineEndSize = (int) strlen (lineEnd);
+    auto totalSize = textSize + lineEndSize;
+
+    auto span = fifo.prepareToWrite (totalSize);
+
+    if (span.getTotalSize() < totalSize)
+    {
+        ++numDropped;
+        ++totalNumDropped;
+        return;
+    }
+
+    auto copyIntoSpan = [&span] (int offset, const char* source, int num)
+    {
+        auto num1 = jlimit (0, num, span.size1 - offset);
+        memcpy (span.data1 + offset, source, (size_t) num1);
+        memcpy (span.data2 + jmax (0, offset - span.size1), source + num1, (size_t) (num - num1));
+    };
+
+    copyIntoSpan (0, text.getAddress(), textSize);
+    copyIntoSpan (textSize, lineEnd, lineEndSize);
+    fifo.finishedWrite (totalSize);
+}
+
+void AsyncFileLogger::flush()
+{
+    const ScopedLock sl (flushLock);
+
+    auto target = ++numFlushesRequested;
+    notify();
+
+    while (numFlushesDone.get() < target && isThreadRunning())
+        flushDone.wait (100);
+}
+
+//==============================================================================
+void AsyncFileLogger::run()
+{
+    while (! threadShouldExit())
+    {
+        wait (writeInterval);
+
+        // (everything logged before a flush was requested must be in the buffers by now)
+        auto numRequested = numFlushesRequested.get();
+        writeWaitingMessages();
+
+        numFlushesDone = numRequested;
+        flushDone.signal();
+    }
+}
+
+void AsyncFileLogger::writeWaitingMessages()
+{
+    for (auto* b = firstBuffer.get(); b != nullptr; b = b->next)
+    {
+        auto span = b->fifo.prepareToRead (b->fifo.getCapacity());
+        batch.write (span.data1, (size_t) span.size1);
+        batch.write (span.data2, (size_t) span.size2);
+        b->fifo.finishedRead (span.getTotalSize());
+    }
+
+    auto dropped = numDropped.exchange (0);
+
+    if (dropped > 0)
+        batch << "(" << dropped << " messages were dropped because the log buffer was full)" << newLine;
+
+    if (batch.getDataSize() == 0)
+        return;
+
+    if (maxFileSize > 0 && stream != nullptr && stream->getPosition() > 0
+         && stream->getPosition() + (int64) batch.getDataSize() > maxFileSize)
+        startNewFile();
+
+    if (stream != nullptr && stream->openedOk())
+    {
+        stream->write (batch.getData(), batch.getDataSize());
+        stream->flush();
+    }
+
+    batch.reset();
+}
+
+void AsyncFileLogger::startNewFile()
+{
+    stream = nullptr;
+
+    if (maxNumOldFiles > 0)
+    {
+        getOldLogFile (maxNumOldFiles).deleteFile();
+
+        for (int i = maxNumOldFiles; --i > 0;)
+            getOldLogFile (i).moveFileTo (getOldLogFile (i + 1));
+
+        logFile.moveFileTo (getOldLogFile (1));
+    }
+
+    logFile.deleteFile();
+    stream = new FileOutputStream (logFile, 16384);
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct AsyncFileLoggerTests  : public UnitTest
+{
+    AsyncFileLoggerTests()  : UnitTest ("AsyncFileLogger", "Logging") {}
+
+    struct LoggingThread  : public Thread
+    {
+        LoggingThread (std::function<void (const String&)> l, int i, int num, WaitableEvent& go)
+            : Thread ("Logging " + String (i)), logMessage (l), index (i), numMessages (num), startEvent (go) {}
+
+        void run() override
+        {
+            String message;
+            startEvent.wait();
+
+            for (int i = 0; i < numMessages; ++i)
+            {
+                message = "thread " + String (index) + " message " + String (i);
+                logMessage (message);
+            }
+        }
+
+        std::function<void (const String&)> logMessage;
+        const int index, numMessages;
+        WaitableEvent& startEvent;
+    };
+
+    // (Logger::logMessage is protected, so this is templated on the type of logger)
+    template <typename LoggerType>
+    static double timeLogging (LoggerType& logger, int numThreads, int numMessagesPerThread)
+    {
+        OwnedArray<LoggingThread> threads;
+        WaitableEvent startEvent (true);
+
+        for (int i = 0; i < numThreads; ++i)
+            threads.add (new LoggingThread ([&logger] (const String& m) { logger.logMessage (m); },
+                                            i, numMessagesPerThread, startEvent));
+
+        // (the threads all wait until they've been started, so that they run at the same time)
+        for (auto* t : threads)
+            t->startThread();
+
+        auto start = Time::getMillisecondCounterHiRes();
+        startEvent.signal();
+
+        for (auto* t : threads)
+            t->stopThread (-1);
+
+        return Time::getMillisecondCounterHiRes() - start;
+    }
+
+    static StringArray readAllLines (const File& file)
+    {
+        StringArray lines;
+        lines.addLines (file.loadFileAsString());
+        lines.removeEmptyStrings();
+        return lines;
+    }
+
+    void runTest() override
+    {
+        auto folder = File::getSpecialLocation (File::tempDirectory).getNonexistentChildFile ("juce_AsyncFileLoggerTests", {}, false);
+        auto logFile = folder.getChildFile ("log.txt");
+
+        beginTest ("Logging from several threads");
+        {
+            const int numThreads = 4, numMessages = 2000;
+
+            {
+                AsyncFileLogger logger (logFile, "Welcome", -1, 3, 1024 * 1024);
+                timeLogging (logger, numThreads, numMessages);
+                logger.logMessage ("last message");
+                logger.flush();
+
+                expect (readAllLines (logFile).contains ("last message"));
+                expectEquals (logger.getNumDroppedMessages(), 0);
+            }
+
+            auto lines = readAllLines (logFile);
+            expect (lines.contains ("Welcome"));
+
+            // Each thread's messages must all be there, in order
+            for (int t = 0; t < numThreads; ++t)
+            {
+                auto prefix = "thread " + String (t) + " message ";
+                int next = 0;
+
+                for (auto& line : lines)
+                    if (line.startsWith (prefix) && line.fromFirstOccurrenceOf (prefix, false, false).getIntValue() == next)
+                        ++next;
+
+                expectEquals (next, numMessages);
+            }
+
+            logFile.deleteFile();
+        }
+
+        beginTest ("Full buffers");
+        {
+            AsyncFileLogger logger (logFile, "Welcome", -1, 3, 256, 100000);
+
+            for (int i = 0; i < 100; ++i)
+                logger.logMessage ("message " + String (i));
+
+            expect (logger.getNumDroppedMessages() > 0);
+            logger.flush();
+
+            auto lines = readAllLines (logFile);
+            expect (lines[lines.size() - 1].contains ("messages were dropped"));
+            // (the welcome message is 3 lines, and there's a line saying how many were dropped)
+            expectEquals (lines.size() - 4 + logger.getNumDroppedMessages(), 100);
+
+            logger.logMessage ("after");
+            logger.flush();
+            expectEquals (readAllLines (logFile).strings.getLast(), String ("after"));
+        }
+
+        logFile.deleteFile();
+
+        beginTest ("Rotation");
+        {
+            const int numMessages = 5000;
+
+            {
+                AsyncFileLogger logger (logFile, "Welcome", 20000, 2, 65536, 1);
+
+                for (int i = 0; i < numMessages; ++i)
+                {
+                    logger.logMessage ("message " + String (i));
+
+                    if (i % 100 == 0)
+                        logger.flush();
+                }
+            }
+
+            expect (logFile.getSize() <= 20000);
+            expect (isValidOldLogFile (logFile.getSiblingFile ("log_1.txt")));
+            expect (isValidOldLogFile (logFile.getSiblingFile ("log_2.txt")));
+            expect (! logFile.getSiblingFile ("log_3.txt").exists());
+
+            // the most recent messages should all be there, in order
+            StringArray lines;
+
+            for (auto& f : { logFile.getSiblingFile ("log_2.txt"), logFile.getSiblingFile ("log_1.txt"), logFile })
+                for (auto& line : readAllLines (f))
+                    if (line.startsWith ("message "))
+                        lines.add (line);
+
+            expect (lines.size() > 1000);
+
+            for (int i = 0; i < lines.size(); ++i)
+                expectEquals (lines[i], "message " + String (numMessages - lines.size() + i));
+        }
+
+        logFile.deleteFile();
+
+        beginTest ("Reusing the buffers of finished threads");
+        {
+            // more threads than there can be buffers, but only a few running at a time
+            const int numThreads = AsyncFileLogger::maxNumThreadBuffers + 100, numAtOnce = 8;
+
+            {
+                AsyncFileLogger logger (logFile, "Welcome", -1);
+
+                auto logAndRelease = [&logger] (const String& m)
+                {
+                    logger.logMessage (m);
+                    logger.releaseBufferForCurrentThread();
+                };
+
+                for (int start = 0; start < numThreads; start += numAtOnce)
+                {
+                    OwnedArray<LoggingThread> threads;
+                    WaitableEvent startEvent (true);
+
+                    for (int i = start; i < jmin (numThreads, start + numAtOnce); ++i)
+                        threads.add (new LoggingThread (logAndRelease, i, 1, startEvent));
+
+                    for (auto* t : threads)
+                        t->startThread();
+
+                    startEvent.signal();
+
+                    for (auto* t : threads)
+                        t->stopThread (-1);
+                }
+
+                logger.flush();
+                expectEquals (logger.getNumDroppedMessages(), 0);
+            }
+
+            auto lines = readAllLines (logFile);
+
+            for (int i = 0; i < numThreads; ++i)
+                expect (lines.contains ("thread " + String (i) + " message 0"));
+        }
+
+        beginTest ("Benchmark");
+        {
+            for (auto numThreads : { 1, 4, 8 })
+            {
+                double fileLoggerTime, asyncTime;
+                const int numFileLoggerMessages = 200, numAsyncMessages = 20000;
+                int numDropped;
+
+                {
+                    logFile.deleteFile();
+                    FileLogger logger (logFile, "Welcome", -1);
+                    fileLoggerTime = timeLogging (logger, numThreads, numFileLoggerMessages);
+                }
+
+                {
+                    logFile.deleteFile();
+                    AsyncFileLogger logger (logFile, "Welcome", -1, 3, 1024 * 1024);
+                    asyncTime = timeLogging (logger, numThreads, numAsyncMessages);
+                    numDropped = logger.getNumDroppedMessages();
+                }
+
+                logMessage (String (numThreads) + " threads: FileLogger "
+                              + String ((int64) (numThreads * numFileLoggerMessages * 1000.0 / fileLoggerTime)) + " messages/s, AsyncFileLogger "
+                              + String ((int64) (numThreads * numAsyncMessages * 1000.0 / asyncTime)) + " messages/s ("
+                              + String (numDropped) + " dropped)");
+            }
+        }
+
+        folder.deleteRecursively();
+    }
+
+    static bool isValidOldLogFile (const File& f)
+    {
+        return f.existsAsFile() && f.getSize() > 0 && f.getSize() <= 20000;
+    }
+};
+
+static AsyncFileLoggerTests asyncFileLoggerTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,145 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A Logger that writes to a file on a background thread.
+
+    Unlike FileLogger, which locks and writes to the file each time a message is logged,
+    this copies each message into a lock-free buffer belonging to the calling thread,
+    and returns straight away. A background thread collects the messages from all the
+    buffers every so often and appends them to the file in one go. This means that
+    messages can be logged from many threads at once without them contending for a lock,
+    and from threads that mustn't block, such as an audio callback.
+
+    Logging a message never waits for anything. If a thread's buffer is full, its message
+    is dropped, and a note of the number of dropped messages is added to the log. The
+    first message that a thread logs allocates its buffer, so a realtime thread should
+    log something when it starts, before it needs to avoid allocating.
+
+    A thread's buffer isn't freed when the thread exits, so a thread which has finished
+    logging should call releaseBufferForCurrentThread(), after which its buffer can be
+    reused by another thread. At most maxNumThreadBuffers buffers are ever allocated;
+    once they're all in use, messages from any other threads are dropped.
+
+    Messages logged by one thread appear in the file in the order they were logged, but
+    those from different threads may be interleaved in batches.
+
+    When the file grows beyond a maximum size, it's renamed and a new file is started,
+    keeping a given number of old files, e.g. "MyLog.txt" is moved to "MyLog_1.txt", which
+    is moved to "MyLog_2.txt", and so on.
+
+    @see FileLogger, Logger
+*/
+class JUCE_API  AsyncFileLogger  : public Logger,
+                                   private Thread
+{
+public:
+    //==============================================================================
+    /** Creates an AsyncFileLogger for a given file.
+
+        @param fileToWriteTo        the file to use - new messages will be appended to the
+                                    file. If the file doesn't exist, it will be created, along
+                                    with any parent directories that are needed.
+        @param welcomeMessage       when opened, the logger will write a header to the log, along
+                                    with the current date and time, and this welcome message
+        @param maxFileSizeBytes     when the file grows beyond this size, it's moved aside and
+                                    a new one is started. If this is zero or less, the file can
+                                    grow indefinitely
+        @param maxNumOldFiles       the number of old log files to keep
+        @param bufferSizePerThread  the number of bytes of messages that each thread can
+                                    have waiting to be written
+        @param writeIntervalMs      how often the background thread writes the waiting messages
+    */
+    AsyncFileLogger (const File& fileToWriteTo,
+                     const String& welcomeMessage,
+                     int64 maxFileSizeBytes = 1024 * 1024,
+                     int maxNumOldFiles = 3,
+                     int bufferSizePerThread = 65536,
+                     int writeIntervalMs = 50);
+
+    /** Destructor.
+        Any messages that are still waiting will be written before the file is closed.
+    */
+    ~AsyncFileLogger();
+
+    //==============================================================================
+    /** Returns the file that this logger is writing to. */
+    const File& getLogFile() const noexcept               { return logFile; }
+
+    /** Returns the file that an older log will have been moved to, where 1 is the most
+        recent one.
+    */
+    File getOldLogFile (int index) const;
+
+    /** Waits until all the messages that have been logged so far have been written to the file. */
+    void flush();
+
+    /** Returns the number of messages which have been dropped because there wasn't space
+        for them.
+    */
+    int getNumDroppedMessages() const noexcept              { return totalNumDropped.get(); }
+
+    /** Called by a thread that won't log anything else, so that its buffer can be
+        reused by other threads. Any messages that are still waiting in it will be
+        written as normal.
+        @see ThreadLocalValue::releaseCurrentThreadStorage
+    */
+    void releaseBufferForCurrentThread();
+
+    /** The maximum number of threads which can have a buffer at the same time. */
+    static constexpr int maxNumThreadBuffers = 256;
+
+    // (implementation of the Logger virtual method)
+    void logMessage (const String&) override;
+
+private:
+    //==============================================================================
+    struct ThreadBuffer;
+
+    const File logFile;
+    const int64 maxFileSize;
+    const int maxNumOldFiles, bufferSize, writeInterval;
+
+    ThreadLocalValue<ThreadBuffer*> currentThreadBuffer;
+    Atomic<ThreadBuffer*> firstBuffer;
+    Atomic<int> numBuffers, numDropped, totalNumDropped;
+
+    ScopedPointer<FileOutputStream> stream;
+    MemoryOutputStream batch;
+
+    CriticalSection flushLock;
+    Atomic<int> numFlushesRequested, numFlushesDone;
+    WaitableEvent flushDone;
+
+    ThreadBuffer* getBufferForCurrentThread();
+    void run() override;
+    void writeWaitingMessages();
+    void startNewFile();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AsyncFileLogger)
+};
+
+} // namespace juce
@@ -50,6 +50,476 @@ int findHighestSetBit (uint32 n) noexcept
   #endif
 }
 
+//==============================================================================
+namespace
+{
+    // The multiplication and Montgomery code works on arrays of "limbs", which are 64 bits
+    // wide where the compiler has a 128-bit type to hold their products, and otherwise
+    // are the same 32-bit words that a BigInteger stores its value in.
+   #if (JUCE_GCC || JUCE_CLANG) && defined (__SIZEOF_INT128__)
+    typedef uint64 Limb;
+    __extension__ typedef unsigned __int128 DoubleLimb;
+   #else
+    typedef uint32 Limb;
+    typedef uint64 DoubleLimb;
+   #endif
+
+    enum
+    {
+        bitsPerLimb = (int) sizeof (Limb) * 8,
+        wordsPerLimb = (int) (sizeof (Limb) / sizeof (uint32)),
+        karatsubaThreshold = 48  // below this many limbs, schoolbook multiplication is faster
+    };
+
+    inline size_t limbsNeededToHold (int highestBit) noexcept    { return (size_t) (highestBit / bitsPerLimb) + 1; }
+
+    void copyToLimbs (Limb* dest, size_t numLimbs, const uint32* source, size_t numWords) noexcept
+    {
+        for (size_t i = 0; i < numLimbs; ++i)
+        {
+            Limb limb = 0;
+
+            for (auto j = (size_t) wordsPerLimb; j-- > 0;)
+            {
+                auto index = i * (size_t) wordsPerLimb + j;
+                limb = (Limb) ((DoubleLimb) limb << 32) | (index < numWords ? source[index] : 0);
+            }
+
+            dest[i] = limb;
+        }
+    }
+
+    void copyFromLimbs (uint32* dest, size_t numWords, const Limb* source) noexcept
+    {
+        for (size_t i = 0; i < numWords; ++i)
+            dest[i] = (uint32) (source[i / (size_t) wordsPerLimb] >> (32 * (i % (size_t) wordsPerLimb)));
+    }
+
+    int compareLimbs (const Limb* a, const Limb* b, size_t num) noexcept
+    {
+        while (num-- > 0)
+            if (a[num] != b[num])
+                return a[num] > b[num] ? 1 : -1;
+
+        return 0;
+    }
+
+    // result = a + b, returning the carry. The result may be the same array as a or b.
+    Limb addLimbs (Limb* result, const Limb* a, const Limb* b, size_t num) noexcept
+    {
+        Limb carry = 0;
+
+        for (size_t i = 0; i < num; ++i)
+        {
+            auto sum = (DoubleLimb) a[i] + b[i] + carry;
+            result[i] = (Limb) sum;
+            carry = (Limb) (sum >> bitsPerLimb);
+        }
+
+        return carry;
+    }
+
+    // result = a - b, returning the borrow. The result may be the same array as a or b.
+    Limb subtractLimbs (Limb* result, const Limb* a, const Limb* b, size_t num) noexcept
+    {
+        Limb borrow = 0;
+
+        for (size_t i = 0; i < num; ++i)
+        {
+            auto difference = (DoubleLimb) a[i] - b[i] - borrow;
+            result[i] = (Limb) difference;
+            borrow = (Limb) (difference >> bitsPerLimb) & 1;
+        }
+
+        return borrow;
+    }
+
+    // Adds a shorter array to a longer one, returning the carry out of the top of it.
+    Limb addInPlace (Limb* dest, size_t numDest, const Limb* source, size_t numSource) noexcept
+    {
+        auto carry = addLimbs (dest, dest, source, numSource);
+
+        for (auto i = numSource; carry != 0 && i < numDest; ++i)
+            carry = (++dest[i] == 0) ? 1 : 0;
+
+        return carry;
+    }
+
+    Limb subtractInPlace (Limb* dest, size_t numDest, const Limb* source, size_t numSource) noexcept
+    {
+        auto borrow = subtractLimbs (dest, dest, source, numSource);
+
+        for (auto i = numSource; borrow != 0 && i < numDest; ++i)
+            borrow = (dest[i]-- == 0) ? 1 : 0;
+
+        return borrow;
+    }
+
+    // dest += source * multiplier, returning the limb that carries out of the top of dest.
+    Limb multiplyAndAdd (Limb* dest, const Limb* source, size_t num, Limb multiplier) noexcept
+    {
+        Limb carry = 0;
+
+        for (size_t i = 0; i < num; ++i)
+        {
+            auto t = (DoubleLimb) source[i] * multiplier + dest[i] + carry;
+            dest[i] = (Limb) t;
+            carry = (Limb) (t >> bitsPerLimb);
+        }
+
+        return carry;
+    }
+
+    // The multiplication functions all take a result array with space for the sum of the
+    // sizes of their operands, which mustn't overlap either of them.
+    void multiplySchoolbook (Limb* result, const Limb* a, size_t numA, const Limb* b, size_t numB) noexcept
+    {
+        std::fill (result, result + numA, (Limb) 0);
+
+        for (size_t i = 0; i < numB; ++i)
+            result[numA + i] = multiplyAndAdd (result + i, a, numA, b[i]);
+    }
+
+    void squareSchoolbook (Limb* result, const Limb* a, size_t num) noexcept
+    {
+        // Each product of two different limbs appears twice in the square, so they're
+        // added up once and then doubled, before adding the squares of each limb.
+        std::fill (result, result + 2 * num, (Limb) 0);
+
+        for (size_t i = 0; i + 1 < num; ++i)
+            result[num + i] = multiplyAndAdd (result + 2 * i + 1, a + i + 1, num - i - 1, a[i]);
+
+        Limb carry = 0;
+
+        for (size_t i = 0; i < 2 * num; ++i)
+        {
+            auto topBit = result[i] >> (bitsPerLimb - 1);
+            result[i] = (Limb) (result[i] << 1) | carry;
+            carry = topBit;
+        }
+
+        carry = 0;
+
+        for (size_t i = 0; i < num; ++i)
+        {
+            auto square = (DoubleLimb) a[i] * a[i];
+            auto low  = (DoubleLimb) result[2 * i] + (Limb) square + carry;
+            auto high = (DoubleLimb) result[2 * i + 1] + (Limb) (square >> bitsPerLimb) + (Limb) (low >> bitsPerLimb);
+            result[2 * i] = (Limb) low;
+            result[2 * i + 1] = (Limb) high;
+            carry = (Limb) (high >> bitsPerLimb);
+        }
+    }
+
+    void multiplyLimbs (Limb* result, const Limb* a, size_t numA, const Limb* b, size_t numB);
+
+    // Karatsuba multiplication, for when b is longer than half of a.
+    // Splitting the operands into a = a1 * B^h + a0 and b = b1 * B^h + b0 means that
+    // a * b = z2 * B^2h + z1 * B^h + z0, where z0 = a0 * b0, z2 = a1 * b1, and
+    // z1 = (a0 + a1) * (b0 + b1) - z0 - z2, so only three half-sized products are needed.
+    void multiplyKaratsuba (Limb* result, const Limb* a, size_t numA, const Limb* b, size_t numB)
+    {
+        auto h = (numA + 1) / 2;
+        auto numA1 = numA - h, numB1 = numB - h;
+        jassert (numA >= numB && numB > h);
+
+        multiplyLimbs (result, a, h, b, h);
+        multiplyLimbs (result + 2 * h, a + h, numA1, b + h, numB1);
+
+        HeapBlock<Limb> temp (4 * h + 4);
+        auto* sumA = temp.get();
+        auto* sumB = sumA + h + 1;
+        auto* z1 = sumB + h + 1;
+
+        std::copy (a, a + h, sumA);
+        sumA[h] = addInPlace (sumA, h, a + h, numA1);
+        std::copy (b, b + h, sumB);
+        sumB[h] = addInPlace (sumB, h, b + h, numB1);
+
+        auto numZ1 = 2 * h + 2;
+        multiplyLimbs (z1, sumA, h + 1, sumB, h + 1);
+        subtractInPlace (z1, numZ1, result, 2 * h);
+        subtractInPlace (z1, numZ1, result + 2 * h, numA1 + numB1);
+
+        while (numZ1 > 0 && z1[numZ1 - 1] == 0)
+            --numZ1;
+
+        jassert (numZ1 <= numA + numB - h);
+        addInPlace (result + h, numA + numB - h, z1, numZ1);
+    }
+
+    void multiplyLimbs (Limb* result, const Limb* a, size_t numA, const Limb* b, size_t numB)
+    {
+        if (numA < numB)
+        {
+            std::swap (a, b);
+            std::swap (numA, numB);
+        }
+
+        if (numB < karatsubaThreshold)
+        {
+            multiplySchoolbook (result, a, numA, b, numB);
+        }
+        else if (numB > (numA + 1) / 2)
+        {
+            multiplyKaratsuba (result, a, numA, b, numB);
+        }
+        else
+        {
+            // when a is much longer than b, it gets multiplied in pieces the length of b
+            std::fill (result, result + numA + numB, (Limb) 0);
+            HeapBlock<Limb> product (2 * numB);
+
+            for (size_t i = 0; i < numA; i += numB)
+            {
+                auto num = jmin (numB, numA - i);
+                multiplyLimbs (product, a + i, num, b, numB);
+                addInPlace (result + i, numA + numB - i, product, num + numB);
+            }
+        }
+    }
+
+    void squareLimbs (Limb* result, const Limb* a, size_t num)
+    {
+        if (num < karatsubaThreshold)
+            squareSchoolbook (result, a, num);
+        else
+            multiplyKaratsuba (result, a, num, a, num);
+    }
+
+    //==============================================================================
+    // Knuth's algorithm D, which divides u by v one word at a time, rather than bit by bit.
+    // The top word of v must be non-zero, and u must be at least as long as v. The quotient
+    // has (numU - numV + 1) words and the remainder has numV words.
+    void divideWords (uint32* quotient, uint32* remainder,
+                      const uint32* u, size_t numU, const uint32* v, size_t numV)
+    {
+        jassert (numV > 0 && numU >= numV && v[numV - 1] != 0);
+
+        if (numV == 1)
+        {
+            uint64 r = 0;
+
+            for (auto i = numU; i-- > 0;)
+            {
+                auto n = (r << 32) | u[i];
+                quotient[i] = (uint32) (n / v[0]);
+                r = n % v[0];
+            }
+
+            remainder[0] = (uint32) r;
+            return;
+        }
+
+        // Shifting both values so that the top bit of v is set means that each guess at
+        // a word of the quotient is never more than 2 too big.
+        auto shift = 31 - findHighestSetBit (v[numV - 1]);
+        HeapBlock<uint32> un (numU + 1), vn (numV);
+
+        for (auto i = numV; --i > 0;)
+            vn[i] = (uint32) ((((uint64) v[i] << 32) | v[i - 1]) >> (32 - shift));
+
+        vn[0] = v[0] << shift;
+
+        un[numU] = (uint32) ((uint64) u[numU - 1] >> (32 - shift));
+
+        for (auto i = numU; --i > 0;)
+            un[i] = (uint32) ((((uint64) u[i] << 32) | u[i - 1]) >> (32 - shift));
+
+        un[0] = u[0] << shift;
+
+        auto topOfV = (uint64) vn[numV - 1];
+
+        for (auto j = numU - numV + 1; j-- > 0;)
+        {
+            auto top = ((uint64) un[j + numV] << 32) | un[j + numV - 1];
+            auto guess = top / topOfV;
+            auto r = top % topOfV;
+
+            while (guess > 0xffffffff || guess * vn[numV - 2] > ((r << 32) | un[j + numV - 2]))
+            {
+                --guess;
+                r += topOfV;
+
+                if (r > 0xffffffff)
+                    break;
+            }
+
+            uint64 carry = 0, borrow = 0;
+
+            for (size_t i = 0; i < numV; ++i)
+            {
+                auto product = guess * vn[i] + carry;
+                carry = product >> 32;
+
+                auto difference = (uint64) un[i + j] - (uint32) product - borrow;
+                un[i + j] = (uint32) difference;
+                borrow = difference >> 63;
+            }
+
+            auto difference = (uint64) un[j + numV] - carry - borrow;
+            un[j + numV] = (uint32) difference;
+
+            if ((difference >> 63) != 0)
+            {
+                // the guess was still one too big, so add v back on
+                --guess;
+                uint64 sum = 0;
+
+                for (size_t i = 0; i < numV; ++i)
+                {
+                    sum += (uint64) un[i + j] + vn[i];
+                    un[i + j] = (uint32) sum;
+                    sum >>= 32;
+                }
+
+                un[j + numV] += (uint32) sum;
+            }
+
+            quotient[j] = (uint32) guess;
+        }
+
+        for (size_t i = 0; i < numV; ++i)
+            remainder[i] = (uint32) ((((uint64) un[i + 1] << 32) | un[i]) >> shift);
+    }
+
+    //==============================================================================
+    // Montgomery multiplication, for modular exponentiation with an odd modulus m. Each value x
+    // is held as x * R mod m, where R = B^n for an n-limb modulus, and after each product the
+    // multiple of m which clears its lowest n limbs is added, so that it can be divided by R
+    // just by dropping them. This avoids any divisions by m.
+    struct MontgomeryContext
+    {
+        MontgomeryContext (const uint32* modulusWords, int modulusHighestBit)
+            : numLimbs (limbsNeededToHold (modulusHighestBit)),
+              modulus (numLimbs), product (2 * numLimbs + 1)
+        {
+            copyToLimbs (modulus, numLimbs, modulusWords, sizeNeededToHold (modulusHighestBit));
+            jassert ((modulus[0] & 1) != 0);
+
+            // Newton's iteration for 1 / m mod B, which doubles the number of correct bits
+            // each time, starting with 3 because m * m = 1 mod 8 for any odd m.
+            auto inverse = modulus[0];
+
+            for (int bits = 3; bits < bitsPerLimb; bits *= 2)
+                inverse = (Limb) (inverse * (Limb) (2 - modulus[0] * inverse));
+
+            negativeInverse = (Limb) (0 - inverse);
+        }
+
+        // result = a * b / R mod m. The result may be the same array as a or b.
+        void multiply (Limb* result, const Limb* a, const Limb* b)
+        {
+            if (a == b)
+                squareLimbs (product, a, numLimbs);
+            else
+                multiplyLimbs (product, a, numLimbs, b, numLimbs);
+
+            reduce (result);
+        }
+
+        // result = a / R mod m, which converts a value back from its Montgomery form
+        void convertBack (Limb* result, const Limb* a)
+        {
+            std::copy (a, a + numLimbs, product.get());
+            std::fill (product + numLimbs, product + 2 * numLimbs, (Limb) 0);
+            reduce (result);
+        }
+
+        // result = base ^ exponent, where base and one (R mod m) are in Montgomery form.
+        // This uses a sliding window, which looks at the exponent in chunks of up to
+        // windowBits, beginning and ending with a set bit, and multiplies by an odd power
+        // of the base from a table once per chunk, rather than once per set bit.
+        void exponentiate (Limb* result, const Limb* base, const Limb* one, const BigInteger& exponent)
+        {
+            auto numBits = exponent.getHighestBit() + 1;
+            auto windowBits = numBits > 671 ? 6 : (numBits > 239 ? 5 : (numBits > 79 ? 4 : (numBits > 23 ? 3 : 1)));
+
+            // table[i] = base ^ (2i + 1)
+            auto tableSize = (size_t) 1 << (windowBits - 1);
+            HeapBlock<Limb> table (tableSize * numLimbs), baseSquared (numLimbs);
+            std::copy (base, base + numLimbs, table.get());
+
+            if (tableSize > 1)
+            {
+                multiply (baseSquared, base, base);
+
+                for (size_t i = 1; i < tableSize; ++i)
+                    multiply (table + i * numLimbs, table + (i - 1) * numLimbs, baseSquared);
+            }
+
+            std::copy (one, one + numLimbs, result);
+            bool resultIsOne = true;
+
+            for (int i = numBits; --i >= 0;)
+            {
+                if (! exponent[i])
+                {
+                    if (! resultIsOne)
+                        multiply (result, result, result);
+
+                    continue;
+                }
+
+                auto start = jmax (0, i - windowBits + 1);
+
+                while (! exponent[start])
+                    ++start;
+
+                auto* power = table + (exponent.getBitRangeAsInt (start, i - start + 1) >> 1) * numLimbs;
+
+                if (resultIsOne)
+                {
+                    std::copy (power, power + numLimbs, result);
+                    resultIsOne = false;
+                }
+                else
+                {
+                    for (int j = start; j <= i; ++j)
+                        multiply (result, result, result);
+
+                    multiply (result, result, power);
+                }
+
+                i = start;
+            }
+        }
+
+        const size_t numLimbs;
+
+    private:
+        HeapBlock<Limb> modulus, product;
+        Limb negativeInverse;
+
+        // result = product / R mod m
+        void reduce (Limb* result) noexcept
+        {
+            Limb carry = 0;
+
+            for (size_t i = 0; i < numLimbs; ++i)
+            {
+                auto sum = (DoubleLimb) product[i + numLimbs] + carry
+                             + multiplyAndAdd (product + i, modulus, numLimbs, (Limb) (product[i] * negativeInverse));
+
+                product[i + numLimbs] = (Limb) sum;
+                carry = (Limb) (sum >> bitsPerLimb);
+            }
+
+            product[2 * numLimbs] = carry;
+
+            // the value is now less than 2m, so at most one more subtraction is needed
+            auto* top = product + numLimbs;
+
+            if (top[numLimbs] != 0 || compareLimbs (top, modulus, numLimbs) >= 0)
+                subtractLimbs (top, top, modulus, numLimbs);
+
+            std::copy (top, top + numLimbs, result);
+        }
+
+        JUCE_DECLARE_NON_COPYABLE (MontgomeryContext)
+    };
+}
+
 //==============================================================================
 BigInteger::BigInteger()
     : allocatedSize (numPreallocatedInts)
@@ -527,38 +997,39 @@ BigInteger& BigInteger::operator*= (const BigInteger& other)
     auto n = getHighestBit();
     auto t = other.getHighestBit();
 
-    auto wasNegative = isNegative();
-    setNegative (false);
-
-    BigInteger total;
-    total.highestBit = n + t + 1;
-    auto* totalValues = total.ensureSize (sizeNeededToHold (total.highestBit) + 1);
-
-    n >>= 5;
-    t >>= 5;
+    if (n < 0 || t < 0)
+    {
+        clear();
+        return *this;
+    }
 
-    auto m = other;
-    m.setNegative (false);
+    auto numA = limbsNeededToHold (n);
+    auto numB = limbsNeededToHold (t);
+    auto numLimbsNeeded = 2 * (numA + numB);
 
-    auto* mValues = m.getValues();
-    auto* values = getValues();
+    Limb localLimbs[16];
+    HeapBlock<Limb> heapLimbs;
+    auto* a = localLimbs;
 
-    for (int i = 0; i <= t; ++i)
+    if (numLimbsNeeded > (size_t) numElementsInArray (localLimbs))
     {
-        uint32 c = 0;
+        heapLimbs.malloc (numLimbsNeeded);
+        a = heapLimbs;
+    }
 
-        for (int j = 0; j <= n; ++j)
-        {
-            auto uv = (uint64) totalValues[i + j] + (uint64) values[j] * (uint64) mValues[i] + (uint64) c;
-            totalValues[i + j] = (uint32) uv;
-            c = uv >> 32;
-        }
+    auto* b = a + numA;
+    auto* product = b + numB;
 
-        totalValues[i + n + 1] = c;
-    }
+    copyToLimbs (a, numA, getValues(), sizeNeededToHold (n));
+    copyToLimbs (b, numB, other.getValues(), sizeNeededToHold (t));
+    multiplyLimbs (product, a, numA, b, numB);
 
+    BigInteger total;
+    auto numWords = (numA + numB) * (size_t) wordsPerLimb;
+    copyFromLimbs (total.ensureSize (numWords), numWords, product);
+    total.highestBit = (int) numWords * 32 - 1;
     total.highestBit = total.getHighestBit();
-    total.setNegative (wasNegative ^ other.isNegative());
+    total.setNegative (isNegative() ^ other.isNegative());
     swapWith (total);
 
     return *this;
@@ -583,30 +1054,32 @@ void BigInteger::divideBy (const BigInteger& divisor, BigInteger& remainder)
     else
     {
         auto wasNegative = isNegative();
+        auto quotientIsNegative = wasNegative ^ divisor.isNegative();
 
-        swapWith (remainder);
-        remainder.setNegative (false);
-        clear();
-
-        BigInteger temp (divisor);
-        temp.setNegative (false);
+        if (ourHB < divHB)
+        {
+            swapWith (remainder);
+            clear();
+        }
+        else
+        {
+            auto numU = sizeNeededToHold (ourHB);
+            auto numV = sizeNeededToHold (divHB);
 
-        auto leftShift = ourHB - divHB;
-        temp <<= leftShift;
+            BigInteger quotient, newRemainder;
+            divideWords (quotient.ensureSize (numU - numV + 1), newRemainder.ensureSize (numV),
+                         getValues(), numU, divisor.getValues(), numV);
 
-        while (leftShift >= 0)
-        {
-            if (remainder.compareAbsolute (temp) >= 0)
-            {
-                remainder -= temp;
-                setBit (leftShift);
-            }
+            quotient.highestBit = (int) (numU - numV + 1) * 32 - 1;
+            quotient.highestBit = quotient.getHighestBit();
+            newRemainder.highestBit = (int) numV * 32 - 1;
+            newRemainder.highestBit = newRemainder.getHighestBit();
 
-            if (--leftShift >= 0)
-                temp >>= 1;
+            swapWith (quotient);
+            remainder.swapWith (newRemainder);
         }
 
-        negative = wasNegative ^ divisor.isNegative();
+        negative = quotientIsNegative;
         remainder.setNegative (wasNegative);
     }
 }
@@ -925,47 +1398,42 @@ void BigInteger::exponentModulo (const BigInteger& exponent, const BigInteger& m
                 *this %= modulus;
         }
     }
-    else
+    else if (! exp.isZero())
     {
-        auto Rfactor = modulus.getHighestBit() + 1;
-        BigInteger R (1);
-        R.shiftLeft (Rfactor, 0);
+        MontgomeryContext context (modulus.getValues(), modulus.getHighestBit());
+        auto numLimbs = context.numLimbs;
+        auto montgomeryShift = (int) numLimbs * bitsPerLimb;
 
-        BigInteger R1, m1, g;
-        g.extendedEuclidean (modulus, R, m1, R1);
+        auto absModulus = modulus;
+        absModulus.setNegative (false);
 
-        if (! g.isOne())
-        {
-            BigInteger a (*this);
+        if (isNegative())
+            *this += absModulus;
 
-            for (int i = exp.getHighestBit(); --i >= 0;)
-            {
-                *this *= *this;
+        // the base and 1, converted to Montgomery form by multiplying them by R
+        auto base = *this << montgomeryShift;
+        base %= absModulus;
 
-                if (exp[i])
-                    *this *= a;
+        BigInteger one (1);
+        one <<= montgomeryShift;
+        one %= absModulus;
 
-                if (compareAbsolute (modulus) >= 0)
-                    *this %= modulus;
-            }
-        }
-        else
-        {
-            auto am  = (*this * R) % modulus;
-            auto xm = am;
-            auto um = R % modulus;
+        HeapBlock<Limb> limbs (3 * numLimbs);
+        auto* baseLimbs = limbs.get();
+        auto* oneLimbs = baseLimbs + numLimbs;
+        auto* resultLimbs = oneLimbs + numLimbs;
 
-            for (int i = exp.getHighestBit(); --i >= 0;)
-            {
-                xm.montgomeryMultiplication (xm, modulus, m1, Rfactor);
+        copyToLimbs (baseLimbs, numLimbs, base.getValues(), sizeNeededToHold (base.getHighestBit()));
+        copyToLimbs (oneLimbs, numLimbs, one.getValues(), sizeNeededToHold (one.getHighestBit()));
 
-                if (exp[i])
-                    xm.montgomeryMultiplication (am, modulus, m1, Rfactor);
-            }
+        context.exponentiate (resultLimbs, baseLimbs, oneLimbs, exp);
+        context.convertBack (resultLimbs, resultLimbs);
 
-            xm.montgomeryMultiplication (1, modulus, m1, Rfactor);
-            swapWith (xm);
-        }
+        auto numWords = numLimbs * (size_t) wordsPerLimb;
+        clear();
+        copyFromLimbs (ensureSize (numWords), numWords, resultLimbs);
+        highestBit = (int) numWords * 32 - 1;
+        highestBit = getHighestBit();
     }
 }
 
@@ -1297,6 +1765,36 @@ public:
         return b;
     }
 
+    // These do things the slow way, to check the results of the faster algorithms
+    static BigInteger referenceMultiply (const BigInteger& a, const BigInteger& b)
+    {
+        BigInteger result;
+
+        for (int i = b.findNextSetBit (0); i >= 0; i = b.findNextSetBit (i + 1))
+            result += a << i;
+
+        if (b.isNegative())
+            result.negate();
+
+        return result;
+    }
+
+    static BigInteger referenceExponentModulo (BigInteger base, const BigInteger& exponent, const BigInteger& modulus)
+    {
+        BigInteger result (1);
+        base %= modulus;
+
+        for (int i = exponent.getHighestBit(); i >= 0; --i)
+        {
+            result = (result * result) % modulus;
+
+            if (exponent[i])
+                result = (result * base) % modulus;
+        }
+
+        return result;
+    }
+
     void runTest() override
     {
         {
@@ -1358,6 +1856,64 @@ public:
                 expect (old2 == readLittleEndianBitsInBuffer (test, offset + num, 6));
             }
         }
+
+        {
+            beginTest ("Large values");
+
+            Random r = getRandom();
+
+            for (int j = 50; --j >= 0;)
+            {
+                BigInteger a, b;
+                r.fillBitsRandomly (a, 0, r.nextInt (8000) + 1);
+                r.fillBitsRandomly (b, 0, r.nextInt (8000) + 1);
+
+                if (b.isZero())
+                    b = 1;
+
+                if (r.nextBool())  a.negate();
+                if (r.nextBool())  b.negate();
+
+                auto product = a * b;
+                expect (product == referenceMultiply (a, b));
+
+                BigInteger quotient (a), remainder;
+                quotient.divideBy (b, remainder);
+                expect (quotient * b + remainder == a);
+                expect (remainder.compareAbsolute (b) < 0);
+                expect (remainder.isZero() || remainder.isNegative() == a.isNegative());
+
+                quotient = product;
+                quotient.divideBy (b, remainder);
+                expect (quotient == a && remainder.isZero());
+            }
+        }
+
+        {
+            beginTest ("Modular exponentiation");
+
+            Random r = getRandom();
+
+            for (int j = 60; --j >= 0;)
+            {
+                BigInteger modulus, base, exponent;
+                r.fillBitsRandomly (modulus, 0, r.nextInt (1200) + 2);
+                r.fillBitsRandomly (base, 0, r.nextInt (1500) + 1);
+                modulus.setBit (0, r.nextInt (4) != 0);
+
+                if (modulus < 3)
+                    modulus = 3;
+
+                r.fillBitsRandomly (exponent, 0, r.nextInt (modulus.getHighestBit()) + 1);
+
+                if (exponent.isZero())
+                    exponent = 1;
+
+                auto expected = referenceExponentModulo (base, exponent, modulus);
+                base.exponentModulo (exponent, modulus);
+                expect (base == expected);
+            }
+        }
     }
 };
 
@@ -259,6 +259,9 @@ public:
 
     /** Performs a combined exponent and modulo operation.
         This BigInteger's value becomes (this ^ exponent) % modulus.
+
+        When the modulus is odd, as it is for RSA, this uses Montgomery multiplication,
+        which avoids having to divide by the modulus after each step.
     */
     void exponentModulo (const BigInteger& exponent, const BigInteger& modulus);
 
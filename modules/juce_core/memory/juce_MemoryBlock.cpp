@@ -356,14 +356,29 @@ String MemoryBlock::toBase64Encoding() const
 
     String destString ((unsigned int) size); // store the length, followed by a '.', and then the data.
     auto initialLen = destString.length();
-    destString.preallocateBytes (sizeof (String::CharPointerType::CharType) * (size_t) initialLen + 2 + numChars);
+    destString.preallocateBytes (sizeof (String::CharPointerType::CharType) * ((size_t) initialLen + 2 + numChars));
 
     auto d = destString.getCharPointer();
     d += initialLen;
     d.write ('.');
 
-    for (size_t i = 0; i < numChars; ++i)
-        d.write ((juce_wchar) (uint8) base64EncodingTable[getBitRange (i * 6, 6)]);
+    // (each 3 bytes hold four 6-bit values, starting from the lowest bits of the first byte)
+    auto* source = reinterpret_cast<const uint8*> (data.get());
+
+    for (size_t i = 0; i < numChars; i += 4)
+    {
+        auto byteIndex = (i / 4) * 3;
+        uint32 bits = source[byteIndex];
+
+        if (byteIndex + 1 < size)  bits |= (uint32) source[byteIndex + 1] << 8;
+        if (byteIndex + 2 < size)  bits |= (uint32) source[byteIndex + 2] << 16;
+
+        for (size_t j = i; j < jmin (i + 4, numChars); ++j)
+        {
+            d.write ((juce_wchar) (uint8) base64EncodingTable[bits & 0x3f]);
+            bits >>= 6;
+        }
+    }
 
     d.writeNull();
     return destString;
@@ -388,23 +403,46 @@ bool MemoryBlock::fromBase64Encoding (StringRef s)
     setSize ((size_t) numBytesNeeded, true);
 
     auto srcChars = dot + 1;
-    int pos = 0;
+    auto* dest = reinterpret_cast<uint8*> (data.get());
+    size_t byteIndex = 0;
+    uint32 bits = 0;
+    int numBits = 0;
 
+    // collect the 6-bit values and write them out a byte at a time
     for (;;)
     {
         auto c = (int) srcChars.getAndAdvance();
 
         if (c == 0)
-            return true;
+            break;
 
         c -= 43;
 
         if (isPositiveAndBelow (c, numElementsInArray (base64DecodingTable)))
         {
-            setBitRange ((size_t) pos, 6, base64DecodingTable[c]);
-            pos += 6;
+            bits |= (uint32) base64DecodingTable[c] << numBits;
+            numBits += 6;
+
+            if (numBits >= 8)
+            {
+                if (byteIndex < size)
+                    dest[byteIndex] = (uint8) bits;
+
+                ++byteIndex;
+                bits >>= 8;
+                numBits -= 8;
+            }
         }
     }
+
+    // any bits left over only replace the low bits of the next byte
+    if (numBits > 0 && byteIndex < size)
+    {
+        auto mask = (1u << numBits) - 1;
+        dest[byteIndex] = (uint8) ((dest[byteIndex] & ~mask) | (bits & mask));
+    }
+
+    return true;
 }
 
 } // namespace juce
@@ -80,6 +80,8 @@
  #endif
 
  #include <sys/socket.h>
+ #include <sys/uio.h>
+ #include <limits.h>
  #include <sys/sysctl.h>
  #include <sys/stat.h>
  #include <sys/param.h>
@@ -92,6 +94,7 @@
  #include <ifaddrs.h>
  #include <net/if_dl.h>
  #include <mach/mach_time.h>
+ #include <mach/mach.h>
  #include <mach-o/dyld.h>
  #include <objc/runtime.h>
  #include <objc/objc.h>
@@ -226,10 +229,14 @@
  #include <sys/types.h>
  #include <sys/ioctl.h>
  #include <sys/socket.h>
+ #include <sys/uio.h>
+ #include <limits.h>
  #include <net/if.h>
  #include <sys/sysinfo.h>
  #include <sys/file.h>
  #include <sys/prctl.h>
+ #include <sys/syscall.h>
+ #include <linux/futex.h>
  #include <signal.h>
  #include <stddef.h>
 
@@ -248,10 +255,14 @@
  #include <sys/ptrace.h>
  #include <sys/sysinfo.h>
  #include <sys/mman.h>
+ #include <sys/uio.h>
+ #include <limits.h>
  #include <pwd.h>
  #include <dirent.h>
  #include <fnmatch.h>
  #include <sys/wait.h>
+ #include <sys/syscall.h>
+ #include <linux/futex.h>
  #include <android/api-level.h>
 
  // If you are getting include errors here, then you to re-build the Projucer
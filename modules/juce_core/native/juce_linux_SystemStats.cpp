@@ -147,6 +147,7 @@ void CPUInformation::initialise() noexcept
     hasSSE42 = flags.contains ("sse4_2");
     hasAVX   = flags.contains ("avx");
     hasAVX2  = flags.contains ("avx2");
+    hasSHA   = flags.contains ("sha_ni");
 
     numLogicalCPUs  = getCpuInfo ("processor").getIntValue() + 1;
 
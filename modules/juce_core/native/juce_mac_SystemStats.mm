@@ -84,6 +84,7 @@ void CPUInformation::initialise() noexcept
 
     SystemStatsHelpers::doCPUID (a, b, c, d, 7);
     hasAVX2  = (b & (1u <<  5)) != 0;
+    hasSHA   = (b & (1u << 29)) != 0;
    #endif
 
     numLogicalCPUs = (int) [[NSProcessInfo processInfo] activeProcessorCount];
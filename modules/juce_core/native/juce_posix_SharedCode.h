@@ -247,9 +247,11 @@ namespace
    #if JUCE_LINUX || (JUCE_IOS && ! __DARWIN_ONLY_64_BIT_INO_T) // (this iOS stuff is to avoid a simulator bug)
     typedef struct stat64 juce_statStruct;
     #define JUCE_STAT     stat64
+    #define JUCE_FSTATAT  fstatat64
    #else
     typedef struct stat   juce_statStruct;
     #define JUCE_STAT     stat
+    #define JUCE_FSTATAT  fstatat
    #endif
 
     bool juce_stat (const String& fileName, juce_statStruct& info)
@@ -568,6 +570,59 @@ ssize_t FileOutputStream::writeInternal (const void* const data, const size_t nu
     return result;
 }
 
+ssize_t FileOutputStream::writeGatheredInternal (const Array<DataToWrite>& blocks)
+{
+    if (fileHandle == 0)
+        return 0;
+
+    HeapBlock<iovec> iov ((size_t) blocks.size());
+    int numBlocks = 0;
+
+    for (auto& b : blocks)
+    {
+        if (b.numBytes > 0)
+        {
+            iov[numBlocks].iov_base = const_cast<void*> (b.data);
+            iov[numBlocks].iov_len = b.numBytes;
+            ++numBlocks;
+        }
+    }
+
+    ssize_t totalWritten = 0;
+
+    for (int i = 0; i < numBlocks;)
+    {
+        auto result = ::writev (getFD (fileHandle), iov + i, jmin (numBlocks - i, (int) IOV_MAX));
+
+        if (result <= 0)
+        {
+            if (result < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+
+                status = getResultForErrno();
+            }
+
+            return totalWritten > 0 ? totalWritten : result;
+        }
+
+        totalWritten += result;
+
+        // skip the blocks that were written, and adjust the first one if it was only partly written
+        while (i < numBlocks && (size_t) result >= iov[i].iov_len)
+            result -= (ssize_t) iov[i++].iov_len;
+
+        if (i < numBlocks)
+        {
+            iov[i].iov_base = static_cast<char*> (iov[i].iov_base) + result;
+            iov[i].iov_len -= (size_t) result;
+        }
+    }
+
+    return totalWritten;
+}
+
 #ifndef JUCE_ANDROID
 void FileOutputStream::flushInternal()
 {
@@ -585,6 +640,137 @@ Result FileOutputStream::truncate()
     return getResultForReturnValue (ftruncate (getFD (fileHandle), (off_t) currentPosition));
 }
 
+//==============================================================================
+bool DirectoryScanner::readDirectory (const File& dir, bool fetchSizesAndTimes, Array<Entry>& results)
+{
+    auto* d = opendir (dir.getFullPathName().toUTF8());
+
+    if (d == nullptr)
+        return false;
+
+    auto parentPath = File::addTrailingSeparator (dir.getFullPathName());
+
+    while (auto* de = readdir (d))
+    {
+        auto* name = de->d_name;
+
+        if (name[0] == '.' && (name[1] == 0 || (name[1] == '.' && name[2] == 0)))
+            continue;
+
+        Entry e;
+        e.file = File::createFileWithoutCheckingPath (parentPath + String (CharPointer_UTF8 (name)));
+        e.isHidden = (name[0] == '.');
+        e.isDirectory = (de->d_type == DT_DIR);
+        e.isSymbolicLink = (de->d_type == DT_LNK);
+
+        // Some filesystems don't supply the type, and a link's type is that of its target,
+        // so those have to be looked up. On Linux, this can be done relative to the open
+        // directory, which saves the kernel from walking the whole path for each file.
+        if (fetchSizesAndTimes || de->d_type == DT_UNKNOWN || de->d_type == DT_LNK)
+        {
+            juce_statStruct info;
+
+           #if JUCE_LINUX || JUCE_ANDROID
+            if (de->d_type == DT_UNKNOWN && JUCE_FSTATAT (dirfd (d), name, &info, AT_SYMLINK_NOFOLLOW) == 0)
+                e.isSymbolicLink = S_ISLNK (info.st_mode);
+
+            const bool statOk = JUCE_FSTATAT (dirfd (d), name, &info, 0) == 0;
+           #else
+            if (de->d_type == DT_UNKNOWN)
+                e.isSymbolicLink = e.file.isSymbolicLink();
+
+            const bool statOk = juce_stat (e.file.getFullPathName(), info);
+           #endif
+
+            if (statOk)
+            {
+                e.isDirectory = S_ISDIR (info.st_mode);
+                e.size = (int64) info.st_size;
+                e.modificationTime = Time ((int64) info.st_mtime * 1000);
+            }
+        }
+
+        results.add (e);
+    }
+
+    closedir (d);
+    return true;
+}
+
+//==============================================================================
+void AsyncFile::openHandle (AccessMode mode)
+{
+    const int f = open (file.getFullPathName().toUTF8(), mode == readOnly ? O_RDONLY : (O_RDWR | O_CREAT), 00644);
+
+    if (f != -1)
+        fileHandle = fdToVoidPointer (f);
+    else
+        status = getResultForErrno();
+}
+
+void AsyncFile::closeHandle()
+{
+    if (fileHandle != nullptr)
+    {
+        close (getFD (fileHandle));
+        fileHandle = nullptr;
+    }
+}
+
+Result AsyncFile::readAt (int64 position, void* buffer, size_t numBytes, size_t& numRead)
+{
+    numRead = 0;
+
+    while (numRead < numBytes)
+    {
+        auto result = pread (getFD (fileHandle), static_cast<char*> (buffer) + numRead,
+                             numBytes - numRead, (off_t) (position + (int64) numRead));
+
+        if (result < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            return getResultForErrno();
+        }
+
+        if (result == 0)
+            break;
+
+        numRead += (size_t) result;
+    }
+
+    return Result::ok();
+}
+
+Result AsyncFile::writeAt (int64 position, const void* data, size_t numBytes, size_t& numWritten)
+{
+    numWritten = 0;
+
+    while (numWritten < numBytes)
+    {
+        auto result = pwrite (getFD (fileHandle), static_cast<const char*> (data) + numWritten,
+                              numBytes - numWritten, (off_t) (position + (int64) numWritten));
+
+        if (result < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            return getResultForErrno();
+        }
+
+        numWritten += (size_t) result;
+    }
+
+    return Result::ok();
+}
+
+Result AsyncFile::flushInternal()
+{
+    return getResultForReturnValue (fsync (getFD (fileHandle)));
+}
+
 //==============================================================================
 String SystemStats::getEnvironmentVariable (const String& name, const String& defaultValue)
 {
@@ -326,6 +326,27 @@ ssize_t FileOutputStream::writeInternal (const void* bufferToWrite, size_t numBy
     return 0;
 }
 
+ssize_t FileOutputStream::writeGatheredInternal (const Array<DataToWrite>& blocks)
+{
+    // (WriteFileGather only works with unbuffered, page-aligned files, so each block
+    // is just written in turn)
+    ssize_t totalWritten = 0;
+
+    for (auto& b : blocks)
+    {
+        if (b.numBytes > 0)
+        {
+            auto result = writeInternal (b.data, b.numBytes);
+            totalWritten += result;
+
+            if (result != (ssize_t) b.numBytes)
+                break;
+        }
+    }
+
+    return totalWritten;
+}
+
 void FileOutputStream::flushInternal()
 {
     if (fileHandle != nullptr)
@@ -343,6 +364,132 @@ Result FileOutputStream::truncate()
                                               : WindowsFileHelpers::getResultForLastError();
 }
 
+//==============================================================================
+bool DirectoryScanner::readDirectory (const File& dir, bool /*fetchSizesAndTimes*/, Array<Entry>& results)
+{
+    using namespace WindowsFileHelpers;
+
+    if (dir.getFullPathName().isEmpty())
+        return false;
+
+    auto parentPath = File::addTrailingSeparator (dir.getFullPathName());
+    WIN32_FIND_DATA findData;
+    HANDLE handle = FindFirstFile ((parentPath + "*").toWideCharPointer(), &findData);
+
+    if (handle == INVALID_HANDLE_VALUE)
+        return false;
+
+    // (the directory listing already contains everything we need)
+    do
+    {
+        auto* name = findData.cFileName;
+
+        if (name[0] == '.' && (name[1] == 0 || (name[1] == '.' && name[2] == 0)))
+            continue;
+
+        Entry e;
+        e.file = File::createFileWithoutCheckingPath (parentPath + name);
+        e.isDirectory    = (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+        e.isHidden       = (findData.dwFileAttributes & FILE_ATTRIBUTE_HIDDEN) != 0;
+        e.isSymbolicLink = (findData.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0
+                             && findData.dwReserved0 == IO_REPARSE_TAG_SYMLINK;
+        e.size = findData.nFileSizeLow + (((int64) findData.nFileSizeHigh) << 32);
+        e.modificationTime = Time (fileTimeToTime (&findData.ftLastWriteTime));
+
+        results.add (e);
+    }
+    while (FindNextFile (handle, &findData) != 0);
+
+    FindClose (handle);
+    return true;
+}
+
+//==============================================================================
+void AsyncFile::openHandle (AccessMode mode)
+{
+    HANDLE h = CreateFile (file.getFullPathName().toWideCharPointer(),
+                           mode == readOnly ? GENERIC_READ : (GENERIC_READ | GENERIC_WRITE),
+                           mode == readOnly ? (FILE_SHARE_READ | FILE_SHARE_WRITE) : FILE_SHARE_READ, 0,
+                           mode == readOnly ? OPEN_EXISTING : OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, 0);
+
+    if (h != INVALID_HANDLE_VALUE)
+        fileHandle = (void*) h;
+    else
+        status = WindowsFileHelpers::getResultForLastError();
+}
+
+void AsyncFile::closeHandle()
+{
+    if (fileHandle != nullptr)
+    {
+        CloseHandle ((HANDLE) fileHandle);
+        fileHandle = nullptr;
+    }
+}
+
+// With a synchronous handle, an OVERLAPPED structure just supplies the position, so
+// several threads can read and write the same handle without sharing a file pointer.
+static OVERLAPPED createOverlappedForPosition (int64 position) noexcept
+{
+    OVERLAPPED overlapped;
+    zerostruct (overlapped);
+    overlapped.Offset     = (DWORD) (position & 0xffffffff);
+    overlapped.OffsetHigh = (DWORD) (position >> 32);
+    return overlapped;
+}
+
+Result AsyncFile::readAt (int64 position, void* buffer, size_t numBytes, size_t& numRead)
+{
+    numRead = 0;
+
+    while (numRead < numBytes)
+    {
+        auto overlapped = createOverlappedForPosition (position + (int64) numRead);
+        DWORD actualNum = 0;
+
+        if (! ReadFile ((HANDLE) fileHandle, static_cast<char*> (buffer) + numRead,
+                        (DWORD) jmin (numBytes - numRead, (size_t) 0x40000000), &actualNum, &overlapped))
+        {
+            if (GetLastError() == ERROR_HANDLE_EOF)
+                break;
+
+            return WindowsFileHelpers::getResultForLastError();
+        }
+
+        if (actualNum == 0)
+            break;
+
+        numRead += actualNum;
+    }
+
+    return Result::ok();
+}
+
+Result AsyncFile::writeAt (int64 position, const void* data, size_t numBytes, size_t& numWritten)
+{
+    numWritten = 0;
+
+    while (numWritten < numBytes)
+    {
+        auto overlapped = createOverlappedForPosition (position + (int64) numWritten);
+        DWORD actualNum = 0;
+
+        if (! WriteFile ((HANDLE) fileHandle, static_cast<const char*> (data) + numWritten,
+                         (DWORD) jmin (numBytes - numWritten, (size_t) 0x40000000), &actualNum, &overlapped))
+            return WindowsFileHelpers::getResultForLastError();
+
+        numWritten += actualNum;
+    }
+
+    return Result::ok();
+}
+
+Result AsyncFile::flushInternal()
+{
+    return FlushFileBuffers ((HANDLE) fileHandle) ? Result::ok()
+                                                  : WindowsFileHelpers::getResultForLastError();
+}
+
 //==============================================================================
 void MemoryMappedFile::openInternal (const File& file, AccessMode mode, bool exclusive)
 {
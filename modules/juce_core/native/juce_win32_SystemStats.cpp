@@ -152,6 +152,7 @@ void CPUInformation::initialise() noexcept
     callCPUID (info, 7);
 
     hasAVX2 = (info[1] & (1 << 5)) != 0;
+    hasSHA  = (info[1] & (1 << 29)) != 0;
 
     SYSTEM_INFO systemInfo;
     GetNativeSystemInfo (&systemInfo);
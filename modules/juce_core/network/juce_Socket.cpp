@@ -469,6 +469,47 @@ int StreamingSocket::write (const void* sourceBuffer, const int numBytesToWrite)
     return (int) ::send (handle, (const char*) sourceBuffer, (juce_recvsend_size_t) numBytesToWrite, 0);
 }
 
+int StreamingSocket::writeGathered (const Array<OutputStream::DataToWrite>& blocks)
+{
+    if (isListener || ! connected)
+        return -1;
+
+   #if JUCE_WINDOWS
+    HeapBlock<WSABUF> buffers ((size_t) blocks.size());
+
+    for (int i = 0; i < blocks.size(); ++i)
+    {
+        buffers[i].buf = (char*) blocks.getReference (i).data;
+        buffers[i].len = (ULONG) blocks.getReference (i).numBytes;
+    }
+
+    DWORD bytesSent = 0;
+
+    if (WSASend (handle, buffers, (DWORD) blocks.size(), &bytesSent, 0, nullptr, nullptr) != 0)
+        return -1;
+
+    return (int) bytesSent;
+   #else
+    // (any blocks beyond the OS's limit are left for the caller to send, just as it would
+    // if only part of the data had been sent)
+    auto numBlocks = jmin (blocks.size(), (int) IOV_MAX);
+    HeapBlock<iovec> iov ((size_t) numBlocks);
+
+    for (int i = 0; i < numBlocks; ++i)
+    {
+        iov[i].iov_base = const_cast<void*> (blocks.getReference (i).data);
+        iov[i].iov_len = blocks.getReference (i).numBytes;
+    }
+
+    msghdr message;
+    zerostruct (message);
+    message.msg_iov = iov;
+    message.msg_iovlen = (decltype (message.msg_iovlen)) numBlocks;
+
+    return (int) ::sendmsg (handle, &message, 0);
+   #endif
+}
+
 //==============================================================================
 int StreamingSocket::waitUntilReady (const bool readyForReading,
                                      const int timeoutMsecs) const
@@ -145,6 +145,19 @@ public:
     */
     int write (const void* sourceBuffer, int numBytesToWrite);
 
+    /** Writes a list of data blocks to the socket, one after the other.
+
+        All the blocks are passed to the OS in a single call, so data that's held in
+        several pieces, such as the contents of a ChunkedMemoryOutputStream, can be sent
+        without first copying it into one buffer.
+
+        Like write(), this will block unless you have checked that the socket is ready
+        for writing.
+
+        @returns the number of bytes written, or -1 if there was an error.
+    */
+    int writeGathered (const Array<OutputStream::DataToWrite>& blocks);
+
     //==============================================================================
     /** Puts this socket into "listener" mode.
 
@@ -37,6 +37,146 @@ static inline int calcBufferStreamBufferSize (int requestedSize, InputStream* so
     return requestedSize;
 }
 
+//==============================================================================
+// Holds the block that's being read ahead from the source. While a task is reading it,
+// the source belongs to that task, so everything else that uses the source has to wait
+// for it first, apart from the length, which is remembered from before the task started.
+// When no task is running, the source is positioned just after the data that's held here.
+struct BufferedInputStream::ReadAhead
+{
+    ReadAhead (TaskScheduler& s, int size, int64 sourcePosition)
+        : scheduler (s), capacity (size), start (sourcePosition)
+    {
+        data.malloc (size);
+    }
+
+    ~ReadAhead()
+    {
+        task.wait();
+    }
+
+    void waitForTask()
+    {
+        if (task.isValid())
+            task.wait();
+    }
+
+    int read (InputStream& source, int64 position, char* dest, int numBytes)
+    {
+        waitForTask();
+
+        if (position != start)
+        {
+            numAvailable = 0;
+            source.setPosition (position);
+            start = position;
+        }
+
+        auto numFromBuffer = jmin (numBytes, numAvailable);
+        memcpy (dest, data, (size_t) numFromBuffer);
+        numAvailable -= numFromBuffer;
+        memmove (data, data + numFromBuffer, (size_t) numAvailable);
+
+        auto numRead = numFromBuffer;
+
+        if (numRead < numBytes)
+            numRead += jmax (0, source.read (dest + numRead, numBytes - numRead));
+
+        start = position + numRead;
+        startReading (source);
+        return numRead;
+    }
+
+    // Reads a whole block into a buffer which must be the same size as this one. If the
+    // data's already been read ahead, the two buffers are swapped rather than copied, and
+    // the next block is read into the one that was passed in.
+    int readBlock (InputStream& source, int64 position, HeapBlock<char>& dest)
+    {
+        waitForTask();
+
+        if (position != start || numAvailable == 0)
+            return read (source, position, dest, capacity);
+
+        dest.swapWith (data);
+        auto numRead = numAvailable;
+        numAvailable = 0;
+
+        if (numRead < capacity)
+            numRead += jmax (0, source.read (dest + numRead, capacity - numRead));
+
+        start = position + numRead;
+        startReading (source);
+        return numRead;
+    }
+
+    // Moves the source to a new position, keeping any data that's already been read
+    // ahead from there.
+    bool seek (InputStream& source, int64 position)
+    {
+        waitForTask();
+
+        if (position >= start && position <= start + numAvailable)
+        {
+            auto numToDiscard = (int) (position - start);
+            numAvailable -= numToDiscard;
+            memmove (data, data + numToDiscard, (size_t) numAvailable);
+        }
+        else
+        {
+            // (if the source can't seek, it'll still be just after the data held here)
+            if (! source.setPosition (position))
+                return false;
+
+            numAvailable = 0;
+        }
+
+        start = position;
+        startReading (source);
+        return true;
+    }
+
+    void startReading (InputStream& source)
+    {
+        sourceLength = source.getTotalLength();
+
+        if (numAvailable < capacity && ! source.isExhausted())
+        {
+            auto* s = &source;
+
+            task = scheduler.addTask ([this, s]
+            {
+                numAvailable += jmax (0, s->read (data + numAvailable, capacity - numAvailable));
+            });
+        }
+    }
+
+    bool isExhausted (InputStream& source)
+    {
+        if (sourceLength >= 0)
+            return start >= sourceLength;
+
+        waitForTask();
+        return numAvailable == 0 && source.isExhausted();
+    }
+
+    int64 getTotalLength (InputStream& source)
+    {
+        if (task.isValid() && ! task.isFinished())
+            return sourceLength;
+
+        return source.getTotalLength();
+    }
+
+    TaskScheduler& scheduler;
+    const int capacity;
+    HeapBlock<char> data;
+    int64 start, sourceLength = -1;
+    int numAvailable = 0;
+    TaskScheduler::TaskHandle task;
+
+    JUCE_DECLARE_NON_COPYABLE (ReadAhead)
+};
+
 //==============================================================================
 BufferedInputStream::BufferedInputStream (InputStream* sourceStream, int size, bool takeOwnership)
    : source (sourceStream, takeOwnership),
@@ -52,8 +192,18 @@ BufferedInputStream::BufferedInputStream (InputStream& sourceStream, int size)
 {
 }
 
+BufferedInputStream::BufferedInputStream (InputStream* sourceStream, int size, bool takeOwnership,
+                                          TaskScheduler& scheduler)
+   : BufferedInputStream (sourceStream, size, takeOwnership)
+{
+    readAhead = new ReadAhead (scheduler, bufferSize, position);
+    readAhead->startReading (*source);
+}
+
 BufferedInputStream::~BufferedInputStream()
 {
+    // (the source can't be deleted while it's being read ahead)
+    readAhead = nullptr;
 }
 
 //==============================================================================
@@ -63,9 +213,24 @@ char BufferedInputStream::peekByte()
     return position < lastReadPos ? *(buffer + (int) (position - bufferStart)) : 0;
 }
 
+const char* BufferedInputStream::peek (int numBytesWanted, int& numBytesAvailable)
+{
+    // You can't peek at more than the buffer can hold!
+    jassert (numBytesWanted <= bufferSize);
+
+    numBytesWanted = jlimit (1, bufferSize, numBytesWanted);
+
+    if (position < bufferStart || position + numBytesWanted > lastReadPos)
+        ensureBuffered (numBytesWanted);
+
+    numBytesAvailable = (int) jlimit ((int64) 0, (int64) bufferSize, lastReadPos - position);
+    return buffer + (int) jlimit ((int64) 0, (int64) bufferSize, position - bufferStart);
+}
+
 int64 BufferedInputStream::getTotalLength()
 {
-    return source->getTotalLength();
+    return readAhead != nullptr ? readAhead->getTotalLength (*source)
+                                : source->getTotalLength();
 }
 
 int64 BufferedInputStream::getPosition()
@@ -81,12 +246,57 @@ bool BufferedInputStream::setPosition (int64 newPosition)
 
 bool BufferedInputStream::isExhausted()
 {
-    return position >= lastReadPos && source->isExhausted();
+    if (position < lastReadPos)
+        return false;
+
+    return readAhead != nullptr ? readAhead->isExhausted (*source)
+                                : source->isExhausted();
+}
+
+void BufferedInputStream::skipNextBytes (int64 numBytesToSkip)
+{
+    if (numBytesToSkip <= 0)
+        return;
+
+    auto newPosition = position + numBytesToSkip;
+
+    // There's no need to read the data that's being skipped if it's already in the buffer,
+    // or if the source knows its length and can move past it. Otherwise, it has to be read
+    // as normal, as the source may not be able to seek at all.
+    if (position >= bufferStart && newPosition <= lastReadPos)
+    {
+        position = newPosition;
+        return;
+    }
+
+    auto totalLength = getTotalLength();
+
+    if (totalLength >= 0)
+    {
+        newPosition = jmin (newPosition, jmax (position, totalLength));
+
+        if (readAhead != nullptr ? readAhead->seek (*source, newPosition)
+                                 : source->setPosition (newPosition))
+        {
+            // the source has moved, so nothing in the buffer can be kept
+            position = bufferStart = lastReadPos = newPosition;
+            return;
+        }
+    }
+
+    InputStream::skipNextBytes (numBytesToSkip);
 }
 
 void BufferedInputStream::ensureBuffered()
 {
-    auto bufferEndOverlap = lastReadPos - bufferOverlap;
+    ensureBuffered (bufferOverlap);
+}
+
+// Refills the buffer if fewer than the given number of bytes are available from the
+// current position.
+void BufferedInputStream::ensureBuffered (int64 minBytesAvailable)
+{
+    auto bufferEndOverlap = lastReadPos - minBytesAvailable;
 
     if (position < bufferStart || position >= bufferEndOverlap)
     {
@@ -101,8 +311,8 @@ void BufferedInputStream::ensureBuffered()
 
             bufferStart = position;
 
-            bytesRead = source->read (buffer + bytesToKeep,
-                                      (int) (bufferSize - bytesToKeep));
+            bytesRead = readFromSource (lastReadPos, buffer + bytesToKeep,
+                                        (int) (bufferSize - bytesToKeep));
 
             lastReadPos += bytesRead;
             bytesRead += bytesToKeep;
@@ -110,8 +320,17 @@ void BufferedInputStream::ensureBuffered()
         else
         {
             bufferStart = position;
-            source->setPosition (bufferStart);
-            bytesRead = source->read (buffer, bufferSize);
+
+            if (readAhead != nullptr)
+            {
+                bytesRead = readAhead->readBlock (*source, bufferStart, buffer);
+            }
+            else
+            {
+                source->setPosition (bufferStart);
+                bytesRead = source->read (buffer, bufferSize);
+            }
+
             lastReadPos = bufferStart + bytesRead;
         }
 
@@ -120,6 +339,14 @@ void BufferedInputStream::ensureBuffered()
     }
 }
 
+int BufferedInputStream::readFromSource (int64 sourcePosition, char* dest, int numBytes)
+{
+    if (readAhead != nullptr)
+        return readAhead->read (*source, sourcePosition, dest, numBytes);
+
+    return source->read (dest, numBytes);
+}
+
 int BufferedInputStream::read (void* destBuffer, int maxBytesToRead)
 {
     jassert (destBuffer != nullptr && maxBytesToRead >= 0);
@@ -184,4 +411,213 @@ String BufferedInputStream::readString()
     return InputStream::readString();
 }
 
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct BufferedInputStreamTests  : public UnitTest
+{
+    BufferedInputStreamTests()  : UnitTest ("BufferedInputStream", "Streams") {}
+
+    // A source which takes a while to return each block, like a file on a network drive
+    struct SlowInputStream  : public MemoryInputStream
+    {
+        SlowInputStream (const MemoryBlock& sourceData, int delayMs)
+            : MemoryInputStream (sourceData, false), delay (delayMs) {}
+
+        int read (void* dest, int numBytes) override
+        {
+            Thread::sleep (delay);
+            return MemoryInputStream::read (dest, numBytes);
+        }
+
+        const int delay;
+    };
+
+    // A source which can only be read forwards, like a socket or a decompressor
+    struct ForwardOnlyInputStream  : public MemoryInputStream
+    {
+        ForwardOnlyInputStream (const MemoryBlock& sourceData, bool lengthKnown)
+            : MemoryInputStream (sourceData, false), isLengthKnown (lengthKnown) {}
+
+        int64 getTotalLength() override                 { return isLengthKnown ? MemoryInputStream::getTotalLength() : -1; }
+        bool setPosition (int64 newPos) override        { return newPos == getPosition(); }
+
+        const bool isLengthKnown;
+    };
+
+    void testReading (BufferedInputStream& stream, const MemoryBlock& data, Random& r)
+    {
+        auto* original = static_cast<const char*> (data.getData());
+        auto size = (int) data.getSize();
+        HeapBlock<char> buffer (5000);
+
+        for (int i = 0; i < 300; ++i)
+        {
+            auto position = (int) stream.getPosition();
+
+            switch (r.nextInt (5))
+            {
+                case 0:
+                    stream.setPosition (r.nextInt (size + 10));
+                    break;
+
+                case 1:
+                {
+                    int numAvailable;
+                    auto wanted = r.nextInt (256) + 1;  // (this mustn't be more than the smallest buffer size)
+                    auto* p = stream.peek (wanted, numAvailable);
+
+                    expectEquals (stream.getPosition(), (int64) position);
+                    expect (numAvailable >= jmin (wanted, jmax (0, size - position)));
+                    expect (numAvailable <= jmax (0, size - position));
+                    expect (memcmp (p, original + jmin (position, size), (size_t) numAvailable) == 0);
+                    break;
+                }
+
+                case 2:
+                {
+                    auto num = r.nextInt (1000);
+                    stream.skipNextBytes (num);
+                    expectEquals (stream.getPosition(), (int64) jmax (position, jmin (position + num, size)));
+                    break;
+                }
+
+                default:
+                {
+                    auto wanted = r.nextInt (5000);
+                    auto numRead = stream.read (buffer, wanted);
+
+                    expectEquals (numRead, jmax (0, jmin (wanted, size - position)));
+                    expect (memcmp (buffer, original + jmin (position, size), (size_t) jmax (0, numRead)) == 0);
+                    expect (stream.isExhausted() == (position + numRead >= size));
+                    break;
+                }
+            }
+        }
+    }
+
+    void runTest() override
+    {
+        auto r = getRandom();
+        TaskScheduler scheduler (2);
+
+        MemoryBlock data ((size_t) 50000 + (size_t) r.nextInt (50000));
+        r.fillBitsRandomly (data.getData(), data.getSize());
+
+        beginTest ("Reading");
+        {
+            for (auto bufferSize : { 256, 1024, 8192 })
+            {
+                MemoryInputStream source (data, false);
+                BufferedInputStream stream (source, bufferSize);
+                testReading (stream, data, r);
+            }
+        }
+
+        beginTest ("Peeking after skipping past the buffer");
+        {
+            for (auto shouldReadAhead : { false, true })
+            {
+                auto* source = new MemoryInputStream (data, false);
+                ScopedPointer<BufferedInputStream> stream (shouldReadAhead ? new BufferedInputStream (source, 1024, true, scheduler)
+                                                                           : new BufferedInputStream (source, 1024, true));
+                HeapBlock<char> buffer (900);
+                int numAvailable;
+
+                expectEquals (stream->read (buffer, 900), 900);
+                stream->skipNextBytes (1500);
+                expect (stream->setPosition (1850));
+                auto* p = stream->peek (100, numAvailable);
+
+                expect (numAvailable >= 100);
+                expect (memcmp (p, static_cast<const char*> (data.getData()) + 1850, (size_t) numAvailable) == 0);
+            }
+        }
+
+        beginTest ("Reading ahead");
+        {
+            for (auto bufferSize : { 256, 1024, 8192 })
+            {
+                BufferedInputStream stream (new MemoryInputStream (data, false), bufferSize, true, scheduler);
+                testReading (stream, data, r);
+
+                // reading straight through
+                stream.setPosition (0);
+                MemoryOutputStream out;
+                out << stream;
+                expect (out.getMemoryBlock() == data);
+                expect (stream.isExhausted());
+            }
+        }
+
+        beginTest ("Skipping in a source which can't seek");
+        {
+            for (auto isLengthKnown : { false, true })
+            {
+                for (auto shouldReadAhead : { false, true })
+                {
+                    auto* source = new ForwardOnlyInputStream (data, isLengthKnown);
+                    ScopedPointer<BufferedInputStream> stream (shouldReadAhead ? new BufferedInputStream (source, 1024, true, scheduler)
+                                                                               : new BufferedInputStream (source, 1024, true));
+                    auto* original = static_cast<const char*> (data.getData());
+                    bool allCorrect = true;
+
+                    while (! stream->isExhausted())
+                    {
+                        auto position = (int) stream->getPosition();
+                        char c;
+
+                        if (stream->read (&c, 1) == 1)
+                            allCorrect = allCorrect && c == original[position];
+
+                        stream->skipNextBytes (r.nextInt (3000));
+                    }
+
+                    expect (allCorrect);
+                }
+            }
+        }
+
+        beginTest ("Benchmark");
+        {
+            // Reads a slow source in small pieces, spending some time on each block
+            MemoryBlock benchmarkData (256 * 1024);
+            r.fillBitsRandomly (benchmarkData.getData(), benchmarkData.getSize());
+
+            auto timeReading = [&] (BufferedInputStream& stream)
+            {
+                auto start = Time::getMillisecondCounterHiRes();
+                int64 total = 0;
+
+                while (! stream.isExhausted())
+                {
+                    int numAvailable;
+                    auto* p = stream.peek (4096, numAvailable);
+
+                    for (int i = 0; i < numAvailable; ++i)
+                        total += p[i];
+
+                    stream.skipNextBytes (numAvailable);
+                    Thread::sleep (2);
+                }
+
+                expect (total != 1);
+                return Time::getMillisecondCounterHiRes() - start;
+            };
+
+            BufferedInputStream syncStream (new SlowInputStream (benchmarkData, 2), 16384, true);
+            BufferedInputStream asyncStream (new SlowInputStream (benchmarkData, 2), 16384, true, scheduler);
+
+            logMessage ("Reading " + String (benchmarkData.getSize() / 1024) + " KB from a slow source: synchronous "
+                          + String (timeReading (syncStream), 1) + " ms, reading ahead "
+                          + String (timeReading (asyncStream), 1) + " ms");
+        }
+    }
+};
+
+static BufferedInputStreamTests bufferedInputStreamTests;
+
+#endif
+
 } // namespace juce
@@ -23,6 +23,8 @@
 namespace juce
 {
 
+class TaskScheduler;
+
 //==============================================================================
 /** Wraps another input stream, and reads from it using an intermediate buffer
 
@@ -30,6 +32,14 @@ namespace juce
     small read accesses to it, it's probably sensible to wrap it in one of these,
     so that the source stream gets accessed in larger chunk sizes, meaning less
     work for the underlying stream.
+
+    If it's given a TaskScheduler, the stream will also read ahead: whenever it takes
+    some data from its source, it starts reading the next block on one of the scheduler's
+    threads, so that when the buffer runs out, the data is usually already there. This
+    helps with sources that are slow to read, e.g. files on a network drive.
+
+    For parsers which can work directly on the buffered data, peek() returns a pointer
+    into the buffer, so the data doesn't need to be copied out of it.
 */
 class JUCE_API  BufferedInputStream  : public InputStream
 {
@@ -54,6 +64,23 @@ public:
     */
     BufferedInputStream (InputStream& sourceStream, int bufferSize);
 
+    /** Creates a BufferedInputStream which reads ahead from its source in the background.
+
+        @param sourceStream                 the source stream to read from
+        @param bufferSize                   the size of reservoir to use to buffer the source. The
+                                            same amount will be read ahead
+        @param deleteSourceWhenDestroyed    whether the sourceStream that is passed in should be
+                                            deleted by this object when it is itself deleted.
+        @param scheduler                    the scheduler whose threads will read ahead. This must
+                                            not be deleted before the stream. While a block is being
+                                            read ahead, the source stream is used by one of these
+                                            threads, so nothing else may use it.
+    */
+    BufferedInputStream (InputStream* sourceStream,
+                         int bufferSize,
+                         bool deleteSourceWhenDestroyed,
+                         TaskScheduler& scheduler);
+
     /** Destructor.
 
         This may also delete the source stream, if that option was chosen when the
@@ -66,12 +93,35 @@ public:
     /** Returns the next byte that would be read by a call to readByte() */
     char peekByte();
 
+    /** Returns a pointer to the data at the current position, without copying it or
+        moving the position.
+
+        If fewer than numBytesWanted bytes are in the buffer, more will be read from the
+        source first, unless the end of the stream is reached. The number of bytes wanted
+        can't be more than the buffer size. Once you've dealt with the data, you can move
+        past it with skipNextBytes(), e.g.
+        @code
+        int numAvailable;
+        auto* data = stream.peek (4096, numAvailable);
+        auto numUsed = parseSomeTokens (data, numAvailable);
+        stream.skipNextBytes (numUsed);
+        @endcode
+
+        @param numBytesWanted       the number of bytes that you'd like to look at
+        @param numBytesAvailable    on return, this is set to the number of bytes at the returned
+                                    address, which may be more or less than numBytesWanted
+        @returns a pointer to the data, which is only valid until the stream is next read
+                 or moved
+    */
+    const char* peek (int numBytesWanted, int& numBytesAvailable);
+
     int64 getTotalLength() override;
     int64 getPosition() override;
     bool setPosition (int64 newPosition) override;
     int read (void* destBuffer, int maxBytesToRead) override;
     String readString() override;
     bool isExhausted() override;
+    void skipNextBytes (int64 numBytesToSkip) override;
 
 
 private:
@@ -80,7 +130,14 @@ private:
     int bufferSize;
     int64 position, lastReadPos = 0, bufferStart, bufferOverlap = 128;
     HeapBlock<char> buffer;
+
+    struct ReadAhead;
+    friend struct ContainerDeletePolicy<ReadAhead>;
+    ScopedPointer<ReadAhead> readAhead;
+
     void ensureBuffered();
+    void ensureBuffered (int64 minBytesAvailable);
+    int readFromSource (int64 sourcePosition, char* dest, int numBytes);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BufferedInputStream)
 };
@@ -0,0 +1,483 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+ChunkedMemoryOutputStream::ChunkedMemoryOutputStream (size_t firstSize, size_t maxSize)
+    : firstChunkSize (jmax ((size_t) 16, firstSize)),
+      maxChunkSize (jmax ((size_t) 16, firstSize, maxSize))
+{
+}
+
+ChunkedMemoryOutputStream::~ChunkedMemoryOutputStream()
+{
+}
+
+void ChunkedMemoryOutputStream::flush()
+{
+}
+
+void ChunkedMemoryOutputStream::reset() noexcept
+{
+    position = 0;
+    size = 0;
+    currentChunk = 0;
+}
+
+bool ChunkedMemoryOutputStream::setPosition (int64 newPosition)
+{
+    if (newPosition <= (int64) size)
+    {
+        // ok to seek backwards
+        position = jlimit ((size_t) 0, size, (size_t) newPosition);
+        return true;
+    }
+
+    // can't move beyond the end of the stream..
+    return false;
+}
+
+//==============================================================================
+// All the chunks apart from the one containing the end of the data are full, so each
+// chunk always holds the same range of positions, even after the stream is reset.
+ChunkedMemoryOutputStream::Chunk* ChunkedMemoryOutputStream::getChunkForPosition (size_t numBytesWanted)
+{
+    if (auto* c = chunks[currentChunk])
+        if (position >= c->start && position < c->start + c->capacity)
+            return c;
+
+    if (position < totalCapacity)
+    {
+        int start = 0, end = chunks.size();
+
+        while (start < end)
+        {
+            auto mid = (start + end) / 2;
+            auto* c = chunks.getUnchecked (mid);
+
+            if (c->start + c->capacity <= position)
+                start = mid + 1;
+            else
+                end = mid;
+        }
+
+        currentChunk = start;
+        return chunks[start];
+    }
+
+    jassert (position == totalCapacity);
+
+    auto capacity = jmax (jlimit (firstChunkSize, maxChunkSize, totalCapacity), numBytesWanted);
+    ScopedPointer<Chunk> newChunk (new Chunk());
+    newChunk->data.malloc (capacity);
+
+    if (newChunk->data == nullptr)
+        return nullptr;
+
+    newChunk->start = totalCapacity;
+    newChunk->capacity = capacity;
+    totalCapacity += capacity;
+
+    currentChunk = chunks.size();
+    return chunks.add (newChunk.release());
+}
+
+char* ChunkedMemoryOutputStream::getSpaceAtPosition (size_t numBytesWanted, size_t& numBytesAvailable)
+{
+    if (auto* c = getChunkForPosition (numBytesWanted))
+    {
+        auto offset = position - c->start;
+        numBytesAvailable = c->capacity - offset;
+        return c->data + offset;
+    }
+
+    numBytesAvailable = 0;
+    return nullptr;
+}
+
+void ChunkedMemoryOutputStream::advance (size_t numBytes) noexcept
+{
+    position += numBytes;
+    size = jmax (size, position);
+}
+
+bool ChunkedMemoryOutputStream::write (const void* buffer, size_t howMany)
+{
+    jassert (buffer != nullptr);
+
+    auto* src = static_cast<const char*> (buffer);
+
+    while (howMany > 0)
+    {
+        size_t numAvailable;
+        auto* dest = getSpaceAtPosition (howMany, numAvailable);
+
+        if (dest == nullptr)
+            return false;
+
+        auto num = jmin (howMany, numAvailable);
+        memcpy (dest, src, num);
+        advance (num);
+        src += num;
+        howMany -= num;
+    }
+
+    return true;
+}
+
+bool ChunkedMemoryOutputStream::writeRepeatedByte (uint8 byte, size_t howMany)
+{
+    while (howMany > 0)
+    {
+        size_t numAvailable;
+        auto* dest = getSpaceAtPosition (howMany, numAvailable);
+
+        if (dest == nullptr)
+            return false;
+
+        auto num = jmin (howMany, numAvailable);
+        memset (dest, byte, num);
+        advance (num);
+        howMany -= num;
+    }
+
+    return true;
+}
+
+int64 ChunkedMemoryOutputStream::writeFromInputStream (InputStream& source, int64 maxNumBytesToWrite)
+{
+    // if we know how much data is coming, the next chunk can be made big enough for all of it
+    auto availableData = source.getTotalLength() - source.getPosition();
+    size_t sizeHint = 0;
+
+    if (availableData > 0)
+    {
+        if (maxNumBytesToWrite > availableData || maxNumBytesToWrite < 0)
+            maxNumBytesToWrite = availableData;
+
+        sizeHint = (size_t) maxNumBytesToWrite;
+    }
+    else if (maxNumBytesToWrite < 0)
+    {
+        maxNumBytesToWrite = std::numeric_limits<int64>::max();
+    }
+
+    int64 numWritten = 0;
+
+    while (numWritten < maxNumBytesToWrite)
+    {
+        size_t numAvailable;
+        auto* dest = getSpaceAtPosition (sizeHint, numAvailable);
+
+        if (dest == nullptr)
+            break;
+
+        auto numToRead = (int) jmin ((int64) numAvailable, maxNumBytesToWrite - numWritten,
+                                     (int64) std::numeric_limits<int>::max());
+        auto num = source.read (dest, numToRead);
+
+        if (num <= 0)
+            break;
+
+        advance ((size_t) num);
+        numWritten += num;
+    }
+
+    return numWritten;
+}
+
+//==============================================================================
+Array<OutputStream::DataToWrite> ChunkedMemoryOutputStream::getChunks() const
+{
+    Array<DataToWrite> result;
+
+    for (auto* c : chunks)
+    {
+        if (c->start >= size)
+            break;
+
+        result.add ({ c->data.get(), jmin (c->capacity, size - c->start) });
+    }
+
+    return result;
+}
+
+bool ChunkedMemoryOutputStream::writeTo (OutputStream& destStream) const
+{
+    return destStream.writeGathered (getChunks());
+}
+
+void ChunkedMemoryOutputStream::copyTo (void* destBuffer) const noexcept
+{
+    auto* dest = static_cast<char*> (destBuffer);
+
+    for (auto* c : chunks)
+    {
+        if (c->start >= size)
+            break;
+
+        memcpy (dest + c->start, c->data, jmin (c->capacity, size - c->start));
+    }
+}
+
+MemoryBlock ChunkedMemoryOutputStream::getMemoryBlock() const
+{
+    MemoryBlock mb (size);
+    copyTo (mb.getData());
+    return mb;
+}
+
+String ChunkedMemoryOutputStream::toUTF8() const
+{
+    auto mb = getMemoryBlock();
+    auto* d = static_cast<const char*> (mb.getData());
+    return String (CharPointer_UTF8 (d), CharPointer_UTF8 (d + mb.getSize()));
+}
+
+String ChunkedMemoryOutputStream::toString() const
+{
+    auto mb = getMemoryBlock();
+    return String::createStringFromData (mb.getData(), (int) mb.getSize());
+}
+
+OutputStream& JUCE_CALLTYPE operator<< (OutputStream& stream, const ChunkedMemoryOutputStream& streamToRead)
+{
+    streamToRead.writeTo (stream);
+    return stream;
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct ChunkedMemoryOutputStreamTests  : public UnitTest
+{
+    ChunkedMemoryOutputStreamTests()  : UnitTest ("ChunkedMemoryOutputStream", "Streams") {}
+
+    static bool matches (const ChunkedMemoryOutputStream& chunked, const MemoryOutputStream& reference)
+    {
+        if (chunked.getDataSize() != reference.getDataSize())
+            return false;
+
+        size_t total = 0;
+
+        for (auto& c : chunked.getChunks())
+        {
+            if (memcmp (c.data, static_cast<const char*> (reference.getData()) + total, c.numBytes) != 0)
+                return false;
+
+            total += c.numBytes;
+        }
+
+        return total == reference.getDataSize()
+                && chunked.getMemoryBlock() == reference.getMemoryBlock();
+    }
+
+    // Writes the same random things to both streams
+    static void writeRandomData (Random& r, OutputStream& s1, OutputStream& s2)
+    {
+        HeapBlock<char> data (5000);
+        r.fillBitsRandomly (data, 5000);
+
+        for (int i = 0; i < 300; ++i)
+        {
+            switch (r.nextInt (6))
+            {
+                case 0:
+                {
+                    auto num = (size_t) r.nextInt (r.nextBool() ? 20 : 5000);
+                    s1.write (data, num);
+                    s2.write (data, num);
+                    break;
+                }
+
+                case 1:
+                {
+                    auto value = r.nextInt();
+                    s1.writeCompressedInt (value);
+                    s2.writeCompressedInt (value);
+                    break;
+                }
+
+                case 2:
+                {
+                    auto byte = (uint8) r.nextInt (256);
+                    auto num = (size_t) r.nextInt (3000);
+                    s1.writeRepeatedByte (byte, num);
+                    s2.writeRepeatedByte (byte, num);
+                    break;
+                }
+
+                case 3:
+                {
+                    auto pos = r.nextInt64() % (s1.getPosition() + 1);
+                    pos = pos < 0 ? -pos : pos;
+                    s1.setPosition (pos);
+                    s2.setPosition (pos);
+                    break;
+                }
+
+                case 4:
+                {
+                    auto num = r.nextInt (5000);
+                    auto maxNum = r.nextBool() ? -1 : r.nextInt (num + 1);
+                    MemoryInputStream in1 (data, (size_t) num, false), in2 (data, (size_t) num, false);
+                    s1.writeFromInputStream (in1, maxNum);
+                    s2.writeFromInputStream (in2, maxNum);
+                    break;
+                }
+
+                default:
+                {
+                    Array<OutputStream::DataToWrite> blocks;
+
+                    for (int j = r.nextInt (5); --j >= 0;)
+                        blocks.add ({ data + r.nextInt (1000), (size_t) r.nextInt (4000) });
+
+                    s1.writeGathered (blocks);
+                    s2.writeGathered (blocks);
+                    break;
+                }
+            }
+        }
+    }
+
+    void runTest() override
+    {
+        auto r = getRandom();
+
+        beginTest ("Writing");
+        {
+            for (int i = 0; i < 20; ++i)
+            {
+                ChunkedMemoryOutputStream chunked ((size_t) r.nextInt (1000), (size_t) r.nextInt (100000));
+                MemoryOutputStream reference;
+
+                writeRandomData (r, chunked, reference);
+
+                expect (matches (chunked, reference));
+                expectEquals (chunked.getPosition(), reference.getPosition());
+                expect (chunked.toUTF8() == reference.toUTF8());
+
+                // the data that's already been written never moves
+                auto* firstChunk = chunked.getChunks().getFirst().data;
+                chunked.writeRepeatedByte (0, 200000);
+                expect (chunked.getChunks().getFirst().data == firstChunk);
+
+                chunked.reset();
+                expect (chunked.getDataSize() == 0 && chunked.getChunks().isEmpty());
+
+                chunked << "abc";
+                expect (chunked.getChunks().getFirst().data == firstChunk);
+                expect (chunked.toString() == "abc");
+            }
+        }
+
+        beginTest ("Gathered writes");
+        {
+            auto tempFile = File::createTempFile (".bin");
+
+            for (auto bufferSize : { 16, 1000, 16384, 1000000 })
+            {
+                ChunkedMemoryOutputStream chunked (100, 2000);
+                MemoryOutputStream reference;
+                writeRandomData (r, chunked, reference);
+                expect (matches (chunked, reference));
+
+                MemoryOutputStream memoryCopy, expected;
+                memoryCopy << "header" << chunked;
+                expected << "header" << reference;
+                expect (memoryCopy.getMemoryBlock() == expected.getMemoryBlock());
+
+                tempFile.deleteFile();
+
+                {
+                    FileOutputStream out (tempFile, (size_t) bufferSize);
+                    out << "header";
+                    expect (chunked.writeTo (out));
+                    expect (out.writeGathered ({}));
+                    out << "footer";
+                    expectEquals (out.getPosition(), (int64) memoryCopy.getDataSize() + 6);
+                }
+
+                memoryCopy << "footer";
+
+                MemoryBlock fileData;
+                expect (tempFile.loadFileAsData (fileData) && fileData == memoryCopy.getMemoryBlock());
+            }
+
+            tempFile.deleteFile();
+        }
+
+        beginTest ("Benchmark");
+        {
+            // Simulates serialising a big tree of small objects, and then saving it
+            auto tempFile = File::createTempFile (".bin");
+
+            auto timeWriting = [&] (OutputStream& stream, std::function<void()> save)
+            {
+                auto start = Time::getMillisecondCounterHiRes();
+
+                for (int i = 0; i < 200000; ++i)
+                {
+                    stream.writeCompressedInt (i);
+                    stream.writeString ("property");
+                    stream.writeDouble (i * 0.5);
+                }
+
+                save();
+                return Time::getMillisecondCounterHiRes() - start;
+            };
+
+            MemoryOutputStream memoryStream;
+            ChunkedMemoryOutputStream chunkedStream;
+
+            auto memoryTime = timeWriting (memoryStream, [&]
+            {
+                tempFile.deleteFile();
+                FileOutputStream out (tempFile);
+                out << memoryStream;
+            });
+
+            auto chunkedTime = timeWriting (chunkedStream, [&]
+            {
+                tempFile.deleteFile();
+                FileOutputStream out (tempFile);
+                out << chunkedStream;
+            });
+
+            expectEquals (tempFile.getSize(), (int64) memoryStream.getDataSize());
+            tempFile.deleteFile();
+
+            logMessage ("Serialising and saving " + String (memoryStream.getDataSize() / 1024) + " KB: MemoryOutputStream "
+                          + String (memoryTime, 2) + " ms, ChunkedMemoryOutputStream " + String (chunkedTime, 2)
+                          + " ms (" + String (chunkedStream.getChunks().size()) + " chunks)");
+        }
+    }
+};
+
+static ChunkedMemoryOutputStreamTests chunkedMemoryOutputStreamTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,142 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Writes data to a list of memory chunks, which is extended as required.
+
+    Unlike MemoryOutputStream, which keeps its data in one block and has to reallocate
+    and copy it whenever it grows, this stream allocates a new chunk when the current
+    one is full, so data that has already been written is never moved. The chunks get
+    bigger as the stream grows, up to a maximum size, so a large stream doesn't end up
+    with a huge number of them.
+
+    This makes it a good choice for building up data from lots of small writes, e.g.
+    when serialising a large ValueTree or MIDI file. The data can then be passed on
+    without being joined up, by handing the list of chunks to OutputStream::writeGathered()
+    or StreamingSocket::writeGathered(), which write them all with a single OS call
+    where possible:
+    @code
+    ChunkedMemoryOutputStream data;
+    valueTree.writeToStream (data);
+
+    FileOutputStream out (file);
+    data.writeTo (out);
+    @endcode
+
+    If you need the data in one contiguous block, use MemoryOutputStream instead.
+
+    @see MemoryOutputStream, OutputStream::writeGathered
+*/
+class JUCE_API  ChunkedMemoryOutputStream  : public OutputStream
+{
+public:
+    //==============================================================================
+    /** Creates an empty stream.
+
+        @param firstChunkSize   the size of the first chunk to allocate. Each new chunk is
+                                as big as all the previous ones put together, until it
+                                reaches the maximum size
+        @param maxChunkSize     the largest size to use for a new chunk, unless a single
+                                write needs a bigger one
+    */
+    ChunkedMemoryOutputStream (size_t firstChunkSize = 256,
+                               size_t maxChunkSize = 65536);
+
+    /** Destructor.
+        This will free any data that was written to it.
+    */
+    ~ChunkedMemoryOutputStream();
+
+    //==============================================================================
+    /** Returns the number of bytes of data that have been written to the stream. */
+    size_t getDataSize() const noexcept                         { return size; }
+
+    /** Returns the chunks of memory that hold the stream's data, in order.
+
+        These can be passed straight to OutputStream::writeGathered(). The pointers stay
+        valid until the stream is reset or deleted, although writing to the stream may
+        add more chunks.
+    */
+    Array<DataToWrite> getChunks() const;
+
+    /** Writes all the data to another stream, without joining up the chunks first.
+        @returns false if the write operation fails for some reason
+    */
+    bool writeTo (OutputStream& destStream) const;
+
+    /** Copies all the data into a block of memory, which must be at least
+        getDataSize() bytes long.
+    */
+    void copyTo (void* destBuffer) const noexcept;
+
+    /** Returns a copy of the stream's data as a memory block. */
+    MemoryBlock getMemoryBlock() const;
+
+    /** Returns a String created from the (UTF8) data that has been written to the stream. */
+    String toUTF8() const;
+
+    /** Attempts to detect the encoding of the data and convert it to a string.
+        @see String::createStringFromData
+    */
+    String toString() const;
+
+    /** Resets the stream, clearing any data that has been written to it so far.
+        The chunks that have been allocated are kept, and will be re-used.
+    */
+    void reset() noexcept;
+
+    //==============================================================================
+    void flush() override;
+    bool write (const void*, size_t) override;
+    int64 getPosition() override                                { return (int64) position; }
+    bool setPosition (int64) override;
+    int64 writeFromInputStream (InputStream&, int64 maxNumBytesToWrite) override;
+    bool writeRepeatedByte (uint8 byte, size_t numTimesToRepeat) override;
+
+private:
+    //==============================================================================
+    struct Chunk
+    {
+        HeapBlock<char> data;
+        size_t start, capacity;
+    };
+
+    OwnedArray<Chunk> chunks;
+    const size_t firstChunkSize, maxChunkSize;
+    size_t position = 0, size = 0, totalCapacity = 0;
+    int currentChunk = 0;
+
+    char* getSpaceAtPosition (size_t numBytesWanted, size_t& numBytesAvailable);
+    Chunk* getChunkForPosition (size_t numBytesWanted);
+    void advance (size_t) noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ChunkedMemoryOutputStream)
+};
+
+/** Copies all the data that has been written to a ChunkedMemoryOutputStream into another stream. */
+OutputStream& JUCE_CALLTYPE operator<< (OutputStream& stream, const ChunkedMemoryOutputStream& streamToRead);
+
+} // namespace juce
@@ -115,6 +115,31 @@ bool MemoryOutputStream::write (const void* const buffer, size_t howMany)
     return false;
 }
 
+bool MemoryOutputStream::writeGathered (const Array<DataToWrite>& blocks)
+{
+    size_t totalBytes = 0;
+
+    for (auto& b : blocks)
+        totalBytes += b.numBytes;
+
+    if (totalBytes == 0)
+        return true;
+
+    // make room for all of them at once, rather than growing the block for each one
+    if (auto* dest = prepareToWrite (totalBytes))
+    {
+        for (auto& b : blocks)
+        {
+            memcpy (dest, b.data, b.numBytes);
+            dest += b.numBytes;
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
 bool MemoryOutputStream::writeRepeatedByte (uint8 byte, size_t howMany)
 {
     if (howMany == 0)
@@ -107,6 +107,7 @@ public:
     void flush() override;
 
     bool write (const void*, size_t) override;
+    bool writeGathered (const Array<DataToWrite>&) override;
     int64 getPosition() override                                 { return (int64) position; }
     bool setPosition (int64) override;
     int64 writeFromInputStream (InputStream&, int64 maxNumBytesToWrite) override;
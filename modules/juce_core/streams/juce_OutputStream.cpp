@@ -63,6 +63,15 @@ OutputStream::~OutputStream()
 }
 
 //==============================================================================
+bool OutputStream::writeGathered (const Array<DataToWrite>& blocks)
+{
+    for (auto& b : blocks)
+        if (b.numBytes > 0 && ! write (b.data, b.numBytes))
+            return false;
+
+    return true;
+}
+
 bool OutputStream::writeBool (bool b)
 {
     return writeByte (b ? (char) 1
@@ -80,6 +80,25 @@ public:
     virtual bool write (const void* dataToWrite,
                         size_t numberOfBytes) = 0;
 
+    /** Refers to a block of data that is to be written by writeGathered(). */
+    struct DataToWrite
+    {
+        const void* data;
+        size_t numBytes;
+    };
+
+    /** Writes a list of data blocks to the stream, one after the other.
+
+        This has the same effect as calling write() for each block in turn, which is
+        what the default implementation does. Streams such as FileOutputStream override
+        it to hand all the blocks to the OS in a single call, so that data which is held
+        in several pieces doesn't have to be copied into one contiguous buffer first.
+
+        @returns false if the write operation fails for some reason
+        @see ChunkedMemoryOutputStream
+    */
+    virtual bool writeGathered (const Array<DataToWrite>& blocks);
+
     //==============================================================================
     /** Writes a single byte to the stream.
         @returns false if the write operation fails for some reason
@@ -295,4 +295,16 @@ namespace juce
  #define JUCE_NO_ASSOCIATIVE_MATH_OPTIMISATIONS
 #endif
 
+//==============================================================================
+#if (JUCE_INTEL && (JUCE_GCC || JUCE_CLANG)) || DOXYGEN
+ /** This can be placed before a function definition to let the compiler use a set of
+     instructions in it that the rest of the code isn't built for, e.g. "ssse3". The
+     function must only be called after checking that the CPU supports them, e.g. with
+     SystemStats::hasSSSE3(). (MSVC doesn't need this to be able to use intrinsics).
+ */
+ #define JUCE_TARGET_INSTRUCTION_SET(instructionSet)   __attribute__ ((target (instructionSet)))
+#else
+ #define JUCE_TARGET_INSTRUCTION_SET(instructionSet)
+#endif
+
 } // namespace juce
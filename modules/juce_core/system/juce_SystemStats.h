@@ -171,6 +171,7 @@ public:
     static bool hasSSE42() noexcept;  /**< Returns true if Intel SSE4.2 instructions are available. */
     static bool hasAVX() noexcept;    /**< Returns true if Intel AVX instructions are available. */
     static bool hasAVX2() noexcept;   /**< Returns true if Intel AVX2 instructions are available. */
+    static bool hasSHA() noexcept;    /**< Returns true if Intel SHA extensions are available. */
     static bool hasNeon() noexcept;   /**< Returns true if ARM NEON instructions are available. */
 
     //==============================================================================
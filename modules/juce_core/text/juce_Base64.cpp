@@ -23,45 +23,156 @@
 namespace juce
 {
 
+namespace Base64Helpers
+{
+    static const char encodingTable[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    // Encodes whole groups of 3 bytes into 4 characters each.
+    static void encodeGroups (const uint8* source, size_t numGroups, char* dest) noexcept
+    {
+        for (size_t i = 0; i < numGroups; ++i)
+        {
+            auto bits = ((uint32) source[0] << 16) | ((uint32) source[1] << 8) | source[2];
+            dest[0] = encodingTable[bits >> 18];
+            dest[1] = encodingTable[(bits >> 12) & 0x3f];
+            dest[2] = encodingTable[(bits >> 6) & 0x3f];
+            dest[3] = encodingTable[bits & 0x3f];
+            source += 3;
+            dest += 4;
+        }
+    }
+
+    // Returns the 6-bit value of a character, or -1 if it's not part of the encoding.
+    static inline int decodeChar (uint32 c) noexcept
+    {
+        if (c >= 'A' && c <= 'Z')    return (int) (c - 'A');
+        if (c >= 'a' && c <= 'z')    return (int) (c - ('a' - 26));
+        if (c >= '0' && c <= '9')    return (int) (c + (52 - '0'));
+        if (c == '+')                return 62;
+        if (c == '/')                return 63;
+        return -1;
+    }
+
+   #if JUCE_INTEL
+    // Encodes 12 bytes into 16 characters at a time, for as long as there are at least 16
+    // bytes to read. Returns the number of groups that were done.
+    JUCE_TARGET_INSTRUCTION_SET ("ssse3")
+    static size_t encodeGroupsSSSE3 (const uint8* source, size_t numGroups, char* dest) noexcept
+    {
+        size_t numDone = 0;
+
+        for (; (numGroups - numDone) * 3 >= 16; numDone += 4)
+        {
+            // split each 3 bytes into 4 bytes holding 6 bits each..
+            auto in = _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i*) source),
+                                        _mm_set_epi8 (10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+
+            auto evenBits = _mm_mulhi_epu16 (_mm_and_si128 (in, _mm_set1_epi32 (0x0fc0fc00)), _mm_set1_epi32 (0x04000040));
+            auto oddBits  = _mm_mullo_epi16 (_mm_and_si128 (in, _mm_set1_epi32 (0x003f03f0)), _mm_set1_epi32 (0x01000010));
+            auto values = _mm_or_si128 (evenBits, oddBits);
+
+            // ..then add the offset that turns each range of values into the right characters
+            auto offsets = _mm_add_epi8 (_mm_set1_epi8 ('A'),
+                           _mm_add_epi8 (_mm_and_si128 (_mm_cmpgt_epi8 (values, _mm_set1_epi8 (25)), _mm_set1_epi8 ('a' - 26 - 'A')),
+                           _mm_add_epi8 (_mm_and_si128 (_mm_cmpgt_epi8 (values, _mm_set1_epi8 (51)), _mm_set1_epi8 ('0' - 52 - ('a' - 26))),
+                           _mm_add_epi8 (_mm_and_si128 (_mm_cmpgt_epi8 (values, _mm_set1_epi8 (61)), _mm_set1_epi8 ('+' - 62 - ('0' - 52))),
+                                         _mm_and_si128 (_mm_cmpgt_epi8 (values, _mm_set1_epi8 (62)), _mm_set1_epi8 ('/' - 63 - ('+' - 62)))))));
+
+            _mm_storeu_si128 ((__m128i*) dest, _mm_add_epi8 (values, offsets));
+            source += 12;
+            dest += 16;
+        }
+
+        return numDone;
+    }
+
+    // Decodes 16 characters into 12 bytes, writing 16 bytes to the destination. Returns
+    // false if any of the characters aren't part of the encoding, including padding.
+    JUCE_TARGET_INSTRUCTION_SET ("ssse3")
+    static bool decodeBlockSSSE3 (const char* source, uint8* dest) noexcept
+    {
+        auto in = _mm_loadu_si128 ((const __m128i*) source);
+
+        auto inRange = [in] (char low, char high)
+        {
+            return _mm_and_si128 (_mm_cmpgt_epi8 (in, _mm_set1_epi8 ((char) (low - 1))),
+                                  _mm_cmplt_epi8 (in, _mm_set1_epi8 ((char) (high + 1))));
+        };
+
+        auto isUpper = inRange ('A', 'Z');
+        auto isLower = inRange ('a', 'z');
+        auto isDigit = inRange ('0', '9');
+        auto isPlus  = _mm_cmpeq_epi8 (in, _mm_set1_epi8 ('+'));
+        auto isSlash = _mm_cmpeq_epi8 (in, _mm_set1_epi8 ('/'));
+
+        auto isValid = _mm_or_si128 (_mm_or_si128 (isUpper, isLower), _mm_or_si128 (_mm_or_si128 (isDigit, isPlus), isSlash));
+
+        if (_mm_movemask_epi8 (isValid) != 0xffff)
+            return false;
+
+        auto offsets = _mm_or_si128 (_mm_or_si128 (_mm_and_si128 (isUpper, _mm_set1_epi8 ((char) -'A')),
+                                                   _mm_and_si128 (isLower, _mm_set1_epi8 ((char) (26 - 'a')))),
+                                     _mm_or_si128 (_mm_and_si128 (isDigit, _mm_set1_epi8 ((char) (52 - '0'))),
+                                                   _mm_or_si128 (_mm_and_si128 (isPlus, _mm_set1_epi8 ((char) (62 - '+'))),
+                                                                 _mm_and_si128 (isSlash, _mm_set1_epi8 ((char) (63 - '/'))))));
+
+        auto values = _mm_add_epi8 (in, offsets);
+
+        // join pairs of 6-bit values into 12 bits, then pairs of those into 24 bits..
+        auto joined = _mm_madd_epi16 (_mm_maddubs_epi16 (values, _mm_set1_epi32 (0x01400140)),
+                                      _mm_set1_epi32 (0x00011000));
+
+        // ..and pick out the three bytes of each one in big-endian order
+        _mm_storeu_si128 ((__m128i*) dest, _mm_shuffle_epi8 (joined, _mm_setr_epi8 (2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1)));
+        return true;
+    }
+   #endif
+}
+
 bool Base64::convertToBase64 (OutputStream& base64Result, const void* sourceData, size_t sourceDataSize)
 {
-    static const char lookup[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    using namespace Base64Helpers;
+
     auto* source = static_cast<const uint8*> (sourceData);
+   #if JUCE_INTEL
+    const bool useSSSE3 = SystemStats::hasSSSE3();
+   #endif
+
+    // encode into a buffer, a few thousand characters at a time
+    const size_t maxGroupsPerBlock = 1024;
+    char buffer[maxGroupsPerBlock * 4];
 
-    while (sourceDataSize > 0)
+    while (sourceDataSize >= 3)
     {
-        char frame[4];
-        auto byte0 = *source++;
-        frame[0] = lookup [(byte0 & 0xfcu) >> 2];
-        uint32 bits = (byte0 & 0x03u) << 4;
+        auto numGroups = jmin (maxGroupsPerBlock, sourceDataSize / 3);
+        size_t numDone = 0;
+
+       #if JUCE_INTEL
+        if (useSSSE3)
+            numDone = encodeGroupsSSSE3 (source, numGroups, buffer);
+       #endif
+
+        encodeGroups (source + numDone * 3, numGroups - numDone, buffer + numDone * 4);
+
+        if (! base64Result.write (buffer, numGroups * 4))
+            return false;
+
+        source += numGroups * 3;
+        sourceDataSize -= numGroups * 3;
+    }
+
+    if (sourceDataSize > 0)
+    {
+        auto bits = (uint32) source[0] << 16;
 
         if (sourceDataSize > 1)
-        {
-            auto byte1 = *source++;
-            frame[1] = lookup[bits | ((byte1 & 0xf0u) >> 4)];
-            bits = (byte1 & 0x0fu) << 2;
+            bits |= (uint32) source[1] << 8;
 
-            if (sourceDataSize > 2)
-            {
-                auto byte2 = *source++;
-                frame[2] = lookup[bits | ((byte2 & 0xc0u) >> 6)];
-                frame[3] = lookup[byte2 & 0x3fu];
-                sourceDataSize -= 3;
-            }
-            else
-            {
-                frame[2] = lookup[bits];
-                frame[3] = '=';
-                sourceDataSize = 0;
-            }
-        }
-        else
-        {
-            frame[1] = lookup[bits];
-            frame[2] = '=';
-            frame[3] = '=';
-            sourceDataSize = 0;
-        }
+        char frame[4];
+        frame[0] = encodingTable[bits >> 18];
+        frame[1] = encodingTable[(bits >> 12) & 0x3f];
+        frame[2] = sourceDataSize > 1 ? encodingTable[(bits >> 6) & 0x3f] : '=';
+        frame[3] = '=';
 
         if (! base64Result.write (frame, 4))
             return false;
@@ -72,34 +183,77 @@ bool Base64::convertToBase64 (OutputStream& base64Result, const void* sourceData
 
 bool Base64::convertFromBase64 (OutputStream& binaryOutput, StringRef base64TextInput)
 {
-    for (auto s = base64TextInput.text; ! s.isEmpty();)
+    using namespace Base64Helpers;
+
+    // (any non-ASCII character is invalid, so the UTF-8 bytes can be decoded directly)
+   #if JUCE_STRING_UTF_TYPE == 8
+    auto utf8 = base64TextInput.text;
+   #else
+    const String utf8Copy (base64TextInput.text);
+    auto utf8 = utf8Copy.toUTF8();
+   #endif
+
+    auto* text = utf8.getAddress();
+    auto length = utf8.sizeInBytes() - 1;
+    size_t pos = 0;
+
+   #if JUCE_INTEL
+    const bool useSSSE3 = SystemStats::hasSSSE3();
+   #endif
+
+    // the buffer leaves room at the end for the 16 bytes that a SIMD block writes
+    const size_t bufferSize = 3072;
+    uint8 buffer[bufferSize + 16];
+
+    while (pos < length)
     {
-        uint8 data[4];
+        size_t numInBuffer = 0;
 
-        for (int i = 0; i < 4; ++i)
+        while (numInBuffer < bufferSize && pos < length)
         {
-            auto c = (uint32) s.getAndAdvance();
+           #if JUCE_INTEL
+            if (useSSSE3 && pos + 16 <= length && decodeBlockSSSE3 (text + pos, buffer + numInBuffer))
+            {
+                pos += 16;
+                numInBuffer += 12;
+                continue;
+            }
+           #endif
 
-            if (c >= 'A' && c <= 'Z')         c -= 'A';
-            else if (c >= 'a' && c <= 'z')    c -= 'a' - 26;
-            else if (c >= '0' && c <= '9')    c += 52 - '0';
-            else if (c == '+')                c = 62;
-            else if (c == '/')                c = 63;
-            else if (c == '=')                { c = 64; if (i <= 1) return false; }
-            else                              return false;
+            // decode a single group of 4 characters, which may include padding
+            int data[4];
 
-            data[i] = (uint8) c;
-        }
+            for (int i = 0; i < 4; ++i)
+            {
+                auto c = pos < length ? (uint32) (uint8) text[pos++] : 0u;
+                auto value = decodeChar (c);
 
-        binaryOutput.writeByte ((char) ((data[0] << 2) | (data[1] >> 4)));
+                if (value < 0)
+                {
+                    if (c != '=' || i <= 1)
+                    {
+                        binaryOutput.write (buffer, numInBuffer);
+                        return false;
+                    }
 
-        if (data[2] < 64)
-        {
-            binaryOutput.writeByte ((char) ((data[1] << 4) | (data[2] >> 2)));
+                    value = 64;
+                }
 
-            if (data[3] < 64)
-                binaryOutput.writeByte ((char) ((data[2] << 6) | data[3]));
+                data[i] = value;
+            }
+
+            buffer[numInBuffer++] = (uint8) ((data[0] << 2) | (data[1] >> 4));
+
+            if (data[2] < 64)
+            {
+                buffer[numInBuffer++] = (uint8) ((data[1] << 4) | (data[2] >> 2));
+
+                if (data[3] < 64)
+                    buffer[numInBuffer++] = (uint8) ((data[2] << 6) | data[3]);
+            }
         }
+
+        binaryOutput.write (buffer, numInBuffer);
     }
 
     return true;
@@ -111,7 +265,7 @@ String Base64::toBase64 (const void* sourceData, size_t sourceDataSize)
     bool ok = convertToBase64 (m, sourceData, sourceDataSize);
     jassert (ok); // should always succeed for this simple case
     ignoreUnused (ok);
-    return m.toString();
+    return m.toUTF8();
 }
 
 String Base64::toBase64 (const String& text)
@@ -139,6 +293,42 @@ public:
         return m.getMemoryBlock();
     }
 
+    // The original byte-at-a-time decoder, for checking the results of the faster one
+    static bool referenceDecode (OutputStream& binaryOutput, StringRef base64TextInput)
+    {
+        for (auto s = base64TextInput.text; ! s.isEmpty();)
+        {
+            uint8 data[4];
+
+            for (int i = 0; i < 4; ++i)
+            {
+                auto c = (uint32) s.getAndAdvance();
+
+                if (c >= 'A' && c <= 'Z')         c -= 'A';
+                else if (c >= 'a' && c <= 'z')    c -= 'a' - 26;
+                else if (c >= '0' && c <= '9')    c += 52 - '0';
+                else if (c == '+')                c = 62;
+                else if (c == '/')                c = 63;
+                else if (c == '=')                { c = 64; if (i <= 1) return false; }
+                else                              return false;
+
+                data[i] = (uint8) c;
+            }
+
+            binaryOutput.writeByte ((char) ((data[0] << 2) | (data[1] >> 4)));
+
+            if (data[2] < 64)
+            {
+                binaryOutput.writeByte ((char) ((data[1] << 4) | (data[2] >> 2)));
+
+                if (data[3] < 64)
+                    binaryOutput.writeByte ((char) ((data[2] << 6) | data[3]));
+            }
+        }
+
+        return true;
+    }
+
     void runTest() override
     {
         beginTest ("Base64");
@@ -154,6 +344,106 @@ public:
             auto result = out.getMemoryBlock();
             expect (result == original);
         }
+
+        beginTest ("Large blocks");
+        {
+            for (int i = 0; i < 50; ++i)
+            {
+                MemoryBlock original ((size_t) r.nextInt (20000));
+                r.fillBitsRandomly (original.getData(), original.getSize());
+
+                auto asBase64 = Base64::toBase64 (original.getData(), original.getSize());
+                expectEquals (asBase64.length(), (int) ((original.getSize() + 2) / 3) * 4);
+
+                // compare the encoding with one made three bytes at a time
+                String expected;
+
+                for (size_t pos = 0; pos < original.getSize(); pos += 3)
+                    expected += Base64::toBase64 (static_cast<const char*> (original.getData()) + pos,
+                                                  jmin ((size_t) 3, original.getSize() - pos));
+
+                expect (asBase64 == expected);
+
+                MemoryOutputStream out;
+                expect (Base64::convertFromBase64 (out, asBase64));
+                expect (out.getMemoryBlock() == original);
+            }
+        }
+
+        beginTest ("Invalid input");
+        {
+            const char validChars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+            const String otherChars[] = { "=", "-", "_", " ", ".", "\n", CharPointer_UTF8 ("\xc3\xa9") };
+
+            for (int i = 0; i < 500; ++i)
+            {
+                String text;
+
+                for (int j = r.nextInt (100); --j >= 0;)
+                    text += r.nextInt (40) == 0 ? otherChars[r.nextInt (numElementsInArray (otherChars))]
+                                                : String::charToString ((juce_wchar) validChars[r.nextInt (64)]);
+
+                if (r.nextBool())
+                    text += r.nextBool() ? "=" : "==";
+
+                MemoryOutputStream out, expected;
+                expect (Base64::convertFromBase64 (out, text) == referenceDecode (expected, text));
+                expect (out.getMemoryBlock() == expected.getMemoryBlock());
+            }
+        }
+
+        beginTest ("MemoryBlock encoding");
+        {
+            for (int i = 0; i < 200; ++i)
+            {
+                auto original = createRandomData (r);
+
+                // compare with the encoding made using getBitRange, which the format is defined by
+                String expected (original.getSize());
+                expected << '.';
+
+                for (size_t bit = 0; bit < original.getSize() * 8; bit += 6)
+                    expected << String::charToString ((juce_wchar) ".ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+"
+                                                                    [original.getBitRange (bit, 6)]);
+
+                auto encoded = original.toBase64Encoding();
+                expect (encoded == expected);
+
+                // decoding mustn't touch anything beyond the end of the data
+                MemoryBlock decoded (original.getSize() + 1, false);
+                decoded.fillWith (0xff);
+                expect (decoded.fromBase64Encoding (encoded));
+                expect (decoded == original);
+            }
+        }
+
+        beginTest ("Benchmark");
+        {
+            MemoryBlock data (4 * 1024 * 1024);
+            r.fillBitsRandomly (data.getData(), data.getSize());
+
+            auto start = Time::getMillisecondCounterHiRes();
+            auto encoded = Base64::toBase64 (data.getData(), data.getSize());
+            auto encodeTime = Time::getMillisecondCounterHiRes() - start;
+
+            MemoryOutputStream out (data.getSize());
+            start = Time::getMillisecondCounterHiRes();
+            expect (Base64::convertFromBase64 (out, encoded));
+            auto decodeTime = Time::getMillisecondCounterHiRes() - start;
+
+            expect (out.getMemoryBlock() == data);
+
+            start = Time::getMillisecondCounterHiRes();
+            MemoryOutputStream referenceOut (data.getSize());
+            referenceDecode (referenceOut, encoded);
+            auto referenceTime = Time::getMillisecondCounterHiRes() - start;
+
+            auto megabytes = (double) data.getSize() / (1024.0 * 1024.0);
+
+            logMessage ("Base64 encoding " + String (megabytes / (encodeTime / 1000.0), 1) + " MB/s, decoding "
+                          + String (megabytes / (decodeTime / 1000.0), 1) + " MB/s (byte-at-a-time decoding "
+                          + String (megabytes / (referenceTime / 1000.0), 1) + " MB/s)");
+        }
     }
 };
 
@@ -0,0 +1,280 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+StringArena::StringArena (size_t chunk)
+    : initialBlock (nullptr), initialBlockSize (0), chunkSize (jmax ((size_t) 64, chunk)),
+      block (nullptr), blockSize (0)
+{
+}
+
+// (the characters in the initial block must be aligned if they're wider than a byte)
+StringArena::StringArena (void* initial, size_t initialSize, size_t chunk)
+    : initialBlock (snapPointerToAlignment (static_cast<char*> (initial), sizeof (CharType))),
+      initialBlockSize (initial == nullptr ? 0 : initialSize - jmin (initialSize, (size_t) getAddressDifference (initialBlock, initial))),
+      chunkSize (jmax ((size_t) 64, chunk)),
+      block (initialBlock), blockSize (initialBlockSize)
+{
+    jassert (initial != nullptr || initialSize == 0);
+}
+
+StringArena::~StringArena() {}
+
+//==============================================================================
+void StringArena::ensureSpace (size_t numBytesNeeded)
+{
+    // leave room for the terminator
+    if (position + numBytesNeeded + sizeof (CharType) <= blockSize)
+        return;
+
+    // the string being built has to be contiguous, so it moves into the new chunk
+    auto numBytesInString = position - stringStart;
+    auto numBytesRequired = numBytesInString + numBytesNeeded + sizeof (CharType);
+    char* newBlock;
+    size_t newSize;
+
+    // after a reset(), a kept chunk is waiting to be used once the initial block is full
+    if (block == initialBlock && chunks.size() == 1 && chunks.getFirst()->getSize() >= numBytesRequired)
+    {
+        newSize = chunks.getFirst()->getSize();
+    }
+    else
+    {
+        newSize = jmax (chunkSize, numBytesRequired * 2);
+        chunks.add (new MemoryBlock (newSize));
+    }
+
+    newBlock = static_cast<char*> (chunks.getLast()->getData());
+
+    if (numBytesInString > 0)
+        memcpy (newBlock, block + stringStart, numBytesInString);
+
+    block = newBlock;
+    blockSize = newSize;
+    stringStart = 0;
+    position = numBytesInString;
+}
+
+String::CharPointerType StringArena::getPointer (size_t offset) const noexcept
+{
+    return String::CharPointerType (reinterpret_cast<CharType*> (block + offset));
+}
+
+void StringArena::appendChar (juce_wchar character)
+{
+    ensureSpace (String::CharPointerType::getBytesRequiredFor (character));
+    auto dest = getPointer (position);
+    dest.write (character);
+    position = (size_t) getAddressDifference (dest.getAddress(), block);
+}
+
+void StringArena::append (String::CharPointerType start, String::CharPointerType end)
+{
+    auto numBytes = (size_t) getAddressDifference (end.getAddress(), start.getAddress());
+    ensureSpace (numBytes);
+    memcpy (block + position, start.getAddress(), numBytes);
+    position += numBytes;
+}
+
+void StringArena::append (StringRef text)
+{
+    append (text.text, text.text.findTerminatingNull());
+}
+
+StringRef StringArena::finishString()
+{
+    ensureSpace (0);
+    getPointer (position).writeNull();
+    position += sizeof (CharType);
+
+    auto start = getPointer (stringStart);
+    stringStart = position;
+    return StringRef (start);
+}
+
+StringRef StringArena::add (StringRef text)
+{
+    jassert (getNumBytesInCurrentString() == 0); // finish the current string first!
+
+    append (text);
+    return finishString();
+}
+
+//==============================================================================
+void StringArena::reset() noexcept
+{
+    // keep the last chunk, which is also the largest, for reuse
+    if (chunks.size() > 1)
+        chunks.removeRange (0, chunks.size() - 1);
+
+    if (initialBlock != nullptr || chunks.isEmpty())
+    {
+        block = initialBlock;
+        blockSize = initialBlockSize;
+    }
+    else
+    {
+        block = static_cast<char*> (chunks.getFirst()->getData());
+        blockSize = chunks.getFirst()->getSize();
+    }
+
+    position = stringStart = 0;
+}
+
+size_t StringArena::getNumBytesAllocated() const noexcept
+{
+    size_t total = 0;
+
+    for (auto* chunk : chunks)
+        total += chunk->getSize();
+
+    return total;
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class StringArenaTests  : public UnitTest
+{
+public:
+    StringArenaTests() : UnitTest ("StringArena", "Text") {}
+
+    void runTest() override
+    {
+        beginTest ("Building strings");
+        {
+            // (the sizes are in characters, which are wider than a byte unless String is UTF-8)
+            String::CharPointerType::CharType buffer[16];
+            const int chunkSize = 64 * (int) sizeof (buffer[0]);
+            StringArena arena (buffer, sizeof (buffer), (size_t) chunkSize);
+
+            arena.append ("abc");
+            arena.appendChar (0x20ac);
+            auto first = arena.finishString();
+
+            expect (first.text.getAddress() == buffer);
+            expectEquals (String (first.text), String ("abc") + String::charToString (0x20ac));
+            expectEquals ((int) arena.getNumBytesAllocated(), 0);
+
+            // this one doesn't fit in the initial block, so must move to a chunk
+            arena.append ("0123456789");
+            arena.append ("0123456789");
+            auto second = arena.finishString();
+            auto third = arena.add ("xyz");
+
+            expect (second.text.getAddress() != buffer);
+            expectEquals (String (second.text), String ("01234567890123456789"));
+            expectEquals (String (third.text), String ("xyz"));
+            expectEquals (String (first.text), String ("abc") + String::charToString (0x20ac));
+            expectEquals ((int) arena.getNumBytesAllocated(), chunkSize);
+
+            arena.reset();
+            expect (arena.add ("abc").text.getAddress() == buffer);
+            expect (arena.add (String::repeatedString ("x", 30)).text.getAddress() != buffer);
+            expectEquals ((int) arena.getNumBytesAllocated(), chunkSize);
+        }
+
+        beginTest ("Long strings");
+        {
+            StringArena arena (64);
+            String expected;
+
+            for (int i = 0; i < 1000; ++i)
+            {
+                arena.appendChar ((juce_wchar) ('a' + i % 26));
+                expected << (juce_wchar) ('a' + i % 26);
+            }
+
+            expectEquals (String (arena.finishString().text), expected);
+            expectEquals (String (arena.add ("").text), String());
+        }
+
+        beginTest ("Parser throughput");
+        {
+            auto json = createTestJSON();
+            auto xml = createTestXML();
+
+            auto jsonTime = timeParse ([&] { var v (JSON::parse (json)); });
+            auto xmlTime = timeParse ([&] { ScopedPointer<XmlElement> e (XmlDocument::parse (xml)); });
+
+            logMessage ("JSON::parse of " + File::descriptionOfSizeInBytes (json.getNumBytesAsUTF8())
+                         + ": " + String (jsonTime * 1000.0, 2) + " ms");
+            logMessage ("XmlDocument::parse of " + File::descriptionOfSizeInBytes (xml.getNumBytesAsUTF8())
+                         + ": " + String (xmlTime * 1000.0, 2) + " ms");
+
+            expect (JSON::parse (json).size() == 20001);
+        }
+    }
+
+    static String createTestJSON()
+    {
+        MemoryOutputStream json;
+        json << "[\n";
+
+        for (int i = 0; i < 20000; ++i)
+            json << "  { \"id\": " << i << ", \"name\": \"item" << i << "\", \"type\": \"preset\", "
+                 << "\"gain\": " << (i % 100) * 0.01 << ", \"enabled\": true, \"tags\": [\"a\", \"b\"] },\n";
+
+        json << "  {}\n]";
+        return json.toString();
+    }
+
+    static String createTestXML()
+    {
+        MemoryOutputStream xml;
+        xml << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<PRESETS>\n";
+
+        for (int i = 0; i < 20000; ++i)
+            xml << "  <PRESET id=\"" << i << "\" name=\"item" << i << "\" type=\"preset\">\n"
+                << "    <PARAM name=\"gain\" value=\"" << (i % 100) * 0.01 << "\"/>\n"
+                << "    <NOTES>Some text &amp; more</NOTES>\n"
+                << "  </PRESET>\n";
+
+        xml << "</PRESETS>\n";
+        return xml.toString();
+    }
+
+    template <typename ParseFunction>
+    static double timeParse (ParseFunction parse)
+    {
+        double best = 1.0e10;
+
+        for (int i = 0; i < 5; ++i)
+        {
+            auto start = Time::getHighResolutionTicks();
+            parse();
+            best = jmin (best, Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start));
+        }
+
+        return best;
+    }
+};
+
+static StringArenaTests stringArenaTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,124 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A block of memory into which a parser can build lots of short-lived strings
+    without allocating each one separately.
+
+    The strings are stored in the same encoding as the String class uses (UTF-8 unless
+    JUCE_STRING_UTF_TYPE has been changed), so that they can be returned as StringRefs.
+
+    Text is appended to the current string with the append methods, and finishString()
+    then terminates it and returns a reference to it. The strings stay valid until the
+    arena is reset or deleted, and are simply abandoned when that happens, so there's no
+    per-string allocation or reference-counting.
+
+    The arena can start with a block of memory that the caller provides, e.g. a buffer
+    on the stack, and only allocates more from the heap when that fills up. That makes
+    it a cheap scratch buffer for building up text that will be turned into a String,
+    or into an Identifier which is usually already in the StringPool:
+
+    @code
+    char buffer[256];
+    StringArena arena (buffer, sizeof (buffer));
+
+    while (! isEndOfName (*p))
+        arena.appendChar (p.getAndAdvance());
+
+    auto name = arena.finishString();
+    const Identifier id (name.text, name.text.findTerminatingNull());
+    @endcode
+
+    A StringRef returned by the arena must not be used after the arena is reset, so
+    copy it into a String if it needs to last longer.
+
+    @see StringRef, StringPool
+*/
+class JUCE_API  StringArena
+{
+public:
+    //==============================================================================
+    /** Creates an arena which allocates its memory in chunks of the given size. */
+    explicit StringArena (size_t chunkSize = 4096);
+
+    /** Creates an arena which uses a block of memory provided by the caller before
+        allocating any more. The block must stay valid for the lifetime of the arena.
+    */
+    StringArena (void* initialBlock, size_t initialBlockSize, size_t chunkSize = 4096);
+
+    /** Destructor. */
+    ~StringArena();
+
+    //==============================================================================
+    /** Appends a character to the current string. */
+    void appendChar (juce_wchar character);
+
+    /** Appends some text to the current string. */
+    void append (String::CharPointerType start, String::CharPointerType end);
+
+    /** Appends some text to the current string. */
+    void append (StringRef text);
+
+    /** Returns the number of bytes in the current string so far. */
+    size_t getNumBytesInCurrentString() const noexcept     { return position - stringStart; }
+
+    /** Null-terminates the current string, and returns a reference to it.
+        The next call to one of the append methods will start a new string.
+    */
+    StringRef finishString();
+
+    /** Copies a string into the arena and returns a reference to the copy. */
+    StringRef add (StringRef text);
+
+    //==============================================================================
+    /** Discards all the strings in the arena.
+        The most recently allocated chunk is kept to be reused, and any others are freed.
+    */
+    void reset() noexcept;
+
+    /** Returns the total number of bytes that the arena has allocated from the heap. */
+    size_t getNumBytesAllocated() const noexcept;
+
+private:
+    //==============================================================================
+    char* const initialBlock;
+    const size_t initialBlockSize, chunkSize;
+
+    OwnedArray<MemoryBlock> chunks;
+
+    char* block;
+    size_t blockSize, position = 0, stringStart = 0;
+
+    using CharType = String::CharPointerType::CharType;
+
+    void ensureSpace (size_t numBytesNeeded);
+    String::CharPointerType getPointer (size_t offset) const noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE (StringArena)
+};
+
+} // namespace juce
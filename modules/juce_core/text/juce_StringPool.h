@@ -33,6 +33,11 @@ namespace juce
     is returned every time a matching string is asked for. This means that it's trivial to
     compare two pooled strings for equality, as you can simply compare their pointers. It
     also cuts down on storage if you're using many copies of the same string.
+
+    The pool is safe to use from multiple threads. It's split into a number of hash
+    tables, each with its own lock which is only needed when adding or removing strings,
+    so finding a string that's already in the pool doesn't block, and threads that add
+    different strings rarely wait for each other.
 */
 class JUCE_API  StringPool
 {
@@ -76,11 +81,10 @@ public:
     static StringPool& getGlobalPool() noexcept;
 
 private:
-    Array<String> strings;
-    CriticalSection lock;
-    uint32 lastGarbageCollectionTime;
+    struct Shard;
+    OwnedArray<Shard> shards;
 
-    void garbageCollectIfNeeded();
+    Shard& getShard (uint32 hash) const noexcept;
 
     JUCE_DECLARE_NON_COPYABLE (StringPool)
 };
@@ -0,0 +1,417 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+//==============================================================================
+struct RealtimeThreadPool::Semaphore
+{
+   #if JUCE_LINUX || JUCE_ANDROID
+    void post (int num) noexcept
+    {
+        count += num;
+
+        if (numWaiters.get() > 0)
+            syscall (SYS_futex, getAddress(), FUTEX_WAKE_PRIVATE, num, nullptr, nullptr, 0);
+    }
+
+    void wait() noexcept
+    {
+        for (;;)
+        {
+            auto available = count.get();
+
+            if (available > 0)
+            {
+                if (count.compareAndSetBool (available - 1, available))
+                    return;
+
+                continue;
+            }
+
+            // the futex call returns immediately if a post has arrived since the count was read
+            ++numWaiters;
+            syscall (SYS_futex, getAddress(), FUTEX_WAIT_PRIVATE, 0, nullptr, nullptr, 0);
+            --numWaiters;
+        }
+    }
+
+    int* getAddress() noexcept    { return (int*) &count.value; }
+
+    Atomic<int> count, numWaiters;
+
+   #elif JUCE_MAC || JUCE_IOS
+    Semaphore() noexcept    { semaphore_create (mach_task_self(), &semaphore, SYNC_POLICY_FIFO, 0); }
+    ~Semaphore() noexcept   { semaphore_destroy (mach_task_self(), semaphore); }
+
+    void post (int num) noexcept
+    {
+        while (--num >= 0)
+            semaphore_signal (semaphore);
+    }
+
+    void wait() noexcept
+    {
+        while (semaphore_wait (semaphore) != KERN_SUCCESS)
+        {}
+    }
+
+    semaphore_t semaphore;
+
+   #else
+    Semaphore() noexcept    : handle (CreateSemaphore (nullptr, 0, 0x7fffffff, nullptr)) {}
+    ~Semaphore() noexcept   { CloseHandle (handle); }
+
+    void post (int num) noexcept    { ReleaseSemaphore (handle, num, nullptr); }
+    void wait() noexcept            { WaitForSingleObject (handle, INFINITE); }
+
+    HANDLE handle;
+   #endif
+};
+
+//==============================================================================
+class RealtimeThreadPool::Worker  : public Thread
+{
+public:
+    Worker (RealtimeThreadPool& p, int index, int priority, bool lockStack)
+        : Thread ("Realtime Pool " + String (index)),
+          pool (p), realtimePriority (priority), shouldLockStack (lockStack)
+    {
+    }
+
+    void run() override
+    {
+        if (setRealtimeScheduling (realtimePriority))
+            ++pool.numRealtimeWorkers;
+
+        if (shouldLockStack && lockStack())
+            ++pool.numLockedWorkers;
+
+        if (++pool.numWorkersStarted == pool.workers.size())
+            pool.allWorkersStarted.signal();
+
+        for (;;)
+        {
+            pool.workAvailable->wait();
+
+            if (threadShouldExit())
+                break;
+
+            // join() can't return until this worker has finished, so the block
+            // number can't change underneath it
+            auto block = pool.blockNumber;
+
+            pool.runTasks();
+            pool.workerFinished (block);
+        }
+    }
+
+private:
+    RealtimeThreadPool& pool;
+    const int realtimePriority;
+    const bool shouldLockStack;
+
+    static bool setRealtimeScheduling (int priority) noexcept
+    {
+       #if JUCE_LINUX || JUCE_ANDROID
+        sched_param param;
+        param.sched_priority = jlimit (sched_get_priority_min (SCHED_FIFO),
+                                       sched_get_priority_max (SCHED_FIFO),
+                                       priority);
+
+        if (pthread_setschedparam (pthread_self(), SCHED_FIFO, &param) == 0)
+            return true;
+
+        setCurrentThreadPriority (10);
+        return false;
+       #else
+        ignoreUnused (priority);
+        return setCurrentThreadPriority (10);
+       #endif
+    }
+
+    // Touches a block of the stack below the caller's frame, so that its pages are
+    // mapped in, and then locks them so that they can't be paged out again.
+   #if JUCE_MSVC
+    __declspec (noinline)
+   #else
+    __attribute__ ((noinline))
+   #endif
+    static bool lockStack() noexcept
+    {
+        char region[RealtimeThreadPool::lockedStackSize];
+        zeromem (region, sizeof (region));
+
+       #if JUCE_WINDOWS
+        return VirtualLock (region, sizeof (region)) != 0;
+       #else
+        auto pageSize = (pointer_sized_int) sysconf (_SC_PAGESIZE);
+        auto start = (pointer_sized_int) region & ~(pageSize - 1);
+        auto end = (pointer_sized_int) region + (pointer_sized_int) sizeof (region);
+
+        return mlock ((void*) start, (size_t) (end - start)) == 0;
+       #endif
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (Worker)
+};
+
+//==============================================================================
+RealtimeThreadPool::RealtimeThreadPool (int numWorkerThreads, int realtimePriority, bool lockStackMemory)
+    : workAvailable (new Semaphore()),
+      workersFinished (new Semaphore())
+{
+    jassert (numWorkerThreads >= 0);
+
+    for (int i = 0; i < numWorkerThreads; ++i)
+        workers.add (new Worker (*this, i, realtimePriority, lockStackMemory));
+
+    for (auto* w : workers)
+        w->startThread();
+
+    // wait for the workers to set themselves up, so that isRealtime() is meaningful
+    if (workers.size() > 0)
+        allWorkersStarted.wait (5000);
+}
+
+RealtimeThreadPool::~RealtimeThreadPool()
+{
+    jassert (! isForked); // you must call join() before deleting the pool!
+
+    for (auto* w : workers)
+        w->signalThreadShouldExit();
+
+    workAvailable->post (workers.size());
+
+    for (auto* w : workers)
+        w->stopThread (-1);
+
+    workers.clear();
+}
+
+int RealtimeThreadPool::getNumThreads() const noexcept      { return workers.size(); }
+bool RealtimeThreadPool::isRealtime() const noexcept        { return numRealtimeWorkers.get() == workers.size(); }
+bool RealtimeThreadPool::isMemoryLocked() const noexcept    { return numLockedWorkers.get() == workers.size(); }
+
+//==============================================================================
+void RealtimeThreadPool::forkTasks (int num, void* context, TaskFunction function) noexcept
+{
+    jassert (! isForked); // each fork() must be followed by a join()
+    isForked = true;
+
+    taskContext = context;
+    taskFunction = function;
+    numTasksInBlock = jmax (0, num);
+    nextTask.set (0);
+
+    // zero means that nobody is waiting, so the numbering skips it when it wraps
+    blockNumber = (blockNumber == std::numeric_limits<int>::max() ? 1 : blockNumber + 1);
+
+    // the calling thread will take one of the tasks in join(), so there's no point
+    // waking a worker for each task
+    auto numToWake = jmin (numTasksInBlock - 1, workers.size());
+
+    if (numToWake > 0)
+    {
+        numWorkersRunning.set (numToWake);
+        workAvailable->post (numToWake);
+    }
+}
+
+void RealtimeThreadPool::join() noexcept
+{
+    jassert (isForked);
+
+    runTasks();
+
+    // the workers will usually be finishing their last tasks, so spin for a moment
+    // before paying for a system call
+    for (int i = 0; i < 2000 && numWorkersRunning.get() > 0; ++i)
+    {}
+
+    if (numWorkersRunning.get() > 0)
+    {
+        // The flag holds the number of this block, so that a worker which finished an
+        // earlier block, but was preempted before checking the flag, can't take it
+        blockBeingJoined.set (blockNumber);
+
+        if (numWorkersRunning.get() > 0)
+        {
+            workersFinished->wait();
+        }
+        else if (! blockBeingJoined.compareAndSetBool (0, blockNumber))
+        {
+            // the last worker saw the flag and has posted, so take that post
+            workersFinished->wait();
+        }
+    }
+
+    isForked = false;
+}
+
+void RealtimeThreadPool::runTasks() noexcept
+{
+    for (;;)
+    {
+        auto index = (++nextTask) - 1;
+
+        if (index >= numTasksInBlock)
+            return;
+
+        taskFunction (taskContext, index);
+    }
+}
+
+void RealtimeThreadPool::workerFinished (int block) noexcept
+{
+    if (--numWorkersRunning == 0 && blockBeingJoined.compareAndSetBool (0, block))
+        workersFinished->post (1);
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class RealtimeThreadPoolTests  : public UnitTest
+{
+public:
+    RealtimeThreadPoolTests() : UnitTest ("RealtimeThreadPool", "Threads") {}
+
+    void runTest() override
+    {
+        const int numWorkers = jmax (1, SystemStats::getNumCpus() - 1);
+
+        {
+            RealtimeThreadPool pool (numWorkers);
+
+            logMessage ("Real-time scheduling: " + String (pool.isRealtime() ? "yes" : "no")
+                         + ", stack locked: " + String (pool.isMemoryLocked() ? "yes" : "no"));
+
+            beginTest ("forkJoin runs every task once");
+            {
+                const int numTasks = 37;
+                Atomic<int> counts[numTasks];
+                bool allRanOnce = true;
+
+                for (int block = 0; block < 2000; ++block)
+                {
+                    for (auto& c : counts)
+                        c.set (0);
+
+                    pool.forkJoin (numTasks, [&] (int index) { ++counts[index]; });
+
+                    for (auto& c : counts)
+                        allRanOnce = allRanOnce && c.get() == 1;
+                }
+
+                expect (allRanOnce);
+            }
+
+            beginTest ("fork and join around the caller's own work");
+            {
+                HeapBlock<float> data (4096, true);
+                bool allCorrect = true;
+
+                auto task = [&] (int index)
+                {
+                    for (int i = 0; i < 256; ++i)
+                        data[index * 256 + i] += 1.0f;
+                };
+
+                for (int block = 0; block < 500; ++block)
+                {
+                    pool.fork (16, task);
+
+                    float callerWork = 0;
+                    for (int i = 0; i < 100; ++i)
+                        callerWork += (float) i;
+
+                    pool.join();
+                    allCorrect = allCorrect && callerWork == 4950.0f;
+                }
+
+                for (int i = 0; i < 4096; ++i)
+                    allCorrect = allCorrect && data[i] == 500.0f;
+
+                expect (allCorrect);
+            }
+
+            beginTest ("Tasks with fewer than two items");
+            {
+                int count = 0;
+                pool.forkJoin (1, [&] (int) { ++count; });
+                pool.forkJoin (0, [&] (int) { ++count; });
+                expectEquals (count, 1);
+            }
+        }
+
+        beginTest ("Pool with no workers");
+        {
+            RealtimeThreadPool pool (0, RealtimeThreadPool::defaultRealtimePriority, false);
+            Atomic<int> count;
+            pool.forkJoin (10, [&] (int) { ++count; });
+            expectEquals (count.get(), 10);
+        }
+
+        beginTest ("Fork-join latency");
+        {
+            const int numBlocks = 5000;
+            const int numTasks = numWorkers + 1;
+            Atomic<int> sink;
+            auto task = [&] (int index) { sink += index; };
+
+            RealtimeThreadPool pool (numWorkers);
+            auto start = Time::getHighResolutionTicks();
+
+            for (int i = 0; i < numBlocks; ++i)
+                pool.forkJoin (numTasks, task);
+
+            auto poolTime = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start);
+
+            TaskScheduler scheduler (numWorkers);
+            start = Time::getHighResolutionTicks();
+
+            for (int i = 0; i < numBlocks; ++i)
+                scheduler.parallelFor (0, numTasks, [&] (int chunkStart, int chunkEnd)
+                {
+                    for (int j = chunkStart; j < chunkEnd; ++j)
+                        task (j);
+                }, 1);
+
+            auto schedulerTime = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start);
+
+            logMessage ("Fork-join of " + String (numTasks) + " tasks: RealtimeThreadPool "
+                         + String (poolTime * 1.0e6 / numBlocks, 2) + " us, TaskScheduler "
+                         + String (schedulerTime * 1.0e6 / numBlocks, 2) + " us");
+
+            expectEquals (sink.get(), 2 * numBlocks * (numTasks * (numTasks - 1) / 2));
+        }
+    }
+};
+
+static RealtimeThreadPoolTests realtimeThreadPoolTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,153 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A group of real-time threads which help an audio callback to process its block.
+
+    The audio thread calls fork() to hand out a number of tasks for the current block,
+    can carry on with its own work, and then calls join(), which runs any tasks that
+    haven't been started yet and waits for the rest to finish before returning.
+
+    @code
+    void processBlock (AudioBuffer<float>& buffer)
+    {
+        pool.forkJoin (voices.size(), [&] (int voiceIndex)
+        {
+            voices[voiceIndex]->render (voiceBuffers[voiceIndex]);
+        });
+
+        // ..all the voices have now been rendered
+    }
+    @endcode
+
+    Neither fork() nor join() allocates memory or takes a lock. The idle workers block
+    on a semaphore (a futex on Linux and Android), so waking them is a single system
+    call rather than waiting for a WaitableEvent to time out, and join() spins for a
+    moment before blocking, as the last tasks are usually about to finish.
+
+    On Linux the workers use the SCHED_FIFO policy, which needs the process to have
+    a suitable RLIMIT_RTPRIO or the CAP_SYS_NICE capability; if that fails, they run at
+    the highest normal priority, and isRealtime() will return false. On the other
+    platforms, they use Thread's highest priority. The workers can also pre-fault and
+    lock their stacks into memory, so that a task can't stall on a page fault.
+
+    Only one thread (normally the audio thread) should use a pool, and it must
+    always call join() after fork().
+
+    @see TaskScheduler, ThreadPool
+*/
+class JUCE_API  RealtimeThreadPool
+{
+public:
+    //==============================================================================
+    /** The default priority of the workers, on the 1 to 99 scale of SCHED_FIFO. */
+    static constexpr int defaultRealtimePriority = 70;
+
+    /** Creates the worker threads.
+
+        @param numWorkerThreads     the number of threads to create, in addition to the
+                                    thread which calls fork() and join(). Typically this is
+                                    one fewer than the number of CPU cores.
+        @param realtimePriority     the SCHED_FIFO priority to use on Linux
+        @param lockStackMemory      if true, each worker pre-faults and locks the first
+                                    lockedStackSize bytes of its stack into memory
+    */
+    RealtimeThreadPool (int numWorkerThreads,
+                        int realtimePriority = defaultRealtimePriority,
+                        bool lockStackMemory = true);
+
+    /** Destructor. This mustn't be called between fork() and join(). */
+    ~RealtimeThreadPool();
+
+    //==============================================================================
+    /** Returns the number of worker threads. */
+    int getNumThreads() const noexcept;
+
+    /** Returns true if all the workers managed to get real-time scheduling. */
+    bool isRealtime() const noexcept;
+
+    /** Returns true if all the workers managed to lock their stacks into memory. */
+    bool isMemoryLocked() const noexcept;
+
+    /** The number of bytes of each worker's stack which are locked into memory. */
+    static constexpr size_t lockedStackSize = 128 * 1024;
+
+    //==============================================================================
+    /** Starts running some tasks on the workers.
+
+        The function will be called once for each task index from 0 to numTasks - 1,
+        on the workers and on the thread which calls join(). It must stay valid until
+        join() has returned.
+    */
+    template <typename FunctionType>
+    void fork (int numTasks, FunctionType& function) noexcept
+    {
+        forkTasks (numTasks, &function, [] (void* context, int taskIndex)
+        {
+            (*static_cast<FunctionType*> (context)) (taskIndex);
+        });
+    }
+
+    /** Runs the tasks passed to fork() which haven't been started yet, and then waits
+        for the workers to finish the rest.
+    */
+    void join() noexcept;
+
+    /** Calls fork() and then join(). */
+    template <typename FunctionType>
+    void forkJoin (int numTasks, FunctionType&& function) noexcept
+    {
+        fork (numTasks, function);
+        join();
+    }
+
+private:
+    //==============================================================================
+    using TaskFunction = void (*) (void*, int);
+
+    struct Semaphore;
+    class Worker;
+
+    OwnedArray<Worker> workers;
+    ScopedPointer<Semaphore> workAvailable, workersFinished;
+    WaitableEvent allWorkersStarted;
+    Atomic<int> numWorkersStarted, numRealtimeWorkers, numLockedWorkers;
+
+    void* taskContext = nullptr;
+    TaskFunction taskFunction = nullptr;
+    int numTasksInBlock = 0, blockNumber = 0;
+    Atomic<int> nextTask, numWorkersRunning, blockBeingJoined;
+    bool isForked = false;
+
+    void forkTasks (int num, void* context, TaskFunction) noexcept;
+    void runTasks() noexcept;
+    void workerFinished (int block) noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RealtimeThreadPool)
+};
+
+} // namespace juce
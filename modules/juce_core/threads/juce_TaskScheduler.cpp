@@ -0,0 +1,754 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+class TaskScheduler::Task  : public ReferenceCountedObject
+{
+public:
+    Task (std::function<void()> f)  : function (std::move (f)) {}
+    Task (ThreadPoolJob& j)  : job (&j) {}
+
+    std::function<void()> function;
+    ThreadPoolJob* const job = nullptr;
+
+    // starts at one so that the task can't be scheduled while its dependencies are being added
+    Atomic<int> numUnfinishedDependencies { 1 };
+
+    Atomic<int> finished;
+    WaitableEvent finishedEvent { true };
+
+    SpinLock dependentsLock;
+    ReferenceCountedArray<Task> dependents;
+
+    using Ptr = ReferenceCountedObjectPtr<Task>;
+
+    JUCE_DECLARE_NON_COPYABLE (Task)
+};
+
+//==============================================================================
+struct TaskScheduler::WorkQueue
+{
+    void push (Task* task)
+    {
+        const SpinLock::ScopedLockType sl (lock);
+        tasks.add (task);
+        ++numTasks;
+    }
+
+    // The owning thread takes the newest task, which is the most likely to
+    // still be in its cache..
+    Task* popNewest()
+    {
+        if (numTasks.get() == 0)
+            return nullptr;
+
+        const SpinLock::ScopedLockType sl (lock);
+
+        if (first >= tasks.size())
+            return nullptr;
+
+        auto* task = tasks.removeAndReturn (tasks.size() - 1);
+        taskRemoved();
+        return task;
+    }
+
+    // ..and other threads steal the oldest one, which is likely to be
+    // the start of a bigger chunk of work.
+    Task* stealOldest()
+    {
+        if (numTasks.get() == 0)
+            return nullptr;
+
+        const SpinLock::ScopedLockType sl (lock);
+
+        if (first >= tasks.size())
+            return nullptr;
+
+        auto* task = tasks.getUnchecked (first++);
+        taskRemoved();
+        return task;
+    }
+
+    void taskRemoved() noexcept
+    {
+        --numTasks;
+
+        if (first >= tasks.size())
+        {
+            tasks.clearQuick();
+            first = 0;
+        }
+        else if (first > 64 && first > tasks.size() / 2)
+        {
+            tasks.removeRange (0, first);
+            first = 0;
+        }
+    }
+
+    SpinLock lock;
+    Array<Task*> tasks;
+    int first = 0;
+    Atomic<int> numTasks;
+};
+
+//==============================================================================
+class TaskScheduler::WorkerThread  : public Thread
+{
+public:
+    WorkerThread (TaskScheduler& s, int threadIndex, size_t stackSize)
+        : Thread ("Task scheduler", stackSize), owner (s), index (threadIndex)
+    {
+    }
+
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            if (auto* task = owner.findTask (this))
+                owner.runTask (task);
+            else
+                owner.sleep (*this);
+        }
+    }
+
+    TaskScheduler& owner;
+    const int index;
+    WorkQueue queue;
+    Atomic<int> isSleeping;
+    ThreadPoolJob* currentJob = nullptr;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WorkerThread)
+};
+
+//==============================================================================
+TaskScheduler::TaskHandle::TaskHandle() noexcept {}
+TaskScheduler::TaskHandle::TaskHandle (const TaskHandle& other) noexcept  : task (other.task) {}
+TaskScheduler::TaskHandle::~TaskHandle() {}
+
+TaskScheduler::TaskHandle& TaskScheduler::TaskHandle::operator= (const TaskHandle& other) noexcept
+{
+    task = other.task;
+    return *this;
+}
+
+bool TaskScheduler::TaskHandle::isValid() const noexcept
+{
+    return task != nullptr;
+}
+
+bool TaskScheduler::TaskHandle::isFinished() const noexcept
+{
+    return task != nullptr && task->finished.get() != 0;
+}
+
+bool TaskScheduler::TaskHandle::wait (int timeOutMilliseconds) const
+{
+    if (task == nullptr || task->finished.get() != 0)
+        return true;
+
+    if (auto* worker = dynamic_cast<WorkerThread*> (Thread::getCurrentThread()))
+        return worker->owner.waitWhileHelping (*task, timeOutMilliseconds);
+
+    return task->finishedEvent.wait (timeOutMilliseconds);
+}
+
+//==============================================================================
+TaskScheduler::TaskScheduler()  : TaskScheduler (SystemStats::getNumCpus())
+{
+}
+
+TaskScheduler::TaskScheduler (int numThreads, size_t threadStackSize)  : sharedQueue (new WorkQueue())
+{
+    jassert (numThreads > 0); // not much point having a scheduler without any threads!
+
+    createThreads (jmax (1, numThreads), threadStackSize);
+}
+
+TaskScheduler::~TaskScheduler()
+{
+    {
+        const ScopedLock sl (jobLock);
+
+        for (auto* job : activeJobs)
+            job->signalJobShouldExit();
+    }
+
+    waitForAllTasks();
+
+    for (auto* w : workers)
+        w->signalThreadShouldExit();
+
+    for (auto* w : workers)
+    {
+        w->notify();
+        w->stopThread (500);
+    }
+}
+
+void TaskScheduler::createThreads (int numThreads, size_t threadStackSize)
+{
+    for (int i = 0; i < numThreads; ++i)
+        workers.add (new WorkerThread (*this, i, threadStackSize));
+
+    for (auto* w : workers)
+        w->startThread();
+}
+
+int TaskScheduler::getNumThreads() const noexcept
+{
+    return workers.size();
+}
+
+int TaskScheduler::getNumPendingTasks() const noexcept
+{
+    return numPendingTasks.get();
+}
+
+bool TaskScheduler::setThreadPriorities (int newPriority)
+{
+    bool ok = true;
+
+    for (auto* w : workers)
+        if (! w->setPriority (newPriority))
+            ok = false;
+
+    return ok;
+}
+
+//==============================================================================
+TaskScheduler::TaskHandle TaskScheduler::addTask (std::function<void()> function)
+{
+    return addTask (std::move (function), {});
+}
+
+TaskScheduler::TaskHandle TaskScheduler::addTask (std::function<void()> function, const Array<TaskHandle>& dependencies)
+{
+    jassert (function != nullptr);
+    return submit (new Task (std::move (function)), dependencies);
+}
+
+TaskScheduler::TaskHandle TaskScheduler::addJob (ThreadPoolJob* job, bool deleteJobWhenFinished)
+{
+    jassert (job != nullptr);
+    jassert (job->pool == nullptr); // a job can't be in a ThreadPool and a TaskScheduler at once!
+
+    job->shouldStop = false;
+    job->isActive = false;
+    job->shouldBeDeleted = deleteJobWhenFinished;
+
+    {
+        const ScopedLock sl (jobLock);
+        activeJobs.add (job);
+    }
+
+    return submit (new Task (*job), {});
+}
+
+TaskScheduler::TaskHandle TaskScheduler::submit (Task* newTask, const Array<TaskHandle>& dependencies)
+{
+    Task::Ptr task (newTask);
+    ++numPendingTasks;
+
+    for (auto& dependency : dependencies)
+    {
+        if (auto* other = dependency.task.get())
+        {
+            const SpinLock::ScopedLockType sl (other->dependentsLock);
+
+            if (other->finished.get() == 0)
+            {
+                other->dependents.add (task);
+                ++(task->numUnfinishedDependencies);
+            }
+        }
+    }
+
+    if (--(task->numUnfinishedDependencies) == 0)
+        schedule (task.get());
+
+    TaskHandle handle;
+    handle.task = task;
+    return handle;
+}
+
+//==============================================================================
+TaskScheduler::WorkerThread* TaskScheduler::getCurrentWorker() const noexcept
+{
+    auto* worker = dynamic_cast<WorkerThread*> (Thread::getCurrentThread());
+    return worker != nullptr && &(worker->owner) == this ? worker : nullptr;
+}
+
+void TaskScheduler::schedule (Task* task)
+{
+    // the queues hold a reference to each task until it has run
+    task->incReferenceCount();
+
+    if (auto* worker = getCurrentWorker())
+        worker->queue.push (task);
+    else
+        sharedQueue->push (task);
+
+    wakeOneThread();
+}
+
+void TaskScheduler::wakeOneThread()
+{
+    if (numSleepingThreads.get() == 0)
+        return;
+
+    for (auto* w : workers)
+    {
+        if (w->isSleeping.compareAndSetBool (0, 1))
+        {
+            w->notify();
+            return;
+        }
+    }
+}
+
+void TaskScheduler::sleep (WorkerThread& worker)
+{
+    // The flags are set before checking the queues, and schedule() adds to a queue before
+    // checking the flags, so a task can't be added without either this thread seeing it
+    // or the scheduling thread waking it up.
+    worker.isSleeping.set (1);
+    ++numSleepingThreads;
+
+    if (! hasQueuedTasks() && ! worker.threadShouldExit())
+        worker.wait (-1);
+
+    worker.isSleeping.set (0);
+    --numSleepingThreads;
+}
+
+bool TaskScheduler::hasQueuedTasks() const noexcept
+{
+    if (sharedQueue->numTasks.get() != 0)
+        return true;
+
+    for (auto* w : workers)
+        if (w->queue.numTasks.get() != 0)
+            return true;
+
+    return false;
+}
+
+TaskScheduler::Task* TaskScheduler::findTask (WorkerThread* worker)
+{
+    if (worker != nullptr)
+        if (auto* task = worker->queue.popNewest())
+            return task;
+
+    if (auto* task = sharedQueue->stealOldest())
+        return task;
+
+    auto numWorkers = workers.size();
+    auto firstVictim = worker != nullptr ? worker->index + 1 : 0;
+
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        auto* victim = workers.getUnchecked ((firstVictim + i) % numWorkers);
+
+        if (victim != worker)
+            if (auto* task = victim->queue.stealOldest())
+                return task;
+    }
+
+    return nullptr;
+}
+
+void TaskScheduler::runTask (Task* task)
+{
+    if (task->job != nullptr)
+    {
+        if (runJob (*task->job))
+        {
+            // put it at the back of the shared queue, so that other tasks get a go first
+            sharedQueue->push (task);
+            wakeOneThread();
+            return;
+        }
+    }
+    else
+    {
+        try
+        {
+            task->function();
+        }
+        catch (...)
+        {
+            jassertfalse; // Your tasks mustn't throw any exceptions!
+        }
+
+        task->function = nullptr;
+    }
+
+    finishTask (*task);
+    task->decReferenceCount();
+}
+
+bool TaskScheduler::runJob (ThreadPoolJob& job)
+{
+    auto* worker = dynamic_cast<WorkerThread*> (Thread::getCurrentThread());
+    jassert (worker != nullptr);
+
+    auto* previousJob = worker->currentJob;
+    worker->currentJob = &job;
+    job.isActive = true;
+
+    auto result = ThreadPoolJob::jobHasFinished;
+
+    try
+    {
+        result = job.runJob();
+    }
+    catch (...)
+    {
+        jassertfalse; // Your runJob() method mustn't throw any exceptions!
+    }
+
+    job.isActive = false;
+    worker->currentJob = previousJob;
+
+    if (result == ThreadPoolJob::jobNeedsRunningAgain && ! job.shouldStop)
+        return true;
+
+    {
+        const ScopedLock sl (jobLock);
+        activeJobs.removeFirstMatchingValue (&job);
+    }
+
+    if (job.shouldBeDeleted)
+        delete &job;
+
+    return false;
+}
+
+void TaskScheduler::finishTask (Task& task)
+{
+    ReferenceCountedArray<Task> dependents;
+
+    {
+        const SpinLock::ScopedLockType sl (task.dependentsLock);
+        task.finished.set (1);
+        dependents.swapWith (task.dependents);
+    }
+
+    task.finishedEvent.signal();
+
+    for (auto* dependent : dependents)
+        if (--(dependent->numUnfinishedDependencies) == 0)
+            schedule (dependent);
+
+    if (--numPendingTasks == 0)
+        allTasksFinished.signal();
+}
+
+bool TaskScheduler::waitWhileHelping (const Task& task, int timeOutMilliseconds)
+{
+    auto* worker = getCurrentWorker();
+    auto start = Time::getMillisecondCounter();
+    int numIdleLoops = 0;
+
+    while (task.finished.get() == 0)
+    {
+        if (auto* other = findTask (worker))
+        {
+            runTask (other);
+            numIdleLoops = 0;
+            continue;
+        }
+
+        if (timeOutMilliseconds >= 0 && Time::getMillisecondCounter() >= start + (uint32) timeOutMilliseconds)
+            return false;
+
+        if (++numIdleLoops < 64)
+            Thread::yield();
+        else
+            task.finishedEvent.wait (1);
+    }
+
+    return true;
+}
+
+bool TaskScheduler::waitForAllTasks (int timeOutMilliseconds) const
+{
+    jassert (getCurrentWorker() == nullptr); // a task can't wait for itself to finish!
+
+    auto start = Time::getMillisecondCounter();
+
+    while (numPendingTasks.get() > 0)
+    {
+        if (timeOutMilliseconds >= 0 && Time::getMillisecondCounter() >= start + (uint32) timeOutMilliseconds)
+            return false;
+
+        allTasksFinished.wait (10);
+    }
+
+    return true;
+}
+
+ThreadPoolJob* TaskScheduler::getCurrentThreadPoolJob()
+{
+    if (auto* worker = dynamic_cast<WorkerThread*> (Thread::getCurrentThread()))
+        return worker->currentJob;
+
+    return nullptr;
+}
+
+//==============================================================================
+int TaskScheduler::getChunkSize (int numIndices, int grainSize) const noexcept
+{
+    auto targetNumChunks = workers.size() * 4;
+    return jmax (1, grainSize, (numIndices + targetNumChunks - 1) / targetNumChunks);
+}
+
+void TaskScheduler::parallelFor (int start, int end, const std::function<void (int, int)>& function, int grainSize)
+{
+    if (end <= start)
+        return;
+
+    auto chunkSize = getChunkSize (end - start, grainSize);
+    auto numChunks = (end - start + chunkSize - 1) / chunkSize;
+
+    if (numChunks == 1)
+    {
+        function (start, end);
+        return;
+    }
+
+    // The chunks are handed out from a shared counter, so helpers which start late
+    // just find nothing left to do, and fast threads take more chunks.
+    Atomic<int> nextChunk;
+
+    auto runChunks = [&]
+    {
+        for (;;)
+        {
+            auto chunk = (++nextChunk) - 1;
+
+            if (chunk >= numChunks)
+                break;
+
+            auto chunkStart = start + chunk * chunkSize;
+            function (chunkStart, jmin (end, chunkStart + chunkSize));
+        }
+    };
+
+    auto numHelpers = jmin (numChunks - 1, workers.size() - (getCurrentWorker() != nullptr ? 1 : 0));
+    Array<TaskHandle> helpers;
+
+    for (int i = 0; i < numHelpers; ++i)
+        helpers.add (addTask (runChunks));
+
+    runChunks();
+
+    for (auto& helper : helpers)
+        helper.wait();
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class TaskSchedulerTests  : public UnitTest
+{
+public:
+    TaskSchedulerTests() : UnitTest ("TaskScheduler", "Threads") {}
+
+    struct CountingJob  : public ThreadPoolJob
+    {
+        CountingJob (int runs)  : ThreadPoolJob ("counting"), numRunsLeft (runs) {}
+
+        JobStatus runJob() override
+        {
+            if (getCurrentThreadPoolJob() == this)
+                ++numTimesRun;
+
+            return --numRunsLeft > 0 ? jobNeedsRunningAgain : jobHasFinished;
+        }
+
+        int numRunsLeft, numTimesRun = 0;
+    };
+
+    void runTest() override
+    {
+        TaskScheduler scheduler (4);
+
+        beginTest ("Tasks");
+        {
+            Atomic<int> count;
+
+            for (int i = 0; i < 1000; ++i)
+                scheduler.addTask ([&] { ++count; });
+
+            expect (scheduler.waitForAllTasks (10000));
+            expectEquals (count.get(), 1000);
+        }
+
+        beginTest ("Futures and dependencies");
+        {
+            Atomic<int> order;
+            int aOrder = -1, bOrder = -1, cOrder = -1;
+
+            auto a = scheduler.async ([&] { Thread::sleep (20); aOrder = ++order; return 3; });
+            auto b = scheduler.async ([&] { bOrder = ++order; return 4; });
+            auto c = scheduler.async ([&] { cOrder = ++order; return a.get() * b.get(); }, { a, b });
+
+            expectEquals (c.get(), 12);
+            expect (cOrder > aOrder && cOrder > bOrder);
+
+            // a dependency which has already finished
+            auto d = scheduler.async ([&] { return c.get() + 1; }, { c });
+            expectEquals (d.get(), 13);
+        }
+
+        beginTest ("parallelFor");
+        {
+            Array<int> visits;
+            visits.insertMultiple (0, 0, 10007);
+
+            scheduler.parallelFor (0, visits.size(), [&] (int start, int end)
+            {
+                for (int i = start; i < end; ++i)
+                    ++visits.getReference (i);
+            });
+
+            bool allVisitedOnce = true;
+
+            for (auto v : visits)
+                allVisitedOnce = allVisitedOnce && v == 1;
+
+            expect (allVisitedOnce);
+        }
+
+        beginTest ("parallelReduce");
+        {
+            auto sum = scheduler.parallelReduce (0, 100000, (int64) 0,
+                                                 [] (int start, int end) { int64 s = 0; for (int i = start; i < end; ++i) s += i; return s; },
+                                                 [] (int64 x, int64 y) { return x + y; });
+
+            expectEquals (sum, (int64) 99999 * 100000 / 2);
+        }
+
+        beginTest ("Nested parallelism");
+        {
+            Atomic<int> count;
+            Array<TaskScheduler::TaskHandle> outerTasks;
+
+            for (int i = 0; i < 16; ++i)
+                outerTasks.add (scheduler.addTask ([&]
+                {
+                    scheduler.parallelFor (0, 100, [&] (int start, int end) { count += end - start; }, 1);
+                }));
+
+            for (auto& t : outerTasks)
+                expect (t.wait (10000));
+
+            expectEquals (count.get(), 1600);
+        }
+
+        beginTest ("ThreadPoolJob");
+        {
+            CountingJob job (5);
+            expect (scheduler.addJob (&job, false).wait (10000));
+            expectEquals (job.numTimesRun, 5);
+            expect (! job.isRunning());
+        }
+
+        beginTest ("Speed");
+        {
+            const int numThreads = jmax (2, SystemStats::getNumCpus());
+            TaskScheduler benchmarkScheduler (numThreads);
+            ThreadPool pool (numThreads);
+
+            // the ThreadPool's job list gets slow with very many jobs, so keep this modest
+            const int numTasks = 20000;
+
+            auto timeInSeconds = [] (std::function<void()> f)
+            {
+                auto start = Time::getHighResolutionTicks();
+                f();
+                return Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start);
+            };
+
+            Atomic<int> count;
+
+            auto poolTime = timeInSeconds ([&]
+            {
+                for (int i = 0; i < numTasks; ++i)
+                    pool.addJob ([&] { ++count; });
+
+                while (pool.getNumJobs() > 0)
+                    Thread::yield();
+            });
+
+            auto schedulerTime = timeInSeconds ([&]
+            {
+                for (int i = 0; i < numTasks; ++i)
+                    benchmarkScheduler.addTask ([&] { ++count; });
+
+                benchmarkScheduler.waitForAllTasks();
+            });
+
+            expectEquals (count.get(), numTasks * 2);
+
+            logMessage ("Tasks per second (" + String (numThreads) + " threads): ThreadPool "
+                          + String (roundToInt (numTasks / poolTime)) + ", TaskScheduler "
+                          + String (roundToInt (numTasks / schedulerTime)));
+
+            // fork-join: split a trivial job across every thread and wait for it
+            const int numRepeats = 500;
+
+            auto poolForkJoin = timeInSeconds ([&]
+            {
+                for (int r = 0; r < numRepeats; ++r)
+                {
+                    Atomic<int> remaining (numThreads);
+                    WaitableEvent done;
+
+                    for (int i = 0; i < numThreads; ++i)
+                        pool.addJob ([&] { if (--remaining == 0) done.signal(); });
+
+                    done.wait();
+                }
+            });
+
+            auto schedulerForkJoin = timeInSeconds ([&]
+            {
+                for (int r = 0; r < numRepeats; ++r)
+                    benchmarkScheduler.parallelFor (0, numThreads, [] (int, int) {}, 1);
+            });
+
+            logMessage ("Fork-join latency: ThreadPool " + String (poolForkJoin * 1.0e6 / numRepeats, 1)
+                          + " us, TaskScheduler " + String (schedulerForkJoin * 1.0e6 / numRepeats, 1) + " us");
+        }
+    }
+};
+
+static TaskSchedulerTests taskSchedulerTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,301 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A set of threads which run small tasks, using work-stealing.
+
+    Each thread has its own queue. A task added by one of the scheduler's own threads
+    goes onto that thread's queue, and a thread which runs out of work steals the
+    oldest tasks from the other queues, so short tasks can be scheduled without every
+    thread contending for one lock. Idle threads sleep until some work is added.
+
+    Tasks are lambdas, and may depend on other tasks, in which case they won't be
+    started until all of their dependencies have finished. The handles returned when
+    adding tasks can be used to wait for them, or to get their results:
+    @code
+    TaskScheduler scheduler;
+
+    auto a = scheduler.async ([] { return loadSomething(); });
+    auto b = scheduler.async ([] { return loadSomethingElse(); });
+    auto c = scheduler.addTask ([&] { combine (a.get(), b.get()); }, { a, b });
+
+    c.wait();
+    @endcode
+
+    A task may wait for other tasks: while it is waiting, its thread will run any other
+    tasks that are queued, so nested parallelism, e.g. a parallelFor() inside a task,
+    can't starve the scheduler of threads.
+
+    The ThreadPool class is still the one to use for long-running jobs which need to be
+    managed individually, but ThreadPoolJob objects can also be run by a TaskScheduler,
+    see addJob().
+
+    @see ThreadPool
+*/
+class JUCE_API  TaskScheduler
+{
+public:
+    //==============================================================================
+    /** Creates a scheduler with one thread per CPU core.
+        @see SystemStats::getNumCpus()
+    */
+    TaskScheduler();
+
+    /** Creates a scheduler with a given number of threads.
+
+        @param numberOfThreads  the number of threads to run. These will be started
+                                immediately, and will run until the scheduler is deleted.
+        @param threadStackSize  the size of the stack of each thread. If this value
+                                is zero then the default stack size of the OS will
+                                be used.
+    */
+    TaskScheduler (int numberOfThreads, size_t threadStackSize = 0);
+
+    /** Destructor.
+        Any ThreadPoolJobs that are still running will be asked to exit, and this will
+        wait for all the tasks to finish before stopping the threads.
+    */
+    ~TaskScheduler();
+
+    //==============================================================================
+    class Task;
+
+    /** A reference to a task which has been added to a TaskScheduler.
+        @see TaskScheduler::addTask
+    */
+    class JUCE_API  TaskHandle
+    {
+    public:
+        /** Creates an invalid handle. */
+        TaskHandle() noexcept;
+        /** Creates a copy of another handle, which refers to the same task. */
+        TaskHandle (const TaskHandle&) noexcept;
+        /** Makes this handle refer to the same task as another one. */
+        TaskHandle& operator= (const TaskHandle&) noexcept;
+        /** Destructor. */
+        ~TaskHandle();
+
+        /** Returns true if this handle refers to a task. */
+        bool isValid() const noexcept;
+
+        /** Returns true if the task has finished running. */
+        bool isFinished() const noexcept;
+
+        /** Waits until the task has finished running.
+
+            If this is called from one of the scheduler's threads, other tasks will be run
+            while waiting.
+
+            @param timeOutMilliseconds  the maximum time to wait, or -1 to wait forever
+            @returns true if the task has finished, false if the timeout expired
+        */
+        bool wait (int timeOutMilliseconds = -1) const;
+
+    private:
+        friend class TaskScheduler;
+        ReferenceCountedObjectPtr<Task> task;
+    };
+
+    /** A handle to a task which returns a value.
+        @see TaskScheduler::async
+    */
+    template <typename ResultType>
+    class Future  : public TaskHandle
+    {
+    public:
+        /** Creates an invalid Future. */
+        Future() {}
+
+        /** Waits for the task to finish if it hasn't already, and returns its result. */
+        const ResultType& get() const
+        {
+            jassert (isValid());
+            wait();
+            return result->value;
+        }
+
+    private:
+        friend class TaskScheduler;
+
+        struct Result  : public ReferenceCountedObject
+        {
+            ResultType value;
+        };
+
+        ReferenceCountedObjectPtr<Result> result;
+    };
+
+    //==============================================================================
+    /** Adds a task to be run as soon as a thread is free.
+        The task mustn't throw any exceptions.
+    */
+    TaskHandle addTask (std::function<void()> task);
+
+    /** Adds a task which will be run once all the given tasks have finished. */
+    TaskHandle addTask (std::function<void()> task, const Array<TaskHandle>& dependencies);
+
+    /** Adds a task which returns a value, and returns a Future that can be used
+        to wait for it and get the result.
+
+        The result type must be default-constructible and copyable. Use addTask() for
+        functions which don't return anything.
+    */
+    template <typename FunctionType>
+    auto async (FunctionType function, const Array<TaskHandle>& dependencies = {})
+        -> Future<decltype (function())>
+    {
+        using ResultType = decltype (function());
+        static_assert (! std::is_void<ResultType>::value, "Use addTask() for functions without a result");
+
+        Future<ResultType> future;
+        ReferenceCountedObjectPtr<typename Future<ResultType>::Result> result (new typename Future<ResultType>::Result());
+        future.result = result;
+
+        static_cast<TaskHandle&> (future) = addTask ([result, function]() mutable { result->value = function(); },
+                                                     dependencies);
+        return future;
+    }
+
+    /** Adds a ThreadPoolJob to be run by the scheduler.
+
+        The job will be run on one of the scheduler's threads, and if its runJob() method
+        returns jobNeedsRunningAgain, it will be put at the back of the queue to be run
+        again. The returned handle will finish when the job has finished for good.
+
+        If deleteJobWhenFinished is true, the scheduler will delete the job when it has
+        finished. Otherwise, the caller mustn't delete it before then.
+    */
+    TaskHandle addJob (ThreadPoolJob* job, bool deleteJobWhenFinished);
+
+    //==============================================================================
+    /** Runs a function over a range of indices in parallel, and waits for it to finish.
+
+        The range is split into chunks, and the function is called with the start and end
+        of each one. The calling thread runs chunks too.
+
+        @param start        the first index
+        @param end          the index after the last one
+        @param function     called with the start and end of each chunk
+        @param grainSize    the minimum number of indices in a chunk, or 0 to split the
+                            range into a few chunks per thread
+    */
+    void parallelFor (int start, int end, const std::function<void (int chunkStart, int chunkEnd)>& function,
+                      int grainSize = 0);
+
+    /** Computes a value from a range of indices in parallel.
+
+        The range is split into chunks as in parallelFor(), and map is called with the start
+        and end of each chunk to compute its value. The values of the chunks are then
+        combined in order, starting with the identity value, so the result doesn't depend
+        on the timing of the threads.
+
+        @code
+        auto sum = scheduler.parallelReduce (0, numValues, 0.0,
+                                             [&] (int s, int e) { return std::accumulate (values + s, values + e, 0.0); },
+                                             [] (double a, double b) { return a + b; });
+        @endcode
+    */
+    template <typename ValueType, typename MapFunction, typename CombineFunction>
+    ValueType parallelReduce (int start, int end, ValueType identity,
+                              MapFunction map, CombineFunction combine, int grainSize = 0)
+    {
+        if (end <= start)
+            return identity;
+
+        auto chunkSize = getChunkSize (end - start, grainSize);
+        auto numChunks = (end - start + chunkSize - 1) / chunkSize;
+
+        Array<ValueType> chunkValues;
+        chunkValues.insertMultiple (0, identity, numChunks);
+
+        parallelFor (0, numChunks, [&] (int firstChunk, int lastChunk)
+        {
+            for (int i = firstChunk; i < lastChunk; ++i)
+            {
+                auto chunkStart = start + i * chunkSize;
+                chunkValues.getReference (i) = map (chunkStart, jmin (end, chunkStart + chunkSize));
+            }
+        }, 1);
+
+        for (auto& value : chunkValues)
+            identity = combine (identity, value);
+
+        return identity;
+    }
+
+    //==============================================================================
+    /** Waits until all the tasks that have been added have finished.
+        @returns true if they have finished, false if the timeout expired
+    */
+    bool waitForAllTasks (int timeOutMilliseconds = -1) const;
+
+    /** Returns the number of tasks which have been added and haven't finished yet. */
+    int getNumPendingTasks() const noexcept;
+
+    /** Returns the number of threads the scheduler is using. */
+    int getNumThreads() const noexcept;
+
+    /** Changes the priority of all the threads.
+        @see Thread::setPriority
+    */
+    bool setThreadPriorities (int newPriority);
+
+private:
+    //==============================================================================
+    struct WorkQueue;
+    class WorkerThread;
+    friend class ThreadPoolJob;
+
+    OwnedArray<WorkerThread> workers;
+    ScopedPointer<WorkQueue> sharedQueue;
+    Atomic<int> numPendingTasks, numSleepingThreads;
+    WaitableEvent allTasksFinished;
+
+    CriticalSection jobLock;
+    Array<ThreadPoolJob*> activeJobs;
+
+    void createThreads (int numThreads, size_t threadStackSize);
+    WorkerThread* getCurrentWorker() const noexcept;
+    int getChunkSize (int numIndices, int grainSize) const noexcept;
+
+    TaskHandle submit (Task*, const Array<TaskHandle>& dependencies);
+    void schedule (Task*);
+    void wakeOneThread();
+    Task* findTask (WorkerThread*);
+    bool hasQueuedTasks() const noexcept;
+    void runTask (Task*);
+    bool runJob (ThreadPoolJob&);
+    void finishTask (Task&);
+    void sleep (WorkerThread&);
+    bool waitWhileHelping (const Task&, int timeOutMilliseconds);
+
+    static ThreadPoolJob* getCurrentThreadPoolJob();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TaskScheduler)
+};
+
+} // namespace juce
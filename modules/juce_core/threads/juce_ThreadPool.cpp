@@ -87,7 +87,7 @@ ThreadPoolJob* ThreadPoolJob::getCurrentThreadPoolJob()
     if (auto* t = dynamic_cast<ThreadPool::ThreadPoolThread*> (Thread::getCurrentThread()))
         return t->currentJob;
 
-    return nullptr;
+    return TaskScheduler::getCurrentThreadPoolJob();
 }
 
 //==============================================================================
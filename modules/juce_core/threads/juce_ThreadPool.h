@@ -25,6 +25,7 @@ namespace juce
 
 class ThreadPool;
 class ThreadPoolThread;
+class TaskScheduler;
 
 
 //==============================================================================
@@ -133,6 +134,7 @@ public:
 private:
     friend class ThreadPool;
     friend class ThreadPoolThread;
+    friend class TaskScheduler;
     String jobName;
     ThreadPool* pool = nullptr;
     bool shouldStop = false, isActive = false, shouldBeDeleted = false;
@@ -0,0 +1,48 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A stream used by the unit tests, which delivers its data in small pieces, to
+    make sure that tokens can span reads.
+
+    This is only compiled when JUCE_UNIT_TESTS is enabled.
+*/
+struct ChunkedTestInputStream  : public InputStream
+{
+    ChunkedTestInputStream (const String& text, int size)
+        : data (text.toRawUTF8(), text.getNumBytesAsUTF8(), true), chunkSize (size) {}
+
+    int64 getTotalLength() override                 { return data.getTotalLength(); }
+    bool isExhausted() override                     { return data.isExhausted(); }
+    int read (void* dest, int maxBytes) override    { return data.read (dest, jmin (maxBytes, chunkSize)); }
+    int64 getPosition() override                    { return data.getPosition(); }
+    bool setPosition (int64 pos) override           { return data.setPosition (pos); }
+
+    MemoryInputStream data;
+    int chunkSize;
+};
+
+} // namespace juce
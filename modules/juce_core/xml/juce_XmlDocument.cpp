@@ -523,7 +523,9 @@ void XmlDocument::readChildElements (XmlElement& parent)
         else  // must be a character block
         {
             input = preWhitespaceInput; // roll back to include the leading whitespace
-            MemoryOutputStream textElementContent;
+            // most blocks are short, and often just whitespace that's thrown away
+            char textBuffer[256];
+            StringArena textElementContent (textBuffer, sizeof (textBuffer));
             bool contentShouldBeUsed = ! ignoreEmptyTextElements;
 
             for (;;)
@@ -579,7 +581,7 @@ void XmlDocument::readChildElements (XmlElement& parent)
                     }
                     else
                     {
-                        textElementContent << entity;
+                        textElementContent.append (entity);
                         contentShouldBeUsed = contentShouldBeUsed || entity.containsNonWhitespaceChars();
                     }
                 }
@@ -607,14 +609,14 @@ void XmlDocument::readChildElements (XmlElement& parent)
                             return;
                         }
 
-                        textElementContent.appendUTF8Char (nextChar);
+                        textElementContent.appendChar (nextChar);
                         contentShouldBeUsed = contentShouldBeUsed || ! CharacterFunctions::isWhitespace (nextChar);
                     }
                 }
             }
 
             if (contentShouldBeUsed)
-                childAppender.append (XmlElement::createTextElement (textElementContent.toUTF8()));
+                childAppender.append (XmlElement::createTextElement (String (textElementContent.finishString().text)));
         }
     }
 }
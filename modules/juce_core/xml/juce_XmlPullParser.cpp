@@ -0,0 +1,854 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+static bool isXmlNameByte (char c) noexcept
+{
+    // bytes from multi-byte UTF-8 sequences are assumed to be part of a name
+    return (uint8) c >= 0x80 || XmlIdentifierChars::isIdentifierChar ((juce_wchar) c);
+}
+
+//==============================================================================
+XmlPullParser::XmlPullParser (InputStream& sourceStream)  : source (sourceStream)
+{
+}
+
+XmlPullParser::~XmlPullParser()
+{
+}
+
+//==============================================================================
+XmlPullParser::EventType XmlPullParser::next()
+{
+    if (savedCharIndex >= 0)
+    {
+        buffer[savedCharIndex] = savedChar;
+        savedCharIndex = -1;
+    }
+
+   #if JUCE_STRING_UTF_TYPE != 8
+    convertedStrings.clearQuick();
+   #endif
+
+    if (currentEvent == endOfDocument || currentEvent == parseError)
+        return currentEvent;
+
+    if (isInsideEmptyElement)
+    {
+        // the name from the start tag is still in the buffer
+        isInsideEmptyElement = false;
+        attributes.clearQuick();
+        --depth;
+        return setEvent (endElement);
+    }
+
+    startNewEvent();
+
+    for (;;)
+    {
+        auto c = peek (0);
+
+        if (c == '<')
+        {
+            auto c1 = peek (1);
+
+            if (c1 == '/')
+                return readEndTag();
+
+            if (c1 == '?')
+            {
+                if (! skipPast ("?>"))
+                    return setError ("unterminated processing instruction");
+
+                startNewEvent();
+                continue;
+            }
+
+            if (c1 == '!')
+            {
+                if (matches ("<!--"))
+                {
+                    if (! skipPast ("-->"))
+                        return setError ("unterminated comment");
+
+                    startNewEvent();
+                    continue;
+                }
+
+                if (matches ("<![CDATA["))
+                    return readCData();
+
+                if (depth == 0 && matches ("<!DOCTYPE"))
+                {
+                    if (! skipDocType())
+                        return setError ("malformed DTD");
+
+                    startNewEvent();
+                    continue;
+                }
+            }
+
+            if (depth == 0 && hasReadDocumentElement)
+                return setEvent (endOfDocument);
+
+            return readStartTag();
+        }
+
+        if (depth == 0)
+        {
+            if (CharacterFunctions::isWhitespace (c) || (c == (char) 0xef && matches ("\xef\xbb\xbf")))
+            {
+                ++position;
+                startNewEvent();
+                continue;
+            }
+
+            if (hasReadDocumentElement)
+                return setEvent (endOfDocument);
+
+            return setError (c == 0 ? "not enough input" : "document element not found");
+        }
+
+        if (c == 0)
+            return setError ("unmatched tags");
+
+        int end = 0;
+        bool containsNonWhitespace = false;
+
+        if (! readEncodedText ('<', end, containsNonWhitespace))
+            return setError ("unmatched tags");
+
+        if (containsNonWhitespace || ! ignoreEmptyTextElements)
+        {
+            textStart = 0;
+            terminate (end);
+            return setEvent (text);
+        }
+
+        startNewEvent();
+    }
+}
+
+bool XmlPullParser::skipElement()
+{
+    jassert (currentEvent == startElement); // this can only be called after a start tag!
+
+    for (auto targetDepth = depth - 1; depth > targetDepth;)
+    {
+        auto event = next();
+
+        if (event == endOfDocument || event == parseError)
+            return false;
+    }
+
+    return true;
+}
+
+//==============================================================================
+StringRef XmlPullParser::getName() const noexcept
+{
+    if (nameStart >= 0 && (currentEvent == startElement || currentEvent == endElement))
+        return getStringRef (nameStart);
+
+    return {};
+}
+
+StringRef XmlPullParser::getAttributeName (int index) const noexcept
+{
+    if (isPositiveAndBelow (index, attributes.size()))
+        return getStringRef (attributes.getReference (index).nameStart);
+
+    jassertfalse;
+    return {};
+}
+
+StringRef XmlPullParser::getAttributeValue (int index) const noexcept
+{
+    if (isPositiveAndBelow (index, attributes.size()))
+        return getStringRef (attributes.getReference (index).valueStart);
+
+    jassertfalse;
+    return {};
+}
+
+StringRef XmlPullParser::getAttributeValue (StringRef attributeName) const noexcept
+{
+    for (int i = 0; i < attributes.size(); ++i)
+        if (attributeNameMatches (i, attributeName))
+            return getAttributeValue (i);
+
+    return {};
+}
+
+bool XmlPullParser::hasAttribute (StringRef attributeName) const noexcept
+{
+    for (int i = 0; i < attributes.size(); ++i)
+        if (attributeNameMatches (i, attributeName))
+            return true;
+
+    return false;
+}
+
+StringRef XmlPullParser::getText() const noexcept
+{
+    if (textStart >= 0 && currentEvent == text)
+        return getStringRef (textStart);
+
+    return {};
+}
+
+//==============================================================================
+/*  All the positions used while parsing an event are relative to eventStart, so that
+    the event's data can be moved to the start of the buffer when more is read.
+*/
+char XmlPullParser::peekAfterReading (int offset)
+{
+    while (eventStart + position + offset >= dataEnd)
+        if (! readMoreData())
+            return 0;
+
+    return buffer[eventStart + position + offset];
+}
+
+bool XmlPullParser::readMoreData()
+{
+    if (sourceExhausted)
+        return false;
+
+    if (eventStart > 0)
+    {
+        dataEnd -= eventStart;
+        memmove (buffer, buffer + eventStart, (size_t) dataEnd);
+        eventStart = 0;
+    }
+
+    const int minBytesToRead = 32768;
+
+    if (dataEnd + minBytesToRead > bufferSize)
+    {
+        bufferSize = jmax (bufferSize * 2, dataEnd + minBytesToRead);
+        buffer.realloc ((size_t) bufferSize + 1);
+    }
+
+    auto numRead = source.read (buffer + dataEnd, bufferSize - dataEnd);
+
+    if (numRead <= 0)
+    {
+        sourceExhausted = true;
+        return false;
+    }
+
+    dataEnd += numRead;
+    return true;
+}
+
+void XmlPullParser::startNewEvent() noexcept
+{
+    eventStart += position;
+    position = 0;
+    nameStart = -1;
+    textStart = -1;
+    attributes.clearQuick();
+}
+
+void XmlPullParser::terminate (int end) noexcept
+{
+    // if the terminator overwrites a character that hasn't been parsed yet, it'll be put back by next()
+    auto index = eventStart + end;
+
+    if (end >= position)
+    {
+        savedCharIndex = index;
+        savedChar = buffer[index];
+    }
+
+    buffer[index] = 0;
+}
+
+bool XmlPullParser::matches (const char* prefix)
+{
+    for (int i = 0; prefix[i] != 0; ++i)
+        if (peek (i) != prefix[i])
+            return false;
+
+    return true;
+}
+
+bool XmlPullParser::skipPast (const char* terminator)
+{
+    for (;;)
+    {
+        if (matches (terminator))
+        {
+            position += (int) strlen (terminator);
+            return true;
+        }
+
+        if (peek (0) == 0)
+            return false;
+
+        ++position;
+    }
+}
+
+bool XmlPullParser::skipDocType()
+{
+    for (int n = 0;;)
+    {
+        auto c = peek (0);
+
+        if (c == 0)
+            return false;
+
+        ++position;
+
+        if (c == '<')
+            ++n;
+        else if (c == '>' && --n == 0)
+            return true;
+    }
+}
+
+void XmlPullParser::skipWhitespace()
+{
+    while (CharacterFunctions::isWhitespace (peek (0)))
+        ++position;
+}
+
+void XmlPullParser::skipName()
+{
+    while (isXmlNameByte (peek (0)))
+        ++position;
+}
+
+String XmlPullParser::getString (int start, int end) const
+{
+    return String (CharPointer_UTF8 (buffer + eventStart + start),
+                   CharPointer_UTF8 (buffer + eventStart + end));
+}
+
+StringRef XmlPullParser::getStringRef (int start) const
+{
+   #if JUCE_STRING_UTF_TYPE == 8
+    return String::CharPointerType (buffer + eventStart + start);
+   #else
+    convertedStrings.add (String (CharPointer_UTF8 (buffer + eventStart + start)));
+    return convertedStrings.getReference (convertedStrings.size() - 1);
+   #endif
+}
+
+bool XmlPullParser::attributeNameMatches (int index, StringRef name) const noexcept
+{
+    return CharPointer_UTF8 (buffer + eventStart + attributes.getReference (index).nameStart).compare (name.text) == 0;
+}
+
+//==============================================================================
+/*  Decodes text in-place up to the terminator, which is left unread. The decoded text is
+    never longer than the original, so it can be written over the characters that have
+    already been read.
+*/
+bool XmlPullParser::readEncodedText (char terminator, int& output, bool& containsNonWhitespace)
+{
+    const bool isElementText = (terminator == '<');
+
+    for (;;)
+    {
+        auto c = peek (0);
+
+        if (c == terminator)
+        {
+            if (isElementText && peek (1) == '!' && peek (2) == '-' && peek (3) == '-')
+            {
+                if (! skipPast ("-->"))
+                    return false;
+
+                continue;
+            }
+
+            return true;
+        }
+
+        if (c == 0)
+            return false;
+
+        if (c == '&')
+        {
+            auto decoded = readEntity (output);
+            containsNonWhitespace = containsNonWhitespace || ! CharacterFunctions::isWhitespace (decoded);
+            continue;
+        }
+
+        ++position;
+
+        if (c == '\r' && isElementText)
+        {
+            if (peek (0) == '\n')
+                continue;
+
+            c = '\n';
+        }
+
+        buffer[eventStart + output++] = c;
+        containsNonWhitespace = containsNonWhitespace || ! CharacterFunctions::isWhitespace (c);
+    }
+}
+
+juce_wchar XmlPullParser::readEntity (int& output)
+{
+    int length = 1;
+
+    while (length < 16 && peek (length) != ';' && peek (length) != 0)
+        ++length;
+
+    juce_wchar decoded = 0;
+
+    if (peek (length) == ';')
+    {
+        CharPointer_UTF8 name (buffer + eventStart + position + 1);
+        auto nameLength = length - 1;
+
+        if      (nameLength == 3 && name.compareIgnoreCaseUpTo (CharPointer_ASCII ("amp"), 3) == 0)   decoded = '&';
+        else if (nameLength == 4 && name.compareIgnoreCaseUpTo (CharPointer_ASCII ("quot"), 4) == 0)  decoded = '"';
+        else if (nameLength == 4 && name.compareIgnoreCaseUpTo (CharPointer_ASCII ("apos"), 4) == 0)  decoded = '\'';
+        else if (nameLength == 2 && name.compareIgnoreCaseUpTo (CharPointer_ASCII ("lt"), 2) == 0)    decoded = '<';
+        else if (nameLength == 2 && name.compareIgnoreCaseUpTo (CharPointer_ASCII ("gt"), 2) == 0)    decoded = '>';
+        else if (nameLength > 1 && name[0] == '#')
+        {
+            auto* digits = buffer + eventStart + position + 2;
+            auto numDigits = nameLength - 1;
+            const bool isHex = (digits[0] == 'x' || digits[0] == 'X');
+
+            if (isHex)
+            {
+                ++digits;
+                --numDigits;
+            }
+
+            uint32 charCode = 0;
+
+            for (int i = 0; i < numDigits && charCode < 0x110000; ++i)
+            {
+                auto digit = isHex ? CharacterFunctions::getHexDigitValue ((juce_wchar) (uint8) digits[i])
+                                   : (digits[i] >= '0' && digits[i] <= '9' ? digits[i] - '0' : -1);
+
+                if (digit < 0)
+                {
+                    charCode = 0;
+                    break;
+                }
+
+                charCode = charCode * (isHex ? 16 : 10) + (uint32) digit;
+            }
+
+            if (numDigits > 0 && charCode < 0x110000)
+                decoded = (juce_wchar) charCode;
+        }
+    }
+
+    if (decoded == 0)
+    {
+        // not something we can decode, so leave it in the text
+        buffer[eventStart + output++] = '&';
+        ++position;
+        return '&';
+    }
+
+    position += length + 1;
+
+    CharPointer_UTF8 dest (buffer + eventStart + output);
+    dest.write (decoded);
+    output = (int) (dest.getAddress() - (buffer + eventStart));
+    return decoded;
+}
+
+//==============================================================================
+XmlPullParser::EventType XmlPullParser::readStartTag()
+{
+    ++position;
+    skipWhitespace();   // (XmlDocument also allows a gap between the '<' and the name)
+    nameStart = position;
+    skipName();
+    auto nameEnd = position;
+
+    if (nameEnd == nameStart)
+        return setError ("tag name missing");
+
+    for (;;)
+    {
+        skipWhitespace();
+        auto c = peek (0);
+
+        if (c == '/' && peek (1) == '>')
+        {
+            position += 2;
+            isInsideEmptyElement = true;
+            break;
+        }
+
+        if (c == '>')
+        {
+            ++position;
+            break;
+        }
+
+        if (isXmlNameByte (c))
+        {
+            Attribute att;
+            att.nameStart = position;
+            skipName();
+            att.nameEnd = position;
+            skipWhitespace();
+
+            if (peek (0) != '=')
+                return setError ("expected '=' after attribute '" + getString (att.nameStart, att.nameEnd) + "'");
+
+            ++position;
+            skipWhitespace();
+            auto quote = peek (0);
+
+            if (quote != '"' && quote != '\'')
+                return setError ("expected a quoted value for attribute '" + getString (att.nameStart, att.nameEnd) + "'");
+
+            ++position;
+            att.valueStart = att.valueEnd = position;
+            bool containsNonWhitespace = false;
+
+            if (! readEncodedText (quote, att.valueEnd, containsNonWhitespace))
+                return setError ("unmatched quotes");
+
+            ++position;
+            attributes.add (att);
+            continue;
+        }
+
+        if (c == 0)
+            return setError ("unmatched tags");
+
+        return setError ("illegal character found in " + getString (nameStart, nameEnd)
+                           + ": '" + String::charToString ((juce_wchar) (uint8) c) + "'");
+    }
+
+    terminate (nameEnd);
+
+    for (auto& att : attributes)
+    {
+        terminate (att.nameEnd);
+        terminate (att.valueEnd);
+    }
+
+    ++depth;
+    hasReadDocumentElement = true;
+    return setEvent (startElement);
+}
+
+XmlPullParser::EventType XmlPullParser::readEndTag()
+{
+    if (depth == 0)
+        return setError ("unmatched tags");
+
+    position += 2;
+    nameStart = position;
+    skipName();
+    auto nameEnd = position;
+    skipWhitespace();
+
+    if (peek (0) != '>')
+        return setError ("malformed closing tag");
+
+    ++position;
+    terminate (nameEnd);
+    --depth;
+    return setEvent (endElement);
+}
+
+XmlPullParser::EventType XmlPullParser::readCData()
+{
+    if (depth == 0)
+        return setError ("document element not found");
+
+    position += 9;
+    textStart = position;
+
+    for (;;)
+    {
+        auto c = peek (0);
+
+        if (c == 0)
+            return setError ("unterminated CDATA section");
+
+        if (c == ']' && peek (1) == ']' && peek (2) == '>')
+            break;
+
+        ++position;
+    }
+
+    auto end = position;
+    position += 3;
+    terminate (end);
+    return setEvent (text);
+}
+
+XmlPullParser::EventType XmlPullParser::setEvent (EventType newEvent)
+{
+    currentEvent = newEvent;
+    return newEvent;
+}
+
+XmlPullParser::EventType XmlPullParser::setError (const String& message)
+{
+    lastError = message;
+    nameStart = -1;
+    textStart = -1;
+    attributes.clearQuick();
+    return setEvent (parseError);
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class XmlPullParserTests  : public UnitTest
+{
+public:
+    XmlPullParserTests() : UnitTest ("XmlPullParser", "XML") {}
+
+    static void describeElement (const XmlElement& e, StringArray& events)
+    {
+        if (e.isTextElement())
+        {
+            events.add ("text: " + e.getText());
+            return;
+        }
+
+        auto start = "start: " + e.getTagName();
+
+        for (int i = 0; i < e.getNumAttributes(); ++i)
+            start << " " << e.getAttributeName (i) << "=" << e.getAttributeValue (i);
+
+        events.add (start);
+
+        forEachXmlChildElement (e, child)
+            describeElement (*child, events);
+
+        events.add ("end: " + e.getTagName());
+    }
+
+    static StringArray getDocumentEvents (const String& text, bool ignoreEmptyText)
+    {
+        StringArray events;
+        XmlDocument doc (text);
+        doc.setEmptyTextElementsIgnored (ignoreEmptyText);
+
+        if (ScopedPointer<XmlElement> xml = doc.getDocumentElement())
+            describeElement (*xml, events);
+        else
+            events.add ("error");
+
+        return events;
+    }
+
+    static StringArray getParserEvents (const String& text, int chunkSize, bool ignoreEmptyText)
+    {
+        StringArray events;
+        ChunkedTestInputStream in (text, chunkSize);
+        XmlPullParser parser (in);
+        parser.setEmptyTextElementsIgnored (ignoreEmptyText);
+
+        for (;;)
+        {
+            switch (parser.next())
+            {
+                case XmlPullParser::startElement:
+                {
+                    auto start = "start: " + String (parser.getName());
+
+                    for (int i = 0; i < parser.getNumAttributes(); ++i)
+                        start << " " << String (parser.getAttributeName (i)) << "=" << String (parser.getAttributeValue (i));
+
+                    events.add (start);
+                    break;
+                }
+
+                case XmlPullParser::endElement:     events.add ("end: " + String (parser.getName())); break;
+                case XmlPullParser::text:           events.add ("text: " + String (parser.getText())); break;
+                case XmlPullParser::endOfDocument:  return events;
+                case XmlPullParser::parseError:     return StringArray ("error");
+                default:                            jassertfalse; return events;
+            }
+        }
+    }
+
+    void expectEvents (const String& text, const StringArray& expected, bool ignoreEmptyText = true)
+    {
+        for (auto chunkSize : { 1, 2, 3, 7, 64, 100000 })
+        {
+            auto events = getParserEvents (text, chunkSize, ignoreEmptyText);
+            expect (events == expected, "chunk size " + String (chunkSize) + ": "
+                                          + events.joinIntoString ("|") + " != " + expected.joinIntoString ("|"));
+        }
+    }
+
+    void expectSameEvents (const String& text)
+    {
+        expectEvents (text, getDocumentEvents (text, true));
+    }
+
+    static String createRandomText (Random& r)
+    {
+        static const char* const fragments[] = { "a", "xyz", " ", "\n", "&", "<", ">", "\"", "'", "\xc3\xa9", "\xe2\x82\xac", "\r\n" };
+
+        String s;
+
+        for (int i = r.nextInt (8); --i >= 0;)
+            s << String (CharPointer_UTF8 (fragments[r.nextInt (numElementsInArray (fragments))]));
+
+        return s;
+    }
+
+    static XmlElement* createRandomElement (Random& r, int depth)
+    {
+        auto* e = new XmlElement ("tag" + String (r.nextInt (10)));
+
+        for (int i = r.nextInt (4); --i >= 0;)
+            e->setAttribute ("att" + String (i), createRandomText (r));
+
+        if (depth < 4)
+        {
+            for (int i = r.nextInt (5); --i >= 0;)
+            {
+                if (r.nextBool())
+                    e->addTextElement (createRandomText (r) + "x");
+                else
+                    e->addChildElement (createRandomElement (r, depth + 1));
+            }
+        }
+
+        return e;
+    }
+
+    void runTest() override
+    {
+        beginTest ("Events match XmlDocument");
+        {
+            expectSameEvents ("<a/>");
+            expectSameEvents ("<a b='1' c = \"2\"><b/>text<c>more text</c>  </a>");
+            expectSameEvents ("\xef\xbb\xbf<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<!DOCTYPE foo [ <!ENTITY x \"y\"> ]>\n"
+                              "<!-- comment --><doc>  <![CDATA[ <raw> & ]]><x/>\r\n<?pi stuff?>text <!-- comment --> after\r\nnext</doc> trailing");
+            expectSameEvents ("<doc a=\"&lt;&amp;&gt;&quot;&apos;&#65;&#x42;&#x20AC;&#12354;\">&LT;&#10;&#x1F600; &amp;amp;</doc>");
+
+            Random r (1234);
+
+            for (int i = 0; i < 50; ++i)
+            {
+                ScopedPointer<XmlElement> xml (createRandomElement (r, 0));
+                expectSameEvents (xml->createDocument ({}));
+                expectSameEvents (xml->createDocument ({}, true, false));
+            }
+        }
+
+        beginTest ("Differences from XmlDocument");
+        {
+            // entities that can't be decoded are left in the text, rather than causing an error
+            expectEvents ("<a b='&x; & &#;'>&unknown; & &#xZZ;</a>", StringArray ("start: a b=&x; & &#;", "text: &unknown; & &#xZZ;", "end: a"));
+
+            // whitespace is always reported if you ask for it
+            expectEvents ("<a> <b/>\n</a>", StringArray ("start: a", "text:  ", "start: b", "end: b", "text: \n", "end: a"), false);
+            expectEvents ("<a> <b/>\n</a>", StringArray ("start: a", "start: b", "end: b", "end: a"), true);
+        }
+
+        beginTest ("Errors");
+        {
+            for (auto text : { "", "   ", "text", "<a>", "<a><b></a>", "<a x=1/>", "<a x></a>", "<a \"x\"/>",
+                               "<a x='1/>", "</a>", "<a><![CDATA[ </a>", "<a><!-- </a>", "<>", "<a></a x>" })
+            {
+                ChunkedTestInputStream in (text, 3);
+                XmlPullParser parser (in);
+                auto event = parser.next();
+
+                while (event != XmlPullParser::endOfDocument && event != XmlPullParser::parseError)
+                    event = parser.next();
+
+                expect (event == XmlPullParser::parseError, text);
+                expect (parser.getLastParseError().isNotEmpty());
+                expect (parser.next() == XmlPullParser::parseError);
+            }
+        }
+
+        beginTest ("Navigation");
+        {
+            ChunkedTestInputStream in ("<root><skip a='1'><x><y/></x>text</skip><keep name=\"value\" other='2'/></root>", 5);
+            XmlPullParser parser (in);
+
+            expect (parser.next() == XmlPullParser::startElement && parser.getName() == StringRef ("root"));
+            expectEquals (parser.getDepth(), 1);
+            expect (parser.next() == XmlPullParser::startElement && parser.getName() == StringRef ("skip"));
+            expect (parser.skipElement());
+            expectEquals (parser.getDepth(), 1);
+            expect (parser.next() == XmlPullParser::startElement && parser.getName() == StringRef ("keep"));
+            expect (parser.hasAttribute ("other") && ! parser.hasAttribute ("missing"));
+            expect (parser.getAttributeValue ("name") == StringRef ("value"));
+            expect (parser.getAttributeValue ("missing").isEmpty());
+            expect (parser.next() == XmlPullParser::endElement && parser.getName() == StringRef ("keep"));
+            expect (parser.next() == XmlPullParser::endElement && parser.getName() == StringRef ("root"));
+            expectEquals (parser.getDepth(), 0);
+            expect (parser.next() == XmlPullParser::endOfDocument);
+        }
+
+        beginTest ("Benchmark");
+        {
+            Random r (5678);
+            XmlElement root ("root");
+
+            for (int i = 0; i < 20000; ++i)
+                root.addChildElement (createRandomElement (r, 2));
+
+            auto text = root.createDocument ({});
+
+            auto start = Time::getMillisecondCounterHiRes();
+            ScopedPointer<XmlElement> xml (XmlDocument::parse (text));
+            auto domTime = Time::getMillisecondCounterHiRes() - start;
+
+            start = Time::getMillisecondCounterHiRes();
+            MemoryInputStream in (text.toRawUTF8(), text.getNumBytesAsUTF8(), false);
+            XmlPullParser parser (in);
+            int numEvents = 0;
+
+            while (parser.next() < XmlPullParser::endOfDocument)
+                ++numEvents;
+
+            auto pullTime = Time::getMillisecondCounterHiRes() - start;
+
+            expect (xml != nullptr && parser.getCurrentEvent() == XmlPullParser::endOfDocument);
+
+            logMessage (String (text.getNumBytesAsUTF8() / 1024) + " KB document: XmlDocument " + String (domTime, 1)
+                          + " ms, XmlPullParser " + String (pullTime, 1) + " ms (" + String (numEvents) + " events)");
+        }
+    }
+};
+
+static XmlPullParserTests xmlPullParserTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,187 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Reads an XML document from a stream as a sequence of events, without building
+    an XmlElement tree.
+
+    XmlDocument loads the whole document into memory and then creates an object for
+    every element, attribute and block of text in it, which can take many times the
+    size of the file. This parser instead reads the stream in blocks, and each call to
+    next() moves on to the next start tag, end tag or block of text. The names, values
+    and text are returned as StringRefs pointing into the parser's internal buffer, so
+    nothing is allocated per token, and the buffer only needs to be large enough to
+    hold the largest single tag or text block. (The buffer holds UTF-8, so if
+    JUCE_STRING_UTF_TYPE isn't 8, the StringRefs instead refer to converted copies that
+    the parser keeps until the next event).
+
+    @code
+    FileInputStream in (file);
+    XmlPullParser parser (in);
+
+    for (;;)
+    {
+        auto event = parser.next();
+
+        if (event == XmlPullParser::startElement && parser.getName() == "PLUGIN")
+            loadPlugin (parser.getAttributeValue ("name"));
+        else if (event == XmlPullParser::parseError)
+            return Result::fail (parser.getLastParseError());
+        else if (event == XmlPullParser::endOfDocument)
+            break;
+    }
+    @endcode
+
+    The standard entities and numeric character references are decoded, but DTDs are
+    skipped, so any entities that they declare are left in the text unexpanded.
+
+    @see XmlDocument, ValueTree::fromXml
+*/
+class JUCE_API  XmlPullParser
+{
+public:
+    //==============================================================================
+    /** Creates a parser to read from the given stream.
+        The stream must stay valid for as long as the parser is being used.
+    */
+    explicit XmlPullParser (InputStream& sourceStream);
+
+    /** Destructor. */
+    ~XmlPullParser();
+
+    //==============================================================================
+    /** The types of event that next() can return. */
+    enum EventType
+    {
+        startElement,   /**< An opening tag. Use getName() and the attribute methods to find out about it. */
+        endElement,     /**< A closing tag, or the end of an empty tag like \<foo/\>. getName() returns the tag name. */
+        text,           /**< A block of text or a CDATA section, which you can get with getText(). */
+        endOfDocument,  /**< The document element has been closed. */
+        parseError      /**< The document is malformed, see getLastParseError(). */
+    };
+
+    /** Reads the next event from the stream.
+
+        Any StringRefs that were obtained for the previous event become invalid when
+        this is called. Once endOfDocument or parseError has been returned, all
+        subsequent calls return the same thing.
+    */
+    EventType next();
+
+    /** Returns the type of the event that was last returned by next(). */
+    EventType getCurrentEvent() const noexcept                  { return currentEvent; }
+
+    /** For a startElement or endElement event, returns the tag name. */
+    StringRef getName() const noexcept;
+
+    /** For a startElement event, returns the number of attributes that the tag has. */
+    int getNumAttributes() const noexcept                       { return attributes.size(); }
+
+    /** For a startElement event, returns the name of one of its attributes. */
+    StringRef getAttributeName (int index) const noexcept;
+
+    /** For a startElement event, returns the value of one of its attributes. */
+    StringRef getAttributeValue (int index) const noexcept;
+
+    /** For a startElement event, returns the value of the attribute with the given name,
+        or an empty string if there isn't one.
+    */
+    StringRef getAttributeValue (StringRef attributeName) const noexcept;
+
+    /** For a startElement event, returns true if the tag has an attribute with this name. */
+    bool hasAttribute (StringRef attributeName) const noexcept;
+
+    /** For a text event, returns the text with any entities decoded. */
+    StringRef getText() const noexcept;
+
+    /** Returns the number of elements that are currently open.
+        This is 1 after the document element's start tag, and goes back to 0 after its end tag.
+    */
+    int getDepth() const noexcept                               { return depth; }
+
+    /** After a startElement event, skips everything up to and including the element's end tag.
+        Returns false if the end of the document or an error was reached first.
+    */
+    bool skipElement();
+
+    /** Returns a description of the error if next() has returned parseError. */
+    const String& getLastParseError() const noexcept            { return lastError; }
+
+    /** Sets whether text blocks that contain only whitespace are skipped (the default),
+        or returned as text events.
+    */
+    void setEmptyTextElementsIgnored (bool shouldBeIgnored) noexcept    { ignoreEmptyTextElements = shouldBeIgnored; }
+
+private:
+    //==============================================================================
+    struct Attribute  { int nameStart, nameEnd, valueStart, valueEnd; };
+
+    InputStream& source;
+    HeapBlock<char> buffer;
+    int bufferSize = 0, dataEnd = 0, eventStart = 0, position = 0;
+    int nameStart = -1, textStart = -1, depth = 0, savedCharIndex = -1;
+    char savedChar = 0;
+    Array<Attribute> attributes;
+    EventType currentEvent = startElement;
+    bool sourceExhausted = false, hasReadDocumentElement = false;
+    bool isInsideEmptyElement = false, ignoreEmptyTextElements = true;
+    String lastError;
+
+   #if JUCE_STRING_UTF_TYPE != 8
+    mutable StringArray convertedStrings;
+   #endif
+
+    char peek (int offset)
+    {
+        auto index = eventStart + position + offset;
+        return index < dataEnd ? buffer[index] : peekAfterReading (offset);
+    }
+
+    char peekAfterReading (int offset);
+    bool readMoreData();
+    void startNewEvent() noexcept;
+    void terminate (int end) noexcept;
+    bool matches (const char*);
+    bool skipPast (const char*);
+    bool skipDocType();
+    void skipWhitespace();
+    void skipName();
+    String getString (int start, int end) const;
+    StringRef getStringRef (int start) const;
+    bool attributeNameMatches (int index, StringRef name) const noexcept;
+    bool readEncodedText (char terminator, int& output, bool& containsNonWhitespace);
+    juce_wchar readEntity (int& output);
+    EventType readStartTag();
+    EventType readEndTag();
+    EventType readCData();
+    EventType setEvent (EventType);
+    EventType setError (const String&);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (XmlPullParser)
+};
+
+} // namespace juce
@@ -112,6 +112,279 @@ private:
     JUCE_DECLARE_NON_COPYABLE (GZIPCompressorHelper)
 };
 
+//==============================================================================
+/*  Compresses blocks of the data on a TaskScheduler's threads, in the same way as pigz.
+
+    Each block is compressed as raw deflate data by its own z_stream, primed with the last
+    32K of the data before it. All blocks but the last one end with a sync flush, which
+    leaves them on a byte boundary without marking the end of the stream, so they can be
+    written one after the other to make a single deflate stream. The zlib or gzip header
+    and checksum are added around them here, with the checksum of each block being
+    calculated by the thread that compressed it, and then combined in order.
+*/
+class GZIPCompressorOutputStream::ParallelCompressorHelper
+{
+public:
+    ParallelCompressorHelper (TaskScheduler& s, const int compressionLevel, const int windowBits, const int size)
+        : scheduler (s),
+          compLevel ((compressionLevel < 0 || compressionLevel > 9) ? -1 : compressionLevel),
+          format (windowBits < 0 ? rawFormat : (windowBits > MAX_WBITS ? gzipFormat : zlibFormat)),
+          numWindowBits (windowBits == 0 ? (int) MAX_WBITS : (std::abs (windowBits) & 15)),
+          blockSize ((size_t) jmax (1024, size)),
+          maxBlocksInFlight (s.getNumThreads() * 2 + 2),
+          pendingInput (blockSize)
+    {
+        jassert (numWindowBits >= 8 && numWindowBits <= MAX_WBITS);
+        checksum = (format == gzipFormat ? zlibNamespace::crc32 (0, nullptr, 0)
+                                         : zlibNamespace::adler32 (0, nullptr, 0));
+    }
+
+    ~ParallelCompressorHelper()
+    {
+        // (blocks can't be deleted while a thread is still compressing them)
+        for (auto* block : blocks)
+            block->task.wait();
+    }
+
+    bool write (const uint8* data, size_t dataSize, OutputStream& out)
+    {
+        // When you call flush() on a gzip stream, the stream is closed, and you can
+        // no longer continue to write data to it!
+        jassert (! finished);
+
+        if (finished)
+            return false;
+
+        while (dataSize > 0)
+        {
+            auto numToCopy = jmin (dataSize, blockSize - numPendingBytes);
+            memcpy (static_cast<uint8*> (pendingInput.getData()) + numPendingBytes, data, numToCopy);
+            numPendingBytes += numToCopy;
+            data += numToCopy;
+            dataSize -= numToCopy;
+
+            if (numPendingBytes == blockSize && ! startBlock (false, out))
+                return false;
+        }
+
+        return true;
+    }
+
+    void finish (OutputStream& out)
+    {
+        if (finished)
+            return;
+
+        finished = true;
+
+        if (startBlock (true, out))
+        {
+            while (blocks.size() > 0)
+                if (! writeFirstBlock (out))
+                    return;
+
+            writeTrailer (out);
+        }
+    }
+
+private:
+    enum Format { rawFormat, zlibFormat, gzipFormat };
+
+    struct Block
+    {
+        MemoryBlock input, dictionary;
+        size_t inputSize = 0;
+        MemoryOutputStream output;
+        zlibNamespace::uLong checksum = 0;
+        bool isLast = false, succeeded = false;
+        TaskScheduler::TaskHandle task;
+    };
+
+    TaskScheduler& scheduler;
+    const int compLevel;
+    const Format format;
+    const int numWindowBits;
+    const size_t blockSize;
+    const int maxBlocksInFlight;
+
+    MemoryBlock pendingInput, dictionary;
+    size_t numPendingBytes = 0;
+    OwnedArray<Block> blocks;
+    zlibNamespace::uLong checksum;
+    uint32 totalInputSize = 0;
+    bool headerWritten = false, finished = false, failed = false;
+
+    bool startBlock (bool isLast, OutputStream& out)
+    {
+        if (failed)
+            return false;
+
+        auto* block = blocks.add (new Block());
+        block->input.swapWith (pendingInput);
+        block->inputSize = numPendingBytes;
+        block->dictionary = dictionary;
+        block->isLast = isLast;
+
+        updateDictionary (*block);
+
+        if (! isLast)
+            pendingInput.setSize (blockSize);
+
+        numPendingBytes = 0;
+
+        const int level = compLevel, windowBits = numWindowBits;
+        const bool useCRC = (format == gzipFormat);
+        block->task = scheduler.addTask ([block, level, windowBits, useCRC] { compressBlock (*block, level, windowBits, useCRC); });
+
+        while (blocks.size() > maxBlocksInFlight)
+            if (! writeFirstBlock (out))
+                return false;
+
+        return true;
+    }
+
+    // The next block gets primed with the last 32K (or whatever the window size is)
+    // of the data that came before it.
+    void updateDictionary (const Block& block)
+    {
+        auto windowSize = (size_t) 1 << numWindowBits;
+
+        if (block.inputSize >= windowSize)
+        {
+            dictionary.replaceWith (static_cast<const char*> (block.input.getData()) + block.inputSize - windowSize, windowSize);
+        }
+        else
+        {
+            dictionary.append (block.input.getData(), block.inputSize);
+
+            if (dictionary.getSize() > windowSize)
+                dictionary.removeSection (0, dictionary.getSize() - windowSize);
+        }
+    }
+
+    static void compressBlock (Block& block, int level, int windowBits, bool useCRC)
+    {
+        using namespace zlibNamespace;
+
+        auto* input = static_cast<Bytef*> (block.input.getData());
+        auto inputSize = (uInt) block.inputSize;
+
+        block.checksum = useCRC ? crc32   (crc32   (0, nullptr, 0), input, inputSize)
+                                : adler32 (adler32 (0, nullptr, 0), input, inputSize);
+
+        z_stream stream;
+        zerostruct (stream);
+
+        if (deflateInit2 (&stream, level, Z_DEFLATED, -windowBits, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+            return;
+
+        if (block.dictionary.getSize() > 0)
+            deflateSetDictionary (&stream, static_cast<const Bytef*> (block.dictionary.getData()),
+                                  (uInt) block.dictionary.getSize());
+
+        stream.next_in  = input;
+        stream.avail_in = inputSize;
+
+        const int flushMode = block.isLast ? Z_FINISH : Z_SYNC_FLUSH;
+        Bytef buffer[16384];
+
+        for (;;)
+        {
+            stream.next_out  = buffer;
+            stream.avail_out = (uInt) sizeof (buffer);
+
+            auto result = deflate (&stream, flushMode);
+
+            if (result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR)
+                break;
+
+            block.output.write (buffer, sizeof (buffer) - stream.avail_out);
+
+            // A sync flush is complete when there's some space left over in the output buffer,
+            // but the last block has to carry on until the end of the stream has been written.
+            if (block.isLast ? (result == Z_STREAM_END) : (stream.avail_out != 0))
+            {
+                block.succeeded = true;
+                break;
+            }
+        }
+
+        deflateEnd (&stream);
+        block.input.reset();
+        block.dictionary.reset();
+    }
+
+    bool writeFirstBlock (OutputStream& out)
+    {
+        ScopedPointer<Block> block (blocks.removeAndReturn (0));
+        block->task.wait();
+
+        if (! (block->succeeded && (headerWritten || writeHeader (out))))
+        {
+            failed = true;
+            return false;
+        }
+
+        if (format == gzipFormat)
+            checksum = zlibNamespace::crc32_combine (checksum, block->checksum, (z_off_t) block->inputSize);
+        else
+            checksum = zlibNamespace::adler32_combine (checksum, block->checksum, (z_off_t) block->inputSize);
+
+        totalInputSize += (uint32) block->inputSize;
+
+        if (! out.write (block->output.getData(), block->output.getDataSize()))
+        {
+            failed = true;
+            return false;
+        }
+
+        return true;
+    }
+
+    bool writeHeader (OutputStream& out)
+    {
+        headerWritten = true;
+
+        if (format == zlibFormat)
+        {
+            // (these are the same flags that zlib's deflate() would write)
+            auto levelFlags = (compLevel == 0 || compLevel == 1) ? 0
+                                : (compLevel >= 2 && compLevel < 6) ? 1
+                                : (compLevel == 6 || compLevel < 0) ? 2 : 3;
+
+            auto header = ((Z_DEFLATED + ((numWindowBits - 8) << 4)) << 8) | (levelFlags << 6);
+            header += 31 - (header % 31);
+
+            return out.writeShortBigEndian ((short) header);
+        }
+
+        if (format == gzipFormat)
+        {
+            const uint8 header[] = { 0x1f, 0x8b, Z_DEFLATED, 0, 0, 0, 0, 0,
+                                     (uint8) (compLevel == 9 ? 2 : (compLevel == 0 || compLevel == 1 ? 4 : 0)),
+                                     0xff }; // (OS unknown)
+
+            return out.write (header, sizeof (header));
+        }
+
+        return true;
+    }
+
+    bool writeTrailer (OutputStream& out)
+    {
+        if (format == zlibFormat)
+            return out.writeIntBigEndian ((int) checksum);
+
+        if (format == gzipFormat)
+            return out.writeInt ((int) checksum)
+                && out.writeInt ((int) totalInputSize);
+
+        return true;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (ParallelCompressorHelper)
+};
+
 //==============================================================================
 GZIPCompressorOutputStream::GZIPCompressorOutputStream (OutputStream* const out,
                                                         const int compressionLevel,
@@ -123,6 +396,18 @@ GZIPCompressorOutputStream::GZIPCompressorOutputStream (OutputStream* const out,
     jassert (out != nullptr);
 }
 
+GZIPCompressorOutputStream::GZIPCompressorOutputStream (OutputStream* const out,
+                                                        TaskScheduler& scheduler,
+                                                        const int compressionLevel,
+                                                        const bool deleteDestStream,
+                                                        const int windowBits,
+                                                        const int blockSize)
+    : destStream (out, deleteDestStream),
+      parallelHelper (new ParallelCompressorHelper (scheduler, compressionLevel, windowBits, blockSize))
+{
+    jassert (out != nullptr);
+}
+
 GZIPCompressorOutputStream::~GZIPCompressorOutputStream()
 {
     flush();
@@ -130,7 +415,11 @@ GZIPCompressorOutputStream::~GZIPCompressorOutputStream()
 
 void GZIPCompressorOutputStream::flush()
 {
-    helper->finish (*destStream);
+    if (parallelHelper != nullptr)
+        parallelHelper->finish (*destStream);
+    else
+        helper->finish (*destStream);
+
     destStream->flush();
 }
 
@@ -138,6 +427,9 @@ bool GZIPCompressorOutputStream::write (const void* destBuffer, size_t howMany)
 {
     jassert (destBuffer != nullptr && (ssize_t) howMany >= 0);
 
+    if (parallelHelper != nullptr)
+        return parallelHelper->write (static_cast<const uint8*> (destBuffer), howMany, *destStream);
+
     return helper->write (static_cast<const uint8*> (destBuffer), howMany, *destStream);
 }
 
@@ -198,6 +490,118 @@ struct GZIPTests  : public UnitTest
                                 original.getData(),
                                 original.getDataSize()) == 0);
         }
+
+        beginTest ("Parallel compression");
+        {
+            TaskScheduler scheduler (3);
+            const int blockSize = 4096;
+
+            struct FormatInfo  { int windowBits; GZIPDecompressorInputStream::Format format; };
+            const FormatInfo formats[] = { { 0,   GZIPDecompressorInputStream::zlibFormat },
+                                           { 12,  GZIPDecompressorInputStream::zlibFormat },
+                                           { 31,  GZIPDecompressorInputStream::gzipFormat },
+                                           { -15, GZIPDecompressorInputStream::deflateFormat } };
+
+            for (auto& f : formats)
+            {
+                for (auto size : { 0, 1, 1000, blockSize, blockSize * 3, 100000 + rng.nextInt (100000) })
+                {
+                    auto original = createTestData (rng, (size_t) size);
+                    MemoryOutputStream compressed;
+
+                    {
+                        GZIPCompressorOutputStream zipper (&compressed, scheduler, rng.nextInt (10), false, f.windowBits, blockSize);
+
+                        // (write in uneven pieces so that blocks are split across calls)
+                        for (size_t pos = 0; pos < original.getSize();)
+                        {
+                            auto num = jmin ((size_t) rng.nextInt (3 * blockSize) + 1, original.getSize() - pos);
+                            expect (zipper.write (static_cast<const char*> (original.getData()) + pos, num));
+                            pos += num;
+                        }
+                    }
+
+                    expect (decompress (compressed.getMemoryBlock(), f.format) == original);
+                }
+            }
+
+            // (level 9 writes different flags in the gzip header)
+            auto original = createTestData (rng, 50000);
+            MemoryOutputStream compressed;
+
+            {
+                GZIPCompressorOutputStream zipper (&compressed, scheduler, 9, false, 31, blockSize);
+                zipper << original;
+            }
+
+            expect (decompress (compressed.getMemoryBlock(), GZIPDecompressorInputStream::gzipFormat) == original);
+        }
+
+        beginTest ("Benchmark");
+        {
+            auto original = createTestData (rng, 16 * 1024 * 1024);
+
+            auto start = Time::getMillisecondCounterHiRes();
+            MemoryOutputStream serialOutput;
+
+            {
+                GZIPCompressorOutputStream zipper (&serialOutput, 6);
+                zipper << original;
+            }
+
+            auto serialTime = Time::getMillisecondCounterHiRes() - start;
+            auto megabytes = original.getSize() / (1024.0 * 1024.0);
+
+            logMessage (String (SystemStats::getNumCpus()) + " CPUs. Serial: " + String (megabytes * 1000.0 / serialTime, 1)
+                          + " MB/s, ratio " + String ((double) original.getSize() / (double) serialOutput.getDataSize(), 3));
+
+            for (auto numThreads : { 1, 2, 4, 8 })
+            {
+                TaskScheduler benchmarkScheduler (numThreads);
+                start = Time::getMillisecondCounterHiRes();
+                MemoryOutputStream output;
+
+                {
+                    GZIPCompressorOutputStream zipper (&output, benchmarkScheduler, 6);
+                    zipper << original;
+                }
+
+                auto time = Time::getMillisecondCounterHiRes() - start;
+
+                logMessage (String (numThreads) + " threads: " + String (megabytes * 1000.0 / time, 1) + " MB/s ("
+                              + String (serialTime / time, 2) + "x), ratio "
+                              + String ((double) original.getSize() / (double) output.getDataSize(), 3));
+
+                expect (decompress (output.getMemoryBlock(), GZIPDecompressorInputStream::zlibFormat) == original);
+            }
+        }
+    }
+
+    // Produces text-like data that compresses reasonably well, with repeats spanning block boundaries.
+    static MemoryBlock createTestData (Random& rng, size_t size)
+    {
+        MemoryOutputStream out (size);
+        StringArray words;
+
+        for (int i = 0; i < 200; ++i)
+            words.add (String::toHexString (rng.nextInt64()).substring (0, rng.nextInt (12) + 1));
+
+        while (out.getDataSize() < size)
+            out << words[rng.nextInt (words.size())] << ' ';
+
+        auto block = out.getMemoryBlock();
+        block.setSize (size);
+        return block;
+    }
+
+    static MemoryBlock decompress (const MemoryBlock& data, GZIPDecompressorInputStream::Format format)
+    {
+        MemoryInputStream compressedInput (data, false);
+        GZIPDecompressorInputStream unzipper (&compressedInput, false, format);
+
+        MemoryOutputStream uncompressed;
+        uncompressed << unzipper;
+        return uncompressed.getMemoryBlock();
     }
 };
 
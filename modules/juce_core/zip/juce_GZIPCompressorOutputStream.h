@@ -56,6 +56,40 @@ public:
                                 bool deleteDestStreamWhenDestroyed = false,
                                 int windowBits = 0);
 
+    /** Creates a compression stream which uses several threads to compress the data.
+
+        The data is split into blocks, and each block is compressed separately on one
+        of the scheduler's threads, using the end of the block before it as a preset
+        dictionary, so hardly any compression is lost. The compressed blocks are then
+        joined together in order to make a single stream in the same format that the
+        other constructor would produce, so it can be read by a GZIPDecompressorInputStream
+        or any other zlib-compatible decoder (although the bytes won't be identical).
+
+        The blocks that are waiting to be compressed or written are held in memory, so
+        this uses a few blocks' worth of memory per thread.
+
+        @param destStream                       the stream into which the compressed data should
+                                                be written
+        @param scheduler                        the scheduler whose threads should do the compression.
+                                                This must not be deleted before the stream
+        @param compressionLevel                 how much to compress the data, between 0 and 9 - see
+                                                the other constructor for details
+        @param deleteDestStreamWhenDestroyed    whether or not to delete the destStream object when
+                                                this stream is destroyed
+        @param windowBits                       this is used internally to change the window size used
+                                                by zlib - leave it as 0 unless you specifically need to set
+                                                its value for some reason
+        @param blockSize                        the number of bytes of uncompressed data in each block.
+                                                Smaller blocks let more threads share the work for small
+                                                amounts of data, but compress slightly less well
+    */
+    GZIPCompressorOutputStream (OutputStream* destStream,
+                                TaskScheduler& scheduler,
+                                int compressionLevel = -1,
+                                bool deleteDestStreamWhenDestroyed = false,
+                                int windowBits = 0,
+                                int blockSize = 128 * 1024);
+
     /** Destructor. */
     ~GZIPCompressorOutputStream();
 
@@ -88,6 +122,10 @@ private:
     friend struct ContainerDeletePolicy<GZIPCompressorHelper>;
     ScopedPointer<GZIPCompressorHelper> helper;
 
+    class ParallelCompressorHelper;
+    friend struct ContainerDeletePolicy<ParallelCompressorHelper>;
+    ScopedPointer<ParallelCompressorHelper> parallelHelper;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GZIPCompressorOutputStream)
 };
 
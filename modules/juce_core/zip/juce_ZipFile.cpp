@@ -128,19 +128,21 @@ struct ZipFile::ZipInputStream  : public InputStream
         else
         {
            #if JUCE_DEBUG
-            zf.streamCounter.numOpenStreams++;
+            ++(zf.streamCounter.numOpenStreams);
            #endif
         }
 
-        char buffer[30];
-
-        if (inputStream != nullptr
-             && inputStream->setPosition (zei.streamOffset)
-             && inputStream->read (buffer, 30) == 30
-             && ByteOrder::littleEndianInt (buffer) == 0x04034b50)
+        if (inputStream != nullptr)
         {
-            headerSize = 30 + ByteOrder::littleEndianShort (buffer + 26)
-                            + ByteOrder::littleEndianShort (buffer + 28);
+            if (inputStream == zf.inputStream)
+            {
+                const ScopedLock sl (zf.lock);
+                readHeader();
+            }
+            else
+            {
+                readHeader();
+            }
         }
     }
 
@@ -148,7 +150,7 @@ struct ZipFile::ZipInputStream  : public InputStream
     {
        #if JUCE_DEBUG
         if (inputStream != nullptr && inputStream == file.inputStream)
-            file.streamCounter.numOpenStreams--;
+            --(file.streamCounter.numOpenStreams);
        #endif
     }
 
@@ -202,6 +204,19 @@ struct ZipFile::ZipInputStream  : public InputStream
     }
 
 private:
+    void readHeader()
+    {
+        char buffer[30];
+
+        if (inputStream->setPosition (zipEntryHolder.streamOffset)
+             && inputStream->read (buffer, 30) == 30
+             && ByteOrder::littleEndianInt (buffer) == 0x04034b50)
+        {
+            headerSize = 30 + ByteOrder::littleEndianShort (buffer + 26)
+                            + ByteOrder::littleEndianShort (buffer + 28);
+        }
+    }
+
     ZipFile& file;
     ZipEntryHolder zipEntryHolder;
     int64 pos = 0;
@@ -238,6 +253,12 @@ ZipFile::ZipFile (InputSource* source)  : inputSource (source)
     init();
 }
 
+ZipFile::ZipFile (MemoryMappedFile* file)  : mappedFile (file)
+{
+    jassert (file != nullptr);
+    init();
+}
+
 ZipFile::~ZipFile()
 {
     entries.clear();
@@ -251,7 +272,7 @@ ZipFile::OpenStreamCounter::~OpenStreamCounter()
        Streams can't be kept open after the file is deleted because they need to share the input
        stream that is managed by the ZipFile object.
     */
-    jassert (numOpenStreams == 0);
+    jassert (numOpenStreams.get() == 0);
 }
 #endif
 
@@ -294,6 +315,9 @@ InputStream* ZipFile::createStreamForEntry (const int index)
 
     if (auto* zei = entries[index])
     {
+        if (mappedFile != nullptr)
+            return createMappedStreamForEntry (*zei);
+
         stream = new ZipInputStream (*this, *zei);
 
         if (zei->isCompressed)
@@ -310,6 +334,38 @@ InputStream* ZipFile::createStreamForEntry (const int index)
     return stream;
 }
 
+InputStream* ZipFile::createMappedStreamForEntry (const ZipEntryHolder& zei) const
+{
+    auto* data = static_cast<const char*> (mappedFile->getData());
+    auto size = (int64) mappedFile->getSize();
+
+    if (zei.streamOffset < 0 || zei.streamOffset + 30 > size)
+        return nullptr;
+
+    auto* header = data + zei.streamOffset;
+
+    if (ByteOrder::littleEndianInt (header) != 0x04034b50)
+        return nullptr;
+
+    auto dataStart = zei.streamOffset + 30 + ByteOrder::littleEndianShort (header + 26)
+                                           + ByteOrder::littleEndianShort (header + 28);
+
+    if (dataStart + zei.compressedSize > size)
+        return nullptr;
+
+    // The mapped data never changes, so these streams can all read it at the same
+    // time without needing to take the lock.
+    auto* stream = new MemoryInputStream (data + dataStart, (size_t) zei.compressedSize, false);
+
+    if (! zei.isCompressed)
+        return stream;
+
+    return new BufferedInputStream (new GZIPDecompressorInputStream (stream, true,
+                                                                     GZIPDecompressorInputStream::deflateFormat,
+                                                                     zei.entry.uncompressedSize),
+                                    32768, true);
+}
+
 InputStream* ZipFile::createStreamForEntry (const ZipEntry& entry)
 {
     for (int i = 0; i < entries.size(); ++i)
@@ -336,6 +392,11 @@ void ZipFile::init()
         in = inputSource->createInputStream();
         toDelete = in;
     }
+    else if (mappedFile != nullptr && mappedFile->getData() != nullptr)
+    {
+        in = new MemoryInputStream (mappedFile->getData(), mappedFile->getSize(), false);
+        toDelete = in;
+    }
 
     if (in != nullptr)
     {
@@ -389,22 +450,113 @@ Result ZipFile::uncompressTo (const File& targetDirectory,
     return Result::ok();
 }
 
-Result ZipFile::uncompressEntry (int index, const File& targetDirectory, bool shouldOverwriteFiles)
+Result ZipFile::uncompressTo (const File& targetDirectory, bool shouldOverwriteFiles, TaskScheduler& scheduler)
 {
-    auto* zei = entries.getUnchecked (index);
+    // Several threads mustn't try to create the same folder at once, so all the
+    // folders get created before any files are written. And where there are
+    // duplicate names, only the entry which would be left on disk by a serial
+    // unzip gets written.
+    FlatHashMap<String, int> fileEntries;
+    FlatHashSet<String> folderPaths;
+    Array<File> folders;
+
+    auto addFolder = [&] (const File& folder)
+    {
+        if (folderPaths.add (folder.getFullPathName()))
+            folders.add (folder);
+    };
+
+    for (int i = 0; i < entries.size(); ++i)
+    {
+        auto entryPath = getEntryPath (i);
+
+        if (entryPath.isEmpty())
+            continue;
+
+        auto targetFile = targetDirectory.getChildFile (entryPath);
+
+        if (isFolderPath (entryPath))
+        {
+            addFolder (targetFile);
+            continue;
+        }
+
+        addFolder (targetFile.getParentDirectory());
+
+        auto key = targetFile.getFullPathName();
+
+        if (! File::areFileNamesCaseSensitive())
+            key = key.toLowerCase();
+
+        if (shouldOverwriteFiles || ! fileEntries.contains (key))
+            fileEntries.set (key, i);
+    }
+
+    for (auto& folder : folders)
+    {
+        auto result = folder.createDirectory();
+
+        if (result.failed())
+            return result;
+    }
+
+    Array<int> indexes;
+
+    for (auto& item : fileEntries)
+        indexes.add (item.value);
+
+    indexes.sort();
+
+    Array<Result> results;
+    results.insertMultiple (0, Result::ok(), indexes.size());
+    Atomic<int> hasFailed;
+
+    scheduler.parallelFor (0, indexes.size(), [&] (int start, int end)
+    {
+        for (int i = start; i < end && hasFailed.get() == 0; ++i)
+        {
+            auto result = uncompressEntry (indexes.getUnchecked (i), targetDirectory, shouldOverwriteFiles);
+
+            if (result.failed())
+            {
+                results.getReference (i) = result;
+                hasFailed = 1;
+            }
+        }
+    }, 1);
+
+    for (auto& result : results)
+        if (result.failed())
+            return result;
+
+    return Result::ok();
+}
 
+String ZipFile::getEntryPath (int index) const
+{
    #if JUCE_WINDOWS
-    auto entryPath = zei->entry.filename;
+    return entries.getUnchecked (index)->entry.filename;
    #else
-    auto entryPath = zei->entry.filename.replaceCharacter ('\\', '/');
+    return entries.getUnchecked (index)->entry.filename.replaceCharacter ('\\', '/');
    #endif
+}
+
+bool ZipFile::isFolderPath (const String& entryPath)
+{
+    return entryPath.endsWithChar ('/') || entryPath.endsWithChar ('\\');
+}
+
+Result ZipFile::uncompressEntry (int index, const File& targetDirectory, bool shouldOverwriteFiles)
+{
+    auto* zei = entries.getUnchecked (index);
+    auto entryPath = getEntryPath (index);
 
     if (entryPath.isEmpty())
         return Result::ok();
 
     auto targetFile = targetDirectory.getChildFile (entryPath);
 
-    if (entryPath.endsWithChar ('/') || entryPath.endsWithChar ('\\'))
+    if (isFolderPath (entryPath))
         return targetFile.createDirectory(); // (entry is a directory, not a file)
 
     ScopedPointer<InputStream> in (createStreamForEntry (index));
@@ -451,30 +603,34 @@ struct ZipFile::Builder::Item
 
     bool writeData (OutputStream& target, const int64 overallStartPosition)
     {
-        MemoryOutputStream compressedData ((size_t) file.getSize());
+        MemoryOutputStream data ((size_t) file.getSize());
 
-        if (compressionLevel > 0)
-        {
-            GZIPCompressorOutputStream compressor (&compressedData, compressionLevel, false,
-                                                   GZIPCompressorOutputStream::windowBitsRaw);
-            if (! writeSource (compressor))
-                return false;
-        }
-        else
-        {
-            if (! writeSource (compressedData))
-                return false;
-        }
+        if (! compressData (data))
+            return false;
 
-        compressedSize = (int64) compressedData.getDataSize();
-        headerStart = target.getPosition() - overallStartPosition;
+        writeHeaderAndData (target, overallStartPosition, data);
+        return true;
+    }
 
-        target.writeInt (0x04034b50);
-        writeFlagsAndSizes (target);
-        target << storedPathname
-               << compressedData;
+    // This part of writeData() can be run on a background thread, leaving the data
+    // in memory until writeCompressedData() is called.
+    bool compressInBackground()
+    {
+        compressedData = new MemoryOutputStream ((size_t) file.getSize());
+        return compressData (*compressedData);
+    }
 
-        return true;
+    void writeCompressedData (OutputStream& target, const int64 overallStartPosition)
+    {
+        jassert (compressedData != nullptr);
+        writeHeaderAndData (target, overallStartPosition, *compressedData);
+        compressedData = nullptr;
+    }
+
+    int64 getSourceSize() const
+    {
+        return stream != nullptr ? jmax ((int64) 0, stream->getTotalLength())
+                                 : file.getSize();
     }
 
     bool writeDirectoryEntry (OutputStream& target)
@@ -495,6 +651,7 @@ struct ZipFile::Builder::Item
 private:
     const File file;
     ScopedPointer<InputStream> stream;
+    ScopedPointer<MemoryOutputStream> compressedData;
     String storedPathname;
     Time fileTime;
     int64 compressedSize = 0, uncompressedSize = 0, headerStart = 0;
@@ -507,6 +664,35 @@ private:
         target.writeShort ((short) (t.getDayOfMonth() + ((t.getMonth() + 1) << 5) + ((t.getYear() - 1980) << 9)));
     }
 
+    bool compressData (MemoryOutputStream& target)
+    {
+        if (compressionLevel > 0)
+        {
+            GZIPCompressorOutputStream compressor (&target, compressionLevel, false,
+                                                   GZIPCompressorOutputStream::windowBitsRaw);
+            if (! writeSource (compressor))
+                return false;
+        }
+        else
+        {
+            if (! writeSource (target))
+                return false;
+        }
+
+        compressedSize = (int64) target.getDataSize();
+        return true;
+    }
+
+    void writeHeaderAndData (OutputStream& target, const int64 overallStartPosition, const MemoryOutputStream& data)
+    {
+        headerStart = target.getPosition() - overallStartPosition;
+
+        target.writeInt (0x04034b50);
+        writeFlagsAndSizes (target);
+        target << storedPathname
+               << data;
+    }
+
     bool writeSource (OutputStream& target)
     {
         if (stream == nullptr)
@@ -585,6 +771,74 @@ bool ZipFile::Builder::writeToStream (OutputStream& target, double* const progre
             return false;
     }
 
+    if (! writeCentralDirectory (target, fileStart))
+        return false;
+
+    if (progress != nullptr)
+        *progress = 1.0;
+
+    return true;
+}
+
+bool ZipFile::Builder::writeToStream (OutputStream& target, double* const progress, TaskScheduler& scheduler) const
+{
+    auto fileStart = target.getPosition();
+
+    // The compressed data for each item stays in memory until all the items before it have
+    // been written, so this limits how far ahead of the writer the compression can get.
+    auto maxItemsInFlight = scheduler.getNumThreads() * 4 + 1;
+    const int64 maxBytesInFlight = 64 * 1024 * 1024;
+
+    Array<TaskScheduler::Future<bool>> tasks;
+    Array<int64> sizes;
+    int64 bytesInFlight = 0;
+    bool ok = true;
+
+    for (int i = 0; i < items.size(); ++i)
+    {
+        while (tasks.size() < items.size()
+                && (tasks.size() == i
+                     || (tasks.size() - i < maxItemsInFlight && bytesInFlight < maxBytesInFlight)))
+        {
+            auto* item = items.getUnchecked (tasks.size());
+            sizes.add (item->getSourceSize());
+            bytesInFlight += sizes.getLast();
+            tasks.add (scheduler.async ([item] { return item->compressInBackground(); }));
+        }
+
+        if (progress != nullptr)
+            *progress = (i + 0.5) / items.size();
+
+        if (! tasks.getReference (i).get())
+        {
+            ok = false;
+
+            // (the other tasks have to finish before their items can be deleted)
+            for (int j = i + 1; j < tasks.size(); ++j)
+                tasks.getReference (j).wait();
+
+            break;
+        }
+
+        items.getUnchecked (i)->writeCompressedData (target, fileStart);
+        tasks.getReference (i) = {};
+        bytesInFlight -= sizes.getUnchecked (i);
+    }
+
+    if (! ok)
+        return false;
+
+    if (! writeCentralDirectory (target, fileStart))
+        return false;
+
+    if (progress != nullptr)
+        *progress = 1.0;
+
+    return true;
+}
+
+bool ZipFile::Builder::writeCentralDirectory (OutputStream& target, const int64 fileStart) const
+{
     auto directoryStart = target.getPosition();
 
     for (auto* item : items)
@@ -602,10 +856,286 @@ bool ZipFile::Builder::writeToStream (OutputStream& target, double* const progre
     target.writeInt ((int) (directoryStart - fileStart));
     target.writeShort (0);
 
-    if (progress != nullptr)
-        *progress = 1.0;
-
     return true;
 }
 
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct ZipFileTests  : public UnitTest
+{
+    ZipFileTests()   : UnitTest ("ZipFile", "Compression") {}
+
+    struct TestEntry
+    {
+        String name;
+        MemoryBlock data;
+    };
+
+    static Array<TestEntry> createEntries (Random& r, int numEntries, int maxSize)
+    {
+        static const char* const words[] = { "alpha", "beta", "gamma", "delta", "preset", "gain", "cutoff",
+                                             "resonance", "attack", "decay", "sustain", "release", "0.5", "1" };
+        Array<TestEntry> entries;
+
+        for (int i = 0; i < numEntries; ++i)
+        {
+            MemoryOutputStream text;
+            auto size = r.nextInt (maxSize);
+
+            while ((int) text.getDataSize() < size)
+                text << words[r.nextInt (numElementsInArray (words))] << (r.nextInt (8) == 0 ? "\n" : " ");
+
+            entries.add ({ "folder" + String (i % 7) + "/entry" + String (i) + ".txt", text.getMemoryBlock() });
+        }
+
+        return entries;
+    }
+
+    static void addEntries (ZipFile::Builder& builder, const Array<TestEntry>& entries, int compressionLevel)
+    {
+        Time time (2017, 5, 10, 12, 30, 20);
+
+        for (auto& e : entries)
+            builder.addEntry (new MemoryInputStream (e.data, false), compressionLevel, e.name, time);
+    }
+
+    static MemoryBlock createZip (const Array<TestEntry>& entries, int compressionLevel, TaskScheduler* scheduler)
+    {
+        ZipFile::Builder builder;
+        addEntries (builder, entries, compressionLevel);
+
+        MemoryOutputStream out;
+
+        if (scheduler != nullptr)
+            builder.writeToStream (out, nullptr, *scheduler);
+        else
+            builder.writeToStream (out, nullptr);
+
+        return out.getMemoryBlock();
+    }
+
+    void expectFilesMatch (const File& folder, const Array<TestEntry>& entries)
+    {
+        for (auto& e : entries)
+        {
+            MemoryBlock fileData;
+            expect (folder.getChildFile (e.name).loadFileAsData (fileData));
+            expect (fileData == e.data, e.name);
+        }
+    }
+
+    void runTest() override
+    {
+        auto r = getRandom();
+        auto entries = createEntries (r, 200, 20000);
+        TaskScheduler scheduler (3);
+
+        beginTest ("Parallel compression");
+        {
+            for (auto level : { 0, 1, 9 })
+            {
+                auto serialZip = createZip (entries, level, nullptr);
+                auto parallelZip = createZip (entries, level, &scheduler);
+                expect (serialZip == parallelZip);
+
+                ZipFile zip (new MemoryInputStream (parallelZip, false), true);
+                expectEquals (zip.getNumEntries(), entries.size());
+
+                for (int i = 0; i < zip.getNumEntries(); ++i)
+                {
+                    ScopedPointer<InputStream> in (zip.createStreamForEntry (i));
+                    MemoryBlock data;
+                    in->readIntoMemoryBlock (data);
+                    expect (data == entries.getReference (i).data);
+                }
+            }
+        }
+
+        beginTest ("Parallel extraction");
+        {
+            auto folder = File::getSpecialLocation (File::tempDirectory).getNonexistentChildFile ("juce_ZipFileTests", {}, false);
+
+            // Include a folder entry, and a name which appears twice, in which case
+            // the last entry should win.
+            auto entriesWithDuplicate = entries;
+            entriesWithDuplicate.add ({ "empty folder/", {} });
+            entriesWithDuplicate.add ({ entries.getReference (3).name, entries.getReference (4).data });
+
+            auto zipData = createZip (entriesWithDuplicate, 6, nullptr);
+
+            {
+                ZipFile zip (new MemoryInputStream (zipData, false), true);
+                expect (zip.uncompressTo (folder, true, scheduler).wasOk());
+            }
+
+            auto expectedFiles = entries;
+            expectedFiles.getReference (3).data = entries.getReference (4).data;
+            expectFilesMatch (folder, expectedFiles);
+            expect (folder.getChildFile ("empty folder").isDirectory());
+
+            // Files that already exist should be left alone when overwriting is disabled
+            folder.getChildFile (entries.getReference (0).name).replaceWithText ("old");
+            folder.getChildFile (entries.getReference (1).name).deleteFile();
+
+            {
+                MemoryInputStream sharedStream (zipData, false);
+                ZipFile zip (sharedStream);
+                expect (zip.uncompressTo (folder, false, scheduler).wasOk());
+            }
+
+            expectEquals (folder.getChildFile (entries.getReference (0).name).loadFileAsString(), String ("old"));
+            expectFilesMatch (folder, expectedFiles.getReference (1));
+
+            folder.deleteRecursively();
+        }
+
+        beginTest ("Memory-mapped files");
+        {
+            TemporaryFile tempFile (".zip");
+
+            {
+                ZipFile::Builder builder;
+                Time time (2017, 5, 10, 12, 30, 20);
+
+                for (int i = 0; i < entries.size(); ++i)
+                    builder.addEntry (new MemoryInputStream (entries.getReference (i).data, false),
+                                      i % 2 == 0 ? 0 : 6, entries.getReference (i).name, time);
+
+                FileOutputStream out (tempFile.getFile());
+                expect (builder.writeToStream (out, nullptr));
+            }
+
+            ZipFile zip (new MemoryMappedFile (tempFile.getFile(), MemoryMappedFile::readOnly));
+            expectEquals (zip.getNumEntries(), entries.size());
+
+            Array<bool> matches;
+            matches.insertMultiple (0, false, entries.size());
+
+            scheduler.parallelFor (0, zip.getNumEntries(), [&] (int start, int end)
+            {
+                for (int i = start; i < end; ++i)
+                {
+                    ScopedPointer<InputStream> in (zip.createStreamForEntry (i));
+                    MemoryBlock data;
+
+                    if (in != nullptr)
+                        in->readIntoMemoryBlock (data);
+
+                    matches.getReference (i) = (data == entries.getReference (i).data);
+                }
+            }, 1);
+
+            expect (! matches.contains (false));
+
+            // An uncompressed entry should be read straight from the mapped data
+            ScopedPointer<InputStream> stored (zip.createStreamForEntry (0));
+            auto* memoryStream = dynamic_cast<MemoryInputStream*> (stored.get());
+            auto& storedData = entries.getReference (0).data;
+
+            expect (memoryStream != nullptr
+                     && memoryStream->getDataSize() == storedData.getSize()
+                     && memcmp (memoryStream->getData(), storedData.getData(), storedData.getSize()) == 0);
+        }
+
+        beginTest ("Benchmark");
+        {
+            auto benchmarkEntries = createEntries (r, 500, 40000);
+            auto folder = File::getSpecialLocation (File::tempDirectory).getNonexistentChildFile ("juce_ZipFileTests", {}, false);
+
+            auto start = Time::getMillisecondCounterHiRes();
+            auto zipData = createZip (benchmarkEntries, 6, nullptr);
+            auto serialCompressTime = Time::getMillisecondCounterHiRes() - start;
+
+            start = Time::getMillisecondCounterHiRes();
+
+            {
+                ZipFile zip (new MemoryInputStream (zipData, false), true);
+                expect (zip.uncompressTo (folder.getChildFile ("serial")).wasOk());
+            }
+
+            auto serialExtractTime = Time::getMillisecondCounterHiRes() - start;
+
+            logMessage (String (benchmarkEntries.size()) + " entries, " + String (zipData.getSize() / 1024) + " KB zipped, "
+                          + String (SystemStats::getNumCpus()) + " CPUs. Serial: compress " + String (serialCompressTime, 1)
+                          + " ms, extract " + String (serialExtractTime, 1) + " ms");
+
+            for (auto numThreads : { 1, 2, 4, 8 })
+            {
+                TaskScheduler benchmarkScheduler (numThreads);
+
+                start = Time::getMillisecondCounterHiRes();
+                expect (createZip (benchmarkEntries, 6, &benchmarkScheduler) == zipData);
+                auto compressTime = Time::getMillisecondCounterHiRes() - start;
+
+                start = Time::getMillisecondCounterHiRes();
+
+                {
+                    ZipFile zip (new MemoryInputStream (zipData, false), true);
+                    expect (zip.uncompressTo (folder.getChildFile (String (numThreads)), true, benchmarkScheduler).wasOk());
+                }
+
+                auto extractTime = Time::getMillisecondCounterHiRes() - start;
+
+                logMessage (String (numThreads) + " threads: compress " + String (compressTime, 1) + " ms ("
+                              + String (serialCompressTime / compressTime, 2) + "x), extract " + String (extractTime, 1)
+                              + " ms (" + String (serialExtractTime / extractTime, 2) + "x)");
+            }
+
+            auto storedZipFile = folder.getChildFile ("stored.zip");
+            {
+                auto storedZip = createZip (benchmarkEntries, 0, nullptr);
+                storedZipFile.replaceWithData (storedZip.getData(), storedZip.getSize());
+            }
+
+            for (auto numThreads : { 1, 4 })
+            {
+                TaskScheduler benchmarkScheduler (numThreads);
+                FileInputStream sharedStream (storedZipFile);
+                ZipFile sharedStreamZip (sharedStream), fileZip (storedZipFile);
+                ZipFile mappedZip (new MemoryMappedFile (storedZipFile, MemoryMappedFile::readOnly));
+
+                logMessage ("Reading stored entries on " + String (numThreads) + " threads: shared stream "
+                              + String (timeReadingAllEntries (sharedStreamZip, benchmarkScheduler), 1) + " ms, File "
+                              + String (timeReadingAllEntries (fileZip, benchmarkScheduler), 1) + " ms, memory-mapped "
+                              + String (timeReadingAllEntries (mappedZip, benchmarkScheduler), 1) + " ms");
+            }
+
+            folder.deleteRecursively();
+        }
+    }
+
+    static double timeReadingAllEntries (ZipFile& zip, TaskScheduler& scheduler)
+    {
+        auto start = Time::getMillisecondCounterHiRes();
+
+        for (int repeat = 0; repeat < 10; ++repeat)
+        {
+            scheduler.parallelFor (0, zip.getNumEntries(), [&] (int chunkStart, int chunkEnd)
+            {
+                HeapBlock<char> buffer (8192);
+
+                for (int i = chunkStart; i < chunkEnd; ++i)
+                {
+                    ScopedPointer<InputStream> in (zip.createStreamForEntry (i));
+
+                    while (in->read (buffer, 8192) > 0)
+                    {}
+                }
+            });
+        }
+
+        return Time::getMillisecondCounterHiRes() - start;
+    }
+
+    void expectFilesMatch (const File& folder, const TestEntry& entry)
+    {
+        expectFilesMatch (folder, Array<TestEntry> (entry));
+    }
+};
+
+static ZipFileTests zipFileTests;
+
+#endif
+
 } // namespace juce
@@ -58,6 +58,23 @@ public:
     */
     explicit ZipFile (InputSource* inputSource);
 
+    /** Creates a ZipFile which reads its data directly from a memory-mapped file.
+
+        The MemoryMappedFile object will be owned by the zip file, which will delete
+        it later when not needed, so any streams that were created for its entries
+        must be deleted before the ZipFile.
+
+        Because the whole archive is already in memory, no locking is needed to read it,
+        so streams for different entries can be used on different threads at the same
+        time. The streams returned for uncompressed entries are MemoryInputStreams which
+        point directly at the mapped data, so you can use MemoryInputStream::getData()
+        to get at an entry's content without copying it.
+        @code
+        ZipFile zip (new MemoryMappedFile (file, MemoryMappedFile::readOnly));
+        @endcode
+    */
+    explicit ZipFile (MemoryMappedFile* mappedFile);
+
     /** Destructor. */
     ~ZipFile();
 
@@ -121,7 +138,8 @@ public:
         Note that if the ZipFile was created with a user-supplied InputStream object,
         then all the streams which are created by this method will by trying to share
         the same source stream, so cannot be safely used on  multiple threads! (But if
-        you create the ZipFile from a File or InputSource, then it is safe to do this).
+        you create the ZipFile from a File, InputSource or MemoryMappedFile, then it is
+        safe to do this).
     */
     InputStream* createStreamForEntry (int index);
 
@@ -136,7 +154,8 @@ public:
         Note that if the ZipFile was created with a user-supplied InputStream object,
         then all the streams which are created by this method will by trying to share
         the same source stream, so cannot be safely used on  multiple threads! (But if
-        you create the ZipFile from a File or InputSource, then it is safe to do this).
+        you create the ZipFile from a File, InputSource or MemoryMappedFile, then it is
+        safe to do this).
     */
     InputStream* createStreamForEntry (const ZipEntry& entry);
 
@@ -153,6 +172,26 @@ public:
     Result uncompressTo (const File& targetDirectory,
                          bool shouldOverwriteFiles = true);
 
+    /** Uncompresses all of the files in the zip file, using a TaskScheduler to
+        extract several entries at the same time.
+
+        This creates all the folders first, and then decompresses and writes the
+        files on the scheduler's threads, waiting until they've all finished. If an
+        entry fails, any that haven't been started yet are skipped, and the error for
+        the first entry that failed is returned.
+
+        If the archive contains more than one entry with the same name, only the
+        one that would have been left on disk by uncompressTo() is extracted.
+
+        @param targetDirectory      the root folder to uncompress to
+        @param shouldOverwriteFiles whether to overwrite existing files with similarly-named ones
+        @param scheduler            the scheduler whose threads should do the work
+        @returns success if the file is successfully unzipped
+    */
+    Result uncompressTo (const File& targetDirectory,
+                         bool shouldOverwriteFiles,
+                         TaskScheduler& scheduler);
+
     /** Uncompresses one of the entries from the zip file.
 
         This will expand the entry and write it in a target directory. The entry's path is used to
@@ -216,12 +255,28 @@ public:
         */
         bool writeToStream (OutputStream& target, double* progress) const;
 
+        /** Generates the zip file, using a TaskScheduler to compress several entries
+            at the same time.
+
+            The entries are compressed into memory on the scheduler's threads, and are
+            written to the target stream in order as they become ready, so the result is
+            the same as the one that the other writeToStream() method produces. To limit
+            the amount of memory used, only a few entries per thread are held in memory
+            at once.
+
+            If the progress parameter is non-null, it will be updated with an approximate
+            progress status between 0 and 1.0
+        */
+        bool writeToStream (OutputStream& target, double* progress, TaskScheduler& scheduler) const;
+
         //==============================================================================
     private:
         struct Item;
         friend struct ContainerDeletePolicy<Item>;
         OwnedArray<Item> items;
 
+        bool writeCentralDirectory (OutputStream&, int64 fileStart) const;
+
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Builder)
     };
 
@@ -235,6 +290,7 @@ private:
     InputStream* inputStream = nullptr;
     ScopedPointer<InputStream> streamToDelete;
     ScopedPointer<InputSource> inputSource;
+    ScopedPointer<MemoryMappedFile> mappedFile;
 
    #if JUCE_DEBUG
     struct OpenStreamCounter
@@ -242,13 +298,16 @@ private:
         OpenStreamCounter() {}
         ~OpenStreamCounter();
 
-        int numOpenStreams = 0;
+        Atomic<int> numOpenStreams;
     };
 
     OpenStreamCounter streamCounter;
    #endif
 
     void init();
+    InputStream* createMappedStreamForEntry (const ZipEntryHolder&) const;
+    String getEntryPath (int index) const;
+    static bool isFolderPath (const String&);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ZipFile)
 };
@@ -139,4 +139,93 @@ void RSAKey::createKeyPair (RSAKey& publicKey, RSAKey& privateKey,
     privateKey.part2 = n;
 }
 
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class RSAKeyTests  : public UnitTest
+{
+public:
+    RSAKeyTests() : UnitTest ("RSAKey", "Cryptography") {}
+
+    static void createKeyPair (RSAKey& publicKey, RSAKey& privateKey, int numBits, Random& r)
+    {
+        int seeds[16];
+
+        for (auto& seed : seeds)
+            seed = r.nextInt();
+
+        RSAKey::createKeyPair (publicKey, privateKey, numBits, seeds, numElementsInArray (seeds));
+    }
+
+    void runTest() override
+    {
+        auto r = getRandom();
+
+        beginTest ("Encrypting and decrypting");
+        {
+            for (auto numBits : { 128, 512, 1024 })
+            {
+                RSAKey publicKey, privateKey;
+                createKeyPair (publicKey, privateKey, numBits, r);
+                expect (publicKey.isValid() && privateKey.isValid());
+                expect (RSAKey (publicKey.toString()) == publicKey);
+
+                for (int i = 0; i < 10; ++i)
+                {
+                    // (values longer than the key are encrypted in several pieces)
+                    BigInteger value;
+                    r.fillBitsRandomly (value, 0, r.nextInt (numBits * 3) + 1);
+
+                    if (value.isZero())
+                        value = 1;
+
+                    auto encrypted = value;
+                    expect (publicKey.applyToValue (encrypted));
+
+                    auto decrypted = encrypted;
+                    expect (privateKey.applyToValue (decrypted));
+                    expect (decrypted == value);
+                }
+            }
+        }
+
+        beginTest ("Benchmark");
+        {
+            for (auto numBits : { 1024, 2048 })
+            {
+                RSAKey publicKey, privateKey;
+
+                auto start = Time::getMillisecondCounterHiRes();
+                createKeyPair (publicKey, privateKey, numBits, r);
+                auto keyTime = Time::getMillisecondCounterHiRes() - start;
+
+                BigInteger value;
+                r.fillBitsRandomly (value, 0, numBits - 8);
+                int numSignatures = 0;
+
+                start = Time::getMillisecondCounterHiRes();
+
+                do
+                {
+                    auto signature = value;
+                    privateKey.applyToValue (signature);
+                    ++numSignatures;
+                }
+                while (Time::getMillisecondCounterHiRes() - start < 500.0);
+
+                auto signingTime = (Time::getMillisecondCounterHiRes() - start) / numSignatures;
+
+                logMessage (String (numBits) + "-bit keys: createKeyPair " + String (keyTime, 1)
+                              + " ms, applyToValue with the private key " + String (signingTime, 3) + " ms ("
+                              + String (1000.0 / signingTime, 1) + " per second)");
+            }
+        }
+    }
+};
+
+static RSAKeyTests rsaKeyTests;
+
+#endif
+
 } // namespace juce
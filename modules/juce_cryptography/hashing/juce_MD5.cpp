@@ -273,10 +273,11 @@ void MD5::processStream (InputStream& input, int64 numBytesToRead)
     if (numBytesToRead < 0)
         numBytesToRead = std::numeric_limits<int64>::max();
 
+    HeapBlock<uint8> tempBuffer (16384);
+
     while (numBytesToRead > 0)
     {
-        uint8 tempBuffer [512];
-        auto bytesRead = input.read (tempBuffer, (int) jmin (numBytesToRead, (int64) sizeof (tempBuffer)));
+        auto bytesRead = input.read (tempBuffer, (int) jmin (numBytesToRead, (int64) 16384));
 
         if (bytesRead <= 0)
             break;
@@ -27,11 +27,73 @@
 namespace juce
 {
 
+static const uint32 sha256RoundConstants[] =
+{
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+#if JUCE_INTEL
+// Processes 64-byte blocks using the SHA extensions, which do two rounds per instruction.
+// The instructions keep the state as two registers holding ABEF and CDGH.
+JUCE_TARGET_INSTRUCTION_SET ("sha,sse4.1")
+static void processSHA256BlocksWithSHAExtensions (uint32* state, const uint8* data, size_t numBlocks) noexcept
+{
+    const auto byteSwap = _mm_set_epi64x (0x0c0d0e0f08090a0bLL, 0x0405060700010203LL);
+
+    auto cdab = _mm_shuffle_epi32 (_mm_loadu_si128 ((const __m128i*) state), 0xb1);
+    auto efgh = _mm_shuffle_epi32 (_mm_loadu_si128 ((const __m128i*) (state + 4)), 0x1b);
+    auto abef = _mm_alignr_epi8 (cdab, efgh, 8);
+    auto cdgh = _mm_blend_epi16 (efgh, cdab, 0xf0);
+
+    for (; numBlocks > 0; --numBlocks, data += 64)
+    {
+        auto oldABEF = abef, oldCDGH = cdgh;
+        __m128i w[4];
+
+        for (int i = 0; i < 4; ++i)
+            w[i] = _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i*) (data + 16 * i)), byteSwap);
+
+        for (int i = 0; i < 16; ++i)
+        {
+            auto words = _mm_add_epi32 (w[i & 3], _mm_loadu_si128 ((const __m128i*) (sha256RoundConstants + 4 * i)));
+            cdgh = _mm_sha256rnds2_epu32 (cdgh, abef, words);
+            abef = _mm_sha256rnds2_epu32 (abef, cdgh, _mm_shuffle_epi32 (words, 0x0e));
+
+            // extend the message schedule by the four words that are needed 16 rounds from now
+            if (i < 12)
+                w[i & 3] = _mm_sha256msg2_epu32 (_mm_add_epi32 (_mm_sha256msg1_epu32 (w[i & 3], w[(i + 1) & 3]),
+                                                                _mm_alignr_epi8 (w[(i + 3) & 3], w[(i + 2) & 3], 4)),
+                                                 w[(i + 3) & 3]);
+        }
+
+        abef = _mm_add_epi32 (abef, oldABEF);
+        cdgh = _mm_add_epi32 (cdgh, oldCDGH);
+    }
+
+    auto feba = _mm_shuffle_epi32 (abef, 0x1b);
+    auto dchg = _mm_shuffle_epi32 (cdgh, 0xb1);
+    _mm_storeu_si128 ((__m128i*) state, _mm_blend_epi16 (feba, dchg, 0xf0));
+    _mm_storeu_si128 ((__m128i*) (state + 4), _mm_alignr_epi8 (dchg, feba, 8));
+}
+#endif
+
+//==============================================================================
 class SHA256Processor
 {
 public:
     SHA256Processor() noexcept
-        : length (0)
+    {
+        reset();
+    }
+
+    void reset() noexcept
     {
         state[0] = 0x6a09e667;
         state[1] = 0xbb67ae85;
@@ -41,22 +103,31 @@ public:
         state[5] = 0x9b05688c;
         state[6] = 0x1f83d9ab;
         state[7] = 0x5be0cd19;
+
+        length = 0;
+        numBufferedBytes = 0;
+    }
+
+    // expects numBlocks * 64 bytes of data
+    void processFullBlocks (const void* const data, size_t numBlocks) noexcept
+    {
+       #if JUCE_INTEL
+        if (useSHAExtensions)
+        {
+            processSHA256BlocksWithSHAExtensions (state, static_cast<const uint8*> (data), numBlocks);
+            length += 64 * numBlocks;
+            return;
+        }
+       #endif
+
+        for (size_t i = 0; i < numBlocks; ++i)
+            processFullBlock (addBytesToPointer (data, 64 * i));
     }
 
     // expects 64 bytes of data
     void processFullBlock (const void* const data) noexcept
     {
-        const uint32 constants[] =
-        {
-            0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
-            0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
-            0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
-            0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
-            0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
-            0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
-            0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
-            0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
-        };
+        const uint32* constants = sha256RoundConstants;
 
         uint32 block[16], s[8];
         memcpy (s, state, sizeof (s));
@@ -104,10 +175,7 @@ public:
 
         jassert (numBytes == 64 || numBytes == 128);
 
-        processFullBlock (finalBlocks);
-
-        if (numBytes > 64)
-            processFullBlock (finalBlocks + 64);
+        processFullBlocks (finalBlocks, numBytes / 64);
     }
 
     void copyResult (uint8* result) const noexcept
@@ -121,32 +189,71 @@ public:
         }
     }
 
+    // Adds some data, which can be any size. Whole blocks are processed directly from
+    // the source, and any partial block is kept until more data arrives.
+    void addData (const void* data, size_t numBytes) noexcept
+    {
+        auto* source = static_cast<const uint8*> (data);
+
+        if (numBufferedBytes > 0)
+        {
+            auto numToCopy = jmin (numBytes, (size_t) 64 - numBufferedBytes);
+            memcpy (buffer + numBufferedBytes, source, numToCopy);
+            numBufferedBytes += numToCopy;
+            source += numToCopy;
+            numBytes -= numToCopy;
+
+            if (numBufferedBytes < 64)
+                return;
+
+            processFullBlocks (buffer, 1);
+            numBufferedBytes = 0;
+        }
+
+        auto numBlocks = numBytes / 64;
+        processFullBlocks (source, numBlocks);
+
+        numBufferedBytes = numBytes - numBlocks * 64;
+        memcpy (buffer, source + numBlocks * 64, numBufferedBytes);
+    }
+
+    void finish (uint8* result) noexcept
+    {
+        processFinalBlock (buffer, (unsigned int) numBufferedBytes);
+        copyResult (result);
+    }
+
     void processStream (InputStream& input, int64 numBytesToRead, uint8* const result)
     {
         if (numBytesToRead < 0)
             numBytesToRead = std::numeric_limits<int64>::max();
 
-        for (;;)
+        HeapBlock<uint8> tempBuffer (16384);
+
+        while (numBytesToRead > 0)
         {
-            uint8 buffer [64];
-            const int bytesRead = input.read (buffer, (int) jmin (numBytesToRead, (int64) sizeof (buffer)));
+            auto bytesRead = input.read (tempBuffer, (int) jmin (numBytesToRead, (int64) 16384));
 
-            if (bytesRead < (int) sizeof (buffer))
-            {
-                processFinalBlock (buffer, (unsigned int) bytesRead);
+            if (bytesRead <= 0)
                 break;
-            }
 
-            numBytesToRead -= sizeof (buffer);
-            processFullBlock (buffer);
+            numBytesToRead -= bytesRead;
+            addData (tempBuffer, (size_t) bytesRead);
         }
 
-        copyResult (result);
+        finish (result);
     }
 
+   #if JUCE_INTEL
+    // (the unit tests turn this off to check the portable version)
+    bool useSHAExtensions = SystemStats::hasSHA() && SystemStats::hasSSE41();
+   #endif
+
 private:
     uint32 state[8];
     uint64 length;
+    uint8 buffer[64];
+    size_t numBufferedBytes;
 
     static inline uint32 rotate (const uint32 x, const uint32 y) noexcept                { return (x >> y) | (x << (32 - y)); }
     static inline uint32 ch  (const uint32 x, const uint32 y, const uint32 z) noexcept   { return z ^ ((y ^ z) & x); }
@@ -218,9 +325,96 @@ SHA256::SHA256 (CharPointer_UTF8 utf8) noexcept
 
 void SHA256::process (const void* const data, size_t numBytes)
 {
-    MemoryInputStream m (data, numBytes, false);
     SHA256Processor processor;
-    processor.processStream (m, -1, result);
+    processor.addData (data, numBytes);
+    processor.finish (result);
+}
+
+//==============================================================================
+SHA256::Hasher::Hasher()  : processor (new SHA256Processor()) {}
+SHA256::Hasher::~Hasher() {}
+
+void SHA256::Hasher::addData (const void* data, size_t numBytes)
+{
+    processor->addData (data, numBytes);
+}
+
+void SHA256::Hasher::addData (const MemoryBlock& data)
+{
+    processor->addData (data.getData(), data.getSize());
+}
+
+SHA256 SHA256::Hasher::getHash()
+{
+    SHA256 hash;
+    processor->finish (hash.result);
+    processor->reset();
+    return hash;
+}
+
+void SHA256::Hasher::reset()
+{
+    processor->reset();
+}
+
+//==============================================================================
+SHA256 SHA256::createTreeHash (const void* data, size_t numBytes, TaskScheduler& scheduler, size_t chunkSize)
+{
+    jassert (chunkSize > 0);
+
+    auto numChunks = (int) ((numBytes + chunkSize - 1) / chunkSize);
+
+    if (numChunks <= 1)
+        return SHA256 (data, numBytes);
+
+    // hash the chunks in parallel, keeping just the 32-byte digests..
+    HeapBlock<uint8> digests ((size_t) numChunks * 32);
+
+    scheduler.parallelFor (0, numChunks, [&] (int start, int end)
+    {
+        for (int i = start; i < end; ++i)
+        {
+            auto offset = (size_t) i * chunkSize;
+            SHA256 chunkHash (addBytesToPointer (data, offset), jmin (chunkSize, numBytes - offset));
+            memcpy (digests + i * 32, chunkHash.result, 32);
+        }
+    }, 1);
+
+    // ..then hash each pair of digests together, until there's only one left. Each parent
+    // is written over the first of the pair that it replaces, so this is done in place.
+    for (auto numDigests = numChunks; numDigests > 1; numDigests = (numDigests + 1) / 2)
+    {
+        for (int i = 0; i < numDigests; i += 2)
+        {
+            if (i + 1 < numDigests)
+            {
+                SHA256 parent (digests + i * 32, 64);
+                memcpy (digests + (i / 2) * 32, parent.result, 32);
+            }
+            else
+            {
+                memmove (digests + (i / 2) * 32, digests + i * 32, 32);
+            }
+        }
+    }
+
+    SHA256 hash;
+    memcpy (hash.result, digests, 32);
+    return hash;
+}
+
+SHA256 SHA256::createTreeHash (const File& file, TaskScheduler& scheduler, size_t chunkSize)
+{
+    MemoryMappedFile mappedFile (file, MemoryMappedFile::readOnly);
+
+    if (mappedFile.getData() != nullptr)
+        return createTreeHash (mappedFile.getData(), mappedFile.getSize(), scheduler, chunkSize);
+
+    // (an empty file can't be mapped)
+    if (file.existsAsFile() && file.getSize() == 0)
+        return SHA256 (nullptr, 0);
+
+    return {};
 }
 
 MemoryBlock SHA256::getRawData() const
@@ -265,6 +459,27 @@ public:
         }
     }
 
+    static MemoryBlock hashWithoutSHAExtensions (const void* data, size_t numBytes)
+    {
+        SHA256Processor processor;
+       #if JUCE_INTEL
+        processor.useSHAExtensions = false;
+       #endif
+        processor.addData (data, numBytes);
+
+        uint8 result[32];
+        processor.finish (result);
+        return MemoryBlock (result, sizeof (result));
+    }
+
+    static SHA256 hashPair (const SHA256& first, const SHA256& second)
+    {
+        SHA256::Hasher hasher;
+        hasher.addData (first.getRawData());
+        hasher.addData (second.getRawData());
+        return hasher.getHash();
+    }
+
     void runTest() override
     {
         beginTest ("SHA256");
@@ -272,6 +487,94 @@ public:
         test ("", "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
         test ("The quick brown fox jumps over the lazy dog",  "d7a8fbb307d7809469ca9abcb0082e4f8d5651e46d3cdb762d02d0bf37c9e592");
         test ("The quick brown fox jumps over the lazy dog.", "ef537f25c895bfa782526529a9b63d97aa631564d5d789c2b765448c8635fb6c");
+        test ("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+
+        {
+            MemoryBlock millionAs (1000000);
+            millionAs.fillWith ('a');
+            expectEquals (SHA256 (millionAs).toHexString(), String ("cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0"));
+            expect (hashWithoutSHAExtensions (millionAs.getData(), millionAs.getSize()) == SHA256 (millionAs).getRawData());
+        }
+
+        auto r = getRandom();
+
+        beginTest ("Hasher");
+        {
+            SHA256::Hasher hasher;
+
+            for (int i = 0; i < 100; ++i)
+            {
+                MemoryBlock data ((size_t) r.nextInt (5000));
+                r.fillBitsRandomly (data.getData(), data.getSize());
+
+                // add the data in random-sized pieces
+                for (size_t pos = 0; pos < data.getSize();)
+                {
+                    auto num = jmin ((size_t) r.nextInt (200), data.getSize() - pos);
+                    hasher.addData (addBytesToPointer (data.getData(), pos), num);
+                    pos += num;
+                }
+
+                auto hash = hasher.getHash();
+                expect (hash == SHA256 (data));
+                expect (hash.getRawData() == hashWithoutSHAExtensions (data.getData(), data.getSize()));
+
+                MemoryInputStream in (data, false);
+                expect (hash == SHA256 (in));
+            }
+        }
+
+        beginTest ("Tree hashes");
+        {
+            TaskScheduler scheduler (3);
+            MemoryBlock data (5000);
+            r.fillBitsRandomly (data.getData(), data.getSize());
+            auto* d = static_cast<const char*> (data.getData());
+
+            expect (SHA256::createTreeHash (d, 5000, scheduler) == SHA256 (data));
+
+            // three chunks make a tree with an odd one out
+            auto expected = hashPair (hashPair (SHA256 (d, 2000), SHA256 (d + 2000, 2000)), SHA256 (d + 4000, 1000));
+            expect (SHA256::createTreeHash (d, 5000, scheduler, 2000) == expected);
+
+            // five chunks have an odd one out at two levels
+            auto chunk = [d] (int i) { return SHA256 (d + i * 1000, 1000); };
+            auto expectedFive = hashPair (hashPair (hashPair (chunk (0), chunk (1)), hashPair (chunk (2), chunk (3))), chunk (4));
+            expect (SHA256::createTreeHash (d, 5000, scheduler, 1000) == expectedFive);
+
+            auto tempFile = File::createTempFile (".bin");
+            tempFile.replaceWithData (d, 5000);
+            expect (SHA256::createTreeHash (tempFile, scheduler, 2000) == expected);
+            expect (SHA256 (tempFile) == SHA256 (data));
+
+            tempFile.deleteFile();
+            tempFile.create();
+            expect (SHA256::createTreeHash (tempFile, scheduler) == SHA256 (nullptr, 0));
+            expect (SHA256 (tempFile) == SHA256 (nullptr, 0));
+
+            tempFile.deleteFile();
+            expect (SHA256::createTreeHash (tempFile, scheduler) == SHA256());
+        }
+
+        beginTest ("Benchmark");
+        {
+            MemoryBlock data (32 * 1024 * 1024);
+            r.fillBitsRandomly (data.getData(), data.getSize());
+            TaskScheduler scheduler;
+
+            auto throughput = [&] (std::function<void()> hashData)
+            {
+                auto start = Time::getMillisecondCounterHiRes();
+                hashData();
+                auto seconds = (Time::getMillisecondCounterHiRes() - start) / 1000.0;
+                return String ((double) data.getSize() / (1024.0 * 1024.0) / seconds, 1) + " MB/s";
+            };
+
+            logMessage ("SHA-256 portable " + throughput ([&] { hashWithoutSHAExtensions (data.getData(), data.getSize()); })
+                          + ", using the CPU's SHA extensions if available " + throughput ([&] { SHA256 hash (data); })
+                          + ", tree hash on " + String (scheduler.getNumThreads()) + " threads "
+                          + throughput ([&] { SHA256::createTreeHash (data.getData(), data.getSize(), scheduler); }));
+        }
     }
 };
 
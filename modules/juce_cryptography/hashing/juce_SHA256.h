@@ -27,6 +27,8 @@
 namespace juce
 {
 
+class SHA256Processor;
+
 //==============================================================================
 /**
     SHA-256 secure hash generator.
@@ -84,6 +86,79 @@ public:
     */
     explicit SHA256 (CharPointer_UTF8 utf8Text) noexcept;
 
+    //==============================================================================
+    /**
+        Calculates a hash from data which is supplied in several pieces.
+
+        @code
+        SHA256::Hasher hasher;
+
+        while (auto* packet = getNextPacket())
+            hasher.addData (packet->data, packet->size);
+
+        auto hash = hasher.getHash();
+        @endcode
+    */
+    class JUCE_API  Hasher
+    {
+    public:
+        /** Creates a Hasher, ready to be given some data. */
+        Hasher();
+
+        /** Destructor. */
+        ~Hasher();
+
+        /** Adds some more data to the hash. */
+        void addData (const void* data, size_t numBytes);
+
+        /** Adds some more data to the hash. */
+        void addData (const MemoryBlock& data);
+
+        /** Returns the hash of all the data that has been added, and resets the Hasher
+            so that it can be used again.
+        */
+        SHA256 getHash();
+
+        /** Discards any data that has been added. */
+        void reset();
+
+    private:
+        ScopedPointer<SHA256Processor> processor;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Hasher)
+    };
+
+    //==============================================================================
+    /** Calculates a tree hash of a block of data, using several threads.
+
+        The data is split into chunks of the given size, which are hashed in parallel.
+        Pairs of adjacent hashes are then hashed together, and so on, until only one is
+        left; an odd one out at the end of a level is passed up to the next level as it
+        is. With the default chunk size of 1MB, this gives the same result as the tree
+        hash used by Amazon Glacier.
+
+        Note that this is not the same as the ordinary hash of the data, unless the data
+        fits into a single chunk.
+    */
+    static SHA256 createTreeHash (const void* data, size_t numBytes,
+                                  TaskScheduler& scheduler, size_t chunkSize = 1024 * 1024);
+
+    /** Calculates a tree hash of a file's contents, using several threads.
+
+        The file is read through a MemoryMappedFile, so that its chunks can be hashed in
+        parallel straight from the OS's file cache. If the file can't be opened, the hash
+        will be left uninitialised (i.e. full of zeros).
+
+        Because the file is mapped, it mustn't be truncated by another process while it's
+        being hashed, as some systems will raise a bus error when the missing pages are
+        read. The SHA256 (const File&) constructor reads through a stream, so use that for
+        files that may change.
+
+        @see createTreeHash
+    */
+    static SHA256 createTreeHash (const File& file, TaskScheduler& scheduler,
+                                  size_t chunkSize = 1024 * 1024);
+
     //==============================================================================
     /** Returns the hash as a 32-byte block of data. */
     MemoryBlock getRawData() const;
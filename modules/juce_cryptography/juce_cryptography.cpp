@@ -35,6 +35,10 @@
 
 #include "juce_cryptography.h"
 
+#if JUCE_INTEL
+ #include <immintrin.h>
+#endif
+
 #include "encryption/juce_BlowFish.cpp"
 #include "encryption/juce_Primes.cpp"
 #include "encryption/juce_RSAKey.cpp"
@@ -369,6 +369,17 @@ public:
     */
     static ValueTree fromXml (const XmlElement& xml);
 
+    /** Tries to recreate a node from XML text which is read from a stream.
+
+        This reads the stream with an XmlPullParser, creating the nodes as it goes, so it's
+        much faster and needs far less memory than loading the document into an XmlElement
+        and then calling fromXml() on that. As with the other version, it's only designed to
+        read XML that was created by the createXml() method.
+
+        If the XML can't be parsed, this returns an invalid ValueTree.
+    */
+    static ValueTree fromXml (InputStream& xmlData);
+
     /** This returns a string containing an XML representation of the tree.
         This is quite handy for debugging purposes, as it provides a quick way to view a tree.
     */
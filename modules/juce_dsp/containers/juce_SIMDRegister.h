@@ -142,6 +142,9 @@ struct SIMDRegister
     /** Subtracts another SIMDRegister to the receiver. */
     inline SIMDRegister& JUCE_VECTOR_CALLTYPE operator*= (SIMDRegister v) noexcept      { value = CmplxOps::mul (value, v.value); return *this; }
 
+    /** Divides the receiver by another SIMDRegister. Only available for floating point element types. */
+    inline SIMDRegister& JUCE_VECTOR_CALLTYPE operator/= (SIMDRegister v) noexcept      { value = NativeOps::div (value, v.value); return *this; }
+
     //==============================================================================
     /** Broadcasts the scalar to all elements of the receiver. */
     inline SIMDRegister& JUCE_VECTOR_CALLTYPE operator=  (ElementType s) noexcept       { value  = CmplxOps::expand (s); return *this; }
@@ -155,6 +158,9 @@ struct SIMDRegister
     /** Multiplies a scalar to the receiver. */
     inline SIMDRegister& JUCE_VECTOR_CALLTYPE operator*= (ElementType s) noexcept       { value = CmplxOps::mul (value, CmplxOps::expand (s)); return *this; }
 
+    /** Divides the receiver by a scalar. Only available for floating point element types. */
+    inline SIMDRegister& JUCE_VECTOR_CALLTYPE operator/= (ElementType s) noexcept       { value = NativeOps::div (value, NativeOps::expand (s)); return *this; }
+
     //==============================================================================
     /** Bit-and the reciver with SIMDRegister v and store the result in the receiver. */
     inline SIMDRegister& JUCE_VECTOR_CALLTYPE operator&= (vMaskType v) noexcept         { value = NativeOps::bit_and (value, toVecType (v.value)); return *this; }
@@ -185,6 +191,9 @@ struct SIMDRegister
     /** Returns the product of the receiver and v.*/
     inline SIMDRegister JUCE_VECTOR_CALLTYPE operator* (SIMDRegister v) const noexcept  { return { CmplxOps::mul (value, v.value) }; }
 
+    /** Returns the quotient of the receiver and v. Only available for floating point element types. */
+    inline SIMDRegister JUCE_VECTOR_CALLTYPE operator/ (SIMDRegister v) const noexcept  { return { NativeOps::div (value, v.value) }; }
+
     //==============================================================================
     /** Returns a vector where each element is the sum of the corresponding element in the receiver and the scalar s.*/
     inline SIMDRegister JUCE_VECTOR_CALLTYPE operator+ (ElementType s) const noexcept   { return { NativeOps::add (value, CmplxOps::expand (s)) }; }
@@ -195,6 +204,10 @@ struct SIMDRegister
     /** Returns a vector where each element is the difference of the corresponding element in the receiver and the scalar s.*/
     inline SIMDRegister JUCE_VECTOR_CALLTYPE operator* (ElementType s) const noexcept   { return { CmplxOps::mul (value, CmplxOps::expand (s)) }; }
 
+    /** Returns a vector where each element is the quotient of the corresponding element in the receiver and the scalar s.
+        Only available for floating point element types. */
+    inline SIMDRegister JUCE_VECTOR_CALLTYPE operator/ (ElementType s) const noexcept   { return { NativeOps::div (value, NativeOps::expand (s)) }; }
+
     //==============================================================================
     /** Returns the bit-and of the receiver and v. */
     inline SIMDRegister JUCE_VECTOR_CALLTYPE operator& (vMaskType v) const noexcept     { return { NativeOps::bit_and (value, toVecType (v.value)) }; }
@@ -52,6 +52,7 @@
 #include "processors/juce_FIRFilter.cpp"
 #include "processors/juce_IIRFilter.cpp"
 #include "processors/juce_Oversampling.cpp"
+#include "processors/juce_BandLimitedOscillator.cpp"
 #include "maths/juce_SpecialFunctions.cpp"
 #include "maths/juce_Matrix.cpp"
 #include "maths/juce_LookupTable.cpp"
@@ -76,9 +77,13 @@
 
 #if JUCE_UNIT_TESTS
 #include "maths/juce_Matrix_test.cpp"
+#include "maths/juce_FastMathApproximations_test.cpp"
 #if JUCE_USE_SIMD
 #include "containers/juce_SIMDRegister_test.cpp"
 #endif
 #include "frequency/juce_FFT_test.cpp"
 #include "processors/juce_FIRFilter_test.cpp"
+#include "processors/juce_Oversampling_test.cpp"
+#include "processors/juce_BandLimitedOscillator_test.cpp"
+#include "processors/juce_SmoothedParameterBank_test.cpp"
 #endif
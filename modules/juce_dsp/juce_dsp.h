@@ -242,10 +242,12 @@ namespace juce
 #include "maths/juce_SpecialFunctions.h"
 #include "maths/juce_Matrix.h"
 #include "maths/juce_Polynomial.h"
-#include "maths/juce_FastMathApproximations.h"
+
 #include "maths/juce_LookupTable.h"
 #include "containers/juce_AudioBlock.h"
+#include "maths/juce_FastMathApproximations.h"
 #include "processors/juce_ProcessContext.h"
+#include "processors/juce_SmoothedParameterBank.h"
 #include "processors/juce_ProcessorWrapper.h"
 #include "processors/juce_ProcessorChain.h"
 #include "processors/juce_ProcessorDuplicator.h"
@@ -255,6 +257,7 @@ namespace juce
 #include "processors/juce_IIRFilter.h"
 #include "processors/juce_FIRFilter.h"
 #include "processors/juce_Oscillator.h"
+#include "processors/juce_BandLimitedOscillator.h"
 #include "processors/juce_StateVariableFilter.h"
 #include "processors/juce_Oversampling.h"
 #include "frequency/juce_FFT.h"
@@ -31,6 +31,10 @@ namespace dsp
 
 /**
     This class contains various fast mathematical function approximations.
+
+    Each function can be called with a single value, a SIMDRegister, a raw buffer
+    or an AudioBlock. The buffer and block versions use SIMD instructions for
+    float and double samples when JUCE_USE_SIMD is enabled.
 */
 struct FastMathApproximations
 {
@@ -43,9 +47,11 @@ struct FastMathApproximations
     template <typename FloatType>
     static FloatType cosh (FloatType x) noexcept
     {
+        using NumericType = typename SampleTypeHelpers::ElementType<FloatType>::Type;
+
         auto x2 = x * x;
-        auto numerator = -(39251520 + x2 * (18471600 + x2 * (1075032 + 14615 * x2)));
-        auto denominator = -39251520 + x2 * (1154160 + x2 * (-16632 + 127 * x2));
+        auto numerator = x2 * (x2 * (x2 * NumericType (-14615) - NumericType (1075032)) - NumericType (18471600)) - NumericType (39251520);
+        auto denominator = x2 * (x2 * (x2 * NumericType (127) - NumericType (16632)) + NumericType (1154160)) - NumericType (39251520);
         return numerator / denominator;
     }
 
@@ -58,8 +64,19 @@ struct FastMathApproximations
     template <typename FloatType>
     static void cosh (FloatType* values, size_t numValues) noexcept
     {
-        for (size_t i = 0; i < numValues; ++i)
-            values[i] = FastMathApproximations::cosh (values[i]);
+        applyToBuffer (Cosh(), values, numValues);
+    }
+
+    /** Applies the fast approximation of cosh(x) to every channel of an AudioBlock,
+        in place.
+
+        For float and double blocks, the samples are processed using SIMDRegister
+        operations when JUCE_USE_SIMD is enabled.
+    */
+    template <typename FloatType>
+    static void cosh (AudioBlock<FloatType> block) noexcept
+    {
+        applyToBlock (Cosh(), block);
     }
 
     /** Provides a fast approximation of the function sinh(x) using a Pade approximant
@@ -71,9 +88,11 @@ struct FastMathApproximations
     template <typename FloatType>
     static FloatType sinh (FloatType x) noexcept
     {
+        using NumericType = typename SampleTypeHelpers::ElementType<FloatType>::Type;
+
         auto x2 = x * x;
-        auto numerator = -x * (11511339840 + x2 * (1640635920 + x2 * (52785432 + x2 * 479249)));
-        auto denominator = -11511339840 + x2 * (277920720 + x2 * (-3177720 + x2 * 18361));
+        auto numerator = x * (x2 * (x2 * (x2 * NumericType (-479249) - NumericType (52785432)) - NumericType (1640635920)) - NumericType (11511339840.0));
+        auto denominator = x2 * (x2 * (x2 * NumericType (18361) - NumericType (3177720)) + NumericType (277920720)) - NumericType (11511339840.0);
         return numerator / denominator;
     }
 
@@ -86,8 +105,19 @@ struct FastMathApproximations
     template <typename FloatType>
     static void sinh (FloatType* values, size_t numValues) noexcept
     {
-        for (size_t i = 0; i < numValues; ++i)
-            values[i] = FastMathApproximations::sinh (values[i]);
+        applyToBuffer (Sinh(), values, numValues);
+    }
+
+    /** Applies the fast approximation of sinh(x) to every channel of an AudioBlock,
+        in place.
+
+        For float and double blocks, the samples are processed using SIMDRegister
+        operations when JUCE_USE_SIMD is enabled.
+    */
+    template <typename FloatType>
+    static void sinh (AudioBlock<FloatType> block) noexcept
+    {
+        applyToBlock (Sinh(), block);
     }
 
     /** Provides a fast approximation of the function tanh(x) using a Pade approximant
@@ -99,9 +129,11 @@ struct FastMathApproximations
     template <typename FloatType>
     static FloatType tanh (FloatType x) noexcept
     {
+        using NumericType = typename SampleTypeHelpers::ElementType<FloatType>::Type;
+
         auto x2 = x * x;
-        auto numerator = x * (135135 + x2 * (17325 + x2 * (378 + x2)));
-        auto denominator = 135135 + x2 * (62370 + x2 * (3150 + 28 * x2));
+        auto numerator = x * (x2 * (x2 * (x2 + NumericType (378)) + NumericType (17325)) + NumericType (135135));
+        auto denominator = x2 * (x2 * (x2 * NumericType (28) + NumericType (3150)) + NumericType (62370)) + NumericType (135135);
         return numerator / denominator;
     }
 
@@ -114,8 +146,19 @@ struct FastMathApproximations
     template <typename FloatType>
     static void tanh (FloatType* values, size_t numValues) noexcept
     {
-        for (size_t i = 0; i < numValues; ++i)
-            values[i] = FastMathApproximations::tanh (values[i]);
+        applyToBuffer (Tanh(), values, numValues);
+    }
+
+    /** Applies the fast approximation of tanh(x) to every channel of an AudioBlock,
+        in place.
+
+        For float and double blocks, the samples are processed using SIMDRegister
+        operations when JUCE_USE_SIMD is enabled.
+    */
+    template <typename FloatType>
+    static void tanh (AudioBlock<FloatType> block) noexcept
+    {
+        applyToBlock (Tanh(), block);
     }
 
     //==============================================================================
@@ -128,9 +171,11 @@ struct FastMathApproximations
     template <typename FloatType>
     static FloatType cos (FloatType x) noexcept
     {
+        using NumericType = typename SampleTypeHelpers::ElementType<FloatType>::Type;
+
         auto x2 = x * x;
-        auto numerator = -(-39251520 + x2 * (18471600 + x2 * (-1075032 + 14615 * x2)));
-        auto denominator = 39251520 + x2 * (1154160 + x2 * (16632 + x2 * 127));
+        auto numerator = x2 * (x2 * (x2 * NumericType (-14615) + NumericType (1075032)) - NumericType (18471600)) + NumericType (39251520);
+        auto denominator = x2 * (x2 * (x2 * NumericType (127) + NumericType (16632)) + NumericType (1154160)) + NumericType (39251520);
         return numerator / denominator;
     }
 
@@ -143,8 +188,19 @@ struct FastMathApproximations
     template <typename FloatType>
     static void cos (FloatType* values, size_t numValues) noexcept
     {
-        for (size_t i = 0; i < numValues; ++i)
-            values[i] = FastMathApproximations::cos (values[i]);
+        applyToBuffer (Cos(), values, numValues);
+    }
+
+    /** Applies the fast approximation of cos(x) to every channel of an AudioBlock,
+        in place.
+
+        For float and double blocks, the samples are processed using SIMDRegister
+        operations when JUCE_USE_SIMD is enabled.
+    */
+    template <typename FloatType>
+    static void cos (AudioBlock<FloatType> block) noexcept
+    {
+        applyToBlock (Cos(), block);
     }
 
     /** Provides a fast approximation of the function sin(x) using a Pade approximant
@@ -156,9 +212,11 @@ struct FastMathApproximations
     template <typename FloatType>
     static FloatType sin (FloatType x) noexcept
     {
+        using NumericType = typename SampleTypeHelpers::ElementType<FloatType>::Type;
+
         auto x2 = x * x;
-        auto numerator = -x * (-11511339840 + x2 * (1640635920 + x2 * (-52785432 + x2 * 479249)));
-        auto denominator = 11511339840 + x2 * (277920720 + x2 * (3177720 + x2 * 18361));
+        auto numerator = x * (x2 * (x2 * (x2 * NumericType (-479249) + NumericType (52785432)) - NumericType (1640635920)) + NumericType (11511339840.0));
+        auto denominator = x2 * (x2 * (x2 * NumericType (18361) + NumericType (3177720)) + NumericType (277920720)) + NumericType (11511339840.0);
         return numerator / denominator;
     }
 
@@ -171,8 +229,19 @@ struct FastMathApproximations
     template <typename FloatType>
     static void sin (FloatType* values, size_t numValues) noexcept
     {
-        for (size_t i = 0; i < numValues; ++i)
-            values[i] = FastMathApproximations::sin (values[i]);
+        applyToBuffer (Sin(), values, numValues);
+    }
+
+    /** Applies the fast approximation of sin(x) to every channel of an AudioBlock,
+        in place.
+
+        For float and double blocks, the samples are processed using SIMDRegister
+        operations when JUCE_USE_SIMD is enabled.
+    */
+    template <typename FloatType>
+    static void sin (AudioBlock<FloatType> block) noexcept
+    {
+        applyToBlock (Sin(), block);
     }
 
     /** Provides a fast approximation of the function tan(x) using a Pade approximant
@@ -184,9 +253,11 @@ struct FastMathApproximations
     template <typename FloatType>
     static FloatType tan (FloatType x) noexcept
     {
+        using NumericType = typename SampleTypeHelpers::ElementType<FloatType>::Type;
+
         auto x2 = x * x;
-        auto numerator = x * (-135135 + x2 * (17325 + x2 * (-378 + x2)));
-        auto denominator = -135135 + x2 * (62370 + x2 * (-3150 + 28 * x2));
+        auto numerator = x * (x2 * (x2 * (x2 - NumericType (378)) + NumericType (17325)) - NumericType (135135));
+        auto denominator = x2 * (x2 * (x2 * NumericType (28) - NumericType (3150)) + NumericType (62370)) - NumericType (135135);
         return numerator / denominator;
     }
 
@@ -199,8 +270,19 @@ struct FastMathApproximations
     template <typename FloatType>
     static void tan (FloatType* values, size_t numValues) noexcept
     {
-        for (size_t i = 0; i < numValues; ++i)
-            values[i] = FastMathApproximations::tan (values[i]);
+        applyToBuffer (Tan(), values, numValues);
+    }
+
+    /** Applies the fast approximation of tan(x) to every channel of an AudioBlock,
+        in place.
+
+        For float and double blocks, the samples are processed using SIMDRegister
+        operations when JUCE_USE_SIMD is enabled.
+    */
+    template <typename FloatType>
+    static void tan (AudioBlock<FloatType> block) noexcept
+    {
+        applyToBlock (Tan(), block);
     }
 
     //==============================================================================
@@ -213,8 +295,10 @@ struct FastMathApproximations
     template <typename FloatType>
     static FloatType exp (FloatType x) noexcept
     {
-        auto numerator = 1680 + x * (840 + x * (180 + x * (20 + x)));
-        auto denominator = 1680 + x *(-840 + x * (180 + x * (-20 + x)));
+        using NumericType = typename SampleTypeHelpers::ElementType<FloatType>::Type;
+
+        auto numerator = x * (x * (x * (x + NumericType (20)) + NumericType (180)) + NumericType (840)) + NumericType (1680);
+        auto denominator = x * (x * (x * (x - NumericType (20)) + NumericType (180)) - NumericType (840)) + NumericType (1680);
         return numerator / denominator;
     }
 
@@ -227,8 +311,19 @@ struct FastMathApproximations
     template <typename FloatType>
     static void exp (FloatType* values, size_t numValues) noexcept
     {
-        for (size_t i = 0; i < numValues; ++i)
-            values[i] = FastMathApproximations::exp (values[i]);
+        applyToBuffer (Exp(), values, numValues);
+    }
+
+    /** Applies the fast approximation of exp(x) to every channel of an AudioBlock,
+        in place.
+
+        For float and double blocks, the samples are processed using SIMDRegister
+        operations when JUCE_USE_SIMD is enabled.
+    */
+    template <typename FloatType>
+    static void exp (AudioBlock<FloatType> block) noexcept
+    {
+        applyToBlock (Exp(), block);
     }
 
     /** Provides a fast approximation of the function log(x+1) using a Pade approximant
@@ -240,8 +335,10 @@ struct FastMathApproximations
     template <typename FloatType>
     static FloatType logNPlusOne (FloatType x) noexcept
     {
-        auto numerator = x * (7560 + x * (15120 + x * (9870 + x * (2310 + x * 137))));
-        auto denominator = 7560 + x * (18900 + x * (16800 + x * (6300 + x * (900 + 30 * x))));
+        using NumericType = typename SampleTypeHelpers::ElementType<FloatType>::Type;
+
+        auto numerator = x * (x * (x * (x * (x * NumericType (137) + NumericType (2310)) + NumericType (9870)) + NumericType (15120)) + NumericType (7560));
+        auto denominator = x * (x * (x * (x * (x * NumericType (30) + NumericType (900)) + NumericType (6300)) + NumericType (16800)) + NumericType (18900)) + NumericType (7560);
         return numerator / denominator;
     }
 
@@ -253,9 +350,148 @@ struct FastMathApproximations
     */
     template <typename FloatType>
     static void logNPlusOne (FloatType* values, size_t numValues) noexcept
+    {
+        applyToBuffer (LogNPlusOne(), values, numValues);
+    }
+
+    /** Applies the fast approximation of log(x+1) to every channel of an AudioBlock,
+        in place.
+
+        For float and double blocks, the samples are processed using SIMDRegister
+        operations when JUCE_USE_SIMD is enabled.
+    */
+    template <typename FloatType>
+    static void logNPlusOne (AudioBlock<FloatType> block) noexcept
+    {
+        applyToBlock (LogNPlusOne(), block);
+    }
+
+    //==============================================================================
+    /** Function objects wrapping each of the approximations, which can be used as the
+        function of a WaveShaper.
+
+        As well as single values (including SIMDRegisters), these can be called with a
+        whole buffer, so a WaveShaper using one of them will process its blocks with
+        the vectorised versions of the functions, e.g.
+        @code
+        WaveShaper<float, FastMathApproximations::Tanh> saturator;
+        @endcode
+    */
+    struct Cosh
+    {
+        template <typename Type>
+        Type operator() (Type x) const noexcept                                  { return FastMathApproximations::cosh (x); }
+
+        template <typename Type>
+        void operator() (Type* values, size_t numValues) const noexcept          { FastMathApproximations::cosh (values, numValues); }
+    };
+
+    struct Sinh
+    {
+        template <typename Type>
+        Type operator() (Type x) const noexcept                                  { return FastMathApproximations::sinh (x); }
+
+        template <typename Type>
+        void operator() (Type* values, size_t numValues) const noexcept          { FastMathApproximations::sinh (values, numValues); }
+    };
+
+    struct Tanh
+    {
+        template <typename Type>
+        Type operator() (Type x) const noexcept                                  { return FastMathApproximations::tanh (x); }
+
+        template <typename Type>
+        void operator() (Type* values, size_t numValues) const noexcept          { FastMathApproximations::tanh (values, numValues); }
+    };
+
+    struct Cos
+    {
+        template <typename Type>
+        Type operator() (Type x) const noexcept                                  { return FastMathApproximations::cos (x); }
+
+        template <typename Type>
+        void operator() (Type* values, size_t numValues) const noexcept          { FastMathApproximations::cos (values, numValues); }
+    };
+
+    struct Sin
+    {
+        template <typename Type>
+        Type operator() (Type x) const noexcept                                  { return FastMathApproximations::sin (x); }
+
+        template <typename Type>
+        void operator() (Type* values, size_t numValues) const noexcept          { FastMathApproximations::sin (values, numValues); }
+    };
+
+    struct Tan
+    {
+        template <typename Type>
+        Type operator() (Type x) const noexcept                                  { return FastMathApproximations::tan (x); }
+
+        template <typename Type>
+        void operator() (Type* values, size_t numValues) const noexcept          { FastMathApproximations::tan (values, numValues); }
+    };
+
+    struct Exp
+    {
+        template <typename Type>
+        Type operator() (Type x) const noexcept                                  { return FastMathApproximations::exp (x); }
+
+        template <typename Type>
+        void operator() (Type* values, size_t numValues) const noexcept          { FastMathApproximations::exp (values, numValues); }
+    };
+
+    struct LogNPlusOne
+    {
+        template <typename Type>
+        Type operator() (Type x) const noexcept                                  { return FastMathApproximations::logNPlusOne (x); }
+
+        template <typename Type>
+        void operator() (Type* values, size_t numValues) const noexcept          { FastMathApproximations::logNPlusOne (values, numValues); }
+    };
+
+private:
+    //==============================================================================
+    template <typename Function, typename FloatType>
+    static void applyToBuffer (Function function, FloatType* values, size_t numValues) noexcept
     {
         for (size_t i = 0; i < numValues; ++i)
-            values[i] = FastMathApproximations::logNPlusOne (values[i]);
+            values[i] = function (values[i]);
+    }
+
+   #if JUCE_USE_SIMD
+    template <typename Function>
+    static void applyToBuffer (Function function, float* values, size_t numValues) noexcept    { applyVectorised (function, values, numValues); }
+
+    template <typename Function>
+    static void applyToBuffer (Function function, double* values, size_t numValues) noexcept   { applyVectorised (function, values, numValues); }
+
+    template <typename Function, typename FloatType>
+    static void applyVectorised (Function function, FloatType* values, size_t numValues) noexcept
+    {
+        using Vector = SIMDRegister<FloatType>;
+
+        auto* end = values + numValues;
+        auto* alignedStart = jmin (Vector::getNextSIMDAlignedPtr (values), end);
+
+        for (; values < alignedStart; ++values)
+            *values = function (*values);
+
+        auto numVectors = static_cast<size_t> (end - values) / Vector::size();
+        auto* vectors = reinterpret_cast<Vector*> (values);
+
+        for (size_t i = 0; i < numVectors; ++i)
+            vectors[i] = function (vectors[i]);
+
+        for (values += numVectors * Vector::size(); values < end; ++values)
+            *values = function (*values);
+    }
+   #endif
+
+    template <typename Function, typename FloatType>
+    static void applyToBlock (Function function, AudioBlock<FloatType>& block) noexcept
+    {
+        for (size_t ch = 0; ch < block.getNumChannels(); ++ch)
+            applyToBuffer (function, block.getChannelPointer (ch), block.getNumSamples());
     }
 };
 
@@ -0,0 +1,186 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 5 End-User License
+   Agreement and JUCE 5 Privacy Policy (both updated and effective as of the
+   27th April 2017).
+
+   End User License Agreement: www.juce.com/juce-5-licence
+   Privacy Policy: www.juce.com/juce-5-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+struct FastMathApproximationsUnitTest  : public UnitTest
+{
+    FastMathApproximationsUnitTest()  : UnitTest ("FastMathApproximations") {}
+
+    template <typename FloatType>
+    struct Function
+    {
+        const char* name;
+        void (*fastBuffer) (FloatType*, size_t);
+        FloatType (*fastScalar) (FloatType);
+        FloatType (*reference) (FloatType);
+        FloatType start, end, maxError;
+    };
+
+    template <typename FloatType>
+    static std::vector<Function<FloatType>> getFunctions()
+    {
+        using FMA = FastMathApproximations;
+
+        return { { "cosh",        FMA::cosh,        FMA::cosh,        [] (FloatType x) { return std::cosh (x); },  -5,    5,    (FloatType) 0.005 },
+                 { "sinh",        FMA::sinh,        FMA::sinh,        [] (FloatType x) { return std::sinh (x); },  -5,    5,    (FloatType) 0.001 },
+                 { "tanh",        FMA::tanh,        FMA::tanh,        [] (FloatType x) { return std::tanh (x); },  -5,    5,    (FloatType) 0.001 },
+                 { "cos",         FMA::cos,         FMA::cos,         [] (FloatType x) { return std::cos (x); },   -3.1f, 3.1f, (FloatType) 0.002 },
+                 { "sin",         FMA::sin,         FMA::sin,         [] (FloatType x) { return std::sin (x); },   -3.1f, 3.1f, (FloatType) 0.002 },
+                 { "tan",         FMA::tan,         FMA::tan,         [] (FloatType x) { return std::tan (x); },   -1.5f, 1.5f, (FloatType) 0.002 },
+                 { "exp",         FMA::exp,         FMA::exp,         [] (FloatType x) { return std::exp (x); },   -6,    4,    (FloatType) 0.02 },
+                 { "logNPlusOne", FMA::logNPlusOne, FMA::logNPlusOne, [] (FloatType x) { return std::log1p (x); }, -0.8f, 5,    (FloatType) 0.001 } };
+    }
+
+    template <typename FloatType>
+    static void fillRamp (FloatType* data, size_t num, FloatType start, FloatType end)
+    {
+        for (size_t i = 0; i < num; ++i)
+            data[i] = start + (end - start) * (FloatType) i / (FloatType) (num - 1);
+    }
+
+    // the absolute error for values of magnitude below 1, and the relative error above
+    template <typename FloatType>
+    static FloatType getRelativeError (FloatType value, FloatType reference)
+    {
+        return std::abs (value - reference) / jmax ((FloatType) 1, std::abs (reference));
+    }
+
+    //==============================================================================
+    template <typename FloatType>
+    void runAccuracyTest()
+    {
+        // an odd length and offset, so that the unaligned head and scalar tail are exercised too
+        constexpr size_t numSamples = 1001;
+        HeapBlock<FloatType> buffer (numSamples + 1);
+        auto* data = buffer.get() + 1;
+
+        for (auto& f : getFunctions<FloatType>())
+        {
+            fillRamp (data, numSamples, f.start, f.end);
+            f.fastBuffer (data, numSamples);
+
+            FloatType maxError = 0, maxDifference = 0;
+
+            for (size_t i = 0; i < numSamples; ++i)
+            {
+                auto x = f.start + (f.end - f.start) * (FloatType) i / (FloatType) (numSamples - 1);
+                maxDifference = jmax (maxDifference, std::abs (data[i] - f.fastScalar (x)));
+                maxError      = jmax (maxError,      getRelativeError (data[i], f.reference (x)));
+            }
+
+            expect (maxDifference <= std::abs (f.fastScalar (f.end)) * (FloatType) 1e-5, String (f.name) + ": buffer and scalar versions differ");
+            expect (maxError < f.maxError, String (f.name) + ": error too large " + String (maxError));
+        }
+    }
+
+    template <typename FloatType>
+    void runWaveShaperTest()
+    {
+        constexpr size_t numChannels = 2, numSamples = 257;
+        HeapBlock<char> inData, outData;
+        AudioBlock<FloatType> input (inData, numChannels, numSamples), output (outData, numChannels, numSamples);
+
+        for (size_t ch = 0; ch < numChannels; ++ch)
+            fillRamp (input.getChannelPointer (ch), numSamples, (FloatType) -4, (FloatType) 4);
+
+        WaveShaper<FloatType, FastMathApproximations::Tanh> fastShaper;
+        fastShaper.process (ProcessContextNonReplacing<FloatType> (input, output));
+
+        WaveShaper<FloatType> scalarShaper { FastMathApproximations::tanh };
+        scalarShaper.process (ProcessContextReplacing<FloatType> (input));
+
+        for (size_t ch = 0; ch < numChannels; ++ch)
+            for (size_t i = 0; i < numSamples; ++i)
+                expect (std::abs (output.getChannelPointer (ch)[i] - input.getChannelPointer (ch)[i]) < (FloatType) 1e-6);
+    }
+
+    //==============================================================================
+    template <typename FloatType>
+    void runBenchmark()
+    {
+        constexpr size_t numSamples = 4096;
+        constexpr int numRepeats = 200;
+        HeapBlock<FloatType> data (numSamples);
+
+        auto timeIt = [&] (const Function<FloatType>& f, std::function<void()> fn)
+        {
+            fillRamp (data.get(), numSamples, f.start, f.end);
+            auto start = Time::getHighResolutionTicks();
+
+            for (int i = 0; i < numRepeats; ++i)
+                fn();
+
+            auto seconds = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start);
+            return (double) (numSamples * numRepeats) / (seconds * 1.0e6);
+        };
+
+        for (auto& f : getFunctions<FloatType>())
+        {
+            auto* d = data.get();
+
+            auto reference = timeIt (f, [&] { for (size_t i = 0; i < numSamples; ++i) d[i] = f.reference (d[i]); });
+            auto scalar    = timeIt (f, [&] { for (size_t i = 0; i < numSamples; ++i) d[i] = f.fastScalar (d[i]); });
+            auto buffer    = timeIt (f, [&] { f.fastBuffer (d, numSamples); });
+
+            FloatType maxError = 0;
+            fillRamp (d, numSamples, f.start, f.end);
+            f.fastBuffer (d, numSamples);
+
+            for (size_t i = 0; i < numSamples; ++i)
+                maxError = jmax (maxError, getRelativeError (d[i], f.reference (f.start + (f.end - f.start) * (FloatType) i / (FloatType) (numSamples - 1))));
+
+            logMessage (String (f.name).paddedRight (' ', 12)
+                          + "std " + String (reference, 1) + " Ms/s, scalar " + String (scalar, 1)
+                          + " Ms/s, buffer " + String (buffer, 1) + " Ms/s, max relative error " + String (maxError));
+        }
+    }
+
+    void runTest() override
+    {
+        beginTest ("Accuracy");
+        runAccuracyTest<float>();
+        runAccuracyTest<double>();
+
+        beginTest ("WaveShaper fast path");
+        runWaveShaperTest<float>();
+        runWaveShaperTest<double>();
+
+        beginTest ("Speed");
+        logMessage ("float:");
+        runBenchmark<float>();
+        logMessage ("double:");
+        runBenchmark<double>();
+    }
+};
+
+static FastMathApproximationsUnitTest fastMathApproximationsUnitTest;
+
+} // namespace dsp
+} // namespace juce
@@ -0,0 +1,115 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 5 End-User License
+   Agreement and JUCE 5 Privacy Policy (both updated and effective as of the
+   27th April 2017).
+
+   End User License Agreement: www.juce.com/juce-5-licence
+   Privacy Policy: www.juce.com/juce-5-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+BandLimitedWavetable::BandLimitedWavetable (const std::function<Complex<float> (int)>& getHarmonicAmplitudes)
+    : data (static_cast<size_t> (numTables * (tableSize + 1)))
+{
+    constexpr int maxHarmonics = tableSize / 2;
+
+    HeapBlock<Complex<float>> amplitudes (maxHarmonics + 1), spectrum (tableSize), result (tableSize);
+
+    for (int harmonic = 1; harmonic <= maxHarmonics; ++harmonic)
+        amplitudes[harmonic] = getHarmonicAmplitudes (harmonic);
+
+    FFT fft (roundToInt (std::log2 (static_cast<double> (tableSize))));
+    auto scale = static_cast<float> (tableSize) * 0.5f;
+
+    for (int index = 0; index < numTables; ++index)
+    {
+        auto numHarmonics = maxHarmonics >> index;
+
+        zeromem (spectrum.get(), sizeof (Complex<float>) * tableSize);
+
+        // a.cos (wt) + b.sin (wt) has its complex amplitude (a - ib) / 2 split
+        // between the positive and the negative frequencies
+        for (int harmonic = 1; harmonic <= numHarmonics && harmonic < maxHarmonics; ++harmonic)
+        {
+            auto a = amplitudes[harmonic];
+            spectrum[harmonic] = Complex<float> (a.real(), -a.imag()) * scale;
+            spectrum[tableSize - harmonic] = std::conj (spectrum[harmonic]);
+        }
+
+        fft.perform (spectrum, result, true);
+
+        auto* table = data.get() + index * (tableSize + 1);
+
+        for (int i = 0; i < tableSize; ++i)
+            table[i] = result[i].real();
+
+        table[tableSize] = table[0];
+    }
+}
+
+BandLimitedWavetable::~BandLimitedWavetable() {}
+
+BandLimitedWavetable::Ptr BandLimitedWavetable::getShared (Waveform waveform)
+{
+    jassert (waveform >= 0 && waveform < numWaveforms);
+
+    static CriticalSection lock;
+    static Ptr sharedTables[numWaveforms];
+
+    const ScopedLock sl (lock);
+    auto& tables = sharedTables[waveform];
+
+    if (tables == nullptr)
+    {
+        // The Fourier series of the naive waveforms generated by BandLimitedOscillator,
+        // so that both algorithms produce the same signal
+        std::function<Complex<float> (int)> series;
+
+        switch (waveform)
+        {
+            case saw:
+                series = [] (int n) { return Complex<float> (0.0f, static_cast<float> (-2.0 / (double_Pi * n))); };
+                break;
+
+            case square:
+                series = [] (int n) { return Complex<float> (0.0f, (n & 1) != 0 ? static_cast<float> (4.0 / (double_Pi * n)) : 0.0f); };
+                break;
+
+            case triangle:
+                series = [] (int n) { return Complex<float> ((n & 1) != 0 ? static_cast<float> (-8.0 / (double_Pi * double_Pi * n * n)) : 0.0f, 0.0f); };
+                break;
+
+            default:
+                series = [] (int n) { return Complex<float> (0.0f, n == 1 ? 1.0f : 0.0f); };
+                break;
+        }
+
+        tables = new BandLimitedWavetable (series);
+    }
+
+    return tables;
+}
+
+} // namespace dsp
+} // namespace juce
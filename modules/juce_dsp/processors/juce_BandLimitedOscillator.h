@@ -0,0 +1,576 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 5 End-User License
+   Agreement and JUCE 5 Privacy Policy (both updated and effective as of the
+   27th April 2017).
+
+   End User License Agreement: www.juce.com/juce-5-licence
+   Privacy Policy: www.juce.com/juce-5-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+/**
+    A set of mip-mapped single-cycle wavetables, each one containing only the
+    harmonics which can be played without aliasing in a given range of
+    frequencies.
+
+    There is one table per octave: the first one contains every harmonic up to half
+    the table size, and each following table contains half as many harmonics as the
+    previous one. The tables of the built-in waveforms are shared by every
+    oscillator which uses them.
+
+    @see BandLimitedOscillator
+*/
+class JUCE_API  BandLimitedWavetable  : public ReferenceCountedObject
+{
+public:
+    //==============================================================================
+    /** The built-in waveforms. */
+    enum Waveform
+    {
+        sine = 0,
+        saw,
+        square,
+        triangle,
+        numWaveforms
+    };
+
+    /** The number of samples in each table, without the guard point. */
+    static constexpr int tableSize = 2048;
+
+    /** The number of tables, one per octave. */
+    static constexpr int numTables = 11;
+
+    //==============================================================================
+    /** Creates a set of tables from a harmonic spectrum.
+
+        The function will be called for each harmonic number from 1 to tableSize / 2,
+        and must return the amplitudes of the cosine (real part) and sine (imaginary
+        part) components of that harmonic.
+    */
+    BandLimitedWavetable (const std::function<Complex<float> (int harmonic)>& getHarmonicAmplitudes);
+
+    /** Destructor. */
+    ~BandLimitedWavetable();
+
+    /** The BandLimitedWavetable is ref-counted, so this is a handy type that can be
+        used as a pointer to one.
+    */
+    using Ptr = ReferenceCountedObjectPtr<BandLimitedWavetable>;
+
+    /** Returns the shared tables of one of the built-in waveforms.
+
+        The tables are created the first time that a waveform is requested, so you
+        should call this once before using a waveform on the audio thread.
+    */
+    static Ptr getShared (Waveform waveform);
+
+    //==============================================================================
+    /** Returns the index of the table which should be used for a phase increment
+        in cycles per sample.
+    */
+    static int getTableIndexForIncrement (double increment) noexcept
+    {
+        // The table with index k has (tableSize / 2) >> k harmonics, which must all
+        // be below the Nyquist frequency.
+        int exponent;
+        std::frexp (increment * tableSize, &exponent);
+
+        return jlimit (0, numTables - 1, exponent);
+    }
+
+    /** Returns the value of a table for a phase between 0 and 1, using linear
+        interpolation.
+    */
+    template <typename FloatType>
+    FloatType getValue (int tableIndex, FloatType phase) const noexcept
+    {
+        jassert (isPositiveAndBelow (tableIndex, numTables));
+
+        auto* table = data.get() + tableIndex * (tableSize + 1);
+        auto position = phase * static_cast<FloatType> (tableSize);
+        auto index = jlimit (0, tableSize - 1, static_cast<int> (position));
+        auto fraction = position - static_cast<FloatType> (index);
+
+        auto a = static_cast<FloatType> (table[index]);
+        auto b = static_cast<FloatType> (table[index + 1]);
+
+        return a + fraction * (b - a);
+    }
+
+    /** Returns a raw pointer to one of the tables, which have tableSize + 1 samples. */
+    const float* getTable (int tableIndex) const noexcept    { return data.get() + tableIndex * (tableSize + 1); }
+
+private:
+    //==============================================================================
+    HeapBlock<float> data;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BandLimitedWavetable)
+};
+
+//==============================================================================
+/**
+    An oscillator generating band-limited classic waveforms, either with PolyBLEP
+    (polynomial band-limited step) corrections or with mip-mapped wavetables.
+
+    Unlike Oscillator, the waveform isn't supplied as a std::function, so all the
+    processing is inlined, and the PolyBLEP waveforms are computed over a whole block
+    with SIMDRegister when it is available. The frequency can be modulated per
+    sample by passing a block of multipliers to process().
+
+    The SampleType must be float or double. To run many voices, use one oscillator
+    per voice: the wavetables are shared between them.
+
+    @see Oscillator, BandLimitedWavetable
+*/
+template <typename SampleType>
+class BandLimitedOscillator
+{
+public:
+    static_assert (std::is_floating_point<SampleType>::value,
+                   "BandLimitedOscillator only works with float or double samples");
+
+    using Waveform = BandLimitedWavetable::Waveform;
+
+    /** The algorithm used to remove the aliasing. */
+    enum Algorithm
+    {
+        polyBLEP = 0,
+        wavetable
+    };
+
+    //==============================================================================
+    /** Creates an oscillator. This may allocate the shared wavetables of the waveform. */
+    BandLimitedOscillator (Waveform waveformToUse = BandLimitedWavetable::saw,
+                           Algorithm algorithmToUse = polyBLEP)
+    {
+        setAlgorithm (algorithmToUse);
+        setWaveform (waveformToUse);
+    }
+
+    //==============================================================================
+    /** Changes the waveform. In wavetable mode, the shared tables of the waveform
+        will be created if they haven't been already.
+    */
+    void setWaveform (Waveform newWaveform)
+    {
+        jassert (newWaveform >= 0 && newWaveform < BandLimitedWavetable::numWaveforms);
+
+        waveform = newWaveform;
+        customTables = false;
+
+        if (algorithm == wavetable)
+            tables = BandLimitedWavetable::getShared (waveform);
+    }
+
+    /** Returns the current waveform. */
+    Waveform getWaveform() const noexcept                        { return waveform; }
+
+    /** Uses a custom set of wavetables, and switches to the wavetable algorithm. */
+    void setWavetable (BandLimitedWavetable* newTables)
+    {
+        jassert (newTables != nullptr);
+
+        tables = newTables;
+        customTables = true;
+        algorithm = wavetable;
+    }
+
+    /** Changes the algorithm used to remove the aliasing. */
+    void setAlgorithm (Algorithm newAlgorithm)
+    {
+        algorithm = newAlgorithm;
+
+        if (algorithm == wavetable && ! customTables)
+            tables = BandLimitedWavetable::getShared (waveform);
+    }
+
+    /** Returns the current algorithm. */
+    Algorithm getAlgorithm() const noexcept                      { return algorithm; }
+
+    //==============================================================================
+    /** Sets the frequency of the oscillator in Hz. */
+    void setFrequency (SampleType newFrequency) noexcept         { frequency.setValue (newFrequency); }
+
+    /** Returns the current frequency of the oscillator. */
+    SampleType getFrequency() const noexcept                     { return frequency.getTargetValue(); }
+
+    /** Sets the phase of the oscillator, between 0 and 1. */
+    void setPhase (SampleType newPhase) noexcept                 { phase = newPhase - std::floor (newPhase); }
+
+    //==============================================================================
+    /** Called before processing starts. */
+    void prepare (const ProcessSpec& spec)
+    {
+        sampleRate = static_cast<SampleType> (spec.sampleRate);
+        maximumBlockSize = static_cast<size_t> (spec.maximumBlockSize);
+
+        // three aligned buffers: phases, phase increments and their inverses
+        auto alignment = static_cast<size_t> (16);
+       #if JUCE_USE_SIMD
+        alignment = SIMDRegister<SampleType>::SIMDRegisterSize / sizeof (SampleType);
+       #endif
+
+        auto paddedSize = ((maximumBlockSize + alignment - 1) / alignment + 1) * alignment;
+        memory.malloc (paddedSize * 4 + alignment);
+
+        auto* start = memory.get();
+       #if JUCE_USE_SIMD
+        start = SIMDRegister<SampleType>::getNextSIMDAlignedPtr (start);
+       #endif
+
+        phases            = start;
+        increments        = start + paddedSize;
+        inverseIncrements = start + paddedSize * 2;
+        outputs           = start + paddedSize * 3;
+
+        reset();
+    }
+
+    /** Resets the internal state of the oscillator. */
+    void reset() noexcept
+    {
+        phase = 0;
+
+        if (sampleRate > 0)
+            frequency.reset (sampleRate, 0.05);
+    }
+
+    //==============================================================================
+    /** Returns the result of processing a single sample. */
+    SampleType JUCE_VECTOR_CALLTYPE processSample (SampleType) noexcept
+    {
+        auto increment = getIncrement (frequency.getNextValue());
+        auto inverseIncrement = increment > 0 ? 1 / increment : SampleType();
+        auto t = phase;
+
+        advancePhase (increment);
+
+        if (algorithm == wavetable)
+            return tables->getValue (BandLimitedWavetable::getTableIndexForIncrement (increment), t);
+
+        switch (waveform)
+        {
+            case BandLimitedWavetable::saw:       return getPolyBLEPSample<BandLimitedWavetable::saw>      (t, increment, inverseIncrement);
+            case BandLimitedWavetable::square:    return getPolyBLEPSample<BandLimitedWavetable::square>   (t, increment, inverseIncrement);
+            case BandLimitedWavetable::triangle:  return getPolyBLEPSample<BandLimitedWavetable::triangle> (t, increment, inverseIncrement);
+            default:                              return getPolyBLEPSample<BandLimitedWavetable::sine>     (t, increment, inverseIncrement);
+        }
+    }
+
+    /** Processes the input and output buffers supplied in the processing context. */
+    template <typename ProcessContext>
+    void process (const ProcessContext& context) noexcept
+    {
+        process (context, nullptr);
+    }
+
+    /** Processes the input and output buffers supplied in the processing context,
+        with a per-sample frequency modulation.
+
+        The frequencyModulation array must contain one multiplier of the frequency
+        for each sample of the block, or be a nullptr.
+    */
+    template <typename ProcessContext>
+    void process (const ProcessContext& context, const SampleType* frequencyModulation) noexcept
+    {
+        auto&& outBlock = context.getOutputBlock();
+
+        // this is an output-only processor
+        jassert (context.getInputBlock().getNumChannels() == 0 || (! context.usesSeparateInputAndOutputBlocks()));
+        jassert (outBlock.getNumSamples() <= maximumBlockSize);
+
+        auto len = outBlock.getNumSamples();
+        auto numChannels = outBlock.getNumChannels();
+
+        if (len == 0 || numChannels == 0)
+            return;
+
+        fillPhases (len, frequencyModulation);
+
+        if (algorithm == wavetable)
+        {
+            generateWavetable (len);
+        }
+        else
+        {
+            switch (waveform)
+            {
+                case BandLimitedWavetable::saw:       generatePolyBLEP<BandLimitedWavetable::saw>      (len); break;
+                case BandLimitedWavetable::square:    generatePolyBLEP<BandLimitedWavetable::square>   (len); break;
+                case BandLimitedWavetable::triangle:  generatePolyBLEP<BandLimitedWavetable::triangle> (len); break;
+                default:                              generatePolyBLEP<BandLimitedWavetable::sine>     (len); break;
+            }
+        }
+
+        for (size_t ch = 0; ch < numChannels; ++ch)
+            FloatVectorOperations::copy (outBlock.getChannelPointer (ch), outputs, static_cast<int> (len));
+    }
+
+private:
+    //==============================================================================
+    SampleType getIncrement (SampleType freq) const noexcept
+    {
+        return jlimit (SampleType(), static_cast<SampleType> (0.5), freq / sampleRate);
+    }
+
+    void advancePhase (SampleType increment) noexcept
+    {
+        phase += increment;
+
+        if (phase >= 1)
+            phase -= 1;
+    }
+
+    void fillPhases (size_t len, const SampleType* frequencyModulation) noexcept
+    {
+        if (frequencyModulation == nullptr && ! frequency.isSmoothing())
+        {
+            auto increment = getIncrement (frequency.getNextValue());
+            auto inverseIncrement = increment > 0 ? 1 / increment : SampleType();
+
+            for (size_t i = 0; i < len; ++i)
+            {
+                phases[i] = phase;
+                increments[i] = increment;
+                inverseIncrements[i] = inverseIncrement;
+                advancePhase (increment);
+            }
+
+            return;
+        }
+
+        for (size_t i = 0; i < len; ++i)
+        {
+            auto freq = frequency.getNextValue();
+
+            if (frequencyModulation != nullptr)
+                freq *= frequencyModulation[i];
+
+            auto increment = getIncrement (freq);
+
+            phases[i] = phase;
+            increments[i] = increment;
+            inverseIncrements[i] = increment > 0 ? 1 / increment : SampleType();
+            advancePhase (increment);
+        }
+    }
+
+    void generateWavetable (size_t len) noexcept
+    {
+        auto& table = *tables;
+        auto lastIncrement = increments[0];
+        auto tableIndex = BandLimitedWavetable::getTableIndexForIncrement (lastIncrement);
+
+        for (size_t i = 0; i < len; ++i)
+        {
+            if (increments[i] != lastIncrement)
+            {
+                lastIncrement = increments[i];
+                tableIndex = BandLimitedWavetable::getTableIndexForIncrement (lastIncrement);
+            }
+
+            outputs[i] = table.getValue (tableIndex, phases[i]);
+        }
+    }
+
+    template <Waveform shape>
+    void generatePolyBLEP (size_t len) noexcept
+    {
+        size_t i = 0;
+
+       #if JUCE_USE_SIMD
+        if (shape != BandLimitedWavetable::sine)
+        {
+            constexpr auto vectorSize = Vector::SIMDNumElements;
+
+            auto* t      = reinterpret_cast<const Vector*> (phases);
+            auto* dt     = reinterpret_cast<const Vector*> (increments);
+            auto* invDt  = reinterpret_cast<const Vector*> (inverseIncrements);
+            auto* output = reinterpret_cast<Vector*> (outputs);
+
+            for (size_t v = 0; v < len / vectorSize; ++v)
+                output[v] = getPolyBLEPSample<shape> (t[v], dt[v], invDt[v]);
+
+            i = (len / vectorSize) * vectorSize;
+        }
+       #endif
+
+        for (; i < len; ++i)
+            outputs[i] = getPolyBLEPSample<shape> (phases[i], increments[i], inverseIncrements[i]);
+    }
+
+    //==============================================================================
+    /* The residuals of a band-limited step and of a band-limited ramp, for the
+       discontinuities located at the phase 0, approximated with 2-point polynomials.
+       The SIMDRegister versions below compute both polynomials and select them with
+       comparison masks, as they can't branch per element.
+    */
+    template <typename Type>
+    static Type wrapPhase (Type t) noexcept
+    {
+        return t >= 1 ? t - 1 : t;
+    }
+
+    template <typename Type>
+    static Type getBLEPResidual (Type t, Type dt, Type invDt) noexcept
+    {
+        if (t < dt)
+        {
+            auto x = t * invDt;
+            return x + x - x * x - 1;
+        }
+
+        if (t > 1 - dt)
+        {
+            auto x = (t - 1) * invDt;
+            return x * x + x + x + 1;
+        }
+
+        return 0;
+    }
+
+    template <typename Type>
+    static Type getBLAMPResidual (Type t, Type dt, Type invDt) noexcept
+    {
+        if (t < dt)
+        {
+            auto x = 1 - t * invDt;
+            return x * x * x * static_cast<Type> (1.0 / 3.0);
+        }
+
+        if (t > 1 - dt)
+        {
+            auto x = 1 + (t - 1) * invDt;
+            return x * x * x * static_cast<Type> (1.0 / 3.0);
+        }
+
+        return 0;
+    }
+
+    template <Waveform shape>
+    static SampleType getPolyBLEPSample (SampleType t, SampleType dt, SampleType invDt) noexcept
+    {
+        switch (shape)
+        {
+            case BandLimitedWavetable::saw:
+                return 2 * t - 1 - getBLEPResidual (t, dt, invDt);
+
+            case BandLimitedWavetable::square:
+                return (t < static_cast<SampleType> (0.5) ? 1 : -1)
+                         + getBLEPResidual (t, dt, invDt)
+                         - getBLEPResidual (wrapPhase (t + static_cast<SampleType> (0.5)), dt, invDt);
+
+            case BandLimitedWavetable::triangle:
+                return 1 - 4 * std::abs (t - static_cast<SampleType> (0.5))
+                         + 4 * dt * (getBLAMPResidual (t, dt, invDt)
+                                       - getBLAMPResidual (wrapPhase (t + static_cast<SampleType> (0.5)), dt, invDt));
+
+            default:
+                return std::sin (static_cast<SampleType> (2.0 * double_Pi) * t);
+        }
+    }
+
+   #if JUCE_USE_SIMD
+    using Vector = SIMDRegister<SampleType>;
+
+    static Vector JUCE_VECTOR_CALLTYPE wrapPhase (Vector t) noexcept
+    {
+        auto one = Vector::expand (1);
+        return t - (one & Vector::greaterThanOrEqual (t, one));
+    }
+
+    static Vector JUCE_VECTOR_CALLTYPE getBLEPResidual (Vector t, Vector dt, Vector invDt) noexcept
+    {
+        auto one = Vector::expand (1);
+
+        auto x = t * invDt;
+        auto y = (t - one) * invDt;
+
+        return ((x + x - x * x - one) & Vector::lessThan (t, dt))
+             + ((y * y + y + y + one) & Vector::greaterThan (t, one - dt));
+    }
+
+    static Vector JUCE_VECTOR_CALLTYPE getBLAMPResidual (Vector t, Vector dt, Vector invDt) noexcept
+    {
+        auto one = Vector::expand (1);
+
+        auto x = one - t * invDt;
+        auto y = one + (t - one) * invDt;
+
+        return (((x * x * x) & Vector::lessThan (t, dt))
+              + ((y * y * y) & Vector::greaterThan (t, one - dt))) * static_cast<SampleType> (1.0 / 3.0);
+    }
+
+    template <Waveform shape>
+    static Vector JUCE_VECTOR_CALLTYPE getPolyBLEPSample (Vector t, Vector dt, Vector invDt) noexcept
+    {
+        auto one  = Vector::expand (1);
+        auto half = Vector::expand (static_cast<SampleType> (0.5));
+
+        switch (shape)
+        {
+            case BandLimitedWavetable::saw:
+                return t + t - one - getBLEPResidual (t, dt, invDt);
+
+            case BandLimitedWavetable::square:
+                return (Vector::expand (2) & Vector::lessThan (t, half)) - one
+                         + getBLEPResidual (t, dt, invDt)
+                         - getBLEPResidual (wrapPhase (t + half), dt, invDt);
+
+            case BandLimitedWavetable::triangle:
+            {
+                auto distance = t - half;
+                auto absDistance = Vector::max (distance, Vector::expand (0) - distance);
+
+                return one - absDistance * static_cast<SampleType> (4)
+                         + dt * static_cast<SampleType> (4) * (getBLAMPResidual (t, dt, invDt)
+                                                                 - getBLAMPResidual (wrapPhase (t + half), dt, invDt));
+            }
+
+            default:
+                jassertfalse; // sine waves are computed with the scalar code
+                return Vector::expand (0);
+        }
+    }
+   #endif
+
+    //==============================================================================
+    BandLimitedWavetable::Ptr tables;
+    Waveform waveform = BandLimitedWavetable::saw;
+    Algorithm algorithm = polyBLEP;
+    bool customTables = false;
+
+    LinearSmoothedValue<SampleType> frequency { static_cast<SampleType> (440.0) };
+    SampleType sampleRate = 48000.0, phase = 0.0;
+
+    HeapBlock<SampleType> memory;
+    SampleType* phases = nullptr;
+    SampleType* increments = nullptr;
+    SampleType* inverseIncrements = nullptr;
+    SampleType* outputs = nullptr;
+    size_t maximumBlockSize = 0;
+};
+
+} // namespace dsp
+} // namespace juce
@@ -0,0 +1,334 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 5 End-User License
+   Agreement and JUCE 5 Privacy Policy (both updated and effective as of the
+   27th April 2017).
+
+   End User License Agreement: www.juce.com/juce-5-licence
+   Privacy Policy: www.juce.com/juce-5-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+struct BandLimitedOscillatorUnitTest  : public UnitTest
+{
+    BandLimitedOscillatorUnitTest()  : UnitTest ("BandLimitedOscillator") {}
+
+    static constexpr double sampleRate = 48000.0;
+    static constexpr size_t blockSize = 256;
+
+    using Wavetable = BandLimitedWavetable;
+
+    static const char* getWaveformName (Wavetable::Waveform waveform)
+    {
+        static const char* const names[] = { "sine", "saw", "square", "triangle" };
+        return names[waveform];
+    }
+
+    // The aliased waveforms which the oscillator is supposed to match, apart from the aliasing
+    template <typename SampleType>
+    static SampleType getNaiveSample (Wavetable::Waveform waveform, SampleType t)
+    {
+        switch (waveform)
+        {
+            case Wavetable::saw:       return 2 * t - 1;
+            case Wavetable::square:    return t < static_cast<SampleType> (0.5) ? 1 : -1;
+            case Wavetable::triangle:  return 1 - 4 * std::abs (t - static_cast<SampleType> (0.5));
+            default:                   return std::sin (static_cast<SampleType> (2.0 * double_Pi) * t);
+        }
+    }
+
+    template <typename SampleType>
+    static void processBlock (BandLimitedOscillator<SampleType>& oscillator, SampleType* data, size_t numSamples,
+                              const SampleType* frequencyModulation = nullptr)
+    {
+        AudioBlock<SampleType> block (&data, 1, numSamples);
+        oscillator.process (ProcessContextReplacing<SampleType> (block), frequencyModulation);
+    }
+
+    template <typename SampleType>
+    static HeapBlock<SampleType> generate (Wavetable::Waveform waveform,
+                                           typename BandLimitedOscillator<SampleType>::Algorithm algorithm,
+                                           SampleType frequency, size_t numSamples)
+    {
+        BandLimitedOscillator<SampleType> oscillator (waveform, algorithm);
+        oscillator.setFrequency (frequency);
+        oscillator.prepare ({ sampleRate, (uint32) blockSize, 1 });
+
+        HeapBlock<SampleType> data (numSamples);
+
+        for (size_t pos = 0; pos < numSamples; pos += blockSize)
+            processBlock (oscillator, data + pos, jmin (blockSize, numSamples - pos));
+
+        return data;
+    }
+
+    // Returns the complex amplitude of a signal at a given normalised frequency
+    template <typename SampleType>
+    static std::complex<double> analyse (const SampleType* data, size_t numSamples, double frequency)
+    {
+        std::complex<double> sum;
+
+        for (size_t i = 0; i < numSamples; ++i)
+            sum += std::polar (static_cast<double> (data[i]), -2.0 * double_Pi * frequency * (double) i);
+
+        return sum * (2.0 / (double) numSamples);
+    }
+
+    // Returns the power of everything which isn't a harmonic of the fundamental, relative to the
+    // total power, in dB. This needs a whole number of periods of the fundamental in the data.
+    template <typename SampleType>
+    static double getAliasingLevel (const SampleType* data, size_t numSamples, double frequency)
+    {
+        double total = 0, mean = 0;
+
+        for (size_t i = 0; i < numSamples; ++i)
+        {
+            total += static_cast<double> (data[i]) * static_cast<double> (data[i]);
+            mean += static_cast<double> (data[i]);
+        }
+
+        total /= (double) numSamples;
+        mean /= (double) numSamples;
+
+        auto remainder = total - mean * mean;
+
+        for (int harmonic = 1; harmonic * frequency < 0.5; ++harmonic)
+            remainder -= std::norm (analyse (data, numSamples, harmonic * frequency)) * 0.5;
+
+        return Decibels::gainToDecibels (std::sqrt (jmax (0.0, remainder) / total), -200.0);
+    }
+
+    //==============================================================================
+    template <typename SampleType>
+    void runBlockTest (SampleType tolerance)
+    {
+        Random random (0x4321);
+
+        for (int w = 0; w < Wavetable::numWaveforms; ++w)
+        {
+            for (auto algorithm : { BandLimitedOscillator<SampleType>::polyBLEP, BandLimitedOscillator<SampleType>::wavetable })
+            {
+                auto waveform = (Wavetable::Waveform) w;
+                BandLimitedOscillator<SampleType> blockOscillator (waveform, algorithm), sampleOscillator (waveform, algorithm);
+                const ProcessSpec spec { sampleRate, (uint32) blockSize, 1 };
+
+                blockOscillator.prepare (spec);
+                sampleOscillator.prepare (spec);
+
+                HeapBlock<SampleType> block (blockSize);
+                SampleType maxDifference = 0;
+
+                // the second half includes a frequency ramp
+                for (int pos = 0; pos < 8000;)
+                {
+                    if (pos >= 4000 && blockOscillator.getFrequency() != static_cast<SampleType> (1234.5))
+                    {
+                        blockOscillator.setFrequency (static_cast<SampleType> (1234.5));
+                        sampleOscillator.setFrequency (static_cast<SampleType> (1234.5));
+                    }
+
+                    auto num = (size_t) random.nextInt ((int) blockSize) + 1;
+                    processBlock (blockOscillator, block.get(), num);
+
+                    for (size_t i = 0; i < num; ++i)
+                        maxDifference = jmax (maxDifference, std::abs (block[i] - sampleOscillator.processSample (0)));
+
+                    pos += (int) num;
+                }
+
+                expectLessThan (maxDifference, tolerance, getWaveformName (waveform));
+            }
+        }
+    }
+
+    template <typename SampleType>
+    void runFrequencyModulationTest()
+    {
+        for (auto algorithm : { BandLimitedOscillator<SampleType>::polyBLEP, BandLimitedOscillator<SampleType>::wavetable })
+        {
+            BandLimitedOscillator<SampleType> modulated (Wavetable::saw, algorithm), reference (Wavetable::saw, algorithm);
+            modulated.setFrequency (440);
+            reference.setFrequency (880);
+            modulated.prepare ({ sampleRate, (uint32) blockSize, 1 });
+            reference.prepare ({ sampleRate, (uint32) blockSize, 1 });
+
+            HeapBlock<SampleType> modulation (blockSize), modulatedBlock (blockSize), referenceBlock (blockSize);
+
+            for (size_t i = 0; i < blockSize; ++i)
+                modulation[i] = 2;
+
+            for (int i = 0; i < 10; ++i)
+            {
+                processBlock (modulated, modulatedBlock.get(), blockSize, modulation.get());
+                processBlock (reference, referenceBlock.get(), blockSize);
+
+                expect (memcmp (modulatedBlock.get(), referenceBlock.get(), blockSize * sizeof (SampleType)) == 0);
+            }
+        }
+    }
+
+    void runAmplitudeTest()
+    {
+        // 200 Hz is a whole number of samples per period, so the averages are exact
+        constexpr size_t numSamples = 48000;
+        const double frequency = 200.0;
+        const double expectedRMS[] = { std::sqrt (0.5), std::sqrt (1.0 / 3.0), 1.0, std::sqrt (1.0 / 3.0) };
+
+        for (int w = 0; w < Wavetable::numWaveforms; ++w)
+        {
+            auto waveform = (Wavetable::Waveform) w;
+            auto polyBLEP  = generate<double> (waveform, BandLimitedOscillator<double>::polyBLEP,  frequency, numSamples);
+            auto wavetable = generate<double> (waveform, BandLimitedOscillator<double>::wavetable, frequency, numSamples);
+
+            for (auto* data : { polyBLEP.get(), wavetable.get() })
+            {
+                double sum = 0, sumOfSquares = 0;
+
+                for (size_t i = 0; i < numSamples; ++i)
+                {
+                    sum += data[i];
+                    sumOfSquares += data[i] * data[i];
+                }
+
+                expectWithinAbsoluteError (sum / (double) numSamples, 0.0, 1.0e-3, getWaveformName (waveform));
+                expectWithinAbsoluteError (std::sqrt (sumOfSquares / (double) numSamples), expectedRMS[w], expectedRMS[w] * 0.02, getWaveformName (waveform));
+            }
+
+            // both algorithms produce the fundamental of the continuous waveform, with the right phase
+            const std::complex<double> fundamentals[] = { { 0.0, -1.0 }, { 0.0, 2.0 / double_Pi },
+                                                          { 0.0, -4.0 / double_Pi }, { -8.0 / (double_Pi * double_Pi), 0.0 } };
+
+            for (auto* data : { polyBLEP.get(), wavetable.get() })
+                expect (std::abs (analyse (data, numSamples, frequency / sampleRate) - fundamentals[w]) < 0.001 * std::abs (fundamentals[w]),
+                        getWaveformName (waveform));
+        }
+    }
+
+    void runAliasingTest()
+    {
+        // 3001 Hz fits a whole number of periods into a second
+        constexpr size_t numSamples = 48000;
+        const double frequency = 3001.0;
+
+        for (int w = Wavetable::saw; w < Wavetable::numWaveforms; ++w)
+        {
+            auto waveform = (Wavetable::Waveform) w;
+            HeapBlock<double> naive (numSamples);
+
+            for (size_t i = 0; i < numSamples; ++i)
+                naive[i] = getNaiveSample (waveform, std::fmod ((double) i * frequency / sampleRate, 1.0));
+
+            auto naiveLevel     = getAliasingLevel (naive.get(), numSamples, frequency / sampleRate);
+            auto polyBLEPLevel  = getAliasingLevel (generate<double> (waveform, BandLimitedOscillator<double>::polyBLEP,  frequency, numSamples).get(),
+                                                    numSamples, frequency / sampleRate);
+            auto wavetableLevel = getAliasingLevel (generate<double> (waveform, BandLimitedOscillator<double>::wavetable, frequency, numSamples).get(),
+                                                    numSamples, frequency / sampleRate);
+
+            logMessage (String (getWaveformName (waveform)) + " aliasing at " + String (frequency) + " Hz: naive " + String (naiveLevel, 1)
+                          + " dB, PolyBLEP " + String (polyBLEPLevel, 1) + " dB, wavetable " + String (wavetableLevel, 1) + " dB");
+
+            expectLessThan (polyBLEPLevel,  naiveLevel - 10.0, getWaveformName (waveform));
+            expectLessThan (wavetableLevel, naiveLevel - 30.0, getWaveformName (waveform));
+        }
+    }
+
+    void runBenchmark()
+    {
+        constexpr int numVoices = 64, numBlocks = 94;
+        constexpr size_t size = 512;
+        const ProcessSpec spec { sampleRate, (uint32) size, 1 };
+
+        HeapBlock<float> data (size);
+        auto* channel = data.get();
+        AudioBlock<float> block (&channel, 1, size);
+
+        auto time = [&] (std::function<void (int voice)> processVoice)
+        {
+            auto start = Time::getMillisecondCounterHiRes();
+
+            for (int i = 0; i < numBlocks; ++i)
+                for (int voice = 0; voice < numVoices; ++voice)
+                    processVoice (voice);
+
+            return Time::getMillisecondCounterHiRes() - start;
+        };
+
+        OwnedArray<Oscillator<float>> naiveOscillators, lookupOscillators;
+        OwnedArray<BandLimitedOscillator<float>> polyBLEPOscillators, wavetableOscillators;
+
+        for (int voice = 0; voice < numVoices; ++voice)
+        {
+            auto frequency = 55.0f * std::pow (2.0f, (float) voice / 12.0f);
+
+            for (auto* oscillator : { naiveOscillators.add (new Oscillator<float> ([] (float x) { return x / float_Pi; })),
+                                      lookupOscillators.add (new Oscillator<float> ([] (float x) { return x / float_Pi; }, 128)) })
+            {
+                oscillator->setFrequency (frequency);
+                oscillator->prepare (spec);
+            }
+
+            for (auto* oscillator : { polyBLEPOscillators.add (new BandLimitedOscillator<float> (Wavetable::saw, BandLimitedOscillator<float>::polyBLEP)),
+                                      wavetableOscillators.add (new BandLimitedOscillator<float> (Wavetable::saw, BandLimitedOscillator<float>::wavetable)) })
+            {
+                oscillator->setFrequency (frequency);
+                oscillator->prepare (spec);
+            }
+        }
+
+        const ProcessContextReplacing<float> context (block);
+        auto naive     = time ([&] (int voice) { naiveOscillators    .getUnchecked (voice)->process (context); });
+        auto lookup    = time ([&] (int voice) { lookupOscillators   .getUnchecked (voice)->process (context); });
+        auto polyBLEP  = time ([&] (int voice) { polyBLEPOscillators .getUnchecked (voice)->process (context); });
+        auto wavetable = time ([&] (int voice) { wavetableOscillators.getUnchecked (voice)->process (context); });
+
+        logMessage (String (numVoices) + " saw voices, 1 second at " + String (sampleRate) + " Hz: Oscillator "
+                      + String (naive, 1) + " ms, Oscillator with lookup table " + String (lookup, 1)
+                      + " ms, BandLimitedOscillator PolyBLEP " + String (polyBLEP, 1) + " ms, wavetable "
+                      + String (wavetable, 1) + " ms");
+    }
+
+    void runTest() override
+    {
+        beginTest ("Block and sample processing");
+        runBlockTest<float> (1.0e-5f);
+        runBlockTest<double> (1.0e-12);
+
+        beginTest ("Frequency modulation");
+        runFrequencyModulationTest<float>();
+        runFrequencyModulationTest<double>();
+
+        beginTest ("Amplitude and DC");
+        runAmplitudeTest();
+
+        beginTest ("Aliasing");
+        runAliasingTest();
+
+        beginTest ("Speed");
+        runBenchmark();
+    }
+};
+
+static BandLimitedOscillatorUnitTest bandLimitedOscillatorUnitTest;
+
+} // namespace dsp
+} // namespace juce
@@ -72,6 +72,17 @@ public:
 
     double getRampDurationSeconds() const noexcept  { return rampDurationSeconds; }
 
+    /** Makes the bias follow a parameter of the SmoothedParameterBank passed in the
+        ProcessContext, rather than its own smoothed value. Pass -1 to go back to
+        using setBias().
+
+        Note that processSample() always uses the bias's own smoothed value.
+    */
+    void setParameterBankIndex (int newIndex) noexcept  { parameterBankIndex = newIndex; }
+
+    /** Returns the index of the parameter used in a SmoothedParameterBank, or -1. */
+    int getParameterBankIndex() const noexcept          { return parameterBankIndex; }
+
     //==============================================================================
     /** Called before processing starts */
     void prepare (const ProcessSpec& spec) noexcept
@@ -107,7 +118,17 @@ public:
         auto len         = inBlock.getNumSamples();
         auto numChannels = inBlock.getNumChannels();
 
-        if (numChannels == 1)
+        if (parameterBankIndex >= 0 && context.parameterBank != nullptr)
+        {
+            jassert (context.parameterBank->getNumSamples() >= len);
+            auto* biases = context.parameterBank->getRamp (parameterBankIndex);
+
+            for (size_t chan = 0; chan < numChannels; ++chan)
+                FloatVectorOperations::add (outBlock.getChannelPointer (chan),
+                                            inBlock.getChannelPointer (chan),
+                                            biases, static_cast<int> (len));
+        }
+        else if (numChannels == 1)
         {
             auto* src = inBlock.getChannelPointer (0);
             auto* dst = outBlock.getChannelPointer (0);
@@ -134,6 +155,7 @@ private:
     //==============================================================================
     LinearSmoothedValue<FloatType> bias;
     double sampleRate = 0, rampDurationSeconds = 0;
+    int parameterBankIndex = -1;
 
     void updateRamp() noexcept
     {
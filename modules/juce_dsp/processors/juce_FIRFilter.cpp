@@ -29,6 +29,206 @@ namespace juce
 namespace dsp
 {
 
+//==============================================================================
+FIR::PartitionedConvolution::PartitionedConvolution() {}
+FIR::PartitionedConvolution::~PartitionedConvolution() {}
+
+size_t FIR::PartitionedConvolution::getPartitionSizeForNumCoefficients (size_t numCoefficientsToUse) noexcept
+{
+    // The time domain head costs one multiply-add per coefficient of the first partition,
+    // and the frequency domain tail costs roughly four per partition, so the total cost
+    // per sample is lowest for partitions of about twice the square root of the length.
+    auto idealSize = 2.0 * std::sqrt (static_cast<double> (numCoefficientsToUse));
+
+    return static_cast<size_t> (jlimit (16, 1024, nextPowerOfTwo (roundToInt (idealSize))));
+}
+
+void FIR::PartitionedConvolution::prepare (const float* coefficients, size_t numCoefficientsToUse)
+{
+    jassert (numCoefficientsToUse > 0);
+
+    auto newPartitionSize = getPartitionSizeForNumCoefficients (numCoefficientsToUse);
+
+    if (newPartitionSize != partitionSize)
+    {
+        partitionSize = newPartitionSize;
+
+        auto order = roundToInt (std::log2 (static_cast<double> (partitionSize * 2)));
+        fft = new FFT (order);
+
+        inputHistory.calloc (partitionSize * 2);
+        accumulator.calloc  ((partitionSize + 1) * 2);
+        tailOutput.calloc   (partitionSize);
+        fftBuffer.calloc    (partitionSize * 4);
+    }
+
+    numCoefficients   = numCoefficientsToUse;
+    headSize          = jmin (numCoefficients, partitionSize);
+    numTailPartitions = (numCoefficients - headSize + partitionSize - 1) / partitionSize;
+
+    auto spectrumSize = (partitionSize + 1) * 2;
+
+    headCoefficients.calloc (headSize);
+    headHistory.calloc (headSize * 2);
+    tailSpectra.calloc (jmax ((size_t) 1, numTailPartitions) * spectrumSize);
+    inputSpectra.calloc (jmax ((size_t) 1, numTailPartitions) * spectrumSize);
+
+    setCoefficients (coefficients, numCoefficientsToUse);
+    reset();
+}
+
+void FIR::PartitionedConvolution::setCoefficients (const float* coefficients, size_t numCoefficientsToUse) noexcept
+{
+    // If the size changes, you need to call prepare() instead!
+    jassert (numCoefficientsToUse == numCoefficients);
+    ignoreUnused (numCoefficientsToUse);
+
+    FloatVectorOperations::copy (headCoefficients.get(), coefficients, (int) headSize);
+
+    auto spectrumSize = (partitionSize + 1) * 2;
+
+    for (size_t p = 0; p < numTailPartitions; ++p)
+    {
+        auto start = headSize + p * partitionSize;
+        auto num = jmin (partitionSize, numCoefficients - start);
+
+        forwardTransform (coefficients + start, num, tailSpectra.get() + p * spectrumSize);
+    }
+
+    // the tail of the current block was computed in advance, so it needs refreshing
+    // to make the new coefficients take effect straight away
+    updateTailOutput();
+}
+
+void FIR::PartitionedConvolution::reset() noexcept
+{
+    auto spectrumSize = (partitionSize + 1) * 2;
+
+    zeromem (headHistory.get(),  sizeof (float) * headSize * 2);
+    zeromem (inputHistory.get(), sizeof (float) * partitionSize * 2);
+    zeromem (tailOutput.get(),   sizeof (float) * partitionSize);
+    zeromem (inputSpectra.get(), sizeof (float) * jmax ((size_t) 1, numTailPartitions) * spectrumSize);
+
+    headPos = inputPos = spectrumPos = 0;
+}
+
+//==============================================================================
+float FIR::PartitionedConvolution::processSample (float sample) noexcept
+{
+    jassert (numCoefficients > 0);
+
+    // The head partition, in the time domain. The history is written twice so that
+    // the dot product can always read a contiguous range.
+    headHistory[headPos] = sample;
+    headHistory[headPos + headSize] = sample;
+
+    auto* history = headHistory.get() + headPos;
+    auto* fir = headCoefficients.get();
+    float out = 0;
+
+    for (size_t k = 0; k < headSize; ++k)
+        out += history[k] * fir[k];
+
+    headPos = (headPos == 0 ? headSize - 1 : headPos - 1);
+
+    // The tail partitions, computed one block in advance
+    out += tailOutput[inputPos];
+    inputHistory[partitionSize + inputPos] = sample;
+
+    if (++inputPos == partitionSize)
+    {
+        processPartition();
+        inputPos = 0;
+    }
+
+    return out;
+}
+
+void FIR::PartitionedConvolution::process (const float* input, float* output, size_t numSamples) noexcept
+{
+    for (size_t i = 0; i < numSamples; ++i)
+        output[i] = processSample (input[i]);
+}
+
+//==============================================================================
+void FIR::PartitionedConvolution::forwardTransform (const float* timeDomainData, size_t numSamples, float* spectrum) noexcept
+{
+    auto* buffer = fftBuffer.get();
+
+    FloatVectorOperations::copy (buffer, timeDomainData, (int) numSamples);
+    FloatVectorOperations::clear (buffer + numSamples, (int) (partitionSize * 4 - numSamples));
+    fft->performRealOnlyForwardTransform (buffer, true);
+
+    // store the non-negative frequencies as separate real and imaginary arrays, so that
+    // the complex multiplications can be done with FloatVectorOperations
+    for (size_t i = 0; i <= partitionSize; ++i)
+    {
+        spectrum[i]                     = buffer[2 * i];
+        spectrum[i + partitionSize + 1] = buffer[2 * i + 1];
+    }
+}
+
+void FIR::PartitionedConvolution::processPartition() noexcept
+{
+    if (numTailPartitions == 0)
+        return;
+
+    auto numBins = partitionSize + 1;
+    auto spectrumSize = numBins * 2;
+
+    // The input history now holds the previous and the latest input blocks, which is
+    // the window needed for overlap-save.
+    spectrumPos = (spectrumPos == 0 ? numTailPartitions - 1 : spectrumPos - 1);
+    forwardTransform (inputHistory.get(), partitionSize * 2, inputSpectra.get() + spectrumPos * spectrumSize);
+
+    FloatVectorOperations::copy (inputHistory.get(), inputHistory.get() + partitionSize, (int) partitionSize);
+
+    updateTailOutput();
+}
+
+void FIR::PartitionedConvolution::updateTailOutput() noexcept
+{
+    if (numTailPartitions == 0)
+        return;
+
+    auto numBins = partitionSize + 1;
+    auto spectrumSize = numBins * 2;
+
+    auto* accRe = accumulator.get();
+    auto* accIm = accumulator.get() + numBins;
+
+    FloatVectorOperations::clear (accumulator.get(), (int) spectrumSize);
+
+    auto index = spectrumPos;
+
+    for (size_t p = 0; p < numTailPartitions; ++p)
+    {
+        auto* x = inputSpectra.get() + index * spectrumSize;
+        auto* h = tailSpectra.get() + p * spectrumSize;
+
+        FloatVectorOperations::addWithMultiply      (accRe, x, h, (int) numBins);
+        FloatVectorOperations::subtractWithMultiply (accRe, x + numBins, h + numBins, (int) numBins);
+        FloatVectorOperations::addWithMultiply      (accIm, x, h + numBins, (int) numBins);
+        FloatVectorOperations::addWithMultiply      (accIm, x + numBins, h, (int) numBins);
+
+        if (++index == numTailPartitions)
+            index = 0;
+    }
+
+    auto* buffer = fftBuffer.get();
+
+    for (size_t i = 0; i < numBins; ++i)
+    {
+        buffer[2 * i]     = accRe[i];
+        buffer[2 * i + 1] = accIm[i];
+    }
+
+    fft->performRealOnlyInverseTransform (buffer);
+
+    // overlap-save: only the second half of the circular convolution is valid
+    FloatVectorOperations::copy (tailOutput.get(), buffer + partitionSize, (int) partitionSize);
+}
+
 template <typename NumericType>
 double FIR::Coefficients<NumericType>::Coefficients::getMagnitudeForFrequency (double frequency, double theSampleRate) const noexcept
 {
@@ -29,6 +29,8 @@ namespace juce
 namespace dsp
 {
 
+class FFT;
+
 /**
     Classes for FIR filter processing.
 */
@@ -37,17 +39,97 @@ namespace FIR
     template <typename NumericType>
     struct Coefficients;
 
+    //==============================================================================
+    /**
+        A zero-latency, uniformly partitioned FFT convolution engine for a single
+        channel of float data.
+
+        The first partition of the impulse response is applied directly in the time
+        domain, so that no latency is introduced, while the remaining partitions are
+        processed in the frequency domain once per partition-sized block of input,
+        using a frequency-domain delay line. This is what FIR::Filter<float> uses
+        internally when the number of coefficients is above its partitioned
+        convolution threshold, but it can also be used on its own.
+
+        @see FIR::Filter, Convolution
+    */
+    class JUCE_API  PartitionedConvolution
+    {
+    public:
+        //==============================================================================
+        PartitionedConvolution();
+        ~PartitionedConvolution();
+
+        //==============================================================================
+        /** Allocates the buffers for a given set of coefficients and clears the
+            processing state. This must not be called on the audio thread.
+        */
+        void prepare (const float* coefficients, size_t numCoefficients);
+
+        /** Replaces the coefficients without clearing the processing state.
+
+            The number of coefficients must be the same as the one passed to the last
+            call to prepare(). This doesn't allocate, but it performs one FFT per
+            partition, so it's best not to call it for every block.
+        */
+        void setCoefficients (const float* coefficients, size_t numCoefficients) noexcept;
+
+        /** Clears the processing state, keeping the current coefficients. */
+        void reset() noexcept;
+
+        //==============================================================================
+        /** Processes a single sample. */
+        float processSample (float sample) noexcept;
+
+        /** Processes a block of samples. The input and output may point to the same data. */
+        void process (const float* input, float* output, size_t numSamples) noexcept;
+
+        //==============================================================================
+        /** Returns the number of coefficients handled by each partition. */
+        size_t getPartitionSize() const noexcept        { return partitionSize; }
+
+        /** Returns the number of coefficients that were passed to prepare(). */
+        size_t getNumCoefficients() const noexcept      { return numCoefficients; }
+
+        /** Returns the partition size which will be used for a given filter length. */
+        static size_t getPartitionSizeForNumCoefficients (size_t numCoefficients) noexcept;
+
+    private:
+        //==============================================================================
+        void processPartition() noexcept;
+        void updateTailOutput() noexcept;
+        void forwardTransform (const float* timeDomainData, size_t numSamples, float* spectrum) noexcept;
+
+        ScopedPointer<FFT> fft;
+        HeapBlock<float> headCoefficients, headHistory, tailSpectra, inputSpectra,
+                         inputHistory, accumulator, tailOutput, fftBuffer;
+
+        size_t numCoefficients = 0, partitionSize = 0, headSize = 0, numTailPartitions = 0;
+        size_t headPos = 0, inputPos = 0, spectrumPos = 0;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PartitionedConvolution)
+    };
+
     //==============================================================================
     /**
         A processing class that can perform FIR filtering on an audio signal, in the
         time domain.
 
-        Using FIRFilter is fast enough for FIRCoefficients with a size lower than 128
-        samples. For longer filters, it might be more efficient to use the class
-        Convolution instead, which does the same processing in the frequency domain
-        thanks to FFT.
-
-        @see FIRFilter::Coefficients, Convolution, FFT
+        Direct-form convolution is fast enough for FIRCoefficients with a size lower
+        than a few hundred samples. For longer filters, a Filter<float> will switch
+        automatically to a zero-latency, uniformly partitioned FFT convolution (see
+        setPartitionedConvolutionThreshold). Other sample types always use the time
+        domain algorithm.
+
+        In partitioned mode the spectra of the coefficients are cached, and they're
+        recalculated whenever the values of the coefficients change, either in place or
+        by assigning a different Coefficients object. This costs one FFT per partition.
+        A different Coefficients object is picked up straight away, but changes made in
+        place are only looked for at the start of each process() call, and once per
+        partition by processSample(), so it can take up to one partition for them to
+        be heard when processing sample by sample.
+
+        @see FIRFilter::Coefficients, PartitionedConvolution, Convolution, FFT
     */
     template <typename SampleType>
     class Filter
@@ -70,6 +152,30 @@ namespace FIR
         Filter& operator= (const Filter&) = default;
         Filter& operator= (Filter&&) = default;
 
+        //==============================================================================
+        /** The default number of coefficients above which a Filter<float> uses
+            partitioned FFT convolution.
+        */
+        static constexpr size_t defaultPartitionedConvolutionThreshold = 192;
+
+        /** Sets the number of coefficients from which a Filter<float> will process its
+            signal with partitioned FFT convolution rather than in the time domain.
+
+            Pass std::numeric_limits<size_t>::max() to always use the time domain
+            algorithm. This has no effect for sample types other than float, and will
+            reset the processing state if the processing mode changes.
+        */
+        void setPartitionedConvolutionThreshold (size_t minimumNumCoefficients)
+        {
+            partitionedThreshold = minimumNumCoefficients;
+
+            if ((partitioned != nullptr) != shouldUsePartitionedConvolution (size))
+                reset();
+        }
+
+        /** Returns true if the filter is currently using partitioned FFT convolution. */
+        bool isUsingPartitionedConvolution() const noexcept        { return partitioned != nullptr; }
+
         //==============================================================================
         /** Prepare this filter for processing. */
         inline void prepare (const ProcessSpec& spec) noexcept
@@ -92,12 +198,35 @@ namespace FIR
             {
                 auto newSize = coefficients->getFilterOrder() + 1;
 
-                if (newSize != size)
+                if (shouldUsePartitionedConvolution (newSize))
+                {
+                    if (partitioned == nullptr)
+                        partitioned = new PartitionedConvolution();
+
+                    preparePartitioned (coefficients->getRawCoefficients(), newSize);
+
+                    memory.free();
+                    fifo = nullptr;
+
+                    if (partitionedCoefficients == nullptr || newSize != size)
+                        partitionedCoefficients.malloc (newSize);
+
+                    size = newSize;
+                    partitionPos = 0;
+                    copyCoefficientsForPartitioned();
+                    return;
+                }
+
+                partitioned = nullptr;
+                partitionedCoefficients.free();
+
+                if (newSize != size || fifo == nullptr)
                 {
                     memory.malloc (1 + jmax (newSize, size, static_cast<size_t> (128)));
 
                     fifo = snapPointerToAlignment (memory.getData(), sizeof (SampleType));
                     size = newSize;
+                    pos = 0;
                 }
 
                 for (size_t i = 0; i < size; ++i)
@@ -121,7 +250,7 @@ namespace FIR
         {
             static_assert (std::is_same<typename ProcessContext::SampleType, SampleType>::value,
                            "The sample-type of the FIR filter must match the sample-type supplied to this process callback");
-            check();
+            check (true);
 
             auto&& inputBlock  = context.getInputBlock();
             auto&& outputBlock = context.getOutputBlock();
@@ -135,6 +264,13 @@ namespace FIR
             auto* src = inputBlock .getChannelPointer (0);
             auto* dst = outputBlock.getChannelPointer (0);
 
+            if (partitioned != nullptr)
+            {
+                processPartitioned (src, dst, numSamples);
+                partitionPos = (partitionPos + numSamples) % partitioned->getPartitionSize();
+                return;
+            }
+
             auto* fir = coefficients->getRawCoefficients();
             size_t p = pos;
 
@@ -150,7 +286,16 @@ namespace FIR
         */
         SampleType JUCE_VECTOR_CALLTYPE processSample (SampleType sample) noexcept
         {
-            check();
+            // Comparing the coefficients costs as much as processing a partition, so it's
+            // only done just before the engine finishes one and uses their spectra
+            check (partitioned != nullptr && partitionPos == partitioned->getPartitionSize() - 1);
+
+            if (partitioned != nullptr)
+            {
+                partitionPos = (partitionPos + 1) % partitioned->getPartitionSize();
+                return processSamplePartitioned (sample);
+            }
+
             return processSingleSample (sample, fifo, coefficients->getRawCoefficients(), size, pos);
         }
 
@@ -160,15 +305,68 @@ namespace FIR
         SampleType* fifo = nullptr;
         size_t pos = 0, size = 0;
 
+        ScopedPointer<PartitionedConvolution> partitioned;
+        HeapBlock<NumericType> partitionedCoefficients;
+        const Coefficients<NumericType>* partitionedCoefficientsSource = nullptr;
+        size_t partitionedThreshold = defaultPartitionedConvolutionThreshold, partitionPos = 0;
+
         //==============================================================================
-        void check()
+        void check (bool shouldCompareValues)
         {
             jassert (coefficients != nullptr);
 
             if (size != (coefficients->getFilterOrder() + 1))
                 reset();
+            else if (partitioned != nullptr
+                      && (coefficients.get() != partitionedCoefficientsSource
+                           || (shouldCompareValues && memcmp (partitionedCoefficients.get(), coefficients->getRawCoefficients(),
+                                                              size * sizeof (NumericType)) != 0)))
+                updatePartitionedCoefficients();
+        }
+
+        bool shouldUsePartitionedConvolution (size_t numCoefficients) const noexcept
+        {
+            return std::is_same<SampleType, float>::value && numCoefficients >= partitionedThreshold;
+        }
+
+        void updatePartitionedCoefficients() noexcept
+        {
+            setPartitionedCoefficients (coefficients->getRawCoefficients(), size);
+            copyCoefficientsForPartitioned();
+        }
+
+        // keeps a copy of the coefficients whose spectra are cached, so that changes
+        // to their values can be spotted
+        void copyCoefficientsForPartitioned() noexcept
+        {
+            memcpy (partitionedCoefficients.get(), coefficients->getRawCoefficients(), size * sizeof (NumericType));
+            partitionedCoefficientsSource = coefficients.get();
         }
 
+        // The partitioned engine only deals with floats, so these overloads are picked
+        // when SampleType is float, and the templated ones are never reached otherwise.
+        void preparePartitioned (const float* fir, size_t n)
+        {
+            if (partitioned->getNumCoefficients() == n)
+            {
+                partitioned->setCoefficients (fir, n);
+                partitioned->reset();
+            }
+            else
+            {
+                partitioned->prepare (fir, n);
+            }
+        }
+
+        void setPartitionedCoefficients (const float* fir, size_t n) noexcept     { partitioned->setCoefficients (fir, n); }
+        void processPartitioned (const float* src, float* dst, size_t n) noexcept { partitioned->process (src, dst, n); }
+        float processSamplePartitioned (float sample) noexcept                    { return partitioned->processSample (sample); }
+
+        template <typename T> void preparePartitioned (const T*, size_t)                   { jassertfalse; }
+        template <typename T> void setPartitionedCoefficients (const T*, size_t) noexcept  { jassertfalse; }
+        template <typename T> void processPartitioned (const T*, T*, size_t) noexcept      { jassertfalse; }
+        template <typename T> T processSamplePartitioned (T sample) noexcept               { jassertfalse; return sample; }
+
         static SampleType JUCE_VECTOR_CALLTYPE processSingleSample (SampleType sample, SampleType* buf,
                                                                     const NumericType* fir, size_t m, size_t& p) noexcept
         {
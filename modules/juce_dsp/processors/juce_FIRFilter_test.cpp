@@ -193,6 +193,124 @@ class FIRFilterTest : public UnitTest
     }
 
 
+    //==============================================================================
+    static float getMaximumDifference (const float* a, const float* b, size_t n) noexcept
+    {
+        float maxDifference = 0;
+
+        for (size_t i = 0; i < n; ++i)
+            maxDifference = jmax (maxDifference, std::abs (a[i] - b[i]));
+
+        return maxDifference;
+    }
+
+    template <typename TheTest>
+    void runPartitionedTest (const char* unitTestName)
+    {
+        beginTest (unitTestName);
+
+        Random random (8392829);
+
+        for (auto size : {192, 200, 257, 512, 1000, 2049})
+        {
+            constexpr size_t n = 4000;
+            auto numCoefficients = static_cast<size_t> (size);
+
+            HeapBlock<float> input (n), output (n), ref (n), firA (numCoefficients), firB (numCoefficients);
+            fillRandom (random, input.get(), n);
+            fillRandom (random, firA.get(), numCoefficients);
+            fillRandom (random, firB.get(), numCoefficients);
+
+            FIR::Filter<float> filter    (new FIR::Coefficients<float> (firA.get(), numCoefficients));
+            FIR::Filter<float> reference (new FIR::Coefficients<float> (firA.get(), numCoefficients));
+            reference.setPartitionedConvolutionThreshold (std::numeric_limits<size_t>::max());
+
+            ProcessSpec spec { 0.0, n, 1 };
+            filter.prepare (spec);
+            reference.prepare (spec);
+
+            expect (filter.isUsingPartitionedConvolution());
+            expect (! reference.isUsingPartitionedConvolution());
+
+            // run a third with one set of coefficients, then swap them for new ones while running,
+            // and then change their values in place
+            auto third = n / 3;
+
+            TheTest::template run<float> (filter,    input.get(), output.get(), third);
+            TheTest::template run<float> (reference, input.get(), ref.get(),    third);
+
+            filter.coefficients    = new FIR::Coefficients<float> (firB.get(), numCoefficients);
+            reference.coefficients = new FIR::Coefficients<float> (firB.get(), numCoefficients);
+
+            TheTest::template run<float> (filter,    input.get() + third, output.get() + third, third);
+            TheTest::template run<float> (reference, input.get() + third, ref.get() + third,    third);
+
+            *filter.coefficients    = FIR::Coefficients<float> (firA.get(), numCoefficients);
+            *reference.coefficients = FIR::Coefficients<float> (firA.get(), numCoefficients);
+
+            TheTest::template run<float> (filter,    input.get() + 2 * third, output.get() + 2 * third, n - 2 * third);
+            TheTest::template run<float> (reference, input.get() + 2 * third, ref.get() + 2 * third,    n - 2 * third);
+
+            // The outputs' magnitudes grow with the square root of the filter length. When
+            // processing sample by sample, the values changed in place can take up to a
+            // partition to be picked up, so the outputs are only compared after that.
+            auto tolerance = 1.0e-5f * std::sqrt (static_cast<float> (size));
+            auto inPlaceStart = 2 * third + FIR::PartitionedConvolution::getPartitionSizeForNumCoefficients (numCoefficients);
+
+            expectLessThan (getMaximumDifference (output.get(), ref.get(), 2 * third), tolerance);
+            expectLessThan (getMaximumDifference (output.get() + inPlaceStart, ref.get() + inPlaceStart, n - inPlaceStart), tolerance);
+        }
+    }
+
+    //==============================================================================
+    void runPartitionedBenchmark()
+    {
+        beginTest ("Partitioned convolution crossover");
+
+        constexpr size_t blockSize = 512, numBlocks = 32;
+        Random random (8392829);
+        HeapBlock<float> input (blockSize), output (blockSize);
+        fillRandom (random, input.get(), blockSize);
+
+        auto timeFilter = [&] (size_t numCoefficients, size_t threshold, bool sampleBySample)
+        {
+            HeapBlock<float> fir (numCoefficients);
+            fillRandom (random, fir.get(), numCoefficients);
+
+            FIR::Filter<float> filter (new FIR::Coefficients<float> (fir.get(), numCoefficients));
+            filter.setPartitionedConvolutionThreshold (threshold);
+            filter.prepare ({ 0.0, blockSize, 1 });
+
+            auto start = Time::getHighResolutionTicks();
+
+            for (size_t i = 0; i < numBlocks; ++i)
+            {
+                if (sampleBySample)
+                    SampleBySampleTest::run<float> (filter, input.get(), output.get(), blockSize);
+                else
+                    LargeBlockTest::run<float> (filter, input.get(), output.get(), blockSize);
+            }
+
+            return Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start);
+        };
+
+        for (auto sampleBySample : { false, true })
+        {
+            logMessage (sampleBySample ? "Sample by sample:" : "Blocks of " + String (blockSize) + " samples:");
+
+            for (size_t numCoefficients = 16; numCoefficients <= 8192; numCoefficients *= 2)
+            {
+                auto direct      = timeFilter (numCoefficients, std::numeric_limits<size_t>::max(), sampleBySample);
+                auto partitioned = timeFilter (numCoefficients, 0, sampleBySample);
+
+                logMessage (String (numCoefficients).paddedLeft (' ', 5) + " taps: direct "
+                              + String (direct * 1000.0, 2) + " ms, partitioned "
+                              + String (partitioned * 1000.0, 2) + " ms ("
+                              + String (direct / partitioned, 2) + "x)");
+            }
+        }
+    }
+
 public:
     FIRFilterTest() : UnitTest ("FIR Filter") {}
 
@@ -201,6 +319,12 @@ public:
         runTestForAllTypes<LargeBlockTest> ("Large Blocks");
         runTestForAllTypes<SampleBySampleTest> ("Sample by Sample");
         runTestForAllTypes<SplitBlockTest> ("Split Block");
+
+        runPartitionedTest<LargeBlockTest> ("Partitioned Large Blocks");
+        runPartitionedTest<SampleBySampleTest> ("Partitioned Sample by Sample");
+        runPartitionedTest<SplitBlockTest> ("Partitioned Split Block");
+
+        runPartitionedBenchmark();
     }
 };
 
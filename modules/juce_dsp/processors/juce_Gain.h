@@ -67,6 +67,17 @@ public:
     /** Returns true if the current value is currently being interpolated. */
     bool isSmoothing() const noexcept                           { return gain.isSmoothing(); }
 
+    /** Makes the gain follow a parameter of the SmoothedParameterBank passed in the
+        ProcessContext, rather than its own smoothed value. The values in the bank are
+        linear gains. Pass -1 to go back to using setGainLinear().
+
+        Note that processSample() always uses the gain's own smoothed value.
+    */
+    void setParameterBankIndex (int newIndex) noexcept          { parameterBankIndex = newIndex; }
+
+    /** Returns the index of the parameter used in a SmoothedParameterBank, or -1. */
+    int getParameterBankIndex() const noexcept                  { return parameterBankIndex; }
+
     //==============================================================================
     /** Called before processing starts. */
     void prepare (const ProcessSpec& spec) noexcept
@@ -103,7 +114,17 @@ public:
         auto len         = inBlock.getNumSamples();
         auto numChannels = inBlock.getNumChannels();
 
-        if (numChannels == 1)
+        if (parameterBankIndex >= 0 && context.parameterBank != nullptr)
+        {
+            jassert (context.parameterBank->getNumSamples() >= len);
+            auto* gains = context.parameterBank->getRamp (parameterBankIndex);
+
+            for (size_t chan = 0; chan < numChannels; ++chan)
+                FloatVectorOperations::multiply (outBlock.getChannelPointer (chan),
+                                                 inBlock.getChannelPointer (chan),
+                                                 gains, static_cast<int> (len));
+        }
+        else if (numChannels == 1)
         {
             auto* src = inBlock.getChannelPointer (0);
             auto* dst = outBlock.getChannelPointer (0);
@@ -129,6 +150,7 @@ private:
     //==============================================================================
     LinearSmoothedValue<FloatType> gain;
     double sampleRate = 0, rampDurationSeconds = 0;
+    int parameterBankIndex = -1;
 };
 
 } // namespace dsp
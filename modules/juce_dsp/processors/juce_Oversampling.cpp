@@ -549,6 +549,373 @@ private:
 };
 
 
+//===============================================================================
+/** Oversampling engine class performing N times oversampling in a single stage,
+    for any integer factor, using Kaiser windowed FIR filters split into polyphase
+    branches. The filters are linear phase, or can be converted to minimum phase to
+    reduce the latency.
+
+    The filter states of all the channels are interleaved, so that the whole factor
+    is handled without any intermediate buffer. The convolutions are plain scalar
+    loops, with the channels in the innermost loop.
+
+    With minimum phase filters, the reported latency is an approximation, as the
+    group delay of these filters depends on the frequency.
+*/
+template <typename SampleType>
+class OversamplingPolyphaseFIR : public OversamplingEngine<SampleType>
+{
+public:
+    //===============================================================================
+    OversamplingPolyphaseFIR (size_t numChans, size_t oversamplingFactor, bool isMinimumPhase,
+                              SampleType normalizedTransitionWidthUp,
+                              SampleType stopbandAttenuationdBUp,
+                              SampleType normalizedTransitionWidthDown,
+                              SampleType stopbandAttenuationdBDown) : OversamplingEngine<SampleType> (numChans, oversamplingFactor)
+    {
+        coefficientsUp   = designFilter (oversamplingFactor, normalizedTransitionWidthUp,   stopbandAttenuationdBUp,   isMinimumPhase);
+        coefficientsDown = designFilter (oversamplingFactor, normalizedTransitionWidthDown, stopbandAttenuationdBDown, isMinimumPhase);
+
+        latency = getFilterLatency (coefficientsUp, isMinimumPhase) + getFilterLatency (coefficientsDown, isMinimumPhase);
+
+        // Split the upsampling filter into its polyphase branches, including the gain
+        // compensating the zeros which are inserted between the input samples.
+        numTapsPerPhase = (static_cast<size_t> (coefficientsUp.size()) + oversamplingFactor - 1) / oversamplingFactor;
+        polyphaseUp.resize (static_cast<int> (numTapsPerPhase * oversamplingFactor));
+
+        for (size_t phase = 0; phase < oversamplingFactor; ++phase)
+            for (size_t k = 0; k < numTapsPerPhase; ++k)
+            {
+                auto index = static_cast<int> (k * oversamplingFactor + phase);
+                polyphaseUp.setUnchecked (static_cast<int> (phase * numTapsPerPhase + k),
+                                          index < coefficientsUp.size() ? coefficientsUp[index] * static_cast<SampleType> (oversamplingFactor)
+                                                                        : static_cast<SampleType> (0));
+            }
+
+        // The states are written twice, so that each convolution reads a contiguous range
+        stateUp.resize   (static_cast<int> (2 * numTapsPerPhase * numChans));
+        stateDown.resize (static_cast<int> (2 * static_cast<size_t> (coefficientsDown.size()) * numChans));
+        accumulator.resize (static_cast<int> (numChans));
+    }
+
+    ~OversamplingPolyphaseFIR() {}
+
+    //===============================================================================
+    SampleType getLatencyInSamples() override
+    {
+        return latency;
+    }
+
+    void reset() override
+    {
+        OversamplingEngine<SampleType>::reset();
+
+        stateUp.fill (0);
+        stateDown.fill (0);
+
+        positionUp = positionDown = 0;
+    }
+
+    void processSamplesUp (dsp::AudioBlock<SampleType> &inputBlock) override
+    {
+        jassert (inputBlock.getNumChannels() <= static_cast<size_t> (OversamplingEngine<SampleType>::buffer.getNumChannels()));
+        jassert (inputBlock.getNumSamples() * OversamplingEngine<SampleType>::factor <= static_cast<size_t> (OversamplingEngine<SampleType>::buffer.getNumSamples()));
+
+        // Initialization
+        auto oversamplingFactor = OversamplingEngine<SampleType>::factor;
+        auto stride = OversamplingEngine<SampleType>::numChannels;
+        auto numChannelsToProcess = inputBlock.getNumChannels();
+        auto numSamples = inputBlock.getNumSamples();
+        auto K = numTapsPerPhase;
+
+        auto fir = polyphaseUp.getRawDataPointer();
+        auto state = stateUp.getRawDataPointer();
+        auto acc = accumulator.getRawDataPointer();
+        auto bufferSamples = OversamplingEngine<SampleType>::buffer.getArrayOfWritePointers();
+
+        // Processing
+        for (size_t i = 0; i < numSamples; i++)
+        {
+            // Input
+            for (size_t channel = 0; channel < numChannelsToProcess; channel++)
+            {
+                auto sample = inputBlock.getChannelPointer (channel)[i];
+                state[positionUp * stride + channel] = sample;
+                state[(positionUp + K) * stride + channel] = sample;
+            }
+
+            auto frames = state + positionUp * stride;
+
+            // Convolution, one output sample per polyphase branch
+            for (size_t phase = 0; phase < oversamplingFactor; phase++)
+            {
+                auto branch = fir + phase * K;
+
+                for (size_t channel = 0; channel < numChannelsToProcess; channel++)
+                    acc[channel] = 0;
+
+                for (size_t k = 0; k < K; k++)
+                {
+                    auto frame = frames + k * stride;
+
+                    for (size_t channel = 0; channel < numChannelsToProcess; channel++)
+                        acc[channel] += branch[k] * frame[channel];
+                }
+
+                // Outputs
+                for (size_t channel = 0; channel < numChannelsToProcess; channel++)
+                    bufferSamples[channel][i * oversamplingFactor + phase] = acc[channel];
+            }
+
+            // Circular buffer
+            positionUp = (positionUp == 0 ? K - 1 : positionUp - 1);
+        }
+    }
+
+    void processSamplesDown (dsp::AudioBlock<SampleType> &outputBlock) override
+    {
+        jassert (outputBlock.getNumChannels() <= static_cast<size_t> (OversamplingEngine<SampleType>::buffer.getNumChannels()));
+        jassert (outputBlock.getNumSamples() * OversamplingEngine<SampleType>::factor <= static_cast<size_t> (OversamplingEngine<SampleType>::buffer.getNumSamples()));
+
+        // Initialization
+        auto oversamplingFactor = OversamplingEngine<SampleType>::factor;
+        auto stride = OversamplingEngine<SampleType>::numChannels;
+        auto numChannelsToProcess = outputBlock.getNumChannels();
+        auto numSamples = outputBlock.getNumSamples();
+        auto N = static_cast<size_t> (coefficientsDown.size());
+
+        auto fir = coefficientsDown.getRawDataPointer();
+        auto state = stateDown.getRawDataPointer();
+        auto acc = accumulator.getRawDataPointer();
+        auto bufferSamples = OversamplingEngine<SampleType>::buffer.getArrayOfReadPointers();
+
+        // Processing
+        for (size_t i = 0; i < numSamples; i++)
+        {
+            for (size_t phase = 0; phase < oversamplingFactor; phase++)
+            {
+                // Input
+                for (size_t channel = 0; channel < numChannelsToProcess; channel++)
+                {
+                    auto sample = bufferSamples[channel][i * oversamplingFactor + phase];
+                    state[positionDown * stride + channel] = sample;
+                    state[(positionDown + N) * stride + channel] = sample;
+                }
+
+                // Convolution, only computed for the samples which are kept
+                if (phase == 0)
+                {
+                    auto frames = state + positionDown * stride;
+
+                    for (size_t channel = 0; channel < numChannelsToProcess; channel++)
+                        acc[channel] = 0;
+
+                    for (size_t k = 0; k < N; k++)
+                    {
+                        auto frame = frames + k * stride;
+
+                        for (size_t channel = 0; channel < numChannelsToProcess; channel++)
+                            acc[channel] += fir[k] * frame[channel];
+                    }
+
+                    // Output
+                    for (size_t channel = 0; channel < numChannelsToProcess; channel++)
+                        outputBlock.getChannelPointer (channel)[i] = acc[channel];
+                }
+
+                // Circular buffer
+                positionDown = (positionDown == 0 ? N - 1 : positionDown - 1);
+            }
+        }
+    }
+
+    //===============================================================================
+    /** Creates an engine with the default filter settings used by the Oversampling
+        class for a given quality.
+    */
+    static OversamplingPolyphaseFIR* create (size_t numChans, size_t oversamplingFactor, bool isMinimumPhase, bool isMaxQuality)
+    {
+        return new OversamplingPolyphaseFIR (numChans, oversamplingFactor, isMinimumPhase,
+                                             getTransitionWidth (true, isMaxQuality),  getStopbandAttenuation (true, isMaxQuality),
+                                             getTransitionWidth (false, isMaxQuality), getStopbandAttenuation (false, isMaxQuality));
+    }
+
+    /** Returns the latency of an engine which would be returned by create(), in
+        samples at the higher sample rate, without allocating its buffers.
+    */
+    static SampleType getDefaultLatencyInSamples (size_t oversamplingFactor, bool isMinimumPhase, bool isMaxQuality)
+    {
+        auto up   = designFilter (oversamplingFactor, getTransitionWidth (true, isMaxQuality),  getStopbandAttenuation (true, isMaxQuality),  isMinimumPhase);
+        auto down = designFilter (oversamplingFactor, getTransitionWidth (false, isMaxQuality), getStopbandAttenuation (false, isMaxQuality), isMinimumPhase);
+
+        return getFilterLatency (up, isMinimumPhase) + getFilterLatency (down, isMinimumPhase);
+    }
+
+    static SampleType getTransitionWidth (bool isUpsampling, bool isMaxQuality)
+    {
+        return static_cast<SampleType> (isUpsampling ? (isMaxQuality ? 0.10 : 0.12)
+                                                     : (isMaxQuality ? 0.12 : 0.15));
+    }
+
+    static SampleType getStopbandAttenuation (bool isUpsampling, bool isMaxQuality)
+    {
+        return static_cast<SampleType> (isUpsampling ? (isMaxQuality ? -90.0 : -70.0)
+                                                     : (isMaxQuality ? -70.0 : -60.0));
+    }
+
+    //===============================================================================
+    /** Designs the anti-imaging or anti-aliasing filter for a given factor. The
+        transition band is given relatively to the original sample rate, and ends at
+        its Nyquist frequency.
+    */
+    static Array<SampleType> designFilter (size_t oversamplingFactor, SampleType normalizedTransitionWidth,
+                                           SampleType stopbandAttenuationdB, bool isMinimumPhase)
+    {
+        auto cutoff = static_cast<SampleType> (0.5) - normalizedTransitionWidth * static_cast<SampleType> (0.5);
+
+        auto design = dsp::FilterDesign<SampleType>::designFIRLowpassKaiserMethod (cutoff, static_cast<double> (oversamplingFactor),
+                                                                                  normalizedTransitionWidth / static_cast<SampleType> (oversamplingFactor),
+                                                                                  stopbandAttenuationdB);
+
+        Array<SampleType> result (design->getRawCoefficients(), static_cast<int> (design->getFilterOrder() + 1));
+
+        if (isMinimumPhase)
+            convertToMinimumPhase (result);
+
+        return result;
+    }
+
+    /** Returns the latency of a filter, as its group delay at DC. This is exact for
+        a linear phase filter, whose group delay is constant, but for a minimum phase
+        filter it's only an approximation of the delay of the low frequencies.
+    */
+    static SampleType getFilterLatency (const Array<SampleType>& coefficients, bool isMinimumPhase)
+    {
+        if (! isMinimumPhase)
+            return static_cast<SampleType> (coefficients.size() - 1) * static_cast<SampleType> (0.5);
+
+        double sum = 0, weightedSum = 0;
+
+        for (auto i = 0; i < coefficients.size(); ++i)
+        {
+            sum += static_cast<double> (coefficients[i]);
+            weightedSum += static_cast<double> (coefficients[i]) * i;
+        }
+
+        return static_cast<SampleType> (weightedSum / sum);
+    }
+
+private:
+    //===============================================================================
+    /** Replaces a filter with the minimum phase filter having the same magnitude
+        response, using the homomorphic method (folding of the real cepstrum).
+        This is done at the precision of SampleType.
+    */
+    static void convertToMinimumPhase (Array<SampleType>& coefficients)
+    {
+        using ComplexType = Complex<SampleType>;
+
+        auto N = coefficients.size();
+        auto order = jmax (10, roundToInt (std::ceil (std::log2 (static_cast<double> (N)))) + 4);
+        auto size = 1 << order;
+
+        HeapBlock<ComplexType> a ((size_t) size, true);
+
+        for (auto i = 0; i < N; ++i)
+            a[i] = ComplexType (coefficients[i], 0);
+
+        // Real cepstrum of the magnitude response
+        performFFT (a, size, false);
+
+        for (auto i = 0; i < size; ++i)
+            a[i] = ComplexType (std::log (jmax (std::abs (a[i]), static_cast<SampleType> (1.0e-12))), 0);
+
+        performFFT (a, size, true);
+
+        // Folding the anticausal part onto the causal part
+        a[0] = ComplexType (a[0].real(), 0);
+
+        for (auto i = 1; i < size / 2; ++i)
+            a[i] = ComplexType (2 * a[i].real(), 0);
+
+        a[size / 2] = ComplexType (a[size / 2].real(), 0);
+
+        for (auto i = size / 2 + 1; i < size; ++i)
+            a[i] = ComplexType (0, 0);
+
+        performFFT (a, size, false);
+
+        for (auto i = 0; i < size; ++i)
+            a[i] = std::exp (a[i]);
+
+        performFFT (a, size, true);
+
+        for (auto i = 0; i < N; ++i)
+            coefficients.setUnchecked (i, a[i].real());
+    }
+
+    /** An in-place radix-2 FFT at the precision of SampleType, as dsp::FFT only deals
+        with floats. Like dsp::FFT, the inverse transform is scaled by 1 / size. This is
+        only used to design the filters, so it isn't optimised.
+    */
+    static void performFFT (Complex<SampleType>* data, int size, bool inverse)
+    {
+        using ComplexType = Complex<SampleType>;
+
+        for (int i = 1, j = 0; i < size; ++i)
+        {
+            auto bit = size >> 1;
+
+            for (; (j & bit) != 0; bit >>= 1)
+                j ^= bit;
+
+            j ^= bit;
+
+            if (i < j)
+                std::swap (data[i], data[j]);
+        }
+
+        HeapBlock<ComplexType> twiddles ((size_t) size / 2);
+
+        for (int i = 0; i < size / 2; ++i)
+        {
+            auto angle = (inverse ? 2.0 : -2.0) * double_Pi * i / size;
+            twiddles[i] = ComplexType (static_cast<SampleType> (std::cos (angle)),
+                                       static_cast<SampleType> (std::sin (angle)));
+        }
+
+        for (int length = 2; length <= size; length <<= 1)
+        {
+            auto half = length / 2;
+            auto stride = size / length;
+
+            for (int start = 0; start < size; start += length)
+            {
+                for (int k = 0; k < half; ++k)
+                {
+                    auto t = twiddles[k * stride] * data[start + k + half];
+                    data[start + k + half] = data[start + k] - t;
+                    data[start + k] += t;
+                }
+            }
+        }
+
+        if (inverse)
+            for (int i = 0; i < size; ++i)
+                data[i] /= static_cast<SampleType> (size);
+    }
+
+    //===============================================================================
+    Array<SampleType> coefficientsUp, coefficientsDown, polyphaseUp;
+    Array<SampleType> stateUp, stateDown, accumulator;
+    size_t numTapsPerPhase = 0, positionUp = 0, positionDown = 0;
+    SampleType latency;
+
+    //===============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OversamplingPolyphaseFIR)
+};
+
+
 //===============================================================================
 template <typename SampleType>
 Oversampling<SampleType>::Oversampling (size_t newNumChannels, size_t newFactor, FilterType newType, bool newMaxQuality)
@@ -584,6 +951,11 @@ Oversampling<SampleType>::Oversampling (size_t newNumChannels, size_t newFactor,
                                                                          twDown, gaindBStartDown + gaindBFactorDown * n));
         }
     }
+    else if (type == FilterType::filterPolyphaseFIR)
+    {
+        numStages = 1;
+        engines.add (OversamplingPolyphaseFIR<SampleType>::create (numChannels, factorOversampling, false, isMaximumQuality));
+    }
     else if (type == FilterType::filterHalfBandFIREquiripple)
     {
         numStages = newFactor;
@@ -605,6 +977,23 @@ Oversampling<SampleType>::Oversampling (size_t newNumChannels, size_t newFactor,
     }
 }
 
+template <typename SampleType>
+Oversampling<SampleType>::Oversampling (size_t newNumChannels, size_t newFactor, PolyphaseFilterPhase phase, bool newMaxQuality)
+{
+    jassert (newFactor > 0 && newNumChannels > 0);
+
+    factorOversampling = newFactor;
+    isMaximumQuality = newMaxQuality;
+    type = FilterType::filterPolyphaseFIR;
+    numChannels = newNumChannels;
+    numStages = 1;
+
+    if (newFactor == 1)
+        engines.add (new OversamplingDummy<SampleType> (numChannels));
+    else
+        engines.add (OversamplingPolyphaseFIR<SampleType>::create (numChannels, newFactor, phase == minimumPhase, isMaximumQuality));
+}
+
 template <typename SampleType>
 Oversampling<SampleType>::~Oversampling()
 {
@@ -629,6 +1018,18 @@ SampleType Oversampling<SampleType>::getLatencyInSamples() noexcept
     return latency;
 }
 
+template <typename SampleType>
+SampleType Oversampling<SampleType>::getPolyphaseLatencyInSamples (size_t factor, PolyphaseFilterPhase phase, bool isMaxQuality)
+{
+    jassert (factor > 0);
+
+    if (factor == 1)
+        return static_cast<SampleType> (0);
+
+    return OversamplingPolyphaseFIR<SampleType>::getDefaultLatencyInSamples (factor, phase == minimumPhase, isMaxQuality)
+             / static_cast<SampleType> (factor);
+}
+
 template <typename SampleType>
 size_t Oversampling<SampleType>::getOversamplingFactor() noexcept
 {
@@ -41,6 +41,9 @@ class OversamplingEngine;
     filters for the filtering, and reports successfully the latency added by the
     filter stages.
 
+    It can also do oversampling by any integer factor (3 times, 6 times...) in a
+    single stage with polyphase FIR filters, which can be linear or minimum phase.
+
     The principle of oversampling is to increase the sample rate of a given
     non-linear process, to prevent it from creating aliasing. Oversampling works
     by upsampling N times the input signal, processing the upsampling signal
@@ -63,9 +66,19 @@ public:
     {
         filterHalfBandFIREquiripple = 0,
         filterHalfBandPolyphaseIIR,
+        filterPolyphaseFIR,
         numFilterTypes
     };
 
+    /** The phase response of the filters used for single-stage polyphase FIR
+        oversampling.
+    */
+    enum PolyphaseFilterPhase
+    {
+        linearPhase = 0,
+        minimumPhase
+    };
+
     //===============================================================================
     /**
         Constructor of the oversampling class. All the processing parameters must be
@@ -77,13 +90,35 @@ public:
         @param numChannels      the number of channels to process with this object
         @param factor           the processing will perform 2 ^ factor times oversampling
         @param type             the type of filter design employed for filtering during
-                                oversampling
+                                oversampling. filterPolyphaseFIR uses a single linear
+                                phase polyphase FIR stage instead of a cascade
         @param isMaxQuality     if the oversampling is done using the maximum quality,
                                 the filters will be more efficient, but the CPU load will
                                 increase as well
     */
     Oversampling (size_t numChannels, size_t factor, FilterType type, bool isMaxQuality = true);
 
+    /**
+        Constructor of the oversampling class using a single polyphase FIR stage,
+        which can do oversampling by any integer factor.
+
+        With linear phase filters, the phase response is preserved but the latency is
+        maximum. With minimum phase filters, the latency is much lower, but the phase
+        is distorted near the Nyquist frequency.
+
+        @param numChannels          the number of channels to process with this object
+        @param oversamplingFactor   the processing will perform oversamplingFactor times
+                                    oversampling (note that this is not a power of two,
+                                    unlike the factor given to the other constructor)
+        @param phase                the phase response of the filters
+        @param isMaxQuality         if the oversampling is done using the maximum quality,
+                                    the filters will be more efficient, but the CPU load will
+                                    increase as well
+
+        @see getPolyphaseLatencyInSamples
+    */
+    Oversampling (size_t numChannels, size_t oversamplingFactor, PolyphaseFilterPhase phase, bool isMaxQuality = true);
+
     /** Destructor. */
     ~Oversampling();
 
@@ -94,10 +129,25 @@ public:
         the latency to the DAW.
 
         Note : the latency might not be integer, so you might need to round its value
-        or to compensate it properly in your processing code.
+        or to compensate it properly in your processing code. With minimum phase
+        polyphase filters, the delay depends on the frequency, and the value returned
+        is only an approximation: the group delay at DC.
     */
     SampleType getLatencyInSamples() noexcept;
 
+    /** Returns the latency in samples which would be reported by an object created
+        with the polyphase FIR constructor and the same settings, without having to
+        create it. This can be used to pick the cheapest oversampling factor for a
+        given processing.
+
+        Note : with minimum phase filters, the delay depends on the frequency, so this
+        is only an approximation, the group delay at DC, which is close to the delay of
+        the low frequencies but not of those near the cutoff. This designs the filters
+        to find their latency, so don't call it on the audio thread.
+    */
+    static SampleType getPolyphaseLatencyInSamples (size_t oversamplingFactor, PolyphaseFilterPhase phase,
+                                                    bool isMaxQuality = true);
+
     /** Returns the current oversampling factor. */
     size_t getOversamplingFactor() noexcept;
 
@@ -0,0 +1,159 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 5 End-User License
+   Agreement and JUCE 5 Privacy Policy (both updated and effective as of the
+   27th April 2017).
+
+   End User License Agreement: www.juce.com/juce-5-licence
+   Privacy Policy: www.juce.com/juce-5-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+struct OversamplingUnitTest  : public UnitTest
+{
+    OversamplingUnitTest()  : UnitTest ("Oversampling") {}
+
+    static constexpr double sampleRate = 44100.0;
+    static constexpr size_t blockSize = 512;
+
+    // Returns the amplitude and phase of a signal at a given normalised frequency
+    static std::complex<double> analyse (const float* data, size_t numSamples, double frequency)
+    {
+        std::complex<double> sum;
+        auto w = 2.0 * double_Pi * frequency;
+
+        for (size_t i = 0; i < numSamples; ++i)
+            sum += std::polar ((double) data[i], -w * (double) i);
+
+        return sum * (2.0 / (double) numSamples);
+    }
+
+    static HeapBlock<float> createSine (size_t numSamples, double frequency)
+    {
+        HeapBlock<float> data (numSamples);
+
+        for (size_t i = 0; i < numSamples; ++i)
+            data[i] = 0.5f * (float) std::sin (2.0 * double_Pi * frequency * (double) i);
+
+        return data;
+    }
+
+    // Oversamples a signal and brings it back down again, keeping the oversampled signal too
+    static void process (Oversampling<float>& oversampling, const float* input, float* output,
+                         float* oversampled, size_t numSamples)
+    {
+        auto factor = oversampling.getOversamplingFactor();
+        oversampling.initProcessing (blockSize);
+
+        for (size_t pos = 0; pos < numSamples; pos += blockSize)
+        {
+            auto num = jmin (blockSize, numSamples - pos);
+            float* inputChannel = const_cast<float*> (input + pos);
+            float* outputChannel = output + pos;
+
+            auto up = oversampling.processSamplesUp (AudioBlock<float> (&inputChannel, 1, num));
+            memcpy (oversampled + pos * factor, up.getChannelPointer (0), num * factor * sizeof (float));
+
+            AudioBlock<float> outputBlock (&outputChannel, 1, num);
+            oversampling.processSamplesDown (outputBlock);
+        }
+    }
+
+    void runTest() override
+    {
+        // The analysis windows skip the start, to let the filters settle,
+        // and hold a whole number of periods of the test signals.
+        constexpr size_t numSamples = 44100, analysisStart = 4410, analysisLength = 35280;
+        const double lowFrequency = 50.0 / sampleRate, highFrequency = 1000.0 / sampleRate;
+
+        auto lowSine  = createSine (numSamples, lowFrequency);
+        auto highSine = createSine (numSamples, highFrequency);
+
+        for (auto phase : { Oversampling<float>::linearPhase, Oversampling<float>::minimumPhase })
+        {
+            beginTest (phase == Oversampling<float>::linearPhase ? "Linear phase" : "Minimum phase");
+
+            for (size_t factor : { 2, 3, 4, 6 })
+            {
+                Oversampling<float> oversampling (1, factor, phase, true);
+                auto latency = oversampling.getLatencyInSamples();
+
+                expectEquals (oversampling.getOversamplingFactor(), factor);
+                expectWithinAbsoluteError (Oversampling<float>::getPolyphaseLatencyInSamples (factor, phase, true),
+                                           latency, 1.0e-4f);
+
+                HeapBlock<float> output (numSamples), oversampled (numSamples * factor);
+
+                // the gain in the passband is unity, and the delay is the reported latency
+                {
+                    process (oversampling, lowSine, output, oversampled, numSamples);
+
+                    auto in  = analyse (lowSine + analysisStart, analysisLength, lowFrequency);
+                    auto out = analyse (output  + analysisStart, analysisLength, lowFrequency);
+                    auto delay = std::arg (in / out) / (2.0 * double_Pi * lowFrequency);
+
+                    expectWithinAbsoluteError (std::abs (out) / std::abs (in), 1.0, 1.0e-3);
+                    expectWithinAbsoluteError (delay, (double) latency, 0.01);
+                }
+
+                {
+                    oversampling.reset();
+                    process (oversampling, highSine, output, oversampled, numSamples);
+
+                    auto in  = analyse (highSine + analysisStart, analysisLength, highFrequency);
+                    auto out = analyse (output   + analysisStart, analysisLength, highFrequency);
+                    expectWithinAbsoluteError (std::abs (out) / std::abs (in), 1.0, 1.0e-3);
+
+                    // the oversampled signal has the same amplitude, and its first image is removed
+                    auto* oversampledStart = oversampled + analysisStart * factor;
+                    auto oversampledLength = analysisLength * factor;
+                    auto signal = analyse (oversampledStart, oversampledLength, highFrequency / (double) factor);
+                    auto image  = analyse (oversampledStart, oversampledLength, (1.0 - highFrequency) / (double) factor);
+
+                    expectWithinAbsoluteError (std::abs (signal) / std::abs (in), 1.0, 1.0e-3);
+                    expectLessThan (Decibels::gainToDecibels (std::abs (image) / std::abs (signal)), -60.0);
+                }
+            }
+        }
+
+        beginTest ("Minimum phase latency");
+        {
+            for (size_t factor : { 2, 3, 4, 6 })
+            {
+                auto minimumLatency = Oversampling<float>::getPolyphaseLatencyInSamples (factor, Oversampling<float>::minimumPhase);
+
+                expectLessThan (minimumLatency, Oversampling<float>::getPolyphaseLatencyInSamples (factor, Oversampling<float>::linearPhase) * 0.5f);
+
+                // the double precision design should describe the same filter
+                expectWithinAbsoluteError ((double) minimumLatency,
+                                           Oversampling<double>::getPolyphaseLatencyInSamples (factor, Oversampling<double>::minimumPhase),
+                                           0.01);
+            }
+        }
+    }
+};
+
+static OversamplingUnitTest oversamplingUnitTest;
+
+} // namespace dsp
+} // namespace juce
@@ -59,6 +59,9 @@ struct ProcessorState  : public ReferenceCountedObject
     using Ptr = ReferenceCountedObjectPtr<ProcessorState>;
 };
 
+template <typename FloatType>
+class SmoothedParameterBank;
+
 //==============================================================================
 /**
     Contains context information that is passed into an algorithm's process method.
@@ -77,6 +80,8 @@ public:
     using SampleType     = ContextSampleType;
     /** The type of audio block that this context handles. */
     using AudioBlockType = AudioBlock<SampleType>;
+    /** The type of the values in a sample. */
+    using NumericType    = typename SampleTypeHelpers::ElementType<SampleType>::Type;
 
     /** Creates a ProcessContextReplacing that uses the given audio block.
         Note that the caller must not delete the block while it is still in use by this object!
@@ -103,6 +108,12 @@ public:
     */
     bool isBypassed = false;
 
+    /** An optional bank of smoothed parameters, whose ramps cover this context's block.
+        Processors which have been given an index in the bank will read their values
+        from it instead of using their own smoothing.
+    */
+    const SmoothedParameterBank<NumericType>* parameterBank = nullptr;
+
 private:
     AudioBlockType& ioBlock;
 };
@@ -126,6 +137,8 @@ public:
     using SampleType     = ContextSampleType;
     /** The type of audio block that this context handles. */
     using AudioBlockType = AudioBlock<SampleType>;
+    /** The type of the values in a sample. */
+    using NumericType    = typename SampleTypeHelpers::ElementType<SampleType>::Type;
 
     /** Creates a ProcessContextReplacing that uses the given input and output blocks.
         Note that the caller must not delete these blocks while they are still in use by this object!
@@ -153,6 +166,12 @@ public:
     */
     bool isBypassed = false;
 
+    /** An optional bank of smoothed parameters, whose ramps cover this context's block.
+        Processors which have been given an index in the bank will read their values
+        from it instead of using their own smoothing.
+    */
+    const SmoothedParameterBank<NumericType>* parameterBank = nullptr;
+
 private:
     const AudioBlockType& inputBlock;
     AudioBlockType& outputBlock;
@@ -0,0 +1,360 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 5 End-User License
+   Agreement and JUCE 5 Privacy Policy (both updated and effective as of the
+   27th April 2017).
+
+   End User License Agreement: www.juce.com/juce-5-licence
+   Privacy Policy: www.juce.com/juce-5-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+/**
+    A bank of linearly smoothed parameters, which produces a ramp of values for
+    each parameter once per block.
+
+    Rather than each processor stepping its own LinearSmoothedValue sample by
+    sample, the state of all the parameters is kept in a structure-of-arrays
+    layout, and a single call to advance() writes the ramps of every parameter
+    for the next block into contiguous, SIMD aligned buffers. Parameters which
+    are not moving are only written once, when they stop moving.
+
+    New target values can be set from any thread with setTargetValue(), which is
+    lock-free: the audio thread picks up the latest value of each parameter at
+    the start of the next call to advance().
+
+    Processors such as Gain and Bias can read their values from a bank when it is
+    passed to them in the parameterBank member of a ProcessContext, e.g.
+    @code
+    bank.advance (block.getNumSamples());
+
+    ProcessContextReplacing<float> context (block);
+    context.parameterBank = &bank;
+    processorChain.process (context);
+    @endcode
+
+    @see LinearSmoothedValue, Gain::setParameterBankIndex
+*/
+template <typename FloatType>
+class SmoothedParameterBank
+{
+public:
+    //==============================================================================
+    /** Creates a bank with a given number of parameters, all starting at zero. */
+    SmoothedParameterBank (int numParametersToUse = 0)
+    {
+        setNumParameters (numParametersToUse);
+    }
+
+    //==============================================================================
+    /** Changes the number of parameters in the bank.
+
+        This allocates memory, so mustn't be called while advance() may be running.
+        The existing parameters keep their values.
+    */
+    void setNumParameters (int newNumParameters)
+    {
+        jassert (newNumParameters >= 0);
+
+        // (the atomics can't be moved by realloc, so the pending values are copied across)
+        HeapBlock<Atomic<FloatType>> newPendingTargets ((size_t) newNumParameters, true);
+        HeapBlock<Atomic<int>> newPendingFlags ((size_t) newNumParameters, true);
+
+        for (int i = 0; i < jmin (numParameters, newNumParameters); ++i)
+        {
+            newPendingTargets[i].set (pendingTargets[i].get());
+            newPendingFlags[i].set (pendingFlags[i].get());
+        }
+
+        pendingTargets.swapWith (newPendingTargets);
+        pendingFlags.swapWith (newPendingFlags);
+
+        currentValues.realloc ((size_t) newNumParameters);
+        targetValues .realloc ((size_t) newNumParameters);
+        steps        .realloc ((size_t) newNumParameters);
+        countdowns   .realloc ((size_t) newNumParameters);
+        stepsToTarget.realloc ((size_t) newNumParameters);
+        rampDurations.realloc ((size_t) newNumParameters);
+        numValidSamples.realloc ((size_t) newNumParameters);
+
+        for (int i = numParameters; i < newNumParameters; ++i)
+        {
+            currentValues[i] = targetValues[i] = steps[i] = 0;
+            countdowns[i] = stepsToTarget[i] = 0;
+            rampDurations[i] = 0.0;
+        }
+
+        numParameters = newNumParameters;
+        allocateRamps();
+        updateStepsToTarget();
+    }
+
+    /** Returns the number of parameters in the bank. */
+    int getNumParameters() const noexcept                       { return numParameters; }
+
+    //==============================================================================
+    /** Sets the length of the ramp used for smoothing changes of every parameter. */
+    void setRampDurationSeconds (double newDurationSeconds) noexcept
+    {
+        for (int i = 0; i < numParameters; ++i)
+            rampDurations[i] = newDurationSeconds;
+
+        updateStepsToTarget();
+    }
+
+    /** Sets the length of the ramp used for smoothing changes of one parameter. */
+    void setRampDurationSeconds (int parameterIndex, double newDurationSeconds) noexcept
+    {
+        jassert (isPositiveAndBelow (parameterIndex, numParameters));
+
+        rampDurations[parameterIndex] = newDurationSeconds;
+        updateStepsToTarget();
+    }
+
+    //==============================================================================
+    /** Sets a new target value for a parameter.
+
+        This can be called from any thread, and is lock-free. The parameter will
+        start moving towards the new value at the start of the next block.
+    */
+    void setTargetValue (int parameterIndex, FloatType newValue) noexcept
+    {
+        jassert (isPositiveAndBelow (parameterIndex, numParameters));
+
+        pendingTargets[parameterIndex].set (newValue);
+        pendingFlags[parameterIndex].set (1);
+        anyPending.set (1);
+    }
+
+    /** Returns the value towards which a parameter is currently moving.
+        This should only be called from the audio thread.
+    */
+    FloatType getTargetValue (int parameterIndex) const noexcept   { return targetValues[parameterIndex]; }
+
+    /** Returns the value that a parameter had at the end of the last block.
+        This should only be called from the audio thread.
+    */
+    FloatType getCurrentValue (int parameterIndex) const noexcept  { return currentValues[parameterIndex]; }
+
+    /** Returns true if a parameter was still moving at the end of the last block. */
+    bool isSmoothing (int parameterIndex) const noexcept           { return countdowns[parameterIndex] > 0; }
+
+    //==============================================================================
+    /** Called before processing starts. */
+    void prepare (const ProcessSpec& spec)
+    {
+        sampleRate = spec.sampleRate;
+        maximumBlockSize = static_cast<size_t> (spec.maximumBlockSize);
+
+        allocateRamps();
+        updateStepsToTarget();
+        reset();
+    }
+
+    /** Stops any ramps, jumping every parameter to its latest target value. */
+    void reset() noexcept
+    {
+        applyPendingTargets();
+
+        for (int i = 0; i < numParameters; ++i)
+        {
+            currentValues[i] = targetValues[i];
+            countdowns[i] = 0;
+            numValidSamples[i] = 0;
+        }
+
+        numSamplesInBlock = 0;
+    }
+
+    //==============================================================================
+    /** Computes the ramps of all the parameters for the next block of samples.
+
+        This must be called from the audio thread, once per block and before any
+        processor reads the ramps. The number of samples must not be larger than the
+        maximumBlockSize passed to prepare().
+    */
+    void advance (size_t numSamples) noexcept
+    {
+        jassert (numSamples <= maximumBlockSize);
+        numSamples = jmin (numSamples, maximumBlockSize);
+
+        if (anyPending.get() != 0)
+            applyPendingTargets();
+
+        for (int i = 0; i < numParameters; ++i)
+        {
+            auto* ramp = getRampPointer (i);
+
+            if (countdowns[i] <= 0)
+            {
+                // already filled with the target value by a previous block
+                if (numValidSamples[i] >= numSamples)
+                    continue;
+
+                FloatVectorOperations::fill (ramp, targetValues[i], static_cast<int> (numSamples));
+                numValidSamples[i] = numSamples;
+                continue;
+            }
+
+            auto numRamping = jmin (static_cast<size_t> (countdowns[i]), numSamples);
+            writeRamp (ramp, currentValues[i], steps[i], numRamping);
+            countdowns[i] -= static_cast<int> (numRamping);
+
+            if (countdowns[i] > 0)
+            {
+                currentValues[i] += steps[i] * static_cast<FloatType> (numRamping);
+            }
+            else
+            {
+                currentValues[i] = targetValues[i];
+
+                if (numRamping < numSamples)
+                    FloatVectorOperations::fill (ramp + numRamping, targetValues[i], static_cast<int> (numSamples - numRamping));
+            }
+
+            numValidSamples[i] = 0;
+        }
+
+        numSamplesInBlock = numSamples;
+    }
+
+    /** Returns the number of samples in the ramps computed by the last call to advance(). */
+    size_t getNumSamples() const noexcept                           { return numSamplesInBlock; }
+
+    /** Returns the values of a parameter for each sample of the last block passed
+        to advance(). The buffer is SIMD aligned.
+    */
+    const FloatType* getRamp (int parameterIndex) const noexcept
+    {
+        jassert (isPositiveAndBelow (parameterIndex, numParameters));
+        return rampData + static_cast<size_t> (parameterIndex) * rampStride;
+    }
+
+private:
+    //==============================================================================
+    FloatType* getRampPointer (int parameterIndex) noexcept
+    {
+        return rampData + static_cast<size_t> (parameterIndex) * rampStride;
+    }
+
+    void applyPendingTargets() noexcept
+    {
+        anyPending.set (0);
+
+        for (int i = 0; i < numParameters; ++i)
+        {
+            if (pendingFlags[i].exchange (0) == 0)
+                continue;
+
+            auto newTarget = pendingTargets[i].get();
+
+            if (newTarget == targetValues[i])
+                continue;
+
+            targetValues[i] = newTarget;
+            countdowns[i] = stepsToTarget[i];
+            numValidSamples[i] = 0;
+
+            if (countdowns[i] <= 0)
+                currentValues[i] = newTarget;
+            else
+                steps[i] = (newTarget - currentValues[i]) / static_cast<FloatType> (countdowns[i]);
+        }
+    }
+
+    void updateStepsToTarget() noexcept
+    {
+        for (int i = 0; i < numParameters; ++i)
+            stepsToTarget[i] = sampleRate > 0 ? (int) std::floor (rampDurations[i] * sampleRate) : 0;
+    }
+
+    void allocateRamps()
+    {
+        auto alignment = static_cast<size_t> (16);
+       #if JUCE_USE_SIMD
+        alignment = SIMDRegister<FloatType>::SIMDRegisterSize / sizeof (FloatType);
+       #endif
+
+        rampStride = ((maximumBlockSize + alignment - 1) / alignment) * alignment;
+        rampMemory.calloc (rampStride * static_cast<size_t> (numParameters) + alignment);
+
+        rampData = rampMemory.get();
+       #if JUCE_USE_SIMD
+        rampData = SIMDRegister<FloatType>::getNextSIMDAlignedPtr (rampData);
+       #endif
+
+        for (int i = 0; i < numParameters; ++i)
+            numValidSamples[i] = 0;
+    }
+
+    // writes start + step * (i + 1) for each sample i
+    static void writeRamp (FloatType* dest, FloatType start, FloatType step, size_t numSamples) noexcept
+    {
+        size_t i = 0;
+
+       #if JUCE_USE_SIMD
+        using Vector = SIMDRegister<FloatType>;
+        constexpr auto vectorSize = Vector::SIMDNumElements;
+
+        auto indices = Vector::expand (0);
+
+        for (size_t j = 0; j < vectorSize; ++j)
+            indices[j] = static_cast<FloatType> (j + 1);
+
+        auto starts = Vector::expand (start);
+        auto steps  = Vector::expand (step);
+        auto* vectors = reinterpret_cast<Vector*> (dest);
+
+        for (; i + vectorSize <= numSamples; i += vectorSize)
+        {
+            *vectors++ = starts + indices * steps;
+            indices += static_cast<FloatType> (vectorSize);
+        }
+       #endif
+
+        for (; i < numSamples; ++i)
+            dest[i] = start + step * static_cast<FloatType> (i + 1);
+    }
+
+    //==============================================================================
+    HeapBlock<Atomic<FloatType>> pendingTargets;
+    HeapBlock<Atomic<int>> pendingFlags;
+    Atomic<int> anyPending;
+
+    HeapBlock<FloatType> currentValues, targetValues, steps;
+    HeapBlock<int> countdowns, stepsToTarget;
+    HeapBlock<double> rampDurations;
+    HeapBlock<size_t> numValidSamples;
+
+    HeapBlock<FloatType> rampMemory;
+    FloatType* rampData = nullptr;
+    size_t rampStride = 0, maximumBlockSize = 0, numSamplesInBlock = 0;
+
+    int numParameters = 0;
+    double sampleRate = 0;
+
+    JUCE_DECLARE_NON_COPYABLE (SmoothedParameterBank)
+};
+
+} // namespace dsp
+} // namespace juce
@@ -0,0 +1,231 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2017 - ROLI Ltd.
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   By using JUCE, you agree to the terms of both the JUCE 5 End-User License
+   Agreement and JUCE 5 Privacy Policy (both updated and effective as of the
+   27th April 2017).
+
+   End User License Agreement: www.juce.com/juce-5-licence
+   Privacy Policy: www.juce.com/juce-5-privacy-policy
+
+   Or: You may also use this code under the terms of the GPL v3 (see
+   www.gnu.org/licenses).
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+namespace dsp
+{
+
+struct SmoothedParameterBankUnitTest  : public UnitTest
+{
+    SmoothedParameterBankUnitTest()  : UnitTest ("SmoothedParameterBank") {}
+
+    static ProcessSpec getSpec (uint32 blockSize)    { return { 44100.0, blockSize, 1 }; }
+
+    template <typename FloatType>
+    void runRampTest()
+    {
+        constexpr int numParameters = 5;
+        constexpr size_t blockSize = 67;
+        const double rampLength = 0.01;
+
+        SmoothedParameterBank<FloatType> bank (numParameters);
+        bank.prepare (getSpec (blockSize));
+        bank.setRampDurationSeconds (rampLength);
+
+        OwnedArray<LinearSmoothedValue<FloatType>> references;
+
+        for (int i = 0; i < numParameters; ++i)
+            references.add (new LinearSmoothedValue<FloatType>())->reset (44100.0, rampLength);
+
+        Random random (0x1234);
+
+        // the ramps are computed as start + step * n rather than by accumulating the
+        // steps, so they will drift slightly from a LinearSmoothedValue's
+        for (int block = 0; block < 100; ++block)
+        {
+            // change some targets every few blocks, sometimes in the middle of a ramp
+            if (block % 3 == 0)
+            {
+                for (int i = 0; i < numParameters; ++i)
+                {
+                    if (random.nextBool())
+                    {
+                        auto newValue = static_cast<FloatType> (random.nextFloat() * 2.0f - 1.0f);
+                        bank.setTargetValue (i, newValue);
+                        references[i]->setValue (newValue);
+                    }
+                }
+            }
+
+            bank.advance (blockSize);
+            expectEquals ((int) bank.getNumSamples(), (int) blockSize);
+
+            for (int i = 0; i < numParameters; ++i)
+            {
+                auto* ramp = bank.getRamp (i);
+
+                for (size_t n = 0; n < blockSize; ++n)
+                    expect (std::abs (ramp[n] - references[i]->getNextValue()) < (FloatType) 1e-4);
+
+                expect (bank.isSmoothing (i) == references[i]->isSmoothing());
+            }
+        }
+    }
+
+    void runConcurrentUpdateTest()
+    {
+        constexpr int numParameters = 64;
+        constexpr size_t blockSize = 32;
+
+        SmoothedParameterBank<float> bank (numParameters);
+        bank.prepare (getSpec (blockSize));
+        bank.setRampDurationSeconds (0.001);
+
+        struct Writer  : public Thread
+        {
+            Writer (SmoothedParameterBank<float>& b) : Thread ("SmoothedParameterBank writer"), bank (b) {}
+
+            void run() override
+            {
+                for (int n = 1; n <= 20000; ++n)
+                    bank.setTargetValue (n % numParameters, (float) n);
+
+                for (int i = 0; i < numParameters; ++i)
+                    bank.setTargetValue (i, -1.0f);
+            }
+
+            SmoothedParameterBank<float>& bank;
+        };
+
+        Writer writer (bank);
+        writer.startThread();
+
+        while (writer.isThreadRunning())
+            bank.advance (blockSize);
+
+        for (int i = 0; i < 10; ++i)
+            bank.advance (blockSize);
+
+        for (int i = 0; i < numParameters; ++i)
+        {
+            expectEquals (bank.getTargetValue (i), -1.0f);
+            expectEquals (bank.getRamp (i)[blockSize - 1], -1.0f);
+        }
+    }
+
+    void runProcessorTest()
+    {
+        constexpr size_t blockSize = 128;
+
+        SmoothedParameterBank<float> bank (2);
+        bank.prepare (getSpec (blockSize));
+        bank.setRampDurationSeconds (0.001);
+        bank.setTargetValue (0, 0.5f);
+        bank.setTargetValue (1, 0.25f);
+        bank.advance (blockSize);
+
+        HeapBlock<char> data;
+        AudioBlock<float> block (data, 2, blockSize);
+        block.fill (1.0f);
+
+        Gain<float> gain;
+        Bias<float> bias;
+        gain.prepare (getSpec (blockSize));
+        bias.prepare (getSpec (blockSize));
+        gain.setParameterBankIndex (0);
+        bias.setParameterBankIndex (1);
+
+        ProcessContextReplacing<float> context (block);
+        context.parameterBank = &bank;
+        gain.process (context);
+        bias.process (context);
+
+        for (size_t ch = 0; ch < 2; ++ch)
+            for (size_t i = 0; i < blockSize; ++i)
+                expect (std::abs (block.getChannelPointer (ch)[i] - (bank.getRamp (0)[i] + bank.getRamp (1)[i])) < 1.0e-6f);
+
+        expectEquals (block.getChannelPointer (1)[blockSize - 1], 0.75f);
+    }
+
+    void runBenchmark()
+    {
+        constexpr int numParameters = 200, numBlocks = 2000;
+        constexpr size_t blockSize = 256;
+
+        SmoothedParameterBank<float> bank (numParameters);
+        bank.prepare (getSpec (blockSize));
+        bank.setRampDurationSeconds (0.05);
+
+        OwnedArray<LinearSmoothedValue<float>> smoothers;
+        HeapBlock<float> output (blockSize);
+
+        for (int i = 0; i < numParameters; ++i)
+            smoothers.add (new LinearSmoothedValue<float>())->reset (44100.0, 0.05);
+
+        // automate one parameter in ten, changing their targets every 20 blocks
+        auto run = [&] (std::function<void (int)> setTarget, std::function<void()> processBlock)
+        {
+            auto start = Time::getHighResolutionTicks();
+
+            for (int block = 0; block < numBlocks; ++block)
+            {
+                if (block % 20 == 0)
+                    for (int i = 0; i < numParameters; i += 10)
+                        setTarget (i);
+
+                processBlock();
+            }
+
+            return Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start) * 1.0e6 / numBlocks;
+        };
+
+        auto separate = run ([&] (int i) { smoothers[i]->setValue ((float) Random::getSystemRandom().nextFloat()); },
+                             [&]
+                             {
+                                 for (auto* s : smoothers)
+                                     for (size_t n = 0; n < blockSize; ++n)
+                                         output[n] = s->getNextValue();
+                             });
+
+        auto banked = run ([&] (int i) { bank.setTargetValue (i, (float) Random::getSystemRandom().nextFloat()); },
+                           [&] { bank.advance (blockSize); });
+
+        logMessage (String (numParameters) + " parameters, " + String (blockSize) + " samples: LinearSmoothedValue "
+                      + String (separate, 2) + " us/block, SmoothedParameterBank " + String (banked, 2) + " us/block");
+    }
+
+    void runTest() override
+    {
+        beginTest ("Ramps");
+        runRampTest<float>();
+        runRampTest<double>();
+
+        beginTest ("Concurrent updates");
+        runConcurrentUpdateTest();
+
+        beginTest ("Gain and Bias");
+        runProcessorTest();
+
+        beginTest ("Speed");
+        runBenchmark();
+    }
+};
+
+static SmoothedParameterBankUnitTest smoothedParameterBankUnitTest;
+
+} // namespace dsp
+} // namespace juce
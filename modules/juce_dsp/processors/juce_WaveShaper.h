@@ -31,6 +31,10 @@ namespace dsp
 
 /**
     Applies waveshaping to audio samples as single samples or AudioBlocks.
+
+    If the function can also be called with a pointer to a buffer and a number of
+    samples, like the FastMathApproximations function objects, whole channels are
+    passed to it at once, which lets it use vectorised code.
 */
 template <typename FloatType, typename Function = FloatType (*) (FloatType)>
 struct WaveShaper
@@ -56,12 +60,38 @@ struct WaveShaper
         jassert (context.getInputBlock().getNumChannels() == context.getOutputBlock().getNumChannels());
         jassert (context.getInputBlock().getNumSamples()  == context.getOutputBlock().getNumSamples());
 
-        AudioBlock<FloatType>::process (context.getInputBlock(),
-                                        context.getOutputBlock(),
-                                        functionToUse);
+        processBlock (context.getInputBlock(), context.getOutputBlock(), 0);
     }
 
     void reset() noexcept {}
+
+private:
+    //==============================================================================
+    // Used when the function can also process a whole buffer at once, like the
+    // vectorised FastMathApproximations function objects
+    template <typename F = Function>
+    auto processBlock (const AudioBlock<FloatType>& input, AudioBlock<FloatType>& output, int) const noexcept
+        -> decltype (std::declval<const F&>() (std::declval<FloatType*>(), size_t()), void())
+    {
+        auto numSamples = output.getNumSamples();
+
+        for (size_t ch = 0; ch < output.getNumChannels(); ++ch)
+        {
+            auto* src = input.getChannelPointer (ch);
+            auto* dst = output.getChannelPointer (ch);
+
+            if (src != dst)
+                std::copy (src, src + numSamples, dst);
+
+            functionToUse (dst, numSamples);
+        }
+    }
+
+    template <typename F = Function>
+    void processBlock (const AudioBlock<FloatType>& input, AudioBlock<FloatType>& output, long) const noexcept
+    {
+        AudioBlock<FloatType>::process (input, output, functionToUse);
+    }
 };
 
 //==============================================================================